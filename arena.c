@@ -0,0 +1,89 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Arena Allocator Implementation
+ * ==============================================================================
+ */
+
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define ARENA_BLOCK_SIZE (64u * 1024)           /* Default block payload */
+#define ARENA_ALIGNMENT sizeof(void *)
+
+struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t capacity;
+    /* Payload follows, aligned by the union below */
+    union {
+        void *pointer;
+        uint64_t integer;
+        double real;
+    } data[];
+};
+
+/* ==============================================================================
+ * Arena Implementation
+ * ==============================================================================
+ */
+
+void arena_init(Arena *arena) {
+    if (!arena) return;
+    arena->blocks = NULL;
+    arena->used = 0;
+    arena->capacity = 0;
+    arena->total = 0;
+}
+
+void arena_destroy(Arena *arena) {
+    if (!arena) return;
+
+    struct ArenaBlock *block = arena->blocks;
+    while (block) {
+        struct ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena_init(arena);
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    if (!arena) return NULL;
+
+    size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (aligned < size) return NULL;
+
+    if (!arena->blocks || arena->capacity - arena->used < aligned) {
+        /* Oversized requests get a block of their own */
+        size_t capacity = aligned > ARENA_BLOCK_SIZE ? aligned : ARENA_BLOCK_SIZE;
+        struct ArenaBlock *block = malloc(sizeof(struct ArenaBlock) + capacity);
+        if (!block) return NULL;
+
+        block->capacity = capacity;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->used = 0;
+        arena->capacity = capacity;
+    }
+
+    void *memory = (char *)arena->blocks->data + arena->used;
+    arena->used += aligned;
+    arena->total += aligned;
+    memset(memory, 0, size);
+    return memory;
+}
+
+char *arena_strdup(Arena *arena, const char *str) {
+    if (!str) return NULL;
+
+    size_t len = strlen(str) + 1;
+    char *copy = arena_alloc(arena, len);
+    if (copy) memcpy(copy, str, len);
+    return copy;
+}
@@ -0,0 +1,77 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Arena Allocator
+ * ==============================================================================
+ *
+ * Bump allocator for objects that all live exactly as long as their owner,
+ * such as the nodes and path strings of a dependency graph. Allocation is a
+ * pointer increment within a block; nothing is freed individually, and
+ * arena_destroy releases every block in one pass.
+ *
+ * An arena is not thread-safe; callers that share one serialize access.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One block of arena memory (internal) */
+struct ArenaBlock;
+
+/**
+ * Arena - Chain of blocks allocated from the front
+ */
+typedef struct Arena {
+    struct ArenaBlock *blocks;              /* Most recent block first */
+    size_t used;                            /* Bytes used in the current block */
+    size_t capacity;                        /* Usable bytes in the current block */
+    size_t total;                           /* Bytes handed out, all blocks */
+} Arena;
+
+/**
+ * Initialize an empty arena (no memory is allocated until first use)
+ *
+ * @param arena  Pointer to Arena
+ */
+void arena_init(Arena *arena);
+
+/**
+ * Free every block
+ *
+ * @param arena  Pointer to Arena
+ */
+void arena_destroy(Arena *arena);
+
+/**
+ * Allocate zeroed, pointer-aligned memory
+ *
+ * @param arena  Pointer to Arena
+ * @param size   Bytes to allocate
+ * @return       Memory valid until arena_destroy, or NULL on allocation failure
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Copy a string into the arena
+ *
+ * @param arena  Pointer to Arena
+ * @param str    String to copy
+ * @return       Copy valid until arena_destroy, or NULL on allocation failure
+ */
+char *arena_strdup(Arena *arena, const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,248 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Build Tracing Implementation
+ * ==============================================================================
+ */
+
+#include "build_trace.h"
+#include "include/eventchains_platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+    #include <time.h>
+#endif
+
+/* ==============================================================================
+ * Clock
+ * ==============================================================================
+ */
+
+double build_clock_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+
+/* ==============================================================================
+ * Recorded Spans
+ * ==============================================================================
+ */
+
+/**
+ * TraceEvent - One closed span
+ */
+typedef struct TraceEvent {
+    const char *category;
+    const char *name;
+    char *detail;                           /* Owned, or NULL */
+    uint64_t start_us;                      /* Since build_trace_start, plus one */
+    uint64_t duration_us;
+    unsigned thread;
+} TraceEvent;
+
+/**
+ * Tracer - Process-wide trace state
+ *
+ * The spans come from every module of the build, many of them on worker
+ * threads, so there is one tracer rather than one threaded through each
+ * API. enabled is only written while no traced threads run.
+ */
+static struct {
+    bool enabled;
+    bool lock_ready;
+    ec_mutex_t lock;                        /* Guards everything below */
+    double origin;                          /* build_clock_seconds at start */
+    TraceEvent *events;
+    size_t count;
+    size_t capacity;
+    size_t dropped;                         /* Spans past BUILD_TRACE_MAX_EVENTS */
+    unsigned next_thread;                   /* Next thread number to hand out */
+    unsigned main_thread;
+    unsigned generation;                    /* Bumped by every build_trace_start */
+} tracer;
+
+/* Thread number within the trace, valid while trace_generation matches */
+static EC_THREAD_LOCAL unsigned trace_thread;
+static EC_THREAD_LOCAL unsigned trace_generation;
+
+static uint64_t trace_now_us(void) {
+    return (uint64_t)((build_clock_seconds() - tracer.origin) * 1e6) + 1;
+}
+
+/* Called with the lock held */
+static unsigned trace_thread_number(void) {
+    if (trace_generation != tracer.generation) {
+        trace_thread = tracer.next_thread++;
+        trace_generation = tracer.generation;
+    }
+    return trace_thread;
+}
+
+static void trace_free_events(void) {
+    for (size_t i = 0; i < tracer.count; i++) {
+        free(tracer.events[i].detail);
+    }
+    free(tracer.events);
+    tracer.events = NULL;
+    tracer.count = 0;
+    tracer.capacity = 0;
+    tracer.dropped = 0;
+}
+
+bool build_trace_start(void) {
+    if (!tracer.lock_ready) {
+        if (ec_mutex_init(&tracer.lock) != 0) return false;
+        tracer.lock_ready = true;
+    }
+
+    ec_mutex_lock(&tracer.lock);
+    trace_free_events();
+    tracer.origin = build_clock_seconds();
+    tracer.next_thread = 1;
+    tracer.generation++;
+    tracer.main_thread = trace_thread_number();
+    tracer.enabled = true;
+    ec_mutex_unlock(&tracer.lock);
+    return true;
+}
+
+bool build_trace_enabled(void) {
+    return tracer.enabled;
+}
+
+uint64_t build_trace_begin(void) {
+    return tracer.enabled ? trace_now_us() : 0;
+}
+
+void build_trace_end(uint64_t start, const char *category, const char *name,
+                     const char *detail) {
+    if (start == 0 || !tracer.enabled) return;
+
+    uint64_t end = trace_now_us();
+    char *detail_copy = detail ? strdup(detail) : NULL;
+
+    ec_mutex_lock(&tracer.lock);
+    if (tracer.count >= BUILD_TRACE_MAX_EVENTS) {
+        tracer.dropped++;
+        ec_mutex_unlock(&tracer.lock);
+        free(detail_copy);
+        return;
+    }
+    if (tracer.count >= tracer.capacity) {
+        size_t capacity = tracer.capacity == 0 ? 1024 : tracer.capacity * 2;
+        TraceEvent *events = realloc(tracer.events, capacity * sizeof(TraceEvent));
+        if (!events) {
+            tracer.dropped++;
+            ec_mutex_unlock(&tracer.lock);
+            free(detail_copy);
+            return;
+        }
+        tracer.events = events;
+        tracer.capacity = capacity;
+    }
+
+    TraceEvent *event = &tracer.events[tracer.count++];
+    event->category = category;
+    event->name = name;
+    event->detail = detail_copy;
+    event->start_us = start;
+    event->duration_us = end > start ? end - start : 0;
+    event->thread = trace_thread_number();
+    ec_mutex_unlock(&tracer.lock);
+}
+
+void build_trace_stop(void) {
+    if (!tracer.lock_ready) return;
+
+    ec_mutex_lock(&tracer.lock);
+    tracer.enabled = false;
+    trace_free_events();
+    ec_mutex_unlock(&tracer.lock);
+}
+
+/* ==============================================================================
+ * Chrome Trace-Event Export
+ * ==============================================================================
+ */
+
+static void write_json_string(FILE *fp, const char *text) {
+    fputc('"', fp);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', fp);
+            fputc(*p, fp);
+        } else if (*p < 0x20) {
+            fprintf(fp, "\\u%04x", *p);
+        } else {
+            fputc(*p, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+bool build_trace_write(const char *path, size_t *event_count) {
+    if (event_count) *event_count = 0;
+    if (!path || !tracer.lock_ready) return false;
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+
+    ec_mutex_lock(&tracer.lock);
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":%zu},\n",
+            tracer.dropped);
+    fprintf(fp, "\"traceEvents\":[");
+
+    /* Thread names first, so viewers label the tracks */
+    const char *separator = "\n";
+    for (unsigned thread = 1; thread < tracer.next_thread; thread++) {
+        fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":", separator, thread);
+        if (thread == tracer.main_thread) {
+            write_json_string(fp, "main");
+        } else {
+            char label[32];
+            snprintf(label, sizeof(label), "worker %u", thread - 1);
+            write_json_string(fp, label);
+        }
+        fprintf(fp, "}}");
+        separator = ",\n";
+    }
+
+    for (size_t i = 0; i < tracer.count; i++) {
+        const TraceEvent *event = &tracer.events[i];
+        fprintf(fp, "%s{\"name\":", separator);
+        write_json_string(fp, event->name);
+        fprintf(fp, ",\"cat\":");
+        write_json_string(fp, event->category);
+        fprintf(fp, ",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u",
+                (unsigned long long)(event->start_us - 1),
+                (unsigned long long)event->duration_us, event->thread);
+        if (event->detail) {
+            fprintf(fp, ",\"args\":{\"detail\":");
+            write_json_string(fp, event->detail);
+            fprintf(fp, "}");
+        }
+        fprintf(fp, "}");
+        separator = ",\n";
+    }
+
+    size_t written = tracer.count;
+    ec_mutex_unlock(&tracer.lock);
+
+    fprintf(fp, "\n]}\n");
+    bool ok = !ferror(fp);
+    ok = fclose(fp) == 0 && ok;
+
+    if (event_count) *event_count = written;
+    return ok;
+}
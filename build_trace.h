@@ -0,0 +1,114 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Build Tracing
+ * ==============================================================================
+ *
+ * Wall-clock spans for every stage of a build - scan, parse, sort, cache
+ * check, hash, spawn, compile, link, cache save - recorded per thread and
+ * written in the Chrome trace-event format, which chrome://tracing and
+ * ui.perfetto.dev load directly.
+ *
+ * Tracing is off until build_trace_start. While it is off, a span costs a
+ * single branch, so the instrumentation stays in release builds:
+ *
+ *     uint64_t start = build_trace_begin();
+ *     ... work ...
+ *     build_trace_end(start, "compile", "compile", source->path);
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef BUILD_TRACE_H
+#define BUILD_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define BUILD_TRACE_MAX_EVENTS (1u << 20)       /* Events kept; later ones are counted, not stored */
+
+/* ==============================================================================
+ * Clock
+ * ==============================================================================
+ */
+
+/**
+ * Monotonic wall-clock time
+ *
+ * Unlike clock(), which counts this process's CPU time, this also runs
+ * while the build waits for a compiler.
+ *
+ * @return  Seconds since an arbitrary fixed point
+ */
+double build_clock_seconds(void);
+
+/* ==============================================================================
+ * Tracing
+ * ==============================================================================
+ */
+
+/**
+ * Start recording spans, discarding any recorded before
+ *
+ * The calling thread is named "main" in the trace. Call before starting
+ * the threads you want traced.
+ *
+ * @return  true on success
+ */
+bool build_trace_start(void);
+
+/**
+ * Whether spans are being recorded
+ */
+bool build_trace_enabled(void);
+
+/**
+ * Open a span
+ *
+ * @return  Start time to pass to build_trace_end, or 0 when tracing is off
+ */
+uint64_t build_trace_begin(void);
+
+/**
+ * Close a span opened by build_trace_begin
+ *
+ * Does nothing when start is 0. Thread-safe.
+ *
+ * @param start     Value build_trace_begin returned
+ * @param category  Span category (a string literal)
+ * @param name      Span name (a string literal)
+ * @param detail    What the span worked on, such as a file path (copied; can be NULL)
+ */
+void build_trace_end(uint64_t start, const char *category, const char *name,
+                     const char *detail);
+
+/**
+ * Write the spans recorded so far as a Chrome trace-event JSON file
+ *
+ * @param path         Output file
+ * @param event_count  Set to the number of spans written (can be NULL)
+ * @return             true on success
+ */
+bool build_trace_write(const char *path, size_t *event_count);
+
+/**
+ * Stop recording and free the recorded spans
+ */
+void build_trace_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUILD_TRACE_H */
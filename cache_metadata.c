@@ -5,6 +5,8 @@
  */
 
 #include "cache_metadata.h"
+#include "content_hash.h"
+#include "build_trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,6 +20,8 @@
     #define F_OK 0
 #else
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
 #endif
 
 /* ==============================================================================
@@ -27,8 +31,9 @@
 
 #define CACHE_FILENAME "cache.dat"
 #define CACHE_TEMP_FILENAME "cache.dat.tmp"
-#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
-#define FNV_PRIME 0x100000001b3ULL
+#define CACHE_OLD_FILENAME "cache.dat.old"
+#define CACHE_ENTRY_VALID 0x1u
+#define CACHE_ENTRY_DEPFILE 0x2u                /* Dependency list is exact */
 
 /* ==============================================================================
  * Utility Functions Implementation
@@ -37,349 +42,2346 @@
 
 uint64_t hash_file_content(const char *path) {
     if (!path) return 0;
+
+    uint64_t trace_start = build_trace_begin();
+    uint64_t hash = content_hash_file(path);
+    build_trace_end(trace_start, "cache", "hash", path);
+    return hash;
+}
+
+time_t get_file_mtime(const char *path) {
+    if (!path) return 0;
     
-    FILE *fp = fopen(path, "rb");
-    if (!fp) return 0;
-    
-    uint64_t hash = FNV_OFFSET_BASIS;
-    unsigned char buffer[8192];
-    size_t bytes;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return 0;
+    }
     
-    while ((bytes = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
-        for (size_t i = 0; i < bytes; i++) {
-            hash ^= buffer[i];
-            hash *= FNV_PRIME;
+    return st.st_mtime;
+}
+
+bool file_stamp_get(const char *path, FileStamp *stamp) {
+    if (!path || !stamp) return false;
+
+    memset(stamp, 0, sizeof(*stamp));
+
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+        return false;
+    }
+
+    /* FILETIME counts 100ns intervals */
+    uint64_t ticks = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) |
+                     data.ftLastWriteTime.dwLowDateTime;
+    stamp->mtime_sec = (int64_t)(ticks / 10000000ULL);
+    stamp->mtime_nsec = (int64_t)(ticks % 10000000ULL) * 100;
+    stamp->size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+
+    stamp->mtime_sec = (int64_t)st.st_mtime;
+#if defined(__APPLE__)
+    stamp->mtime_nsec = (int64_t)st.st_mtimespec.tv_nsec;
+#else
+    stamp->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+#endif
+    stamp->size = (uint64_t)st.st_size;
+    stamp->inode = (uint64_t)st.st_ino;
+#endif
+
+    return true;
+}
+
+bool file_exists_cache(const char *path) {
+    if (!path) return false;
+    return access(path, F_OK) == 0;
+}
+
+/* ==============================================================================
+ * On-Disk Format
+ * ==============================================================================
+ */
+
+/**
+ * CacheFileHeader - Fixed header at the start of cache.dat
+ *
+ * The version stays the first field so every format revision can be
+ * recognized (and rejected) by older readers. Section offsets are absolute
+ * file offsets; every section is aligned for direct use from the mapping.
+ */
+typedef struct CacheFileHeader {
+    uint32_t version;
+    uint32_t magic;
+    uint32_t string_count;
+    uint32_t entry_count;
+    uint32_t bucket_count;                  /* Power of two, or 0 when empty */
+    uint32_t reserved;
+    uint64_t file_size;                     /* Must match the mapped size */
+    uint64_t dependency_count;              /* Total dependencies, all entries */
+    uint64_t blob_size;                     /* String blob size including NULs */
+    uint64_t graph_include_count;           /* Include ids, all graph records */
+    uint64_t graph_fingerprint;             /* Include paths the graph was resolved with */
+    uint64_t reverse_count;                 /* Reverse-dependency ids, all strings */
+    uint64_t file_set_fingerprint;          /* Graph files entries were last pruned against */
+
+    uint64_t entries_offset;                /* CacheEntryRecord[entry_count] */
+    uint64_t string_offsets_offset;         /* uint32_t[string_count], into blob */
+    uint64_t entry_by_string_offset;        /* uint32_t[string_count], record or NONE */
+    uint64_t buckets_offset;                /* uint32_t[bucket_count], string id or NONE */
+    uint64_t dep_ids_offset;                /* uint32_t[dependency_count] */
+    uint64_t dep_hashes_offset;             /* uint64_t[dependency_count] */
+    uint64_t stamps_offset;                 /* CacheStampRecord[string_count] */
+    uint64_t graph_offset;                  /* CacheGraphRecord[string_count] */
+    uint64_t reverse_starts_offset;         /* uint64_t[string_count + 1], into reverse ids */
+    uint64_t graph_includes_offset;         /* uint32_t[graph_include_count] */
+    uint64_t reverse_ids_offset;            /* uint32_t[reverse_count], dependent string ids */
+    uint64_t blob_offset;                   /* char[blob_size] */
+} CacheFileHeader;
+
+/**
+ * CacheEntryRecord - Fixed-size per-entry record
+ *
+ * Dependencies live in the shared id/hash sections starting at
+ * dependency_start, so any record can be read without touching the others.
+ */
+typedef struct CacheEntryRecord {
+    uint32_t source_id;
+    uint32_t object_id;
+    uint64_t source_hash;
+    int64_t source_mtime;
+    int64_t last_compiled;
+    uint64_t dependency_start;
+    uint32_t dependency_count;
+    uint32_t flags;
+    double compile_seconds;
+    uint64_t peak_memory;
+} CacheEntryRecord;
+
+/**
+ * CacheView - A mapped cache.dat plus pointers to its sections
+ */
+typedef struct CacheView {
+    const uint8_t *base;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    const CacheFileHeader *header;
+    const CacheEntryRecord *records;
+    const uint32_t *string_offsets;
+    const uint32_t *entry_by_string;
+    const uint32_t *buckets;
+    const uint32_t *dep_ids;
+    const uint64_t *dep_hashes;
+    const CacheStampRecord *stamps;
+    const CacheGraphRecord *graph;
+    const uint32_t *graph_includes;
+    const uint64_t *reverse_starts;
+    const uint32_t *reverse_ids;
+    const char *blob;
+
+    CacheEntry **materialized;              /* Overlay copy per record, lazily allocated */
+} CacheView;
+
+/* ==============================================================================
+ * Memory Mapping
+ * ==============================================================================
+ */
+
+/**
+ * Check that a section of count elements fits in the file and is aligned
+ */
+static bool view_section_ok(const CacheView *view, uint64_t offset, uint64_t count,
+                            size_t element_size, size_t alignment) {
+    if (offset % alignment != 0 || offset > view->size) return false;
+    return count <= (view->size - offset) / element_size;
+}
+
+static void view_unmap(CacheView *view) {
+#ifdef _WIN32
+    if (view->base) UnmapViewOfFile(view->base);
+    if (view->mapping) CloseHandle(view->mapping);
+    if (view->file != INVALID_HANDLE_VALUE) CloseHandle(view->file);
+#else
+    if (view->base) munmap((void *)view->base, view->size);
+#endif
+    view->base = NULL;
+}
+
+/**
+ * Map cache.dat read-only
+ *
+ * On Windows the file is opened with FILE_SHARE_DELETE so that a later
+ * save can move it aside while the view is still alive.
+ */
+static bool view_map(CacheView *view, const char *path) {
+#ifdef _WIN32
+    view->mapping = NULL;
+    view->file = CreateFileA(path, GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (view->file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(view->file, &size) || size.QuadPart <= 0) {
+        view_unmap(view);
+        return false;
+    }
+    view->size = (size_t)size.QuadPart;
+
+    view->mapping = CreateFileMappingA(view->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!view->mapping) {
+        view_unmap(view);
+        return false;
+    }
+
+    view->base = (const uint8_t *)MapViewOfFile(view->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view->base) {
+        view_unmap(view);
+        return false;
+    }
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    view->size = (size_t)st.st_size;
+
+    void *base = mmap(NULL, view->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  /* The mapping keeps the file alive */
+    if (base == MAP_FAILED) return false;
+
+    view->base = (const uint8_t *)base;
+    return true;
+#endif
+}
+
+/**
+ * Validate the header and resolve section pointers
+ *
+ * Only the header and the last blob byte are touched here; ids and
+ * dependency ranges are checked as records are read.
+ */
+static bool view_resolve_sections(CacheView *view) {
+    if (view->size < sizeof(CacheFileHeader)) return false;
+
+    const CacheFileHeader *h = (const CacheFileHeader *)view->base;
+    if (h->magic != CACHE_MAGIC || h->file_size != view->size) return false;
+
+    if (!view_section_ok(view, h->entries_offset, h->entry_count,
+                         sizeof(CacheEntryRecord), sizeof(uint64_t)) ||
+        !view_section_ok(view, h->string_offsets_offset, h->string_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->entry_by_string_offset, h->string_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->buckets_offset, h->bucket_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->dep_ids_offset, h->dependency_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->dep_hashes_offset, h->dependency_count,
+                         sizeof(uint64_t), sizeof(uint64_t)) ||
+        !view_section_ok(view, h->stamps_offset, h->string_count,
+                         sizeof(CacheStampRecord), sizeof(uint64_t)) ||
+        !view_section_ok(view, h->graph_offset, h->string_count,
+                         sizeof(CacheGraphRecord), sizeof(uint64_t)) ||
+        !view_section_ok(view, h->reverse_starts_offset, (uint64_t)h->string_count + 1,
+                         sizeof(uint64_t), sizeof(uint64_t)) ||
+        !view_section_ok(view, h->graph_includes_offset, h->graph_include_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->reverse_ids_offset, h->reverse_count,
+                         sizeof(uint32_t), sizeof(uint32_t)) ||
+        !view_section_ok(view, h->blob_offset, h->blob_size, 1, 1)) {
+        return false;
+    }
+
+    /* Bucket count must be a power of two with room for every string */
+    if (h->bucket_count & (h->bucket_count - 1)) return false;
+    if (h->string_count > 0 && h->bucket_count <= h->string_count) return false;
+
+    /* Every string is NUL-terminated if the blob ends in one */
+    if (h->string_count > 0 &&
+        (h->blob_size == 0 || view->base[h->blob_offset + h->blob_size - 1] != '\0')) {
+        return false;
+    }
+
+    view->header = h;
+    view->records = (const CacheEntryRecord *)(view->base + h->entries_offset);
+    view->string_offsets = (const uint32_t *)(view->base + h->string_offsets_offset);
+    view->entry_by_string = (const uint32_t *)(view->base + h->entry_by_string_offset);
+    view->buckets = (const uint32_t *)(view->base + h->buckets_offset);
+    view->dep_ids = (const uint32_t *)(view->base + h->dep_ids_offset);
+    view->dep_hashes = (const uint64_t *)(view->base + h->dep_hashes_offset);
+    view->stamps = (const CacheStampRecord *)(view->base + h->stamps_offset);
+    view->graph = (const CacheGraphRecord *)(view->base + h->graph_offset);
+    view->graph_includes = (const uint32_t *)(view->base + h->graph_includes_offset);
+    view->reverse_starts = (const uint64_t *)(view->base + h->reverse_starts_offset);
+    view->reverse_ids = (const uint32_t *)(view->base + h->reverse_ids_offset);
+    view->blob = (const char *)(view->base + h->blob_offset);
+    return true;
+}
+
+static const char *view_string(const CacheView *view, uint32_t id) {
+    if (id >= view->header->string_count) return NULL;
+    uint32_t offset = view->string_offsets[id];
+    if (offset >= view->header->blob_size) return NULL;
+    return view->blob + offset;
+}
+
+/**
+ * Find a string id through the on-disk hash table
+ */
+static uint32_t view_lookup_string(const CacheView *view, const char *path) {
+    uint32_t bucket_count = view->header->bucket_count;
+    if (bucket_count == 0) return CACHE_STRING_NONE;
+
+    uint32_t mask = bucket_count - 1;
+    uint32_t slot = (uint32_t)path_index_hash(path) & mask;
+
+    for (uint32_t probe = 0; probe < bucket_count; probe++) {
+        uint32_t id = view->buckets[slot];
+        if (id == CACHE_STRING_NONE) break;
+
+        const char *candidate = view_string(view, id);
+        if (candidate && strcmp(candidate, path) == 0) return id;
+
+        slot = (slot + 1) & mask;
+    }
+    return CACHE_STRING_NONE;
+}
+
+/**
+ * Check that a record's ids and dependency range are in bounds
+ */
+static bool view_record_ok(const CacheView *view, const CacheEntryRecord *rec) {
+    uint32_t string_count = view->header->string_count;
+    if (rec->source_id >= string_count || rec->object_id >= string_count) return false;
+    if (rec->dependency_start > view->header->dependency_count ||
+        rec->dependency_count > view->header->dependency_count - rec->dependency_start) {
+        return false;
+    }
+    return true;
+}
+
+/* ==============================================================================
+ * Internal Helpers
+ * ==============================================================================
+ */
+
+static size_t cache_mapped_strings(const BuildCache *cache) {
+    return cache->view ? cache->view->header->string_count : 0;
+}
+
+static void cache_entry_free(CacheEntry *entry) {
+    if (!entry) return;
+    free(entry->dependency_ids);
+    free(entry->dependency_hashes);
+    free(entry);
+}
+
+static void cache_close_view(BuildCache *cache) {
+    CacheView *view = cache->view;
+    if (!view) return;
+
+    view_unmap(view);
+    free(view->materialized);
+    free(view);
+    cache->view = NULL;
+
+#ifdef _WIN32
+    /* A save while mapped moved the previous file aside */
+    char old_file[MAX_PATH_LENGTH];
+    snprintf(old_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_OLD_FILENAME);
+    remove(old_file);
+#endif
+}
+
+static void cache_free_contents(BuildCache *cache) {
+    for (size_t i = 0; i < cache->overlay_count; i++) {
+        cache_entry_free(cache->entries[i]);
+    }
+    free(cache->entries);
+    cache->entries = NULL;
+    path_index_clear(&cache->entry_index);
+    cache->overlay_count = 0;
+    cache->overlay_capacity = 0;
+    cache->entry_count = 0;
+
+    size_t added = cache->string_count - cache_mapped_strings(cache);
+    for (size_t i = 0; i < added; i++) {
+        free(cache->strings[i]);
+    }
+    free(cache->strings);
+    cache->strings = NULL;
+    path_index_clear(&cache->string_index);
+    cache->string_count = 0;
+    cache->string_capacity = 0;
+
+    free(cache->stamps);
+    cache->stamps = NULL;
+    cache->stamp_capacity = 0;
+
+    free(cache->graph_records);
+    free(cache->graph_includes);
+    free(cache->scan_stamps);
+    cache->graph_records = NULL;
+    cache->graph_includes = NULL;
+    cache->scan_stamps = NULL;
+    cache->graph_record_count = 0;
+    cache->graph_include_count = 0;
+    cache->scan_stamp_capacity = 0;
+    cache->graph_recorded = false;
+    cache->graph_usable = false;
+    cache->graph_fingerprint = 0;
+    cache->file_set_fingerprint = 0;
+
+    free(cache->reverse_starts);
+    free(cache->reverse_ids);
+    cache->reverse_starts = NULL;
+    cache->reverse_ids = NULL;
+    cache->reverse_node_count = 0;
+    cache->edges_changed = false;
+
+    free(cache->memo_hashes);
+    free(cache->memo_known);
+    cache->memo_hashes = NULL;
+    cache->memo_known = NULL;
+    cache->memo_capacity = 0;
+
+    cache_close_view(cache);
+}
+
+/**
+ * Map cache.dat and check that it is one this version can read
+ *
+ * @return  The view, or NULL if the file is unreadable
+ */
+static CacheView *view_open(const char *cache_file) {
+    CacheView *view = (CacheView *)calloc(1, sizeof(CacheView));
+    if (!view) return NULL;
+
+    if (!view_map(view, cache_file)) {
+        free(view);
+        return NULL;
+    }
+
+    /* Check version compatibility */
+    uint32_t version = view->size >= sizeof(uint32_t) ? *(const uint32_t *)view->base : 0;
+    if (version != CACHE_VERSION) {
+        printf("Warning: Cache version mismatch (expected %d, got %u) - rebuilding cache\n",
+               CACHE_VERSION, version);
+        view_unmap(view);
+        free(view);
+        return NULL;
+    }
+
+    if (!view_resolve_sections(view)) {
+        printf("Warning: Invalid cache header - rebuilding cache\n");
+        view_unmap(view);
+        free(view);
+        return NULL;
+    }
+    return view;
+}
+
+/**
+ * Adopt a view's records and strings (the cache must hold nothing else)
+ */
+static void cache_adopt_view(BuildCache *cache, CacheView *view) {
+    cache->view = view;
+    cache->string_count = view->header->string_count;
+    cache->entry_count = view->header->entry_count;
+    cache->graph_fingerprint = view->header->graph_fingerprint;
+    cache->file_set_fingerprint = view->header->file_set_fingerprint;
+}
+
+/**
+ * Map cache.dat and adopt its records and strings
+ */
+static bool cache_open_view(BuildCache *cache, const char *cache_file) {
+    CacheView *view = view_open(cache_file);
+    if (!view) return false;
+
+    cache_adopt_view(cache, view);
+    return true;
+}
+
+/**
+ * Look up a path in the mapped and added strings (called with lock held)
+ */
+static uint32_t cache_lookup_string(const BuildCache *cache, const char *str) {
+    if (cache->view) {
+        uint32_t id = view_lookup_string(cache->view, str);
+        if (id != CACHE_STRING_NONE) return id;
+    }
+
+    size_t id = path_index_find(&cache->string_index, str);
+    return id == PATH_INDEX_NONE ? CACHE_STRING_NONE : (uint32_t)id;
+}
+
+/**
+ * Intern a path, returning the id of an existing copy when there is one
+ * (called with lock held)
+ */
+static uint32_t cache_intern(BuildCache *cache, const char *str) {
+    uint32_t id = cache_lookup_string(cache, str);
+    if (id != CACHE_STRING_NONE) return id;
+
+    if (cache->string_count >= CACHE_STRING_NONE) return CACHE_STRING_NONE;
+
+    size_t added = cache->string_count - cache_mapped_strings(cache);
+    if (added >= cache->string_capacity) {
+        size_t new_capacity = cache->string_capacity == 0 ? 64 : cache->string_capacity * 2;
+        char **new_strings = realloc(cache->strings, new_capacity * sizeof(char *));
+        if (!new_strings) return CACHE_STRING_NONE;
+        cache->strings = new_strings;
+        cache->string_capacity = new_capacity;
+    }
+
+    char *copy = strdup(str);
+    if (!copy) return CACHE_STRING_NONE;
+
+    if (!path_index_insert(&cache->string_index, copy, cache->string_count)) {
+        free(copy);
+        return CACHE_STRING_NONE;
+    }
+    cache->strings[added] = copy;
+    return (uint32_t)cache->string_count++;
+}
+
+/**
+ * Add a blank overlay entry for an interned source path
+ * (called with lock held)
+ */
+static CacheEntry *cache_add_overlay(BuildCache *cache, uint32_t source_id) {
+    const char *source_path = build_cache_string(cache, source_id);
+    if (!source_path) return NULL;
+
+    if (cache->overlay_count >= cache->overlay_capacity) {
+        size_t new_capacity = cache->overlay_capacity == 0 ? 64 : cache->overlay_capacity * 2;
+        CacheEntry **new_entries = realloc(cache->entries, new_capacity * sizeof(CacheEntry *));
+        if (!new_entries) return NULL;
+        cache->entries = new_entries;
+        cache->overlay_capacity = new_capacity;
+    }
+
+    CacheEntry *entry = calloc(1, sizeof(CacheEntry));
+    if (!entry) return NULL;
+
+    if (!path_index_insert(&cache->entry_index, source_path, cache->overlay_count)) {
+        free(entry);
+        return NULL;
+    }
+
+    entry->source_id = source_id;
+    entry->object_id = CACHE_STRING_NONE;
+    entry->record_index = CACHE_INDEX_NONE;
+    cache->entries[cache->overlay_count++] = entry;
+    return entry;
+}
+
+/**
+ * Copy a mapped record into the overlay so it can be modified
+ * (called with lock held)
+ */
+static CacheEntry *cache_materialize(BuildCache *cache, uint32_t record) {
+    CacheView *view = cache->view;
+    const CacheEntryRecord *rec = &view->records[record];
+    if (!view_record_ok(view, rec)) return NULL;
+
+    if (!view->materialized) {
+        view->materialized = calloc(view->header->entry_count, sizeof(CacheEntry *));
+        if (!view->materialized) return NULL;
+    }
+
+    uint32_t *dep_ids = NULL;
+    uint64_t *dep_hashes = NULL;
+    if (rec->dependency_count > 0) {
+        dep_ids = malloc(rec->dependency_count * sizeof(uint32_t));
+        dep_hashes = malloc(rec->dependency_count * sizeof(uint64_t));
+        if (!dep_ids || !dep_hashes) {
+            free(dep_ids);
+            free(dep_hashes);
+            return NULL;
         }
+        memcpy(dep_ids, view->dep_ids + rec->dependency_start,
+               rec->dependency_count * sizeof(uint32_t));
+        memcpy(dep_hashes, view->dep_hashes + rec->dependency_start,
+               rec->dependency_count * sizeof(uint64_t));
     }
-    
-    fclose(fp);
-    return hash;
+
+    CacheEntry *entry = cache_add_overlay(cache, rec->source_id);
+    if (!entry) {
+        free(dep_ids);
+        free(dep_hashes);
+        return NULL;
+    }
+
+    entry->object_id = rec->object_id;
+    entry->source_hash = rec->source_hash;
+    entry->source_mtime = (time_t)rec->source_mtime;
+    entry->last_compiled = (time_t)rec->last_compiled;
+    entry->compile_seconds = rec->compile_seconds;
+    entry->peak_memory = rec->peak_memory;
+    entry->dependency_ids = dep_ids;
+    entry->dependency_hashes = dep_hashes;
+    entry->dependency_count = rec->dependency_count;
+    entry->valid = (rec->flags & CACHE_ENTRY_VALID) != 0;
+    entry->exact_dependencies = (rec->flags & CACHE_ENTRY_DEPFILE) != 0;
+    entry->record_index = record;
+
+    view->materialized[record] = entry;
+    return entry;
+}
+
+/**
+ * Locate the entry for a source path (called with lock held)
+ *
+ * Returns the overlay entry when there is one. Otherwise *record is set
+ * to the mapped record for the path, or CACHE_INDEX_NONE.
+ */
+static CacheEntry *cache_locate(const BuildCache *cache, const char *source_path,
+                                uint32_t *record) {
+    *record = CACHE_INDEX_NONE;
+
+    /* Copied or created since load */
+    size_t pos = path_index_find(&cache->entry_index, source_path);
+    if (pos != PATH_INDEX_NONE) return cache->entries[pos];
+
+    /* Mapped record, via the on-disk hash table */
+    const CacheView *view = cache->view;
+    if (!view) return NULL;
+
+    uint32_t id = view_lookup_string(view, source_path);
+    if (id == CACHE_STRING_NONE) return NULL;
+
+    uint32_t rec = view->entry_by_string[id];
+    if (rec < view->header->entry_count && view->records[rec].source_id == id) {
+        *record = rec;
+    }
+    return NULL;
+}
+
+/**
+ * Find an entry, copying it into the overlay if it is only mapped
+ * (called with lock held)
+ */
+static CacheEntry *cache_find_writable(BuildCache *cache, const char *source_path) {
+    uint32_t record;
+    CacheEntry *entry = cache_locate(cache, source_path, &record);
+    if (!entry && record != CACHE_INDEX_NONE) {
+        entry = cache_materialize(cache, record);
+    }
+    return entry;
+}
+
+/**
+ * Get the last known stamp for a string id (called with lock held)
+ */
+static bool cache_get_stamp(const BuildCache *cache, uint32_t id, CacheStampRecord *out) {
+    if (id < cache->stamp_capacity && (cache->stamps[id].flags & CACHE_STAMP_VALID)) {
+        *out = cache->stamps[id];
+        return true;
+    }
+    if (cache->view && id < cache->view->header->string_count &&
+        (cache->view->stamps[id].flags & CACHE_STAMP_VALID)) {
+        *out = cache->view->stamps[id];
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Grow a stamp array so that id is in range, zeroing the new slots
+ */
+static bool stamps_reserve(CacheStampRecord **stamps, size_t *capacity, uint32_t id) {
+    if (id < *capacity) return true;
+
+    size_t new_capacity = *capacity == 0 ? 64 : *capacity;
+    while (new_capacity <= id) new_capacity *= 2;
+
+    CacheStampRecord *new_stamps = realloc(*stamps, new_capacity * sizeof(CacheStampRecord));
+    if (!new_stamps) return false;
+
+    memset(new_stamps + *capacity, 0, (new_capacity - *capacity) * sizeof(CacheStampRecord));
+    *stamps = new_stamps;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * Record a fresh stamp and hash for a string id (called with lock held)
+ */
+static void cache_set_stamp(BuildCache *cache, uint32_t id, const FileStamp *stamp,
+                            uint64_t hash) {
+    /* Losing a stamp only costs a re-hash */
+    if (!stamps_reserve(&cache->stamps, &cache->stamp_capacity, id)) return;
+
+    CacheStampRecord *record = &cache->stamps[id];
+    record->stamp = *stamp;
+    record->hash = hash;
+    record->flags = CACHE_STAMP_VALID;
+    cache->dirty = true;
+}
+
+/**
+ * Get the graph record of a string id, from the snapshot recorded this
+ * run if there is one, else from the mapped file (called with lock held)
+ */
+static bool cache_get_graph_record(const BuildCache *cache, uint32_t id,
+                                   CacheGraphRecord *out, const uint32_t **includes) {
+    const CacheGraphRecord *rec = NULL;
+    const uint32_t *all_includes = NULL;
+    uint64_t include_total = 0;
+
+    if (cache->graph_recorded) {
+        if (id < cache->graph_record_count) rec = &cache->graph_records[id];
+        all_includes = cache->graph_includes;
+        include_total = cache->graph_include_count;
+    } else if (cache->view && id < cache->view->header->string_count) {
+        rec = &cache->view->graph[id];
+        all_includes = cache->view->graph_includes;
+        include_total = cache->view->header->graph_include_count;
+    }
+
+    if (!rec || !(rec->flags & CACHE_GRAPH_SCANNED)) return false;
+    if (rec->include_start > include_total ||
+        rec->include_count > include_total - rec->include_start) {
+        return false;
+    }
+
+    *out = *rec;
+    if (includes) *includes = all_includes ? all_includes + rec->include_start : NULL;
+    return true;
+}
+
+/* ==============================================================================
+ * Reverse-Dependency Index
+ * ==============================================================================
+ */
+
+/**
+ * Note that entry dependencies or graph includes changed (called with lock
+ * held); the mapped index and any built one no longer match
+ */
+static void cache_edges_changed(BuildCache *cache) {
+    free(cache->reverse_starts);
+    free(cache->reverse_ids);
+    cache->reverse_starts = NULL;
+    cache->reverse_ids = NULL;
+    cache->reverse_node_count = 0;
+    cache->edges_changed = true;
+}
+
+/**
+ * ReverseBuild - Counting pass, then filling pass, over every edge
+ */
+typedef struct ReverseBuild {
+    uint64_t *starts;                       /* Counts, then offsets */
+    uint64_t *cursor;                       /* Next free slot per node (filling pass) */
+    uint32_t *ids;                          /* Dependent ids (filling pass) */
+    size_t node_count;                      /* Valid ids */
+} ReverseBuild;
+
+static void reverse_add_edge(ReverseBuild *build, uint32_t dependent, uint32_t dependency) {
+    if (dependent >= build->node_count || dependency >= build->node_count ||
+        dependent == dependency) {
+        return;
+    }
+    if (build->ids) {
+        build->ids[build->cursor[dependency]++] = dependent;
+    } else {
+        build->starts[dependency + 1]++;
+    }
+}
+
+/**
+ * Feed every edge to a build: entry source -> each dependency, and
+ * graph file -> each include (called with lock held)
+ */
+static void cache_collect_edges(const BuildCache *cache, ReverseBuild *build) {
+    const CacheView *view = cache->view;
+    size_t mapped_records = view ? view->header->entry_count : 0;
+
+    for (size_t r = 0; r < mapped_records; r++) {
+        if (view->materialized && view->materialized[r]) continue;
+
+        const CacheEntryRecord *rec = &view->records[r];
+        if (!view_record_ok(view, rec)) continue;
+
+        const uint32_t *ids = view->dep_ids + rec->dependency_start;
+        for (size_t j = 0; j < rec->dependency_count; j++) {
+            reverse_add_edge(build, rec->source_id, ids[j]);
+        }
+    }
+
+    for (size_t i = 0; i < cache->overlay_count; i++) {
+        const CacheEntry *entry = cache->entries[i];
+        if (entry->removed) continue;
+        for (size_t j = 0; j < entry->dependency_count; j++) {
+            reverse_add_edge(build, entry->source_id, entry->dependency_ids[j]);
+        }
+    }
+
+    for (size_t id = 0; id < cache->string_count; id++) {
+        CacheGraphRecord rec;
+        const uint32_t *includes;
+        if (!cache_get_graph_record(cache, (uint32_t)id, &rec, &includes) || !includes) continue;
+
+        for (size_t j = 0; j < rec.include_count; j++) {
+            reverse_add_edge(build, (uint32_t)id, includes[j]);
+        }
+    }
+}
+
+static int compare_ids(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Build the reverse index from the current entries and graph (called with
+ * lock held); each list is sorted with duplicates removed
+ */
+static bool cache_build_reverse(const BuildCache *cache, uint64_t **starts_out,
+                                uint32_t **ids_out) {
+    ReverseBuild build;
+    build.node_count = cache->string_count;
+    build.starts = calloc(build.node_count + 1, sizeof(uint64_t));
+    build.cursor = NULL;
+    build.ids = NULL;
+    if (!build.starts) return false;
+
+    cache_collect_edges(cache, &build);
+    for (size_t i = 0; i < build.node_count; i++) {
+        build.starts[i + 1] += build.starts[i];
+    }
+
+    uint64_t edge_count = build.starts[build.node_count];
+    build.cursor = malloc((build.node_count + 1) * sizeof(uint64_t));
+    build.ids = malloc((size_t)(edge_count + 1) * sizeof(uint32_t));
+    if (!build.cursor || !build.ids) {
+        free(build.starts);
+        free(build.cursor);
+        free(build.ids);
+        return false;
+    }
+    memcpy(build.cursor, build.starts, (build.node_count + 1) * sizeof(uint64_t));
+    cache_collect_edges(cache, &build);
+    free(build.cursor);
+
+    /* An entry and a graph record often name the same edge */
+    uint64_t kept = 0;
+    for (size_t i = 0; i < build.node_count; i++) {
+        uint64_t begin = build.starts[i];
+        uint64_t end = build.starts[i + 1];
+        qsort(build.ids + begin, (size_t)(end - begin), sizeof(uint32_t), compare_ids);
+
+        build.starts[i] = kept;
+        for (uint64_t e = begin; e < end; e++) {
+            if (e == begin || build.ids[e] != build.ids[e - 1]) {
+                build.ids[kept++] = build.ids[e];
+            }
+        }
+    }
+    build.starts[build.node_count] = kept;
+
+    *starts_out = build.starts;
+    *ids_out = build.ids;
+    return true;
+}
+
+/**
+ * The reverse index that matches the cache now, without building one
+ * (called with lock held)
+ */
+static bool cache_current_reverse(const BuildCache *cache, const uint64_t **starts,
+                                  const uint32_t **ids, size_t *node_count,
+                                  uint64_t *id_count) {
+    if (cache->reverse_starts) {
+        *starts = cache->reverse_starts;
+        *ids = cache->reverse_ids;
+        *node_count = cache->reverse_node_count;
+    } else if (cache->view && !cache->edges_changed) {
+        *starts = cache->view->reverse_starts;
+        *ids = cache->view->reverse_ids;
+        *node_count = cache->view->header->string_count;
+    } else {
+        return false;
+    }
+    *id_count = (*starts)[*node_count];
+    return true;
+}
+
+/**
+ * The reverse index, building it if the mapped one is out of date
+ * (called with lock held)
+ */
+static bool cache_reverse_index(BuildCache *cache, const uint64_t **starts,
+                                const uint32_t **ids, size_t *node_count) {
+    uint64_t id_count;
+    if (cache_current_reverse(cache, starts, ids, node_count, &id_count)) return true;
+
+    if (!cache_build_reverse(cache, &cache->reverse_starts, &cache->reverse_ids)) {
+        return false;
+    }
+    cache->reverse_node_count = cache->string_count;
+    return cache_current_reverse(cache, starts, ids, node_count, &id_count);
+}
+
+/**
+ * Every string id that depends on id, transitively, nearest first
+ * (called with lock held)
+ *
+ * Breadth-first over the reverse index, so only affected ids are visited.
+ * Returns a malloc'ed list, or NULL when out of memory.
+ */
+static uint32_t *cache_collect_dependents(BuildCache *cache, uint32_t id, size_t *count) {
+    *count = 0;
+
+    const uint64_t *starts;
+    const uint32_t *ids;
+    size_t node_count;
+    if (!cache_reverse_index(cache, &starts, &ids, &node_count)) return NULL;
+
+    uint64_t id_count = starts[node_count];
+    bool *seen = calloc(cache->string_count + 1, sizeof(bool));
+    uint32_t *queue = malloc((cache->string_count + 1) * sizeof(uint32_t));
+    if (!seen || !queue) {
+        free(seen);
+        free(queue);
+        return NULL;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    if (id < cache->string_count) {
+        seen[id] = true;
+        queue[tail++] = id;
+    }
+
+    while (head < tail) {
+        uint32_t node = queue[head++];
+        if (node >= node_count) continue;
+
+        /* Mapped offsets are checked as they are read */
+        uint64_t begin = starts[node];
+        uint64_t end = starts[node + 1];
+        if (begin > end || end > id_count) continue;
+
+        for (uint64_t e = begin; e < end; e++) {
+            uint32_t dependent = ids[e];
+            if (dependent >= cache->string_count || seen[dependent]) continue;
+            seen[dependent] = true;
+            queue[tail++] = dependent;
+        }
+    }
+
+    free(seen);
+
+    /* Drop the starting id itself */
+    *count = tail > 0 ? tail - 1 : 0;
+    memmove(queue, queue + (tail > 0 ? 1 : 0), *count * sizeof(uint32_t));
+    return queue;
+}
+
+/**
+ * Look up this build's memoized hash for a string id (called with lock held)
+ */
+static bool cache_memo_get(const BuildCache *cache, uint32_t id, uint64_t *hash) {
+    if (id >= cache->memo_capacity || !cache->memo_known[id]) return false;
+    *hash = cache->memo_hashes[id];
+    return true;
+}
+
+/**
+ * Remember a hash for the rest of the build (called with lock held)
+ */
+static void cache_memo_set(BuildCache *cache, uint32_t id, uint64_t hash) {
+    if (id >= cache->memo_capacity) {
+        size_t new_capacity = cache->memo_capacity == 0 ? 256 : cache->memo_capacity;
+        while (new_capacity <= id) new_capacity *= 2;
+
+        uint64_t *new_hashes = realloc(cache->memo_hashes, new_capacity * sizeof(uint64_t));
+        if (!new_hashes) return;
+        cache->memo_hashes = new_hashes;
+
+        bool *new_known = realloc(cache->memo_known, new_capacity * sizeof(bool));
+        if (!new_known) return;
+        memset(new_known + cache->memo_capacity, 0,
+               (new_capacity - cache->memo_capacity) * sizeof(bool));
+        cache->memo_known = new_known;
+        cache->memo_capacity = new_capacity;
+    }
+
+    cache->memo_hashes[id] = hash;
+    cache->memo_known[id] = true;
+}
+
+/**
+ * Current content hash of an interned path, or 0 if it cannot be read
+ *
+ * Each path is checked at most once per build: the result is memoized by
+ * id, so a header included by every translation unit is stat'ed (and at
+ * most hashed) once, whichever worker gets to it first. Two workers racing
+ * on the same path may both hash it; they store the same value.
+ *
+ * In CACHE_CHECK_STAT mode the file is stat'ed first; when its stamp
+ * matches the recorded one the recorded hash is returned without reading
+ * the file. Files modified within the last couple of seconds are not
+ * stamped, since a same-second rewrite would leave the stamp unchanged.
+ * Must be called without the lock held.
+ */
+static uint64_t cache_current_hash(BuildCache *cache, uint32_t id, const char *path) {
+    if (id == CACHE_STRING_NONE) {
+        return hash_file_content(path);
+    }
+
+    uint64_t hash;
+    CacheStampRecord known;
+    ec_mutex_lock(&cache->lock);
+    if (cache_memo_get(cache, id, &hash)) {
+        cache->memo_hits++;
+        ec_mutex_unlock(&cache->lock);
+        return hash;
+    }
+    bool have_known = cache_get_stamp(cache, id, &known);
+    ec_mutex_unlock(&cache->lock);
+
+    FileStamp stamp;
+    bool have_stamp = false;
+
+    if (cache->check_mode == CACHE_CHECK_CONTENT) {
+        hash = hash_file_content(path);
+    } else if (!file_stamp_get(path, &stamp)) {
+        hash = 0;
+    } else if (have_known && memcmp(&known.stamp, &stamp, sizeof(FileStamp)) == 0) {
+        hash = known.hash;
+    } else {
+        hash = hash_file_content(path);
+        have_stamp = hash != 0 && stamp.mtime_sec + 2 < (int64_t)time(NULL);
+    }
+
+    ec_mutex_lock(&cache->lock);
+    if (have_stamp) {
+        cache_set_stamp(cache, id, &stamp, hash);
+    }
+    cache_memo_set(cache, id, hash);
+    ec_mutex_unlock(&cache->lock);
+
+    return hash;
+}
+
+void build_cache_reset_hash_memo(BuildCache *cache) {
+    if (!cache) return;
+
+    ec_mutex_lock(&cache->lock);
+    if (cache->memo_known) {
+        memset(cache->memo_known, 0, cache->memo_capacity * sizeof(bool));
+    }
+    cache->memo_hits = 0;
+    ec_mutex_unlock(&cache->lock);
+}
+
+uint64_t build_cache_file_hash(BuildCache *cache, const char *path) {
+    if (!path) return 0;
+    if (!cache) return hash_file_content(path);
+
+    ec_mutex_lock(&cache->lock);
+    uint32_t id = cache_lookup_string(cache, path);
+    ec_mutex_unlock(&cache->lock);
+
+    return cache_current_hash(cache, id, path);
+}
+
+/* ==============================================================================
+ * Cache Management Implementation
+ * ==============================================================================
+ */
+
+BuildCache *build_cache_create(const char *project_dir) {
+    if (!project_dir) return NULL;
+
+    BuildCache *cache = (BuildCache *)calloc(1, sizeof(BuildCache));
+    if (!cache) return NULL;
+
+    /* Initialize cache */
+    cache->version = CACHE_VERSION;
+    cache->entry_count = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->invalidations = 0;
+    cache->check_mode = CACHE_CHECK_STAT;
+    path_index_init(&cache->entry_index);
+    path_index_init(&cache->string_index);
+
+    if (ec_mutex_init(&cache->lock) != 0) {
+        free(cache);
+        return NULL;
+    }
+
+    /* Store project directory */
+    strncpy(cache->project_dir, project_dir, MAX_PATH_LENGTH - 1);
+    cache->project_dir[MAX_PATH_LENGTH - 1] = '\0';
+
+    /* Create .eventchains directory */
+    snprintf(cache->cache_dir, MAX_PATH_LENGTH, "%s/.eventchains", project_dir);
+    mkdir(cache->cache_dir, 0755);
+
+    /* Map existing cache; records are read in place on lookup */
+    char cache_file[MAX_PATH_LENGTH];
+    snprintf(cache_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_FILENAME);
+
+    if (file_exists_cache(cache_file) && cache_open_view(cache, cache_file)) {
+        printf("Loaded cache: %zu entries from %s\n", cache->entry_count, cache_file);
+    }
+
+    return cache;
+}
+
+/**
+ * Source of one output entry while saving: an overlay entry or a mapped record
+ */
+typedef struct CacheSaveItem {
+    const CacheEntry *entry;
+    const CacheEntryRecord *record;
+} CacheSaveItem;
+
+static uint32_t item_source_id(const CacheSaveItem *item) {
+    return item->entry ? item->entry->source_id : item->record->source_id;
+}
+
+static uint32_t item_object_id(const CacheSaveItem *item) {
+    return item->entry ? item->entry->object_id : item->record->object_id;
+}
+
+static size_t item_dependency_count(const CacheSaveItem *item) {
+    return item->entry ? item->entry->dependency_count : item->record->dependency_count;
+}
+
+static const uint32_t *item_dependency_ids(const BuildCache *cache, const CacheSaveItem *item) {
+    return item->entry ? item->entry->dependency_ids
+                       : cache->view->dep_ids + item->record->dependency_start;
+}
+
+/**
+ * Number the strings the saved file keeps (called with lock held)
+ *
+ * A string stays if a saved entry or the graph snapshot names it; paths
+ * of files that were deleted or renamed, and that only pruned entries or
+ * an older scan still mentioned, are dropped with their stamps. Ids keep
+ * their order, so remapping leaves sorted lists sorted.
+ *
+ * @param new_ids  Set per old id: its id in the file, or CACHE_STRING_NONE
+ * @param old_ids  Set per kept id: the old id
+ * @return         Number of strings kept
+ */
+static size_t cache_number_strings(const BuildCache *cache, const CacheSaveItem *items,
+                                   size_t item_count, uint32_t *new_ids, uint32_t *old_ids) {
+    for (size_t i = 0; i < cache->string_count; i++) new_ids[i] = CACHE_STRING_NONE;
+
+    /* Mark: CACHE_STRING_NONE means dropped, anything else kept */
+    #define KEEP_STRING(id) \
+        if ((id) < cache->string_count) new_ids[(id)] = 0
+    for (size_t e = 0; e < item_count; e++) {
+        KEEP_STRING(item_source_id(&items[e]));
+        KEEP_STRING(item_object_id(&items[e]));
+        const uint32_t *ids = item_dependency_ids(cache, &items[e]);
+        for (size_t j = 0; j < item_dependency_count(&items[e]); j++) {
+            KEEP_STRING(ids[j]);
+        }
+    }
+    for (size_t id = 0; id < cache->string_count; id++) {
+        CacheGraphRecord rec;
+        const uint32_t *includes;
+        if (!cache_get_graph_record(cache, (uint32_t)id, &rec, &includes)) continue;
+        KEEP_STRING(id);
+        for (size_t j = 0; includes && j < rec.include_count; j++) {
+            KEEP_STRING(includes[j]);
+        }
+    }
+    #undef KEEP_STRING
+
+    size_t kept = 0;
+    for (size_t i = 0; i < cache->string_count; i++) {
+        if (new_ids[i] == CACHE_STRING_NONE) continue;
+        new_ids[i] = (uint32_t)kept;
+        old_ids[kept++] = (uint32_t)i;
+    }
+    return kept;
+}
+
+/**
+ * Write string ids, renumbered unless every string was kept (new_ids
+ * covers id_total old ids; others are written as CACHE_STRING_NONE)
+ */
+static bool write_ids(FILE *fp, const uint32_t *ids, size_t count, const uint32_t *new_ids,
+                      size_t id_total) {
+    if (!new_ids) return count == 0 || fwrite(ids, sizeof(uint32_t), count, fp) == count;
+
+    uint32_t chunk[256];
+    while (count > 0) {
+        size_t n = count < 256 ? count : 256;
+        for (size_t i = 0; i < n; i++) {
+            chunk[i] = ids[i] < id_total ? new_ids[ids[i]] : CACHE_STRING_NONE;
+        }
+        if (fwrite(chunk, sizeof(uint32_t), n, fp) != n) return false;
+        ids += n;
+        count -= n;
+    }
+    return true;
+}
+
+static bool cache_write_file(const BuildCache *cache, FILE *fp) {
+    const CacheView *view = cache->view;
+    size_t mapped_records = view ? view->header->entry_count : 0;
+
+    if (cache->string_count >= CACHE_STRING_NONE || cache->entry_count >= CACHE_INDEX_NONE) {
+        return false;
+    }
+
+    /* Output order: mapped records (or their overlay copies), then new
+     * entries; pruned entries are left out */
+    CacheSaveItem *items = malloc((mapped_records + cache->overlay_count + 1) * sizeof(CacheSaveItem));
+    uint32_t *new_ids = malloc((cache->string_count + 1) * sizeof(uint32_t));
+    uint32_t *old_ids = malloc((cache->string_count + 1) * sizeof(uint32_t));
+
+    bool ok = items && new_ids && old_ids;
+    size_t item_count = 0;
+    uint64_t dependency_count = 0;
+
+    for (size_t r = 0; ok && r < mapped_records; r++) {
+        CacheSaveItem item = {NULL, NULL};
+        if (view->materialized && view->materialized[r]) {
+            if (view->materialized[r]->removed) continue;
+            item.entry = view->materialized[r];
+        } else if (view_record_ok(view, &view->records[r])) {
+            item.record = &view->records[r];
+        } else {
+            continue;  /* Drop corrupt records */
+        }
+        items[item_count++] = item;
+    }
+    for (size_t i = 0; ok && i < cache->overlay_count; i++) {
+        if (cache->entries[i]->record_index == CACHE_INDEX_NONE && !cache->entries[i]->removed) {
+            items[item_count].entry = cache->entries[i];
+            items[item_count].record = NULL;
+            item_count++;
+        }
+    }
+
+    size_t string_count = ok ? cache_number_strings(cache, items, item_count, new_ids, old_ids) : 0;
+    const uint32_t *remap = string_count < cache->string_count ? new_ids : NULL;
+
+    uint32_t *string_offsets = malloc((string_count + 1) * sizeof(uint32_t));
+    uint32_t *entry_by_string = malloc((string_count + 1) * sizeof(uint32_t));
+    uint32_t bucket_count = 16;
+    while (bucket_count <= string_count * 2) bucket_count *= 2;
+    uint32_t *buckets = malloc(bucket_count * sizeof(uint32_t));
+    ok = ok && string_offsets && entry_by_string && buckets;
+
+    /* String offsets, hash table and entry-by-string index */
+    uint64_t blob_size = 0;
+    for (size_t i = 0; ok && i < string_count; i++) {
+        const char *str = build_cache_string(cache, old_ids[i]);
+        if (!str) str = "";
+        if (blob_size > UINT32_MAX) {
+            ok = false;
+            break;
+        }
+        string_offsets[i] = (uint32_t)blob_size;
+        entry_by_string[i] = CACHE_INDEX_NONE;
+        blob_size += strlen(str) + 1;
+    }
+
+    if (ok) {
+        uint32_t mask = bucket_count - 1;
+        for (uint32_t b = 0; b < bucket_count; b++) buckets[b] = CACHE_STRING_NONE;
+        for (size_t i = 0; i < string_count; i++) {
+            const char *str = build_cache_string(cache, old_ids[i]);
+            uint32_t slot = (uint32_t)path_index_hash(str ? str : "") & mask;
+            while (buckets[slot] != CACHE_STRING_NONE) slot = (slot + 1) & mask;
+            buckets[slot] = (uint32_t)i;
+        }
+
+        for (size_t e = 0; e < item_count; e++) {
+            entry_by_string[new_ids[item_source_id(&items[e])]] = (uint32_t)e;
+            dependency_count += item_dependency_count(&items[e]);
+        }
+    }
+
+    /* Header with section offsets */
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.version = cache->version;
+    header.magic = CACHE_MAGIC;
+    header.string_count = (uint32_t)string_count;
+    header.entry_count = (uint32_t)item_count;
+    header.bucket_count = bucket_count;
+    header.dependency_count = dependency_count;
+    header.blob_size = blob_size;
+
+    /* Graph snapshot: the one recorded this run, else the mapped one */
+    const uint32_t *graph_includes = cache->graph_recorded ? cache->graph_includes
+                                   : view ? view->graph_includes : NULL;
+    uint64_t graph_include_count = cache->graph_recorded ? cache->graph_include_count
+                                 : view ? view->header->graph_include_count : 0;
+    header.graph_include_count = graph_include_count;
+    header.graph_fingerprint = cache->graph_fingerprint;
+    header.file_set_fingerprint = cache->file_set_fingerprint;
+
+    /* Reverse index: as mapped or built if still current, else built now */
+    const uint64_t *reverse_starts = NULL;
+    const uint32_t *reverse_ids = NULL;
+    size_t reverse_nodes = 0;
+    uint64_t reverse_count = 0;
+    uint64_t *built_starts = NULL;
+    uint32_t *built_ids = NULL;
+    if (ok && !cache_current_reverse(cache, &reverse_starts, &reverse_ids,
+                                     &reverse_nodes, &reverse_count)) {
+        ok = cache_build_reverse(cache, &built_starts, &built_ids);
+        reverse_starts = built_starts;
+        reverse_ids = built_ids;
+        reverse_nodes = cache->string_count;
+        reverse_count = ok ? built_starts[reverse_nodes] : 0;
+    }
+
+    /* Renumbered: keep the lists of kept strings, naming kept dependents */
+    uint64_t *kept_starts = NULL;
+    uint32_t *kept_ids = NULL;
+    if (ok && remap) {
+        kept_starts = malloc((string_count + 1) * sizeof(uint64_t));
+        kept_ids = malloc((size_t)(reverse_count + 1) * sizeof(uint32_t));
+        ok = kept_starts && kept_ids;
+
+        uint64_t kept = 0;
+        for (size_t i = 0; ok && i < string_count; i++) {
+            kept_starts[i] = kept;
+            uint32_t old = old_ids[i];
+            if (old >= reverse_nodes) continue;
+            for (uint64_t e = reverse_starts[old]; e < reverse_starts[old + 1]; e++) {
+                uint32_t dependent = reverse_ids[e] < cache->string_count
+                                   ? new_ids[reverse_ids[e]] : CACHE_STRING_NONE;
+                if (dependent != CACHE_STRING_NONE) kept_ids[kept++] = dependent;
+            }
+        }
+        if (ok) kept_starts[string_count] = kept;
+        reverse_starts = kept_starts;
+        reverse_ids = kept_ids;
+        reverse_nodes = string_count;
+        reverse_count = kept;
+    }
+    header.reverse_count = reverse_count;
+
+    uint64_t offset = sizeof(CacheFileHeader);
+    header.entries_offset = offset;
+    offset += item_count * sizeof(CacheEntryRecord);
+    header.string_offsets_offset = offset;
+    offset += string_count * sizeof(uint32_t);
+    header.entry_by_string_offset = offset;
+    offset += string_count * sizeof(uint32_t);
+    header.buckets_offset = offset;
+    offset += (uint64_t)bucket_count * sizeof(uint32_t);
+    header.dep_ids_offset = offset;
+    offset += dependency_count * sizeof(uint32_t);
+    uint64_t padding = (sizeof(uint64_t) - offset % sizeof(uint64_t)) % sizeof(uint64_t);
+    offset += padding;
+    header.dep_hashes_offset = offset;
+    offset += dependency_count * sizeof(uint64_t);
+    header.stamps_offset = offset;
+    offset += string_count * sizeof(CacheStampRecord);
+    header.graph_offset = offset;
+    offset += string_count * sizeof(CacheGraphRecord);
+    header.reverse_starts_offset = offset;
+    offset += (string_count + 1) * sizeof(uint64_t);
+    header.graph_includes_offset = offset;
+    offset += graph_include_count * sizeof(uint32_t);
+    header.reverse_ids_offset = offset;
+    offset += reverse_count * sizeof(uint32_t);
+    header.blob_offset = offset;
+    offset += blob_size;
+    header.file_size = offset;
+
+    ok = ok && fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    /* Entry records */
+    uint64_t dependency_start = 0;
+    for (size_t e = 0; ok && e < item_count; e++) {
+        CacheEntryRecord rec;
+        if (items[e].record) {
+            rec = *items[e].record;
+        } else {
+            const CacheEntry *entry = items[e].entry;
+            memset(&rec, 0, sizeof(rec));
+            rec.source_id = entry->source_id;
+            rec.object_id = entry->object_id;
+            rec.source_hash = entry->source_hash;
+            rec.source_mtime = (int64_t)entry->source_mtime;
+            rec.last_compiled = (int64_t)entry->last_compiled;
+            rec.compile_seconds = entry->compile_seconds;
+            rec.peak_memory = entry->peak_memory;
+            rec.dependency_count = (uint32_t)entry->dependency_count;
+            rec.flags = (entry->valid ? CACHE_ENTRY_VALID : 0) |
+                        (entry->exact_dependencies ? CACHE_ENTRY_DEPFILE : 0);
+        }
+        rec.source_id = new_ids[rec.source_id];
+        if (rec.object_id < cache->string_count) rec.object_id = new_ids[rec.object_id];
+        rec.dependency_start = dependency_start;
+        dependency_start += rec.dependency_count;
+        ok = fwrite(&rec, sizeof(rec), 1, fp) == 1;
+    }
+
+    /* Index sections */
+    ok = ok && fwrite(string_offsets, sizeof(uint32_t), string_count, fp) == string_count;
+    ok = ok && fwrite(entry_by_string, sizeof(uint32_t), string_count, fp) == string_count;
+    ok = ok && fwrite(buckets, sizeof(uint32_t), bucket_count, fp) == bucket_count;
+
+    /* Dependency ids, then hashes */
+    for (size_t e = 0; ok && e < item_count; e++) {
+        ok = write_ids(fp, item_dependency_ids(cache, &items[e]),
+                       item_dependency_count(&items[e]), remap, cache->string_count);
+    }
+
+    static const uint8_t zeros[sizeof(uint64_t)] = {0};
+    ok = ok && fwrite(zeros, 1, (size_t)padding, fp) == padding;
+
+    for (size_t e = 0; ok && e < item_count; e++) {
+        const uint64_t *hashes = items[e].entry ? items[e].entry->dependency_hashes
+                                                : view->dep_hashes + items[e].record->dependency_start;
+        size_t count = item_dependency_count(&items[e]);
+        ok = count == 0 || fwrite(hashes, sizeof(uint64_t), count, fp) == count;
+    }
+
+    /* Stamp records */
+    for (size_t i = 0; ok && i < string_count; i++) {
+        CacheStampRecord record;
+        if (!cache_get_stamp(cache, old_ids[i], &record)) {
+            memset(&record, 0, sizeof(record));
+        }
+        ok = fwrite(&record, sizeof(record), 1, fp) == 1;
+    }
+
+    /* Graph records, reverse offsets (strings added since the index was
+     * built have no dependents), graph include ids, then reverse ids */
+    for (size_t i = 0; ok && i < string_count; i++) {
+        CacheGraphRecord record;
+        if (!cache_get_graph_record(cache, old_ids[i], &record, NULL)) {
+            memset(&record, 0, sizeof(record));
+        }
+        ok = fwrite(&record, sizeof(record), 1, fp) == 1;
+    }
+    for (size_t i = 0; ok && i <= string_count; i++) {
+        uint64_t start = i <= reverse_nodes ? reverse_starts[i] : reverse_count;
+        ok = fwrite(&start, sizeof(start), 1, fp) == 1;
+    }
+    ok = ok && write_ids(fp, graph_includes, (size_t)graph_include_count, remap,
+                         cache->string_count);
+    ok = ok && (reverse_count == 0 ||
+                fwrite(reverse_ids, sizeof(uint32_t), (size_t)reverse_count, fp) == reverse_count);
+
+    /* String blob */
+    for (size_t i = 0; ok && i < string_count; i++) {
+        const char *str = build_cache_string(cache, old_ids[i]);
+        if (!str) str = "";
+        size_t len = strlen(str) + 1;
+        ok = fwrite(str, 1, len, fp) == len;
+    }
+
+    free(items);
+    free(new_ids);
+    free(old_ids);
+    free(string_offsets);
+    free(entry_by_string);
+    free(buckets);
+    free(built_starts);
+    free(built_ids);
+    free(kept_starts);
+    free(kept_ids);
+    return ok;
+}
+
+static bool cache_save(BuildCache *cache) {
+
+    /* Nothing changed since the file was mapped */
+    if (cache->view && !cache->dirty) return true;
+
+    /* Write to temporary file first (atomic write) */
+    char temp_file[MAX_PATH_LENGTH];
+    snprintf(temp_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_TEMP_FILENAME);
+
+    FILE *fp = fopen(temp_file, "wb");
+    if (!fp) {
+        printf("Warning: Failed to open cache file for writing: %s\n", temp_file);
+        return false;
+    }
+
+    ec_mutex_lock(&cache->lock);
+    bool ok = cache_write_file(cache, fp);
+    ec_mutex_unlock(&cache->lock);
+
+    if (fclose(fp) != 0) ok = false;
+
+    if (!ok) {
+        remove(temp_file);
+        return false;
+    }
+
+    /* Atomic rename; the old file stays valid for our own mapping */
+    char cache_file[MAX_PATH_LENGTH];
+    snprintf(cache_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_FILENAME);
+
+#ifdef _WIN32
+    /* Windows cannot replace a mapped file, but it can rename one that was
+     * opened with FILE_SHARE_DELETE; move it aside and delete it on close */
+    if (cache->view) {
+        char old_file[MAX_PATH_LENGTH];
+        snprintf(old_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_OLD_FILENAME);
+        MoveFileExA(cache_file, old_file, MOVEFILE_REPLACE_EXISTING);
+    } else {
+        remove(cache_file);
+    }
+#endif
+
+    if (rename(temp_file, cache_file) != 0) {
+        printf("Warning: Failed to rename cache file\n");
+        remove(temp_file);
+        return false;
+    }
+
+    /* The file now holds everything the overlay did: read it in place from
+     * here on. Ids were renumbered by the save, so the memo goes too. If
+     * the file cannot be mapped the overlay stays, still dirty. */
+    CacheView *view = view_open(cache_file);
+    if (view) {
+        ec_mutex_lock(&cache->lock);
+        cache_free_contents(cache);
+        cache_adopt_view(cache, view);
+        cache->dirty = false;
+        ec_mutex_unlock(&cache->lock);
+    }
+
+    return true;
+}
+
+bool build_cache_save(BuildCache *cache) {
+    if (!cache) return false;
+
+    uint64_t trace_start = build_trace_begin();
+    bool ok = cache_save(cache);
+    build_trace_end(trace_start, "cache", "cache save", cache->cache_dir);
+    return ok;
+}
+
+void build_cache_destroy(BuildCache *cache) {
+    if (!cache) return;
+    cache_free_contents(cache);
+    path_index_destroy(&cache->entry_index);
+    path_index_destroy(&cache->string_index);
+    ec_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+void build_cache_clear(BuildCache *cache) {
+    if (!cache) return;
+
+    ec_mutex_lock(&cache->lock);
+
+    cache_free_contents(cache);
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->invalidations = 0;
+    cache->dirty = true;
+
+    ec_mutex_unlock(&cache->lock);
+}
+
+/* ==============================================================================
+ * Cache Query Implementation
+ * ==============================================================================
+ */
+
+const char *build_cache_string(const BuildCache *cache, uint32_t id) {
+    if (!cache || id >= cache->string_count) return NULL;
+
+    size_t base = cache_mapped_strings(cache);
+    if (id < base) return view_string(cache->view, id);
+    return cache->strings[id - base];
+}
+
+void build_cache_set_check_mode(BuildCache *cache, CacheCheckMode mode) {
+    if (!cache) return;
+    cache->check_mode = mode;
+}
+
+CacheEntry *build_cache_find(BuildCache *cache, const char *source_path) {
+    if (!cache || !source_path) return NULL;
+
+    ec_mutex_lock(&cache->lock);
+    CacheEntry *entry = cache_find_writable(cache, source_path);
+    ec_mutex_unlock(&cache->lock);
+
+    return entry && !entry->removed ? entry : NULL;
+}
+
+/**
+ * Check a source against its entry, counting a hit or miss if asked to
+ */
+static bool cache_source_changed(BuildCache *cache, const SourceFile *source, bool count) {
+    if (!cache || !source) {
+        return true;
+    }
+
+    /* Find cache entry and snapshot what we need. Mapped records are read
+     * in place; interned strings never move while the cache is alive. */
+    ec_mutex_lock(&cache->lock);
+    uint32_t record;
+    const CacheEntry *entry = cache_locate(cache, source->path, &record);
+    const CacheEntryRecord *rec = NULL;
+    bool usable = false;
+
+    uint64_t source_hash = 0;
+    size_t dep_count = 0;
+    const uint32_t *dep_ids = NULL;
+    const uint64_t *stored_hashes = NULL;
+
+    if (entry) {
+        usable = entry->valid;
+        source_hash = entry->source_hash;
+        dep_count = entry->dependency_count;
+        dep_ids = entry->dependency_ids;
+        stored_hashes = entry->dependency_hashes;
+    } else if (record != CACHE_INDEX_NONE) {
+        rec = &cache->view->records[record];
+        usable = (rec->flags & CACHE_ENTRY_VALID) && view_record_ok(cache->view, rec);
+        if (usable) {
+            source_hash = rec->source_hash;
+            dep_count = rec->dependency_count;
+            dep_ids = cache->view->dep_ids + rec->dependency_start;
+            stored_hashes = cache->view->dep_hashes + rec->dependency_start;
+        }
+    }
+
+    uint32_t source_id = usable ? cache_lookup_string(cache, source->path) : CACHE_STRING_NONE;
+    const char **dep_paths = NULL;
+    uint32_t *dep_path_ids = NULL;
+    uint64_t *dep_hashes = NULL;
+
+    if (usable && dep_count > 0) {
+        dep_paths = malloc(dep_count * sizeof(const char *));
+        dep_path_ids = malloc(dep_count * sizeof(uint32_t));
+        dep_hashes = malloc(dep_count * sizeof(uint64_t));
+        if (!dep_paths || !dep_path_ids || !dep_hashes) {
+            usable = false;
+        } else {
+            for (size_t i = 0; i < dep_count; i++) {
+                dep_paths[i] = build_cache_string(cache, dep_ids[i]);
+                dep_path_ids[i] = dep_ids[i];
+                dep_hashes[i] = stored_hashes[i];
+                if (!dep_paths[i]) usable = false;
+            }
+        }
+    }
+
+    if (!usable && count) {
+        cache->misses++;
+    }
+    ec_mutex_unlock(&cache->lock);
+
+    if (!usable) {
+        free(dep_paths);
+        free(dep_path_ids);
+        free(dep_hashes);
+        return true; /* No cache entry = must compile */
+    }
+
+    bool changed = false;
+
+    /* Check if source content changed */
+    uint64_t current_hash = cache_current_hash(cache, source_id, source->path);
+    if (current_hash == 0) {
+        changed = true; /* Can't read source file */
+    } else if (current_hash != source_hash) {
+        changed = true; /* Source content changed */
+    }
+
+    /* Check if any dependency changed */
+    for (size_t i = 0; !changed && i < dep_count; i++) {
+        uint64_t dep_hash = cache_current_hash(cache, dep_path_ids[i], dep_paths[i]);
+        if (dep_hash == 0) {
+            /* Dependency file missing - might be OK if it's a system header */
+            continue;
+        }
+
+        if (dep_hash != dep_hashes[i]) {
+            changed = true; /* Dependency changed */
+        }
+    }
+
+    free(dep_paths);
+    free(dep_path_ids);
+    free(dep_hashes);
+
+    /* Cache hit if nothing changed!
+     * Note: We DON'T check if object file exists. If source and dependencies
+     * are unchanged, we trust the cache even if .o file was deleted.
+     * The compilation system will handle regenerating it if needed.
+     */
+    if (count) {
+        ec_mutex_lock(&cache->lock);
+        if (changed) {
+            cache->misses++;
+        } else {
+            cache->hits++;
+        }
+        ec_mutex_unlock(&cache->lock);
+    }
+
+    return changed;
+}
+
+bool build_cache_needs_recompilation(
+    BuildCache *cache,
+    const SourceFile *source,
+    const char *object_path
+) {
+    (void)object_path; /* Object presence is checked by the cache middleware */
+    return cache_source_changed(cache, source, true);
+}
+
+bool build_cache_is_current(BuildCache *cache, const SourceFile *source) {
+    return !cache_source_changed(cache, source, false);
+}
+
+/**
+ * Record a compiled source with the given dependency paths
+ */
+static void cache_update_entry(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    const char *const *dependencies,
+    size_t dep_count,
+    bool exact
+) {
+    uint32_t *dep_ids = NULL;
+    uint64_t *dep_hashes = NULL;
+
+    if (dep_count > 0) {
+        dep_ids = malloc(dep_count * sizeof(uint32_t));
+        dep_hashes = malloc(dep_count * sizeof(uint64_t));
+        if (!dep_ids || !dep_hashes) {
+            free(dep_ids);
+            free(dep_hashes);
+            printf("Warning: Out of memory updating cache for %s\n", source_path);
+            return;
+        }
+    }
+
+    /* Intern paths first so hashing can use (and refresh) their stamps */
+    ec_mutex_lock(&cache->lock);
+
+    uint32_t source_id = cache_intern(cache, source_path);
+    uint32_t object_id = cache_intern(cache, object_path);
+    bool ok = source_id != CACHE_STRING_NONE && object_id != CACHE_STRING_NONE;
+
+    for (size_t i = 0; ok && i < dep_count; i++) {
+        dep_ids[i] = cache_intern(cache, dependencies[i]);
+        ok = dep_ids[i] != CACHE_STRING_NONE;
+    }
+
+    ec_mutex_unlock(&cache->lock);
+
+    /* Hash everything without the lock held */
+    uint64_t source_hash = 0;
+    time_t source_mtime = get_file_mtime(source_path);
+    if (ok) {
+        source_hash = cache_current_hash(cache, source_id, source_path);
+        for (size_t i = 0; i < dep_count; i++) {
+            dep_hashes[i] = cache_current_hash(cache, dep_ids[i], dependencies[i]);
+        }
+    }
+
+    ec_mutex_lock(&cache->lock);
+
+    /* Find existing entry (copying it out of the mapping) or create new one */
+    CacheEntry *entry = ok ? cache_find_writable(cache, source_path) : NULL;
+    if (ok && !entry) {
+        entry = cache_add_overlay(cache, source_id);
+        if (entry) cache->entry_count++;
+    } else if (entry && entry->removed) {
+        /* Pruned, then compiled again (a file restored while watching) */
+        entry->removed = false;
+        cache->entry_count++;
+    }
+
+    if (!entry) {
+        ec_mutex_unlock(&cache->lock);
+        free(dep_ids);
+        free(dep_hashes);
+        printf("Warning: Out of memory updating cache for %s\n", source_path);
+        return;
+    }
+
+    /* Update basic info */
+    entry->source_id = source_id;
+    entry->object_id = object_id;
+    entry->source_hash = source_hash;
+    entry->source_mtime = source_mtime;
+    entry->last_compiled = time(NULL);
+
+    /* Store dependencies */
+    free(entry->dependency_ids);
+    free(entry->dependency_hashes);
+    entry->dependency_ids = dep_ids;
+    entry->dependency_hashes = dep_hashes;
+    entry->dependency_count = dep_count;
+    entry->exact_dependencies = exact;
+
+    entry->valid = true;
+    cache->dirty = true;
+    cache_edges_changed(cache);
+
+    ec_mutex_unlock(&cache->lock);
+}
+
+void build_cache_update(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    const DependencyGraph *graph
+) {
+    if (!cache || !source_path || !object_path) return;
+
+    /* Dependencies from dependency graph */
+    SourceFile *source = graph ? dependency_graph_find_file(graph, source_path) : NULL;
+    cache_update_entry(cache, source_path, object_path,
+                       source ? (const char *const *)source->includes : NULL,
+                       source ? source->include_count : 0, false);
+}
+
+void build_cache_update_dependencies(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    const char *const *dependencies,
+    size_t dependency_count
+) {
+    if (!cache || !source_path || !object_path) return;
+    if (!dependencies) dependency_count = 0;
+
+    cache_update_entry(cache, source_path, object_path, dependencies, dependency_count, true);
+}
+
+void build_cache_update_closure(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    DependencyGraph *graph
+) {
+    if (!cache || !source_path || !object_path) return;
+
+    SourceFile *source = graph ? dependency_graph_find_file(graph, source_path) : NULL;
+    SourceFile **deps = source ? malloc((graph->file_count + 1) * sizeof(SourceFile *)) : NULL;
+    const char **paths = deps ? malloc((graph->file_count + 1) * sizeof(const char *)) : NULL;
+    size_t dep_count = 0;
+    if (!paths || dependency_graph_get_all_dependencies(graph, source, deps, graph->file_count,
+                                                        &dep_count) != DEP_SUCCESS) {
+        free(deps);
+        free(paths);
+        build_cache_update(cache, source_path, object_path, graph);
+        return;
+    }
+
+    for (size_t i = 0; i < dep_count; i++) {
+        paths[i] = deps[i]->path;
+    }
+    cache_update_entry(cache, source_path, object_path, paths, dep_count, true);
+    free(deps);
+    free(paths);
+}
+
+void build_cache_record_compile(
+    BuildCache *cache,
+    const char *source_path,
+    double seconds,
+    uint64_t peak_memory
+) {
+    if (!cache || !source_path) return;
+
+    ec_mutex_lock(&cache->lock);
+    CacheEntry *entry = cache_find_writable(cache, source_path);
+    if (entry) {
+        if (seconds > 0.0) entry->compile_seconds = seconds;
+        if (peak_memory > 0) entry->peak_memory = peak_memory;
+        cache->dirty = true;
+    }
+    ec_mutex_unlock(&cache->lock);
 }
 
-time_t get_file_mtime(const char *path) {
-    if (!path) return 0;
-    
-    struct stat st;
-    if (stat(path, &st) != 0) {
-        return 0;
+bool build_cache_get_compile_stats(
+    BuildCache *cache,
+    const char *source_path,
+    double *seconds,
+    uint64_t *peak_memory
+) {
+    if (seconds) *seconds = 0.0;
+    if (peak_memory) *peak_memory = 0;
+    if (!cache || !source_path) return false;
+
+    ec_mutex_lock(&cache->lock);
+    uint32_t record;
+    const CacheEntry *entry = cache_locate(cache, source_path, &record);
+    double recorded_seconds = 0.0;
+    uint64_t recorded_memory = 0;
+    if (entry) {
+        recorded_seconds = entry->compile_seconds;
+        recorded_memory = entry->peak_memory;
+    } else if (record != CACHE_INDEX_NONE) {
+        recorded_seconds = cache->view->records[record].compile_seconds;
+        recorded_memory = cache->view->records[record].peak_memory;
     }
-    
-    return st.st_mtime;
-}
+    ec_mutex_unlock(&cache->lock);
 
-bool file_exists_cache(const char *path) {
-    if (!path) return false;
-    return access(path, F_OK) == 0;
+    /* A corrupt record must not schedule a compile at infinity */
+    if (!(recorded_seconds > 0.0 && recorded_seconds < 1e9)) recorded_seconds = 0.0;
+
+    if (seconds) *seconds = recorded_seconds;
+    if (peak_memory) *peak_memory = recorded_memory;
+    return recorded_seconds > 0.0;
 }
 
-/* ==============================================================================
- * Cache Management Implementation
- * ==============================================================================
+/**
+ * Provide a depfile entry's dependency list (called with lock held)
  */
+static IncludeProvision cache_provide_from_entry(BuildCache *cache, SourceFile *file,
+                                                 const FileStamp *stamp) {
+    uint32_t record;
+    const CacheEntry *entry = cache_locate(cache, file->path, &record);
+    bool usable = false;
+    size_t dep_count = 0;
+    const uint32_t *dep_ids = NULL;
 
-BuildCache *build_cache_create(const char *project_dir) {
-    if (!project_dir) return NULL;
-    
-    BuildCache *cache = (BuildCache *)calloc(1, sizeof(BuildCache));
-    if (!cache) return NULL;
-    
-    /* Initialize cache */
-    cache->version = CACHE_VERSION;
-    cache->entry_count = 0;
-    cache->hits = 0;
-    cache->misses = 0;
-    cache->invalidations = 0;
-    
-    /* Store project directory */
-    strncpy(cache->project_dir, project_dir, MAX_PATH_LENGTH - 1);
-    cache->project_dir[MAX_PATH_LENGTH - 1] = '\0';
-    
-    /* Create .eventchains directory */
-    snprintf(cache->cache_dir, MAX_PATH_LENGTH, "%s/.eventchains", project_dir);
-    mkdir(cache->cache_dir, 0755);
-    
-    /* Try to load existing cache */
-    char cache_file[MAX_PATH_LENGTH];
-    snprintf(cache_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_FILENAME);
-    
-    FILE *fp = fopen(cache_file, "rb");
-    if (fp) {
-        /* Read version */
-        uint32_t version;
-        if (fread(&version, sizeof(uint32_t), 1, fp) != 1) {
-            fclose(fp);
-            printf("Warning: Failed to read cache version\n");
-            return cache;
-        }
-        
-        /* Check version compatibility */
-        if (version != CACHE_VERSION) {
-            fclose(fp);
-            printf("Warning: Cache version mismatch (expected %d, got %d) - rebuilding cache\n",
-                   CACHE_VERSION, version);
-            return cache;
-        }
-        
-        /* Read entry count */
-        if (fread(&cache->entry_count, sizeof(size_t), 1, fp) != 1) {
-            fclose(fp);
-            printf("Warning: Failed to read cache entry count\n");
-            cache->entry_count = 0;
-            return cache;
-        }
-        
-        /* Validate entry count */
-        if (cache->entry_count > MAX_CACHE_ENTRIES) {
-            fclose(fp);
-            printf("Warning: Invalid cache entry count (%zu) - rebuilding cache\n",
-                   cache->entry_count);
-            cache->entry_count = 0;
-            return cache;
-        }
-        
-        /* Read entries */
-        if (fread(cache->entries, sizeof(CacheEntry), cache->entry_count, fp) != cache->entry_count) {
-            fclose(fp);
-            printf("Warning: Failed to read cache entries - rebuilding cache\n");
-            cache->entry_count = 0;
-            return cache;
-        }
-        
-        fclose(fp);
-        printf("Loaded cache: %zu entries from %s\n", cache->entry_count, cache_file);
+    if (entry) {
+        usable = entry->valid && entry->exact_dependencies;
+        dep_count = entry->dependency_count;
+        dep_ids = entry->dependency_ids;
+    } else if (record != CACHE_INDEX_NONE) {
+        const CacheEntryRecord *rec = &cache->view->records[record];
+        usable = (rec->flags & CACHE_ENTRY_VALID) && (rec->flags & CACHE_ENTRY_DEPFILE) &&
+                 view_record_ok(cache->view, rec);
+        dep_count = usable ? rec->dependency_count : 0;
+        dep_ids = usable ? cache->view->dep_ids + rec->dependency_start : NULL;
     }
-    
-    return cache;
-}
 
-bool build_cache_save(const BuildCache *cache) {
-    if (!cache) return false;
-    
-    /* Write to temporary file first (atomic write) */
-    char temp_file[MAX_PATH_LENGTH];
-    snprintf(temp_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_TEMP_FILENAME);
-    
-    FILE *fp = fopen(temp_file, "wb");
-    if (!fp) {
-        printf("Warning: Failed to open cache file for writing: %s\n", temp_file);
-        return false;
+    /* Only an unchanged source can reuse its old list */
+    CacheStampRecord known;
+    usable = usable && stamp &&
+             cache_get_stamp(cache, cache_lookup_string(cache, file->path), &known) &&
+             memcmp(&known.stamp, stamp, sizeof(FileStamp)) == 0;
+
+    for (size_t i = 0; usable && i < dep_count; i++) {
+        const char *dep = build_cache_string(cache, dep_ids[i]);
+        usable = dep && source_file_add_include(file, dep) == DEP_SUCCESS;
     }
-    
-    /* Write version */
-    if (fwrite(&cache->version, sizeof(uint32_t), 1, fp) != 1) {
-        fclose(fp);
-        remove(temp_file);
-        return false;
+
+    return usable ? INCLUDES_TRANSITIVE : INCLUDES_NOT_PROVIDED;
+}
+
+/**
+ * Provide the graph snapshot's record of an unchanged file (called with lock held)
+ */
+static IncludeProvision cache_provide_from_graph(BuildCache *cache, SourceFile *file,
+                                                 const FileStamp *stamp) {
+    CacheGraphRecord rec;
+    const uint32_t *include_ids;
+    if (!stamp || !cache->graph_usable ||
+        !cache_get_graph_record(cache, cache_lookup_string(cache, file->path), &rec, &include_ids) ||
+        memcmp(&rec.stamp, stamp, sizeof(FileStamp)) != 0) {
+        return INCLUDES_NOT_PROVIDED;
     }
-    
-    /* Write entry count */
-    if (fwrite(&cache->entry_count, sizeof(size_t), 1, fp) != 1) {
-        fclose(fp);
-        remove(temp_file);
-        return false;
+
+    for (size_t i = 0; i < rec.include_count; i++) {
+        const char *include = build_cache_string(cache, include_ids[i]);
+        if (!include || source_file_add_include(file, include) != DEP_SUCCESS) {
+            return INCLUDES_NOT_PROVIDED;
+        }
     }
-    
-    /* Write entries */
-    if (fwrite(cache->entries, sizeof(CacheEntry), cache->entry_count, fp) != cache->entry_count) {
-        fclose(fp);
-        remove(temp_file);
-        return false;
+
+    file->main_known = (rec.flags & CACHE_GRAPH_MAIN_KNOWN) != 0;
+    file->has_main = (rec.flags & CACHE_GRAPH_MAIN) != 0;
+    return (rec.flags & CACHE_GRAPH_TRANSITIVE) ? INCLUDES_TRANSITIVE : INCLUDES_DIRECT;
+}
+
+IncludeProvision build_cache_include_provider(void *user_data, SourceFile *file) {
+    BuildCache *cache = (BuildCache *)user_data;
+    if (!cache || !file) return INCLUDES_NOT_PROVIDED;
+
+    FileStamp stamp;
+    bool have_stamp = file_stamp_get(file->path, &stamp);
+
+    ec_mutex_lock(&cache->lock);
+
+    IncludeProvision provision = cache_provide_from_entry(cache, file, have_stamp ? &stamp : NULL);
+    if (provision == INCLUDES_NOT_PROVIDED && file->include_count == 0) {
+        provision = cache_provide_from_graph(cache, file, have_stamp ? &stamp : NULL);
     }
-    
-    fclose(fp);
-    
-    /* Atomic rename */
-    char cache_file[MAX_PATH_LENGTH];
-    snprintf(cache_file, MAX_PATH_LENGTH, "%s/%s", cache->cache_dir, CACHE_FILENAME);
-    
-#ifdef _WIN32
-    /* Windows requires removing the target file first */
-    remove(cache_file);
-#endif
-    
-    if (rename(temp_file, cache_file) != 0) {
-        printf("Warning: Failed to rename cache file\n");
-        remove(temp_file);
-        return false;
+
+    /* Remember the stamp from before the scan; a recent mtime could hide
+     * a same-second rewrite, so such files are simply parsed again */
+    if (have_stamp && stamp.mtime_sec + 2 < (int64_t)time(NULL)) {
+        uint32_t id = cache_intern(cache, file->path);
+        if (id != CACHE_STRING_NONE &&
+            stamps_reserve(&cache->scan_stamps, &cache->scan_stamp_capacity, id)) {
+            cache->scan_stamps[id].stamp = stamp;
+            cache->scan_stamps[id].flags = CACHE_STAMP_VALID;
+        }
     }
-    
-    return true;
+
+    ec_mutex_unlock(&cache->lock);
+    return provision;
 }
 
-void build_cache_destroy(BuildCache *cache) {
-    if (!cache) return;
-    free(cache);
+/**
+ * Fingerprint of a graph's include paths, which decide how includes resolve
+ */
+static uint64_t graph_fingerprint(const DependencyGraph *graph) {
+    uint64_t fingerprint = 0xcbf29ce484222325ULL ^ graph->include_path_count;
+    for (size_t i = 0; i < graph->include_path_count; i++) {
+        fingerprint = (fingerprint ^ path_index_hash(graph->include_paths[i])) *
+                      0x100000001b3ULL;
+    }
+    return fingerprint;
 }
 
-void build_cache_clear(BuildCache *cache) {
-    if (!cache) return;
-    
-    cache->entry_count = 0;
-    cache->hits = 0;
-    cache->misses = 0;
-    cache->invalidations = 0;
-    
-    memset(cache->entries, 0, sizeof(cache->entries));
+void build_cache_provide_includes(BuildCache *cache, DependencyGraph *graph) {
+    if (!cache || !graph) return;
+
+    ec_mutex_lock(&cache->lock);
+    cache->graph_usable = cache->graph_fingerprint == graph_fingerprint(graph);
+    /* A cache kept for another scan must not record the last scan's stamps */
+    if (cache->scan_stamps) {
+        memset(cache->scan_stamps, 0, cache->scan_stamp_capacity * sizeof(CacheStampRecord));
+    }
+    ec_mutex_unlock(&cache->lock);
+
+    dependency_graph_set_include_provider(graph, build_cache_include_provider, cache);
 }
 
-/* ==============================================================================
- * Cache Query Implementation
- * ==============================================================================
+/**
+ * Whether newly built graph records say the same as the current snapshot
+ * (called with lock held)
  */
+static bool graph_snapshot_matches(const BuildCache *cache, const CacheGraphRecord *records,
+                                   const uint32_t *includes, uint64_t fingerprint) {
+    if (!cache->view && !cache->graph_recorded) return false;
+    if (cache->graph_fingerprint != fingerprint) return false;
 
-CacheEntry *build_cache_find(BuildCache *cache, const char *source_path) {
-    if (!cache || !source_path) return NULL;
-    
-    for (size_t i = 0; i < cache->entry_count; i++) {
-        if (strcmp(cache->entries[i].source_path, source_path) == 0) {
-            return &cache->entries[i];
+    for (uint32_t id = 0; id < cache->string_count; id++) {
+        const CacheGraphRecord *rec = &records[id];
+        CacheGraphRecord old;
+        const uint32_t *old_includes;
+        bool had = cache_get_graph_record(cache, id, &old, &old_includes);
+        bool has = (rec->flags & CACHE_GRAPH_SCANNED) != 0;
+
+        if (had != has) return false;
+        if (!has) continue;
+        if (memcmp(&old.stamp, &rec->stamp, sizeof(FileStamp)) != 0 ||
+            old.flags != rec->flags || old.include_count != rec->include_count ||
+            (rec->include_count > 0 &&
+             memcmp(old_includes, includes + rec->include_start,
+                    rec->include_count * sizeof(uint32_t)) != 0)) {
+            return false;
         }
     }
-    
-    return NULL;
+    return true;
 }
 
-bool build_cache_needs_recompilation(
-    BuildCache *cache,
-    const SourceFile *source,
-    const char *object_path
-) {
-    if (!cache || !source) {
-        return true;
-    }
-    
-    /* Find cache entry */
-    CacheEntry *entry = build_cache_find(cache, source->path);
-    if (!entry || !entry->valid) {
-        cache->misses++;
-        return true; /* No cache entry = must compile */
-    }
-    
-    /* Check if source content changed */
-    uint64_t current_hash = hash_file_content(source->path);
-    if (current_hash == 0) {
-        cache->misses++;
-        return true; /* Can't read source file */
+void build_cache_record_graph(BuildCache *cache, const DependencyGraph *graph) {
+    if (!cache || !graph) return;
+
+    ec_mutex_lock(&cache->lock);
+
+    /* Intern every path first so the record array is sized once */
+    size_t include_total = 0;
+    for (size_t i = 0; i < graph->file_count; i++) {
+        const SourceFile *file = graph->files[i];
+        if (!file->scanned) continue;
+        cache_intern(cache, file->path);
+        for (size_t j = 0; j < file->include_count; j++) {
+            cache_intern(cache, file->includes[j]);
+        }
+        include_total += file->include_count;
     }
-    
-    if (current_hash != entry->source_hash) {
-        cache->misses++;
-        return true; /* Source content changed */
+
+    CacheGraphRecord *records = calloc(cache->string_count + 1, sizeof(CacheGraphRecord));
+    uint32_t *includes = malloc((include_total + 1) * sizeof(uint32_t));
+    if (!records || !includes) {
+        free(records);
+        free(includes);
+        ec_mutex_unlock(&cache->lock);
+        return;
     }
-    
-    /* Check if any dependency changed */
-    for (size_t i = 0; i < entry->dependency_count; i++) {
-        uint64_t dep_hash = hash_file_content(entry->dependencies[i]);
-        if (dep_hash == 0) {
-            /* Dependency file missing - might be OK if it's a system header */
+
+    size_t include_count = 0;
+    for (size_t i = 0; i < graph->file_count; i++) {
+        const SourceFile *file = graph->files[i];
+        uint32_t id = file->scanned ? cache_lookup_string(cache, file->path) : CACHE_STRING_NONE;
+
+        /* Without a trusted stamp from before the scan the file is parsed next time */
+        if (id == CACHE_STRING_NONE || id >= cache->scan_stamp_capacity ||
+            !(cache->scan_stamps[id].flags & CACHE_STAMP_VALID)) {
             continue;
         }
-        
-        if (dep_hash != entry->dependency_hashes[i]) {
-            cache->misses++;
-            return true; /* Dependency changed */
-        }
-    }
-    
-    /* Cache hit!
-     * Note: We DON'T check if object file exists. If source and dependencies
-     * are unchanged, we trust the cache even if .o file was deleted.
-     * The compilation system will handle regenerating it if needed.
-     */
-    cache->hits++;
-    return false;
-}
 
-void build_cache_update(
-    BuildCache *cache,
-    const char *source_path,
-    const char *object_path,
-    const DependencyGraph *graph
-) {
-    if (!cache || !source_path || !object_path) return;
+        CacheGraphRecord *rec = &records[id];
+        rec->stamp = cache->scan_stamps[id].stamp;
+        rec->include_start = include_count;
+        rec->flags = CACHE_GRAPH_SCANNED;
+        if (file->dependencies_provided) rec->flags |= CACHE_GRAPH_TRANSITIVE;
+        if (file->main_known) rec->flags |= CACHE_GRAPH_MAIN_KNOWN;
+        if (file->has_main) rec->flags |= CACHE_GRAPH_MAIN;
 
-    /* Find existing entry or create new one */
-    CacheEntry *entry = build_cache_find(cache, source_path);
-    if (!entry) {
-        if (cache->entry_count >= MAX_CACHE_ENTRIES) {
-            printf("Warning: Cache full (%d entries), cannot add more\n", MAX_CACHE_ENTRIES);
-            return;
+        for (size_t j = 0; j < file->include_count; j++) {
+            uint32_t include_id = cache_lookup_string(cache, file->includes[j]);
+            if (include_id == CACHE_STRING_NONE) {
+                rec->flags = 0;
+                break;
+            }
+            includes[include_count + j] = include_id;
+        }
+        if (rec->flags) {
+            rec->include_count = (uint32_t)file->include_count;
+            include_count += file->include_count;
         }
-        entry = &cache->entries[cache->entry_count++];
     }
 
-    /* Update basic info */
-    strncpy(entry->source_path, source_path, MAX_PATH_LENGTH - 1);
-    entry->source_path[MAX_PATH_LENGTH - 1] = '\0';
+    /* A scan that found what the snapshot already says changes nothing,
+     * so an up-to-date build does not rewrite the file */
+    uint64_t fingerprint = graph_fingerprint(graph);
+    if (graph_snapshot_matches(cache, records, includes, fingerprint)) {
+        free(records);
+        free(includes);
+        cache->graph_usable = true;
+        ec_mutex_unlock(&cache->lock);
+        return;
+    }
 
-    strncpy(entry->object_path, object_path, MAX_PATH_LENGTH - 1);
-    entry->object_path[MAX_PATH_LENGTH - 1] = '\0';
+    free(cache->graph_records);
+    free(cache->graph_includes);
+    cache->graph_records = records;
+    cache->graph_record_count = cache->string_count;
+    cache->graph_includes = includes;
+    cache->graph_include_count = include_count;
+    cache->graph_recorded = true;
+    cache->graph_fingerprint = fingerprint;
+    cache->graph_usable = true;
+    cache->dirty = true;
+    cache_edges_changed(cache);
 
-    /* Hash source content */
-    entry->source_hash = hash_file_content(source_path);
-    entry->source_mtime = get_file_mtime(source_path);
-    entry->last_compiled = time(NULL);
+    ec_mutex_unlock(&cache->lock);
+}
+
+/**
+ * Whether an entry's source still exists (called with lock held)
+ */
+static bool cache_source_present(const BuildCache *cache, const DependencyGraph *graph,
+                                 uint32_t source_id) {
+    const char *path = build_cache_string(cache, source_id);
+    if (!path) return false;
+    if (graph && dependency_graph_find_file(graph, path)) return true;
+    return file_exists_cache(path);
+}
+
+static void cache_mark_removed(BuildCache *cache, CacheEntry *entry) {
+    entry->removed = true;
+    entry->valid = false;
+    cache->entry_count--;
+}
+
+/**
+ * Fingerprint of a graph's files, the same whatever order they were
+ * scanned in
+ */
+static uint64_t file_set_fingerprint(const DependencyGraph *graph) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < graph->file_count; i++) {
+        uint64_t hash = path_index_hash(graph->files[i]->path);
+        sum += (hash ^ (hash >> 31)) * 0x9e3779b97f4a7c15ULL;
+    }
+    return sum ^ graph->file_count;
+}
+
+size_t build_cache_prune(BuildCache *cache, const DependencyGraph *graph) {
+    if (!cache) return 0;
 
-    /* Store dependencies from dependency graph */
-    entry->dependency_count = 0;
+    ec_mutex_lock(&cache->lock);
 
     if (graph) {
-        SourceFile *source = dependency_graph_find_file(graph, source_path);
-        if (source) {
-            size_t max_deps = source->include_count;
-            if (max_deps > MAX_DEPENDENCIES_PER_FILE) {
-                max_deps = MAX_DEPENDENCIES_PER_FILE;
-            }
+        uint64_t fingerprint = file_set_fingerprint(graph);
+        if (fingerprint != cache->file_set_fingerprint) {
+            cache->file_set_fingerprint = fingerprint;
+            cache->dirty = true;
+        }
+    }
 
-            for (size_t i = 0; i < max_deps; i++) {
-                strncpy(entry->dependencies[entry->dependency_count],
-                       source->includes[i],
-                       MAX_PATH_LENGTH - 1);
-                entry->dependencies[entry->dependency_count][MAX_PATH_LENGTH - 1] = '\0';
+    size_t removed = 0;
+    for (size_t i = 0; i < cache->overlay_count; i++) {
+        CacheEntry *entry = cache->entries[i];
+        if (entry->removed || cache_source_present(cache, graph, entry->source_id)) continue;
+        cache_mark_removed(cache, entry);
+        removed++;
+    }
 
-                entry->dependency_hashes[entry->dependency_count] =
-                    hash_file_content(source->includes[i]);
+    /* Mapped records are copied out to carry the mark */
+    CacheView *view = cache->view;
+    size_t mapped_records = view ? view->header->entry_count : 0;
+    for (size_t r = 0; r < mapped_records; r++) {
+        if (view->materialized && view->materialized[r]) continue;
 
-                entry->dependency_count++;
-            }
+        const CacheEntryRecord *rec = &view->records[r];
+        if (!view_record_ok(view, rec) || cache_source_present(cache, graph, rec->source_id)) {
+            continue;
+        }
+        CacheEntry *entry = cache_materialize(cache, (uint32_t)r);
+        if (entry) {
+            cache_mark_removed(cache, entry);
+            removed++;
         }
     }
 
-    entry->valid = true;
+    if (removed > 0) {
+        cache->dirty = true;
+        cache_edges_changed(cache);
+    }
+
+    ec_mutex_unlock(&cache->lock);
+    return removed;
+}
+
+size_t build_cache_prune_changed(BuildCache *cache, const DependencyGraph *graph) {
+    if (!cache || !graph) return 0;
+
+    ec_mutex_lock(&cache->lock);
+    bool changed = file_set_fingerprint(graph) != cache->file_set_fingerprint;
+    ec_mutex_unlock(&cache->lock);
+
+    return changed ? build_cache_prune(cache, graph) : 0;
 }
 
 void build_cache_invalidate(BuildCache *cache, const char *source_path) {
     if (!cache || !source_path) return;
 
-    CacheEntry *entry = build_cache_find(cache, source_path);
-    if (entry) {
+    ec_mutex_lock(&cache->lock);
+    CacheEntry *entry = cache_find_writable(cache, source_path);
+    if (entry && !entry->removed) {
         entry->valid = false;
         cache->invalidations++;
+        cache->dirty = true;
     }
+    ec_mutex_unlock(&cache->lock);
 }
 
 void build_cache_invalidate_dependents(
     BuildCache *cache,
     const char *changed_file,
-    const DependencyGraph *graph
+    DependencyGraph *graph
 ) {
-    if (!cache || !changed_file || !graph) return;
+    if (!cache || !changed_file) return;
 
-    /* Find all cache entries that depend on changed_file */
-    for (size_t i = 0; i < cache->entry_count; i++) {
-        CacheEntry *entry = &cache->entries[i];
-        if (!entry->valid) continue;
+    ec_mutex_lock(&cache->lock);
 
-        /* Check if this entry depends on changed_file */
-        for (size_t j = 0; j < entry->dependency_count; j++) {
-            if (strcmp(entry->dependencies[j], changed_file) == 0) {
-                /* Found a dependent - invalidate it */
-                entry->valid = false;
-                cache->invalidations++;
-                break;
-            }
+    /* Breadth-first over the reverse index; only affected ids are visited */
+    uint32_t changed_id = cache_lookup_string(cache, changed_file);
+    size_t dependent_count = 0;
+    uint32_t *dependents = changed_id != CACHE_STRING_NONE
+                         ? cache_collect_dependents(cache, changed_id, &dependent_count)
+                         : NULL;
+    for (size_t i = 0; i < dependent_count; i++) {
+        CacheEntry *entry = cache_find_writable(cache, build_cache_string(cache, dependents[i]));
+        if (entry && entry->valid) {
+            entry->valid = false;
+            cache->invalidations++;
+            cache->dirty = true;
+        }
+    }
+    free(dependents);
+
+    ec_mutex_unlock(&cache->lock);
+
+    /* Includes scanned this run that the cache has not recorded yet */
+    SourceFile *changed = graph ? dependency_graph_find_file(graph, changed_file) : NULL;
+    SourceFile **graph_dependents = changed ? malloc((graph->file_count + 1) * sizeof(SourceFile *))
+                                            : NULL;
+    if (!graph_dependents ||
+        dependency_graph_get_dependents(graph, changed, graph_dependents, graph->file_count,
+                                        &dependent_count) != DEP_SUCCESS) {
+        free(graph_dependents);
+        return;
+    }
+
+    ec_mutex_lock(&cache->lock);
+    for (size_t i = 0; i < dependent_count; i++) {
+        CacheEntry *entry = cache_find_writable(cache, graph_dependents[i]->path);
+        if (entry && entry->valid) {
+            entry->valid = false;
+            cache->invalidations++;
+            cache->dirty = true;
+        }
+    }
+    ec_mutex_unlock(&cache->lock);
+    free(graph_dependents);
+}
+
+bool build_cache_get_affected_sources(
+    BuildCache *cache,
+    const char *changed_file,
+    const char **sources,
+    size_t max_sources,
+    size_t *source_count
+) {
+    if (!cache || !changed_file || !source_count) return false;
+    *source_count = 0;
+
+    ec_mutex_lock(&cache->lock);
+
+    uint32_t changed_id = cache_lookup_string(cache, changed_file);
+    if (changed_id == CACHE_STRING_NONE) {
+        ec_mutex_unlock(&cache->lock);
+        return false;
+    }
+
+    size_t dependent_count = 0;
+    uint32_t *dependents = cache_collect_dependents(cache, changed_id, &dependent_count);
+
+    /* A compiled source is rebuilt itself, then everything depending on it */
+    for (size_t i = 0; i <= dependent_count; i++) {
+        if (i > 0 && !dependents) break;
+
+        const char *path = build_cache_string(cache, i == 0 ? changed_id : dependents[i - 1]);
+        uint32_t record;
+        const CacheEntry *entry = path ? cache_locate(cache, path, &record) : NULL;
+        if (!path || (entry ? entry->removed : record == CACHE_INDEX_NONE)) {
+            continue;
         }
+
+        if (sources && *source_count < max_sources) sources[*source_count] = path;
+        (*source_count)++;
     }
+    free(dependents);
+
+    ec_mutex_unlock(&cache->lock);
+    return true;
 }
 
 /* ==============================================================================
@@ -395,6 +2397,7 @@ void build_cache_print_stats(const BuildCache *cache) {
     printf("  Cache Hits:    %zu\n", cache->hits);
     printf("  Cache Misses:  %zu\n", cache->misses);
     printf("  Invalidations: %zu\n", cache->invalidations);
+    printf("  Memo Hits:     %zu\n", cache->memo_hits);
 
     if (cache->hits + cache->misses > 0) {
         double hit_rate = (double)cache->hits / (cache->hits + cache->misses) * 100.0;
@@ -416,6 +2419,40 @@ double build_cache_hit_rate(const BuildCache *cache) {
 size_t build_cache_size_bytes(const BuildCache *cache) {
     if (!cache) return 0;
 
-    return sizeof(BuildCache) +
-           (cache->entry_count * sizeof(CacheEntry));
-}
\ No newline at end of file
+    size_t size = sizeof(BuildCache) +
+                  cache->overlay_capacity * sizeof(CacheEntry *) +
+                  cache->string_capacity * sizeof(char *);
+
+    for (size_t i = 0; i < cache->overlay_count; i++) {
+        size += sizeof(CacheEntry) +
+                cache->entries[i]->dependency_count * (sizeof(uint32_t) + sizeof(uint64_t));
+    }
+
+    size_t base = cache_mapped_strings(cache);
+    for (size_t i = base; i < cache->string_count; i++) {
+        size += strlen(cache->strings[i - base]) + 1;
+    }
+
+    size += (cache->stamp_capacity + cache->scan_stamp_capacity) * sizeof(CacheStampRecord) +
+            cache->memo_capacity * (sizeof(uint64_t) + sizeof(bool));
+
+    size += cache->graph_record_count * sizeof(CacheGraphRecord) +
+            cache->graph_include_count * sizeof(uint32_t);
+
+    if (cache->view) {
+        size += sizeof(CacheView) + cache->view->size;
+    }
+
+    return size;
+}
+
+uint64_t build_cache_file_bytes(const BuildCache *cache) {
+    if (!cache) return 0;
+
+    char cache_file[MAX_PATH_LENGTH + 32];
+    snprintf(cache_file, sizeof(cache_file), "%s/%s", cache->cache_dir, CACHE_FILENAME);
+
+    struct stat st;
+    if (stat(cache_file, &st) != 0) return 0;
+    return (uint64_t)st.st_size;
+}
@@ -21,6 +21,8 @@
 #define CACHE_METADATA_H
 
 #include "dependency_resolver.h"
+#include "path_index.h"
+#include "include/eventchains_platform.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <time.h>
@@ -34,9 +36,10 @@ extern "C" {
  * ==============================================================================
  */
 
-#define MAX_CACHE_ENTRIES 2048
-#define MAX_DEPENDENCIES_PER_FILE 128
-#define CACHE_VERSION 1
+#define CACHE_VERSION 9
+#define CACHE_MAGIC 0x48434345u                 /* "ECCH" in little endian */
+#define CACHE_STRING_NONE UINT32_MAX            /* No interned string */
+#define CACHE_INDEX_NONE UINT32_MAX             /* No mapped record */
 
 /* ==============================================================================
  * Cache Entry Structure
@@ -51,33 +54,165 @@ extern "C" {
  * - Object file location
  * - All dependencies and their hashes
  * - Timestamps for fallback
+ *
+ * Paths are ids into the cache's interned string table (see
+ * build_cache_string), so an entry costs a few dozen bytes plus 12 bytes
+ * per dependency instead of a fixed worst-case layout.
  */
 typedef struct CacheEntry {
-    char source_path[MAX_PATH_LENGTH];      /* Full path to source file */
-    char object_path[MAX_PATH_LENGTH];      /* Full path to object file */
+    uint32_t source_id;                     /* Interned path to source file */
+    uint32_t object_id;                     /* Interned path to object file */
     
-    uint64_t source_hash;                   /* Hash of source content (FNV-1a) */
+    uint64_t source_hash;                   /* Hash of source content */
     time_t source_mtime;                    /* Last modification time (fallback) */
     time_t last_compiled;                   /* When we compiled it */
+    double compile_seconds;                 /* Wall time of the last compile, 0 if unknown */
+    uint64_t peak_memory;                   /* Compiler's peak RSS in bytes, 0 if unknown */
     
     /* Transitive dependencies */
-    char dependencies[MAX_DEPENDENCIES_PER_FILE][MAX_PATH_LENGTH];
-    uint64_t dependency_hashes[MAX_DEPENDENCIES_PER_FILE];
+    uint32_t *dependency_ids;               /* Interned dependency paths */
+    uint64_t *dependency_hashes;            /* Hash of each dependency */
     size_t dependency_count;
     
     bool valid;                             /* Is this entry valid? */
+    bool exact_dependencies;                /* Dependencies came from a compiler depfile */
+    bool removed;                           /* Pruned: left out of lookups and saves */
+    uint32_t record_index;                  /* Mapped record this shadows, or CACHE_INDEX_NONE */
 } CacheEntry;
 
+/**
+ * FileStamp - Cheap file identity used before falling back to hashing
+ *
+ * If a file's stamp matches the one recorded when it was last hashed, the
+ * recorded hash is reused without reading the file. Windows has no inode
+ * through stat, so inode is 0 there and mtime has 100ns resolution.
+ */
+typedef struct FileStamp {
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t size;
+    uint64_t inode;
+} FileStamp;
+
+/**
+ * CacheStampRecord - Last known stamp and content hash of one path
+ *
+ * Kept per interned string, so one header hashed for one translation unit
+ * is free for every other unit that includes it.
+ */
+typedef struct CacheStampRecord {
+    FileStamp stamp;
+    uint64_t hash;                          /* Content hash at that stamp */
+    uint32_t flags;                         /* CACHE_STAMP_* */
+    uint32_t reserved;
+} CacheStampRecord;
+
+#define CACHE_STAMP_VALID 0x1u                  /* Stamp and hash are set */
+
+/**
+ * CacheGraphRecord - One dependency graph node from the last scan
+ *
+ * Kept per interned string like stamps. The stamp is taken before the
+ * file is scanned, so a file edited while it was being read never looks
+ * unchanged next time.
+ */
+typedef struct CacheGraphRecord {
+    FileStamp stamp;                        /* File stamp when it was scanned */
+    uint64_t include_start;                 /* First id in the include section */
+    uint32_t include_count;                 /* Number of include ids */
+    uint32_t flags;                         /* CACHE_GRAPH_* */
+} CacheGraphRecord;
+
+#define CACHE_GRAPH_SCANNED 0x1u                /* Record holds the file's includes */
+#define CACHE_GRAPH_TRANSITIVE 0x2u             /* Includes are a depfile list */
+#define CACHE_GRAPH_MAIN_KNOWN 0x4u             /* CACHE_GRAPH_MAIN is meaningful */
+#define CACHE_GRAPH_MAIN 0x8u                   /* File defines main() */
+
+/**
+ * CacheCheckMode - How needs_recompilation decides whether a file changed
+ */
+typedef enum {
+    CACHE_CHECK_STAT = 0,                   /* Trust matching stamps, hash otherwise */
+    CACHE_CHECK_CONTENT                     /* Always hash (paranoid CI builds) */
+} CacheCheckMode;
+
+/* Read-only view of a memory-mapped cache.dat (internal) */
+struct CacheView;
+
 /**
  * BuildCache - Complete persistent cache
  * 
  * Stores all compilation metadata for the project.
  * Persisted to disk as .eventchains/cache.dat
+ *
+ * On-disk layout (version 9): a fixed header with section offsets and
+ * the include-path and file-set fingerprints, the entry records, the
+ * string offset table, an entry-by-string index, an open-addressing hash
+ * table over the strings, the packed dependency ids and hashes, one stamp
+ * record per string, one graph record per string, the reverse-dependency
+ * offsets, the graph's include ids, the reverse-dependency ids, and
+ * finally the NUL-terminated string blob.
+ *
+ * The reverse-dependency index maps each string id to the ids of the
+ * files that depend on it, from entry dependencies and graph includes.
+ * It is used as mapped until entries or the graph change, then rebuilt
+ * once in memory.
+ *
+ * The file-set fingerprint identifies the graph files the entries were
+ * last pruned against (see build_cache_prune_changed); builds prune again
+ * only when it no longer matches.
+ *
+ * The file is memory-mapped and queried in place; only the pages touched
+ * by the lookups of a build are read. Entries that are updated or
+ * invalidated are copied into a heap overlay on first write, and new
+ * strings are appended after the mapped ones so ids stay stable. Saving
+ * rewrites the file from mapping + overlay and renames it into place.
  */
 typedef struct BuildCache {
     uint32_t version;                       /* Cache format version */
-    size_t entry_count;                     /* Number of entries */
-    CacheEntry entries[MAX_CACHE_ENTRIES];  /* Cache entries */
+    size_t entry_count;                     /* Mapped records plus new entries */
+    
+    CacheEntry **entries;                   /* Overlay entries (stable pointers) */
+    size_t overlay_count;                   /* Number of overlay entries */
+    size_t overlay_capacity;                /* Allocated overlay slots */
+    PathIndex entry_index;                  /* Source path -> overlay position */
+    
+    char **strings;                         /* Strings added since load */
+    size_t string_count;                    /* Total ids, mapped and added */
+    size_t string_capacity;                 /* Allocated string slots */
+    PathIndex string_index;                 /* Added string -> id */
+    
+    CacheStampRecord *stamps;               /* Re-stamped paths, indexed by id */
+    size_t stamp_capacity;                  /* Allocated stamp slots */
+    CacheCheckMode check_mode;              /* Stat-first or always-hash */
+    
+    /* Build-scoped hash memo: every path is checked at most once per
+     * build, shared by all workers (indexed by string id, not persisted) */
+    uint64_t *memo_hashes;                  /* Hash seen this build */
+    bool *memo_known;                       /* Slot filled this build */
+    size_t memo_capacity;                   /* Allocated memo slots */
+    
+    /* Dependency graph snapshot (see build_cache_record_graph) */
+    CacheGraphRecord *graph_records;        /* Recorded this run, indexed by id */
+    size_t graph_record_count;              /* Recorded slots */
+    uint32_t *graph_includes;               /* Include ids of the recorded records */
+    size_t graph_include_count;             /* Recorded include ids */
+    bool graph_recorded;                    /* Recorded snapshot replaces the mapped one */
+    bool graph_usable;                      /* Snapshot matches the graph's include paths */
+    uint64_t graph_fingerprint;             /* Include paths the snapshot was resolved with */
+    uint64_t file_set_fingerprint;          /* Graph files entries were last pruned against */
+    CacheStampRecord *scan_stamps;          /* Stamps taken before scanning, by id */
+    size_t scan_stamp_capacity;             /* Allocated scan stamp slots */
+    
+    /* Reverse dependencies, rebuilt once edges change (see
+     * build_cache_get_affected_sources) */
+    uint64_t *reverse_starts;               /* Built index: node_count + 1 offsets */
+    uint32_t *reverse_ids;                  /* Built index: dependent ids */
+    size_t reverse_node_count;              /* Ids covered by the built index */
+    bool edges_changed;                     /* Mapped index is out of date */
+    
+    struct CacheView *view;                 /* Mapped cache.dat, or NULL */
+    bool dirty;                             /* Overlay differs from disk */
     
     char cache_dir[MAX_PATH_LENGTH];        /* .eventchains directory */
     char project_dir[MAX_PATH_LENGTH];      /* Project root directory */
@@ -86,6 +221,11 @@ typedef struct BuildCache {
     size_t hits;                            /* Cache hits */
     size_t misses;                          /* Cache misses */
     size_t invalidations;                   /* Entries invalidated */
+    size_t memo_hits;                       /* File checks answered by the memo */
+
+    /* Guards entries, strings and statistics; parallel compile workers
+     * share the cache. File hashing happens outside the lock. */
+    ec_mutex_t lock;
 } BuildCache;
 
 /* ==============================================================================
@@ -111,11 +251,13 @@ BuildCache *build_cache_create(const char *project_dir);
  * 
  * Writes cache.dat to .eventchains/ directory.
  * Uses atomic write (write to temp file, then rename).
+ * Afterwards the cache maps the new file in place of its overlay and is
+ * clean, so saving again without changes writes nothing.
  * 
  * @param cache  Pointer to BuildCache
  * @return       true on success, false on error
  */
-bool build_cache_save(const BuildCache *cache);
+bool build_cache_save(BuildCache *cache);
 
 /**
  * Destroy cache and free resources
@@ -145,12 +287,50 @@ void build_cache_clear(BuildCache *cache);
  */
 CacheEntry *build_cache_find(BuildCache *cache, const char *source_path);
 
+/**
+ * Select how file changes are detected
+ * 
+ * CACHE_CHECK_STAT (the default) stats each file and only hashes it when
+ * its mtime, size or inode differ from the last hash. CACHE_CHECK_CONTENT
+ * hashes every file on every check.
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param mode   Check mode
+ */
+void build_cache_set_check_mode(BuildCache *cache, CacheCheckMode mode);
+
+/**
+ * Forget the hashes memoized during this build
+ * 
+ * A cache lives for one build, so this is only needed when the same cache
+ * is reused for another build in the same process.
+ * 
+ * @param cache  Pointer to BuildCache
+ */
+void build_cache_reset_hash_memo(BuildCache *cache);
+
+/**
+ * Current content hash of a file, checked the way dependencies are
+ * 
+ * Goes through the per-build memo and, in CACHE_CHECK_STAT mode, the
+ * recorded stamps, so a file build_cache_needs_recompilation has already
+ * looked at is not read again. Safe to call from parallel workers.
+ * 
+ * @param cache  Pointer to BuildCache (NULL hashes the file directly)
+ * @param path   File path as the build spells it
+ * @return       64-bit hash, or 0 if the file cannot be read
+ */
+uint64_t build_cache_file_hash(BuildCache *cache, const char *path);
+
 /**
  * Check if source needs recompilation using cache metadata
  * 
- * This is the core caching logic. Returns true if:
+ * This is the core caching logic. Safe to call from parallel workers as
+ * long as each source is checked and updated by only one worker at a time.
+ * Returns true if:
  * - No cache entry exists
- * - Source content changed (hash mismatch)
+ * - Source content changed (hash mismatch; only hashed when its stamp
+ *   differs, unless the cache is in CACHE_CHECK_CONTENT mode)
  * - Any dependency changed (hash mismatch)
  * - Object file doesn't exist (optional check)
  * 
@@ -165,6 +345,19 @@ bool build_cache_needs_recompilation(
     const char *object_path
 );
 
+/**
+ * Check whether a source's entry is still current, without counting it
+ * 
+ * The same check as build_cache_needs_recompilation, for looking ahead
+ * at a build (such as choosing which objects to prefetch) without
+ * touching the hit and miss statistics.
+ * 
+ * @param cache   Pointer to BuildCache
+ * @param source  Source file to check
+ * @return        true if the recorded source and dependency hashes still match
+ */
+bool build_cache_is_current(BuildCache *cache, const SourceFile *source);
+
 /**
  * Update cache entry after compilation
  * 
@@ -186,6 +379,157 @@ void build_cache_update(
     const DependencyGraph *graph
 );
 
+/**
+ * Update cache entry with an exact dependency list
+ * 
+ * Like build_cache_update, but the dependencies are given directly, e.g.
+ * read from the depfile the compiler wrote. Such entries can later stand
+ * in for an #include scan (see build_cache_include_provider).
+ * 
+ * @param cache             Pointer to BuildCache
+ * @param source_path       Path to source file
+ * @param object_path       Path to object file
+ * @param dependencies      Every file the source depends on
+ * @param dependency_count  Number of dependencies
+ */
+void build_cache_update_dependencies(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    const char *const *dependencies,
+    size_t dependency_count
+);
+
+/**
+ * Update cache entry with every file the source pulls in
+ * 
+ * Like build_cache_update, but records the whole transitive closure from
+ * the graph rather than the direct includes; for generated sources whose
+ * includes are other sources (see unity_build.h), as those sources' own
+ * includes are what usually changes.
+ * 
+ * @param cache        Pointer to BuildCache
+ * @param source_path  Path to source file
+ * @param object_path  Path to object file
+ * @param graph        Dependency graph
+ */
+void build_cache_update_closure(
+    BuildCache *cache,
+    const char *source_path,
+    const char *object_path,
+    DependencyGraph *graph
+);
+
+/**
+ * Remember how long a source took to compile and how much memory it used
+ * 
+ * The next build schedules long compiles first and can keep heavy ones
+ * from running side by side (see build_cache_get_compile_stats). Call
+ * after build_cache_update. A zero leaves the recorded value alone, so a
+ * compile that could not be measured does not erase the history.
+ * 
+ * @param cache        Pointer to BuildCache
+ * @param source_path  Path to source file
+ * @param seconds      Wall time of the compile
+ * @param peak_memory  Compiler's peak resident set in bytes
+ */
+void build_cache_record_compile(
+    BuildCache *cache,
+    const char *source_path,
+    double seconds,
+    uint64_t peak_memory
+);
+
+/**
+ * Look up the compile time and peak memory recorded for a source
+ * 
+ * @param cache        Pointer to BuildCache
+ * @param source_path  Path to source file
+ * @param seconds      Set to the recorded wall time (can be NULL)
+ * @param peak_memory  Set to the recorded peak RSS in bytes (can be NULL)
+ * @return             true if a compile time is recorded
+ */
+bool build_cache_get_compile_stats(
+    BuildCache *cache,
+    const char *source_path,
+    double *seconds,
+    uint64_t *peak_memory
+);
+
+/**
+ * IncludeProvider backed by the cache
+ * 
+ * Supplies the recorded dependency list of a source whose entry came
+ * from a depfile and whose stamp is unchanged (INCLUDES_TRANSITIVE), or
+ * else the includes and main() flag the graph snapshot recorded for an
+ * unchanged file (INCLUDES_DIRECT), so the resolver can skip parsing it.
+ * Either way the file's stamp is remembered for build_cache_record_graph.
+ * Install it with build_cache_provide_includes.
+ * 
+ * @param user_data  BuildCache
+ * @param file       File about to be scanned
+ * @return           What was provided
+ */
+IncludeProvision build_cache_include_provider(void *user_data, SourceFile *file);
+
+/**
+ * Serve a dependency graph's scans from the cache
+ * 
+ * Installs build_cache_include_provider on the graph. The graph snapshot
+ * is only used if it was resolved against the same include paths, so add
+ * those to the graph first.
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param graph  Graph about to be scanned
+ */
+void build_cache_provide_includes(BuildCache *cache, DependencyGraph *graph);
+
+/**
+ * Record a scanned graph as the snapshot for the next build
+ * 
+ * Stores every scanned file's includes and main() flag with the stamp
+ * it had before it was scanned. Files that were only registered, or
+ * whose stamp was too recent to trust, are left out and will be parsed
+ * next time. Takes effect on the next build_cache_save; a graph that
+ * matches the current snapshot leaves the cache untouched.
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param graph  Graph scanned through build_cache_include_provider
+ */
+void build_cache_record_graph(BuildCache *cache, const DependencyGraph *graph);
+
+/**
+ * Drop the entries of sources that no longer exist
+ * 
+ * An entry is kept while its source is in the graph or still on disk
+ * (generated files the scan does not see, such as precompiled headers,
+ * stay), so deleted and renamed files stop taking up the cache. The next
+ * build_cache_save leaves them out, along with every path only they (or
+ * an older scan) still named.
+ * 
+ * Every entry is checked, which reads the whole mapped file; builds use
+ * build_cache_prune_changed instead.
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param graph  Dependency graph of the project (can be NULL: disk only)
+ * @return       Number of entries dropped
+ */
+size_t build_cache_prune(BuildCache *cache, const DependencyGraph *graph);
+
+/**
+ * Drop the entries of sources that no longer exist, if the project's
+ * files have changed
+ * 
+ * Prunes only when the graph's file set differs from the one the cache
+ * was last pruned against (a fingerprint kept in the file), so a build
+ * that adds, removes or renames no file leaves the mapping untouched.
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param graph  Dependency graph of the project
+ * @return       Number of entries dropped
+ */
+size_t build_cache_prune_changed(BuildCache *cache, const DependencyGraph *graph);
+
 /**
  * Invalidate cache entry for a source file
  * 
@@ -199,17 +543,42 @@ void build_cache_invalidate(BuildCache *cache, const char *source_path);
 /**
  * Invalidate all entries that depend on a given file
  * 
- * This is used when a header changes - all sources that include it
- * need to be recompiled.
+ * This is used when a header changes - all sources that include it,
+ * directly or through other headers, need to be recompiled. Dependents
+ * are found by a breadth-first search of the reverse-dependency index,
+ * so only affected entries are visited; the graph's reverse edges add
+ * any includes scanned since the cache last recorded them.
  * 
  * @param cache       Pointer to BuildCache
  * @param changed_file Path to changed file (usually a header)
- * @param graph       Dependency graph
+ * @param graph       Dependency graph (can be NULL)
  */
 void build_cache_invalidate_dependents(
     BuildCache *cache,
     const char *changed_file,
-    const DependencyGraph *graph
+    DependencyGraph *graph
+);
+
+/**
+ * List the compiled sources a change to a file would rebuild
+ * 
+ * Answers from the reverse-dependency index alone, without scanning the
+ * project: every source with a cache entry that depends on the file,
+ * transitively, nearest first, and the file itself if it has an entry.
+ * 
+ * @param cache         Pointer to BuildCache
+ * @param changed_file  Path as the build spells it
+ * @param sources       Array to store source paths (valid until the cache is destroyed)
+ * @param max_sources   Maximum number of sources
+ * @param source_count  Pointer to store the number of sources found (may exceed max_sources)
+ * @return              true if the cache knows the file, false otherwise
+ */
+bool build_cache_get_affected_sources(
+    BuildCache *cache,
+    const char *changed_file,
+    const char **sources,
+    size_t max_sources,
+    size_t *source_count
 );
 
 /* ==============================================================================
@@ -224,6 +593,15 @@ void build_cache_invalidate_dependents(
  */
 void build_cache_print_stats(const BuildCache *cache);
 
+/**
+ * Look up an interned path
+ * 
+ * @param cache  Pointer to BuildCache
+ * @param id     String id from a CacheEntry
+ * @return       Path, or NULL if id is out of range
+ */
+const char *build_cache_string(const BuildCache *cache, uint32_t id);
+
 /**
  * Get cache hit rate
  * 
@@ -235,20 +613,33 @@ double build_cache_hit_rate(const BuildCache *cache);
 /**
  * Get cache size in bytes
  * 
+ * Counts the heap held by overlay entries, dependency lists and added
+ * strings, plus the size of the mapped cache file.
+ * 
  * @param cache  Pointer to BuildCache
  * @return       Size in bytes
  */
 size_t build_cache_size_bytes(const BuildCache *cache);
 
+/**
+ * Get the size of the saved cache file
+ *
+ * @param cache  Pointer to BuildCache
+ * @return       Size of cache.dat in bytes, or 0 if it has not been saved
+ */
+uint64_t build_cache_file_bytes(const BuildCache *cache);
+
 /* ==============================================================================
  * Utility Functions
  * ==============================================================================
  */
 
 /**
- * Hash file contents using FNV-1a
+ * Hash file contents
  * 
- * Fast, non-cryptographic hash suitable for cache validation.
+ * Fast, non-cryptographic hash suitable for cache validation; see
+ * content_hash.h. Values differ from the FNV-1a hash used before cache
+ * version 5, so older caches are discarded on load.
  * 
  * @param path  Path to file
  * @return      64-bit hash, or 0 on error
@@ -263,6 +654,15 @@ uint64_t hash_file_content(const char *path);
  */
 time_t get_file_mtime(const char *path);
 
+/**
+ * Read a file's stamp (mtime with sub-second precision, size, inode)
+ * 
+ * @param path   Path to file
+ * @param stamp  Receives the stamp
+ * @return       true on success, false if the file cannot be stat'ed
+ */
+bool file_stamp_get(const char *path, FileStamp *stamp);
+
 /**
  * Check if file exists
  * 
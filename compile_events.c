@@ -5,6 +5,11 @@
  */
 
 #include "compile_events.h"
+#include "depfile.h"
+#include "cache_metadata.h"
+#include "content_hash.h"
+#include "build_trace.h"
+#include "precompiled_header.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,6 +49,14 @@ BuildConfig *build_config_create(void) {
     config->debug = false;
     config->optimize = true;
     config->parallel_jobs = 1;
+    config->always_hash = false;
+    config->use_depfiles = false;
+    config->memory_budget = 0;
+    config->object_store_dir = NULL;
+    config->object_store_max_bytes = 0;
+    config->remote_cache_url = NULL;
+    config->remote_cache_upload = false;
+    config->dist_hosts = NULL;
     
     /* Add default flags */
     build_config_add_cflag(config, "-Wall");
@@ -60,6 +73,10 @@ void build_config_destroy(BuildConfig *config) {
     free(config->compiler_path);
     free(config->output_dir);
     free(config->output_binary);
+    free(config->object_store_dir);
+    free(config->remote_cache_url);
+    free(config->dist_hosts);
+    free(config->linker);
     
     for (size_t i = 0; i < config->cflag_count; i++) {
         free(config->cflags[i]);
@@ -152,6 +169,68 @@ bool build_config_set_output_binary(BuildConfig *config, const char *name) {
     return config->output_binary != NULL;
 }
 
+bool build_config_set_object_store(BuildConfig *config, const char *directory,
+                                   uint64_t max_bytes) {
+    if (!config) return false;
+    
+    free(config->object_store_dir);
+    config->object_store_dir = directory ? strdup(directory) : NULL;
+    config->object_store_max_bytes = max_bytes;
+    return !directory || config->object_store_dir != NULL;
+}
+
+bool build_config_set_remote_cache(BuildConfig *config, const char *url, bool upload) {
+    if (!config) return false;
+    
+    free(config->remote_cache_url);
+    config->remote_cache_url = url ? strdup(url) : NULL;
+    config->remote_cache_upload = url && upload;
+    return !url || config->remote_cache_url != NULL;
+}
+
+bool build_config_set_dist_hosts(BuildConfig *config, const char *hosts) {
+    if (!config) return false;
+    
+    free(config->dist_hosts);
+    config->dist_hosts = hosts ? strdup(hosts) : NULL;
+    return !hosts || config->dist_hosts != NULL;
+}
+
+bool build_config_set_linker(BuildConfig *config, const char *linker) {
+    if (!config) return false;
+    
+    free(config->linker);
+    config->linker = linker ? strdup(linker) : NULL;
+    return !linker || config->linker != NULL;
+}
+
+const char *build_config_detect_linker(BuildConfig *config) {
+    if (!config || config->compiler == COMPILER_MSVC) return NULL;
+    
+    /* Fastest first; each must be found and accepted by the compiler driver
+     * (GCC learned -fuse-ld=mold only in 12.1) */
+    const char *linkers[] = {"mold", "lld", "gold"};
+    const char *programs[] = {"mold", "ld.lld", "ld.gold"};
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    
+    for (size_t i = 0; i < sizeof(linkers) / sizeof(linkers[0]); i++) {
+        if (!process_find_executable(programs[i], NULL, 0)) continue;
+        
+        char fuse_ld[32];
+        snprintf(fuse_ld, sizeof(fuse_ld), "-fuse-ld=%s", linkers[i]);
+        char *const argv[] = {(char *)compiler, fuse_ld, "-Wl,--version", NULL};
+        
+        char output[1024];
+        int exit_code = 0;
+        if (process_run(argv, output, sizeof(output), &exit_code) && exit_code == 0) {
+            build_config_set_linker(config, linkers[i]);
+            return config->linker;
+        }
+    }
+    
+    return NULL;
+}
+
 bool build_config_auto_detect_compiler(BuildConfig *config) {
     if (!config) return false;
     
@@ -160,15 +239,7 @@ bool build_config_auto_detect_compiler(BuildConfig *config) {
     const CompilerType types[] = {COMPILER_GCC, COMPILER_CLANG, COMPILER_MSVC};
     
     for (size_t i = 0; i < 3; i++) {
-        char test_cmd[256];
-        
-#ifdef _WIN32
-        snprintf(test_cmd, sizeof(test_cmd), "where %s > nul 2>&1", compilers[i]);
-#else
-        snprintf(test_cmd, sizeof(test_cmd), "which %s > /dev/null 2>&1", compilers[i]);
-#endif
-        
-        if (system(test_cmd) == 0) {
+        if (process_find_executable(compilers[i], NULL, 0)) {
             config->compiler = types[i];
             config->compiler_path = strdup(compilers[i]);
             return true;
@@ -243,6 +314,131 @@ bool get_object_file_path(
     return true;
 }
 
+/**
+ * Compute the output binary path for a link
+ */
+static void link_output_path(const BuildConfig *config, const char *name,
+                             char *dest, size_t dest_size) {
+    snprintf(dest, dest_size, "%s/%s", config->output_dir, name);
+    
+#ifdef _WIN32
+    strncat(dest, ".exe", dest_size - strlen(dest) - 1);
+#endif
+}
+
+bool compile_command_build(
+    const char *source_path,
+    const char *object_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+) {
+    if (!source_path || !object_path || !config || !args) return false;
+    
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    bool ok = process_args_add(args, compiler) &&
+              process_args_add(args, "-c") &&
+              process_args_add(args, source_path) &&
+              process_args_add(args, "-o") &&
+              process_args_add(args, object_path);
+    
+    /* Add include paths */
+    for (size_t i = 0; ok && i < config->include_path_count; i++) {
+        ok = process_args_addf(args, "-I%s", config->include_paths[i]);
+    }
+    
+    /* Add compiler flags */
+    for (size_t i = 0; ok && i < config->cflag_count; i++) {
+        ok = process_args_add(args, config->cflags[i]);
+    }
+    
+    /* Headers the source starts with, already parsed */
+    const PrecompiledHeader *pch = pch_set_find(config->pch, source_path);
+    if (ok && pch) {
+        ok = pch_add_compile_flags(pch, config, args);
+    }
+    
+    /* Exact dependencies for the next build (GCC/Clang) */
+    if (ok && config->use_depfiles && config->compiler != COMPILER_MSVC) {
+        char depfile[MAX_PATH_LENGTH];
+        ok = depfile_path_for_object(object_path, depfile, sizeof(depfile)) &&
+             process_args_add(args, "-MMD") &&
+             process_args_add(args, "-MF") &&
+             process_args_add(args, depfile);
+    }
+    
+    return ok;
+}
+
+bool link_command_build(
+    const char **object_files,
+    size_t object_count,
+    const char *binary_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+) {
+    if (!object_files || !binary_path || !config || !args) return false;
+    
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    bool ok = process_args_add(args, compiler);
+    
+    /* Add all object files */
+    for (size_t i = 0; ok && i < object_count; i++) {
+        ok = process_args_add(args, object_files[i]);
+    }
+    
+    /* Output binary */
+    ok = ok && process_args_add(args, "-o") && process_args_add(args, binary_path);
+    
+    /* Linker other than the driver's default */
+    if (ok && config->linker && config->compiler != COMPILER_MSVC) {
+        ok = process_args_addf(args, "-fuse-ld=%s", config->linker);
+    }
+    
+    /* Add library paths */
+    for (size_t i = 0; ok && i < config->library_path_count; i++) {
+        ok = process_args_addf(args, "-L%s", config->library_paths[i]);
+    }
+    
+    /* Add libraries */
+    for (size_t i = 0; ok && i < config->library_count; i++) {
+        ok = process_args_addf(args, "-l%s", config->libraries[i]);
+    }
+    
+    /* Add linker flags */
+    for (size_t i = 0; ok && i < config->ldflag_count; i++) {
+        ok = process_args_add(args, config->ldflags[i]);
+    }
+    
+    return ok;
+}
+
+bool archive_command_build(
+    const char **object_files,
+    size_t object_count,
+    const char *archive_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+) {
+    if (!object_files || !archive_path || !config || !args) return false;
+    
+    bool ok;
+    if (config->compiler == COMPILER_MSVC) {
+        ok = process_args_add(args, "lib") &&
+             process_args_add(args, "/nologo") &&
+             process_args_addf(args, "/OUT:%s", archive_path);
+    } else {
+        ok = process_args_add(args, "ar") &&
+             process_args_add(args, "rcs") &&
+             process_args_add(args, archive_path);
+    }
+    
+    for (size_t i = 0; ok && i < object_count; i++) {
+        ok = process_args_add(args, object_files[i]);
+    }
+    
+    return ok;
+}
+
 bool execute_command(
     const char *command,
     char *output,
@@ -252,29 +448,17 @@ bool execute_command(
     if (!command) return false;
     
     if (output && output_size > 0) {
-        /* Capture output */
-        FILE *fp = popen(command, "r");
-        if (!fp) {
-            if (exit_code) *exit_code = -1;
-            return false;
-        }
-        
-        size_t total_read = 0;
-        while (fgets(output + total_read, output_size - total_read, fp)) {
-            total_read = strlen(output);
-            if (total_read >= output_size - 1) break;
-        }
-        
-        int status = pclose(fp);
-        if (exit_code) {
+        /* Capture output; process_run keeps draining the pipe once the
+         * buffer is full, so a chatty command never stalls on it */
 #ifdef _WIN32
-            *exit_code = status;
+        char *const argv[] = {"cmd.exe", "/c", (char *)command, NULL};
 #else
-            *exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        char *const argv[] = {"/bin/sh", "-c", (char *)command, NULL};
 #endif
-        }
-        
-        return status == 0;
+        int status = 0;
+        bool success = process_run(argv, output, output_size, &status);
+        if (exit_code) *exit_code = status;
+        return success;
     } else {
         /* Just execute */
         int status = system(command);
@@ -353,146 +537,368 @@ bool compile_source_file(
     }
     
     /* Build compile command */
-    char command[MAX_COMMAND_LENGTH];
-    int pos = 0;
-    
-    /* Compiler */
-    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
-    pos += snprintf(command + pos, sizeof(command) - pos, "%s -c %s -o %s",
-                   compiler, source->path, object_path);
-    
-    /* Add include paths */
-    for (size_t i = 0; i < config->include_path_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " -I%s",
-                       config->include_paths[i]);
-    }
-    
-    /* Add compiler flags */
-    for (size_t i = 0; i < config->cflag_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " %s",
-                       config->cflags[i]);
+    ProcessArgs args;
+    process_args_init(&args);
+    if (!compile_command_build(source->path, object_path, config, &args)) {
+        process_args_destroy(&args);
+        return false;
     }
     
     if (config->verbose) {
+        char command[MAX_COMMAND_LENGTH];
+        process_args_format(&args, command, sizeof(command));
         printf("  [COMPILE] %s\n", source->path);
         printf("            %s\n", command);
     }
     
     /* Execute compilation */
-    clock_t start = clock();
+    double start = build_clock_seconds();
+    uint64_t trace_start = build_trace_begin();
     
-    char error_output[4096] = {0};
-    int exit_code = 0;
-    bool success = execute_command(command, error_output, sizeof(error_output), &exit_code);
+    /* Verbose builds show each job's output as it arrives, tagged with
+     * its source so parallel jobs stay readable */
+    char prefix[MAX_PATH_LENGTH + 8];
+    snprintf(prefix, sizeof(prefix), "  [%s] ", source->path);
     
-    clock_t end = clock();
-    result->compile_time = (double)(end - start) / CLOCKS_PER_SEC;
-    result->exit_code = exit_code;
-    
-    if (strlen(error_output) > 0) {
-        result->error_output = strdup(error_output);
+    ProcessCapture capture = {0};
+    capture.limit = MAX_COMPILE_OUTPUT;
+    if (config->verbose) {
+        capture.echo = stderr;
+        capture.echo_prefix = prefix;
     }
-    
+    bool success = process_run_captured(args.argv, &capture);
+    process_args_destroy(&args);
+    
+    build_trace_end(trace_start, "compile", "compile", source->path);
+    result->compile_time = build_clock_seconds() - start;
+    result->exit_code = capture.exit_code;
+    result->peak_memory = capture.peak_memory;
+    result->error_output = capture.output;
     result->success = success;
     
-    if (!success && config->verbose) {
-        printf("  [FAILED] Compilation failed with exit code %d\n", exit_code);
-        if (result->error_output) {
-            printf("%s\n", result->error_output);
+    if (success) {
+        /* Output arrives through a pipe now; pass warnings on to the user,
+         * then let them go: only a failure's diagnostics are kept */
+        if (result->error_output && !capture.echo) {
+            fputs(result->error_output, stderr);
         }
+        free(result->error_output);
+        result->error_output = NULL;
+    } else if (config->verbose) {
+        printf("  [FAILED] Compilation failed with exit code %d\n", capture.exit_code);
     }
     
     return success;
 }
 
-bool link_executable(
-    const char **object_files,
-    size_t object_count,
-    const BuildConfig *config,
-    CompileResult *result
-) {
-    if (!object_files || object_count == 0 || !config || !result) {
-        return false;
+/* ==============================================================================
+ * Linking Implementation
+ * ==============================================================================
+ */
+
+/**
+ * Hash a command line; any change to the tool, inputs, order or flags
+ * changes the hash
+ */
+static uint64_t command_hash(const ProcessArgs *args) {
+    size_t length = 0;
+    for (size_t i = 0; i < args->count; i++) {
+        length += strlen(args->argv[i]) + 1;
     }
     
-    /* Initialize result */
-    memset(result, 0, sizeof(CompileResult));
-    result->success = false;
+    char *joined = malloc(length + 1);
+    if (!joined) return 0;
     
-    /* Build link command */
-    char command[MAX_COMMAND_LENGTH];
-    int pos = 0;
+    char *end = joined;
+    for (size_t i = 0; i < args->count; i++) {
+        size_t arg_length = strlen(args->argv[i]) + 1;
+        memcpy(end, args->argv[i], arg_length);
+        end += arg_length;
+    }
     
-    /* Compiler/linker */
-    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    uint64_t hash = content_hash_bytes(joined, length);
+    free(joined);
+    return hash;
+}
+
+/**
+ * The stamp beside a link output (<output>.link), recording the hash of
+ * the command that produced it
+ */
+static bool command_stamp_path(const char *output, char *dest, size_t dest_size) {
+    int written = snprintf(dest, dest_size, "%s.link", output);
+    return written > 0 && (size_t)written < dest_size;
+}
+
+static bool command_stamp_read(const char *output, uint64_t *hash) {
+    char path[MAX_PATH_LENGTH + 8];
+    if (!command_stamp_path(output, path, sizeof(path))) return false;
     
-    /* Output binary path */
-    char binary_path[MAX_PATH_LENGTH];
-    snprintf(binary_path, sizeof(binary_path), "%s/%s",
-             config->output_dir, config->output_binary);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return false;
     
-#ifdef _WIN32
-    strcat(binary_path, ".exe");
-#endif
+    unsigned long long value = 0;
+    bool ok = fscanf(fp, "%llx", &value) == 1;
+    fclose(fp);
     
-    pos += snprintf(command + pos, sizeof(command) - pos, "%s", compiler);
+    *hash = (uint64_t)value;
+    return ok;
+}
+
+static void command_stamp_write(const char *output, uint64_t hash) {
+    char path[MAX_PATH_LENGTH + 8];
+    if (!command_stamp_path(output, path, sizeof(path))) return;
+    
+    FILE *fp = fopen(path, "w");
+    if (!fp) return;
+    fprintf(fp, "%016llx\n", (unsigned long long)hash);
+    fclose(fp);
+}
+
+static bool stamp_is_newer(const FileStamp *a, const FileStamp *b) {
+    return a->mtime_sec > b->mtime_sec ||
+           (a->mtime_sec == b->mtime_sec && a->mtime_nsec > b->mtime_nsec);
+}
+
+/**
+ * Whether an output can stand instead of running its command again: it
+ * exists, no input is newer, and its stamp records the same command
+ */
+static bool output_is_current(const char *output, const char **inputs, size_t input_count,
+                              uint64_t hash) {
+    FileStamp output_stamp;
+    uint64_t recorded = 0;
+    if (!file_stamp_get(output, &output_stamp) || !command_stamp_read(output, &recorded) ||
+        recorded != hash) {
+        return false;
+    }
     
-    /* Add all object files */
-    for (size_t i = 0; i < object_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " %s", object_files[i]);
+    for (size_t i = 0; i < input_count; i++) {
+        FileStamp input_stamp;
+        if (!file_stamp_get(inputs[i], &input_stamp) ||
+            stamp_is_newer(&input_stamp, &output_stamp)) {
+            return false;
+        }
     }
     
-    /* Output binary */
-    pos += snprintf(command + pos, sizeof(command) - pos, " -o %s", binary_path);
+    return true;
+}
+
+/**
+ * Move a long command's arguments into a response file (<output>.rsp),
+ * leaving "tool @file". GCC, Clang, ar and MSVC's link and lib all read
+ * one, and a link of tens of thousands of objects cannot be spawned with
+ * them on the command line (ARG_MAX, or 32 KiB on Windows).
+ *
+ * @return  true if short_args is the command to run; false to run args
+ */
+static bool response_file_prepare(const ProcessArgs *args, const char *output,
+                                  char *rsp_path, size_t rsp_size, ProcessArgs *short_args) {
+    size_t length = 0;
+    for (size_t i = 0; i < args->count; i++) {
+        length += strlen(args->argv[i]) + 3;
+    }
+    if (length < RESPONSE_FILE_THRESHOLD || args->count < 2) return false;
     
-    /* Add library paths */
-    for (size_t i = 0; i < config->library_path_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " -L%s",
-                       config->library_paths[i]);
+    int written = snprintf(rsp_path, rsp_size, "%s.rsp", output);
+    if (written < 0 || (size_t)written >= rsp_size) return false;
+    
+    FILE *fp = fopen(rsp_path, "w");
+    if (!fp) return false;
+    
+    /* One quoted argument per line; GCC's reader takes backslash escapes,
+     * MSVC's only escapes quotes */
+    for (size_t i = 1; i < args->count; i++) {
+        fputc('"', fp);
+        for (const char *c = args->argv[i]; *c; c++) {
+#ifdef _WIN32
+            if (*c == '"') fputc('\\', fp);
+#else
+            if (*c == '"' || *c == '\\') fputc('\\', fp);
+#endif
+            fputc(*c, fp);
+        }
+        fputs("\"\n", fp);
+    }
+    if (fclose(fp) != 0) {
+        remove(rsp_path);
+        return false;
     }
     
-    /* Add libraries */
-    for (size_t i = 0; i < config->library_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " -l%s",
-                       config->libraries[i]);
+    process_args_init(short_args);
+    if (!process_args_add(short_args, args->argv[0]) ||
+        !process_args_addf(short_args, "@%s", rsp_path)) {
+        process_args_destroy(short_args);
+        remove(rsp_path);
+        return false;
     }
+    return true;
+}
+
+/**
+ * Run a link or archive command, unless its output is already current
+ *
+ * @param tag      Verbose output label
+ * @param span     Trace span name
+ * @param args     Command line
+ * @param output   File the command produces
+ * @param inputs   Files it reads
+ * @param replace  Delete the old output before running
+ */
+static bool run_output_command(
+    const char *tag,
+    const char *span,
+    const ProcessArgs *args,
+    const char *output,
+    const char **inputs,
+    size_t input_count,
+    bool replace,
+    const BuildConfig *config,
+    CompileResult *result
+) {
+    memset(result, 0, sizeof(CompileResult));
+    result->object_file = strdup(output);
     
-    /* Add linker flags */
-    for (size_t i = 0; i < config->ldflag_count; i++) {
-        pos += snprintf(command + pos, sizeof(command) - pos, " %s",
-                       config->ldflags[i]);
+    uint64_t hash = command_hash(args);
+    if (output_is_current(output, inputs, input_count, hash)) {
+        if (config->verbose) {
+            printf("  [UP TO DATE] %s\n", output);
+        }
+        result->success = true;
+        result->up_to_date = true;
+        return true;
     }
     
     if (config->verbose) {
-        printf("  [LINK] %s\n", binary_path);
-        printf("         %s\n", command);
+        char command[MAX_COMMAND_LENGTH];
+        process_args_format(args, command, sizeof(command));
+        printf("  [%s] %s\n", tag, output);
+        printf("  %*s%s\n", (int)strlen(tag) + 3, "", command);
+    }
+    
+    /* An interrupted or failed run must not leave a stamp that vouches
+     * for whatever is left of the output */
+    char stamp_path[MAX_PATH_LENGTH + 8];
+    if (command_stamp_path(output, stamp_path, sizeof(stamp_path))) {
+        remove(stamp_path);
+    }
+    if (replace) {
+        remove(output);
     }
     
-    /* Execute linking */
-    clock_t start = clock();
+    double start = build_clock_seconds();
+    uint64_t trace_start = build_trace_begin();
     
-    char error_output[4096] = {0};
-    int exit_code = 0;
-    bool success = execute_command(command, error_output, sizeof(error_output), &exit_code);
+    ProcessArgs response;
+    char rsp_path[MAX_PATH_LENGTH + 8];
+    bool use_response = response_file_prepare(args, output, rsp_path, sizeof(rsp_path),
+                                              &response);
     
-    clock_t end = clock();
-    result->compile_time = (double)(end - start) / CLOCKS_PER_SEC;
-    result->exit_code = exit_code;
+    ProcessCapture capture = {0};
+    capture.limit = MAX_COMPILE_OUTPUT;
+    bool success = process_run_captured(use_response ? response.argv : args->argv, &capture);
     
-    if (strlen(error_output) > 0) {
-        result->error_output = strdup(error_output);
+    if (use_response) {
+        remove(rsp_path);
+        process_args_destroy(&response);
     }
     
+    build_trace_end(trace_start, "link", span, output);
+    result->compile_time = build_clock_seconds() - start;
+    result->exit_code = capture.exit_code;
+    result->error_output = capture.output;
+    
     result->success = success;
-    result->object_file = strdup(binary_path);
+    if (success) {
+        command_stamp_write(output, hash);
+    } else if (config->verbose) {
+        printf("  [FAILED] %s exited with code %d\n", args->argv[0], capture.exit_code);
+    }
     
-    if (!success && config->verbose) {
-        printf("  [FAILED] Linking failed with exit code %d\n", exit_code);
-        if (result->error_output) {
-            printf("%s\n", result->error_output);
-        }
+    return success;
+}
+
+bool link_executable(
+    const char **object_files,
+    size_t object_count,
+    const BuildConfig *config,
+    CompileResult *result
+) {
+    if (!config) return false;
+    return link_executable_named(object_files, object_count, config->output_binary,
+                                 config, result);
+}
+
+bool link_executable_named(
+    const char **object_files,
+    size_t object_count,
+    const char *name,
+    const BuildConfig *config,
+    CompileResult *result
+) {
+    if (!object_files || object_count == 0 || !name || !config || !result) {
+        return false;
     }
     
+    /* Output binary path */
+    char binary_path[MAX_PATH_LENGTH];
+    link_output_path(config, name, binary_path, sizeof(binary_path));
+    
+    /* Build link command */
+    ProcessArgs args;
+    process_args_init(&args);
+    if (!link_command_build(object_files, object_count, binary_path, config, &args)) {
+        process_args_destroy(&args);
+        memset(result, 0, sizeof(CompileResult));
+        return false;
+    }
+    
+    bool success = run_output_command("LINK", "link", &args, binary_path, object_files,
+                                      object_count, false, config, result);
+    process_args_destroy(&args);
+    return success;
+}
+
+bool static_library_path(const BuildConfig *config, const char *name,
+                         char *dest, size_t dest_size) {
+    if (!config || !name || !dest) return false;
+    
+    int written = config->compiler == COMPILER_MSVC
+        ? snprintf(dest, dest_size, "%s/%s.lib", config->output_dir, name)
+        : snprintf(dest, dest_size, "%s/lib%s.a", config->output_dir, name);
+    return written > 0 && (size_t)written < dest_size;
+}
+
+bool create_static_library(
+    const char **object_files,
+    size_t object_count,
+    const char *name,
+    const BuildConfig *config,
+    CompileResult *result
+) {
+    if (!object_files || object_count == 0 || !name || !config || !result) {
+        return false;
+    }
+    
+    memset(result, 0, sizeof(CompileResult));
+    
+    char archive_path[MAX_PATH_LENGTH];
+    if (!static_library_path(config, name, archive_path, sizeof(archive_path))) {
+        return false;
+    }
+    
+    ProcessArgs args;
+    process_args_init(&args);
+    if (!archive_command_build(object_files, object_count, archive_path, config, &args)) {
+        process_args_destroy(&args);
+        return false;
+    }
+    
+    /* ar only adds and replaces members, so an archive that is rebuilt
+     * starts over and objects of deleted sources do not linger in it */
+    bool success = run_output_command("ARCHIVE", "archive", &args, archive_path, object_files,
+                                      object_count, true, config, result);
+    process_args_destroy(&args);
     return success;
 }
 
@@ -555,6 +961,7 @@ int build_project(
     DependencyErrorCode err = dependency_graph_topological_sort(graph, &order);
     if (err != DEP_SUCCESS) {
         fprintf(stderr, "Failed to determine build order\n");
+        build_order_destroy(&order);
         return 1;
     }
     
@@ -562,7 +969,11 @@ int build_project(
     printf("----------------------------------------------------------------\n");
     
     /* Compile each source file */
-    const char *object_files[1024];
+    const char **object_files = malloc((order.file_count + 1) * sizeof(const char *));
+    if (!object_files) {
+        build_order_destroy(&order);
+        return 1;
+    }
     size_t object_count = 0;
     size_t compiled_count = 0;
     size_t cached_count = 0;
@@ -591,10 +1002,14 @@ int build_project(
             for (size_t j = 0; j < object_count; j++) {
                 free((void *)object_files[j]);
             }
+            free(object_files);
+            build_order_destroy(&order);
             return 1;
         }
     }
     
+    build_order_destroy(&order);
+    
     printf("Compiled: %zu files\n", compiled_count);
     if (cached_count > 0) {
         printf("Cached: %zu files\n", cached_count);
@@ -614,6 +1029,7 @@ int build_project(
         for (size_t i = 0; i < object_count; i++) {
             free((void *)object_files[i]);
         }
+        free(object_files);
         return 1;
     }
     
@@ -634,6 +1050,7 @@ int build_project(
     for (size_t i = 0; i < object_count; i++) {
         free((void *)object_files[i]);
     }
+    free(object_files);
     
     return 0;
 }
\ No newline at end of file
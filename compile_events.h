@@ -15,13 +15,19 @@
 #define COMPILE_EVENTS_H
 
 #include "dependency_resolver.h"
+#include "process_spawn.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Defined in precompiled_header.h and unity_build.h */
+struct PchSet;
+struct UnityBuild;
+
 /* ==============================================================================
  * Configuration Constants
  * ==============================================================================
@@ -32,6 +38,8 @@ extern "C" {
 #define MAX_LIBRARY_PATHS 64
 #define MAX_LIBRARIES 64
 #define MAX_COMMAND_LENGTH 8192
+#define MAX_COMPILE_OUTPUT (1024 * 1024)  /* Diagnostics kept per compile or link */
+#define RESPONSE_FILE_THRESHOLD (16 * 1024)  /* Longer link commands go through @file */
 
 /* ==============================================================================
  * Compiler Types
@@ -81,6 +89,31 @@ typedef struct BuildConfig {
     bool debug;                                /* Debug build (-g) */
     bool optimize;                             /* Optimization (-O2) */
     int parallel_jobs;                         /* Number of parallel jobs */
+    bool always_hash;                          /* Hash every file, ignore stat stamps */
+    bool use_depfiles;                         /* Have the compiler write .d files (-MMD) */
+    bool use_pch;                              /* Precompile the headers most sources start with */
+    int unity_size;                            /* Sources per unity source (0 = no unity build) */
+    uint64_t memory_budget;                    /* Peak compiler RSS in flight, in bytes (0 = no limit) */
+    
+    /* Shared object store (see object_store.h) */
+    char *object_store_dir;                    /* Store directory, or NULL for none */
+    uint64_t object_store_max_bytes;           /* Size limit (0 for the default) */
+    char *remote_cache_url;                    /* Remote tier (see remote_cache.h), or NULL */
+    bool remote_cache_upload;                  /* Upload compiled objects to the remote */
+    
+    /* Distributed compilation (see distributed_compile.h) */
+    char *dist_hosts;                          /* Worker list, or NULL to compile locally */
+    
+    /* Linking */
+    char *linker;                              /* -fuse-ld= name, or NULL for the default */
+    
+    /* Precompiled headers of the running build (see precompiled_header.h),
+     * set while it compiles; not owned */
+    struct PchSet *pch;
+    
+    /* Unity sources of the running build (see unity_build.h), set while
+     * its chain is built; not owned */
+    struct UnityBuild *unity;
 } BuildConfig;
 
 /* ==============================================================================
@@ -94,6 +127,8 @@ typedef struct CompileResult {
     char *error_output;                        /* Compiler error output */
     int exit_code;                             /* Compiler exit code */
     double compile_time;                       /* Time taken in seconds */
+    uint64_t peak_memory;                      /* Compiler's peak RSS in bytes, 0 if unknown */
+    bool up_to_date;                           /* Output was current; nothing ran */
 } CompileResult;
 
 /* ==============================================================================
@@ -161,6 +196,48 @@ bool build_config_set_output_dir(BuildConfig *config, const char *path);
  */
 bool build_config_set_output_binary(BuildConfig *config, const char *name);
 
+/**
+ * Use a shared object store
+ * @param config     Pointer to BuildConfig
+ * @param directory  Store directory (NULL to build without one)
+ * @param max_bytes  Size limit (0 for the default)
+ * @return           true on success, false on error
+ */
+bool build_config_set_object_store(BuildConfig *config, const char *directory,
+                                   uint64_t max_bytes);
+
+/**
+ * Back the object store with a remote cache
+ * @param config  Pointer to BuildConfig
+ * @param url     Cache URL (NULL to build without one)
+ * @param upload  Upload objects this build compiles (false for read-only use)
+ * @return        true on success, false on error
+ */
+bool build_config_set_remote_cache(BuildConfig *config, const char *url, bool upload);
+
+/**
+ * Compile on remote workers
+ * @param config  Pointer to BuildConfig
+ * @param hosts   Comma-separated "host[:port][/slots]" list (NULL to compile locally)
+ * @return        true on success, false on error
+ */
+bool build_config_set_dist_hosts(BuildConfig *config, const char *hosts);
+
+/**
+ * Link with a given linker (GCC and Clang -fuse-ld=)
+ * @param config  Pointer to BuildConfig
+ * @param linker  "mold", "lld", "gold", "bfd", ... (NULL for the driver's default)
+ * @return        true on success, false on error
+ */
+bool build_config_set_linker(BuildConfig *config, const char *linker);
+
+/**
+ * Pick the fastest linker the compiler driver accepts: mold, lld, then gold
+ * @param config  Pointer to BuildConfig (compiler already detected)
+ * @return        Linker chosen, or NULL to keep the default
+ */
+const char *build_config_detect_linker(BuildConfig *config);
+
 /**
  * Auto-detect compiler
  * @param config  Pointer to BuildConfig
@@ -188,6 +265,10 @@ bool compile_source_file(
 
 /**
  * Link object files into executable
+ *
+ * Nothing is run when the binary is newer than every object and was linked
+ * by the same command line, recorded in <binary>.link; result->up_to_date
+ * is set then. create_static_library is incremental the same way.
  * @param object_files  Array of object file paths
  * @param object_count  Number of object files
  * @param config        Build configuration
@@ -201,6 +282,51 @@ bool link_executable(
     CompileResult *result
 );
 
+/**
+ * Link object files into an executable with a given name
+ * @param object_files  Array of object file and static library paths
+ * @param object_count  Number of entries
+ * @param name          Executable name, without directory or .exe
+ * @param config        Build configuration
+ * @param result        Pointer to store link result
+ * @return              true on success, false on error
+ */
+bool link_executable_named(
+    const char **object_files,
+    size_t object_count,
+    const char *name,
+    const BuildConfig *config,
+    CompileResult *result
+);
+
+/**
+ * Archive object files into a static library (lib<name>.a, or <name>.lib for MSVC)
+ * @param object_files  Array of object file paths
+ * @param object_count  Number of object files
+ * @param name          Library name, without directory, prefix or suffix
+ * @param config        Build configuration
+ * @param result        Pointer to store the result (object_file is the archive)
+ * @return              true on success, false on error
+ */
+bool create_static_library(
+    const char **object_files,
+    size_t object_count,
+    const char *name,
+    const BuildConfig *config,
+    CompileResult *result
+);
+
+/**
+ * Compute the path of a static library in the output directory
+ * @param config     Build configuration
+ * @param name       Library name
+ * @param dest       Destination buffer
+ * @param dest_size  Size of destination buffer
+ * @return           true on success, false if the path does not fit
+ */
+bool static_library_path(const BuildConfig *config, const char *name,
+                         char *dest, size_t dest_size);
+
 /**
  * Build a complete project
  * @param graph       Dependency graph
@@ -241,7 +367,60 @@ bool get_object_file_path(
 );
 
 /**
- * Execute a command and capture output
+ * Build the argv for compiling one source file
+ * @param source_path  Source file path
+ * @param object_path  Object file path
+ * @param config       Build configuration
+ * @param args         Initialized ProcessArgs to append to
+ * @return             true on success, false on allocation failure
+ */
+bool compile_command_build(
+    const char *source_path,
+    const char *object_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+);
+
+/**
+ * Build the argv for linking object files
+ * @param object_files  Array of object file paths
+ * @param object_count  Number of object files
+ * @param binary_path   Output executable path
+ * @param config        Build configuration
+ * @param args          Initialized ProcessArgs to append to
+ * @return              true on success, false on allocation failure
+ */
+bool link_command_build(
+    const char **object_files,
+    size_t object_count,
+    const char *binary_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+);
+
+/**
+ * Build the argv for archiving object files (ar rcs, or lib for MSVC)
+ * @param object_files  Array of object file paths
+ * @param object_count  Number of object files
+ * @param archive_path  Output library path
+ * @param config        Build configuration
+ * @param args          Initialized ProcessArgs to append to
+ * @return              true on success, false on allocation failure
+ */
+bool archive_command_build(
+    const char **object_files,
+    size_t object_count,
+    const char *archive_path,
+    const BuildConfig *config,
+    ProcessArgs *args
+);
+
+/**
+ * Execute a shell command and capture its output (stdout and stderr)
+ * 
+ * Goes through /bin/sh (cmd.exe on Windows); compiles and links use
+ * process_run with an argv instead.
+ * 
  * @param command      Command to execute
  * @param output       Buffer for output (can be NULL)
  * @param output_size  Size of output buffer
@@ -0,0 +1,524 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Content Hashing Implementation
+ * ==============================================================================
+ */
+
+#include "content_hash.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+/* ==============================================================================
+ * Implementation Selection
+ * ==============================================================================
+ */
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define CONTENT_HASH_BIG_ENDIAN 1
+#else
+    #define CONTENT_HASH_BIG_ENDIAN 0
+#endif
+
+#if !CONTENT_HASH_BIG_ENDIAN && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define CONTENT_HASH_SSE2 1
+    #include <emmintrin.h>
+#elif !CONTENT_HASH_BIG_ENDIAN && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define CONTENT_HASH_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define PRIME32_1 0x9E3779B1U
+#define PRIME32_2 0x85EBCA77U
+#define PRIME32_3 0xC2B2AE3DU
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+#define STRIPE_LEN 64                           /* Bytes per accumulate step */
+#define STRIPES_PER_BLOCK 16                    /* Stripes between scrambles */
+#define BLOCK_LEN (STRIPE_LEN * STRIPES_PER_BLOCK)
+#define SHORT_MAX_LEN 240                       /* Longest input on the short path */
+#define SECRET_WORDS 24
+#define SECRET_SCRAMBLE 16                      /* Word offset used by scramble */
+#define SECRET_LAST_STRIPE 11                   /* Word offset for the final stripe */
+#define READ_BUFFER_SIZE (16 * 1024)            /* Files up to this size are read, not mapped */
+
+/* Key material; stripe n reads words [n, n+8), so windows overlap like XXH3 */
+static const uint64_t SECRET[SECRET_WORDS] = {
+    0x4c313ca34261c5c7ULL, 0x92942a143c2e40a6ULL, 0x2f5c5f100d3a055aULL,
+    0xaafeaa9255548d92ULL, 0x4e490ba3d0b54472ULL, 0x881faf59a1434fecULL,
+    0xf2006cdb9d4b10c3ULL, 0x80d5cfded98aad17ULL, 0xda752325770365edULL,
+    0x7771292735b5904cULL, 0x17d95ae64fcdf08cULL, 0x000c143fa1370d21ULL,
+    0x7661aabc80ed6f84ULL, 0x6cde66dff420f0dcULL, 0x21c0b210fd9395b0ULL,
+    0xeabfc29eb4f728d3ULL, 0x383a7e422e78525cULL, 0x3d883b8473130c5eULL,
+    0x14d477ee41ce90caULL, 0xdde699550dc96ba4ULL, 0x92928870887532c4ULL,
+    0x13317910ba090dbfULL, 0x43d36b5badd850c3ULL, 0x7c19933a4d74adadULL,
+};
+
+/* ==============================================================================
+ * Scalar Primitives
+ * ==============================================================================
+ */
+
+static inline uint64_t read64le(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if CONTENT_HASH_BIG_ENDIAN
+    v = ((v & 0x00000000000000FFULL) << 56) | ((v & 0x000000000000FF00ULL) << 40) |
+        ((v & 0x0000000000FF0000ULL) << 24) | ((v & 0x00000000FF000000ULL) << 8) |
+        ((v & 0x000000FF00000000ULL) >> 8)  | ((v & 0x0000FF0000000000ULL) >> 24) |
+        ((v & 0x00FF000000000000ULL) >> 40) | ((v & 0xFF00000000000000ULL) >> 56);
+#endif
+    return v;
+}
+
+/**
+ * 64x64->128 multiply, folded to 64 bits by xoring the halves
+ */
+static inline uint64_t mul128_fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFULL);
+    uint64_t lo_hi = (a & 0xFFFFFFFFULL) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint64_t mix16(const uint8_t *p, uint64_t s0, uint64_t s1) {
+    return mul128_fold64(read64le(p) ^ s0, read64le(p + 8) ^ s1);
+}
+
+/* Accumulate nb_stripes consecutive stripes; stripe n uses secret + n */
+typedef void (*accumulate_func)(uint64_t *acc, const uint8_t *input,
+                                const uint64_t *secret, size_t nb_stripes);
+typedef void (*scramble_func)(uint64_t *acc, const uint64_t *secret);
+
+static void accumulate_scalar(uint64_t *acc, const uint8_t *input,
+                              const uint64_t *secret, size_t nb_stripes) {
+    for (size_t n = 0; n < nb_stripes; n++) {
+        const uint8_t *stripe = input + n * STRIPE_LEN;
+        for (size_t i = 0; i < 8; i++) {
+            uint64_t data = read64le(stripe + 8 * i);
+            uint64_t key = data ^ secret[n + i];
+            acc[i ^ 1] += data;
+            acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+        }
+    }
+}
+
+static void scramble_scalar(uint64_t *acc, const uint64_t *secret) {
+    for (size_t i = 0; i < 8; i++) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= secret[i];
+        a *= PRIME32_1;
+        acc[i] = a;
+    }
+}
+
+/* ==============================================================================
+ * Vector Primitives
+ * ==============================================================================
+ */
+
+#if defined(CONTENT_HASH_SSE2)
+
+static void accumulate_sse2(uint64_t *acc, const uint8_t *input,
+                            const uint64_t *secret, size_t nb_stripes) {
+    __m128i a[4];
+    for (size_t i = 0; i < 4; i++) a[i] = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+
+    for (size_t n = 0; n < nb_stripes; n++) {
+        const uint8_t *stripe = input + n * STRIPE_LEN;
+        const uint64_t *key_words = secret + n;
+        for (size_t i = 0; i < 4; i++) {
+            __m128i data = _mm_loadu_si128((const __m128i *)(stripe + 16 * i));
+            __m128i key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i *)(key_words + 2 * i)));
+            __m128i key_hi = _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i product = _mm_mul_epu32(key, key_hi);
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            a[i] = _mm_add_epi64(a[i], swapped);
+            a[i] = _mm_add_epi64(a[i], product);
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++) _mm_storeu_si128((__m128i *)(acc + 2 * i), a[i]);
+}
+
+static void scramble_sse2(uint64_t *acc, const uint64_t *secret) {
+    const __m128i prime = _mm_set1_epi32((int)PRIME32_1);
+    for (size_t i = 0; i < 4; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *)(secret + 2 * i)));
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        a = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        _mm_storeu_si128((__m128i *)(acc + 2 * i), a);
+    }
+}
+
+#define accumulate_vector accumulate_sse2
+#define scramble_vector scramble_sse2
+#define CONTENT_HASH_IMPL "sse2"
+
+#elif defined(CONTENT_HASH_NEON)
+
+static void accumulate_neon(uint64_t *acc, const uint8_t *input,
+                            const uint64_t *secret, size_t nb_stripes) {
+    uint64x2_t a[4];
+    for (size_t i = 0; i < 4; i++) a[i] = vld1q_u64(acc + 2 * i);
+
+    for (size_t n = 0; n < nb_stripes; n++) {
+        const uint8_t *stripe = input + n * STRIPE_LEN;
+        const uint64_t *key_words = secret + n;
+        for (size_t i = 0; i < 4; i++) {
+            uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(stripe + 16 * i));
+            uint64x2_t key = veorq_u64(data, vld1q_u64(key_words + 2 * i));
+            uint64x2_t product = vmull_u32(vmovn_u64(key), vshrn_n_u64(key, 32));
+            uint64x2_t swapped = vextq_u64(data, data, 1);
+            a[i] = vaddq_u64(a[i], swapped);
+            a[i] = vaddq_u64(a[i], product);
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++) vst1q_u64(acc + 2 * i, a[i]);
+}
+
+static void scramble_neon(uint64_t *acc, const uint64_t *secret) {
+    const uint32x2_t prime = vdup_n_u32(PRIME32_1);
+    for (size_t i = 0; i < 4; i++) {
+        uint64x2_t a = vld1q_u64(acc + 2 * i);
+        a = veorq_u64(a, vshrq_n_u64(a, 47));
+        a = veorq_u64(a, vld1q_u64(secret + 2 * i));
+        uint64x2_t hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+        a = vmlal_u32(hi, vmovn_u64(a), prime);
+        vst1q_u64(acc + 2 * i, a);
+    }
+}
+
+#define accumulate_vector accumulate_neon
+#define scramble_vector scramble_neon
+#define CONTENT_HASH_IMPL "neon"
+
+#else
+
+#define accumulate_vector accumulate_scalar
+#define scramble_vector scramble_scalar
+#define CONTENT_HASH_IMPL "scalar"
+
+#endif
+
+/* ==============================================================================
+ * Hash Core
+ * ==============================================================================
+ */
+
+static uint64_t hash_short(const uint8_t *p, size_t len) {
+    uint64_t acc = (uint64_t)len * PRIME64_1;
+
+    if (len == 0) {
+        return avalanche(acc ^ SECRET[0] ^ SECRET[1]);
+    }
+
+    if (len < 16) {
+        uint8_t buffer[16] = {0};
+        memcpy(buffer, p, len);
+        return avalanche(acc + mix16(buffer, SECRET[0], SECRET[1]));
+    }
+
+    size_t chunk = 0;
+    for (size_t i = 0; i + 16 <= len; i += 16, chunk++) {
+        size_t word = (chunk % 11) * 2;
+        acc += mix16(p + i, SECRET[word], SECRET[word + 1]);
+    }
+
+    /* Overlapping final chunk covers any tail */
+    if (len % 16 != 0) {
+        acc += mix16(p + len - 16, SECRET[22], SECRET[23]);
+    }
+
+    return avalanche(acc);
+}
+
+static uint64_t hash_long(const uint8_t *p, size_t len,
+                          accumulate_func accumulate, scramble_func scramble) {
+    uint64_t acc[8] = {
+        PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+        PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+    };
+
+    size_t nb_blocks = (len - 1) / BLOCK_LEN;
+    for (size_t b = 0; b < nb_blocks; b++) {
+        accumulate(acc, p + b * BLOCK_LEN, SECRET, STRIPES_PER_BLOCK);
+        scramble(acc, SECRET + SECRET_SCRAMBLE);
+    }
+
+    /* Last partial block, then the final (possibly overlapping) stripe */
+    size_t nb_stripes = ((len - 1) - nb_blocks * BLOCK_LEN) / STRIPE_LEN;
+    accumulate(acc, p + nb_blocks * BLOCK_LEN, SECRET, nb_stripes);
+    accumulate(acc, p + len - STRIPE_LEN, SECRET + SECRET_LAST_STRIPE, 1);
+
+    uint64_t result = (uint64_t)len * PRIME64_1;
+    for (size_t i = 0; i < 4; i++) {
+        result += mul128_fold64(acc[2 * i] ^ SECRET[2 * i + 1], acc[2 * i + 1] ^ SECRET[2 * i + 2]);
+    }
+    return avalanche(result);
+}
+
+/* ==============================================================================
+ * Public API Implementation
+ * ==============================================================================
+ */
+
+uint64_t content_hash_bytes(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    if (len <= SHORT_MAX_LEN) return hash_short(p, len);
+    return hash_long(p, len, accumulate_vector, scramble_vector);
+}
+
+uint64_t content_hash_bytes_scalar(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    if (len <= SHORT_MAX_LEN) return hash_short(p, len);
+    return hash_long(p, len, accumulate_scalar, scramble_scalar);
+}
+
+uint64_t content_hash_fnv1a(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+const char *content_hash_implementation(void) {
+    return CONTENT_HASH_IMPL;
+}
+
+/* ==============================================================================
+ * SHA-256 (FIPS 180-4)
+ * ==============================================================================
+ */
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr32(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void sha256_block(uint32_t *state, const uint8_t *block) {
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 |
+               (uint32_t)block[4 * i + 2] << 8 | (uint32_t)block[4 * i + 3];
+    }
+    for (size_t i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (size_t i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) +
+                      ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) +
+                      ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void content_hash_sha256(const void *data, size_t len, uint8_t digest[32]) {
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    const uint8_t *p = (const uint8_t *)data;
+
+    size_t full = len / 64 * 64;
+    for (size_t i = 0; i < full; i += 64) {
+        sha256_block(state, p + i);
+    }
+
+    /* Final one or two blocks: the tail, 0x80, zeros, then the bit length */
+    uint8_t tail[128] = {0};
+    size_t rest = len - full;
+    if (rest > 0) memcpy(tail, p + full, rest);
+    tail[rest] = 0x80;
+    size_t tail_len = rest < 56 ? 64 : 128;
+    uint64_t bits = (uint64_t)len * 8;
+    for (size_t i = 0; i < 8; i++) {
+        tail[tail_len - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    sha256_block(state, tail);
+    if (tail_len == 128) sha256_block(state, tail + 64);
+
+    for (size_t i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)state[i];
+    }
+}
+
+/* 0 is reserved for "cannot read" */
+static uint64_t content_hash_nonzero(const void *data, size_t len) {
+    uint64_t hash = content_hash_bytes(data, len);
+    return hash == 0 ? 1 : hash;
+}
+
+#ifdef _WIN32
+
+uint64_t content_hash_file(const char *path) {
+    if (!path) return 0;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < 0) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    uint64_t hash = 0;
+    if (size.QuadPart <= READ_BUFFER_SIZE) {
+        uint8_t buffer[READ_BUFFER_SIZE];
+        DWORD bytes = 0;
+        if (ReadFile(file, buffer, (DWORD)size.QuadPart, &bytes, NULL)) {
+            hash = content_hash_nonzero(buffer, bytes);
+        }
+    } else {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view) {
+                hash = content_hash_nonzero(view, (size_t)size.QuadPart);
+                UnmapViewOfFile(view);
+            }
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+    return hash;
+}
+
+#else
+
+/**
+ * Read up to len bytes, retrying short reads
+ */
+static bool read_fully(int fd, uint8_t *buffer, size_t len, size_t *got) {
+    *got = 0;
+    while (*got < len) {
+        ssize_t bytes = read(fd, buffer + *got, len - *got);
+        if (bytes < 0) return false;
+        if (bytes == 0) break;
+        *got += (size_t)bytes;
+    }
+    return true;
+}
+
+uint64_t content_hash_file(const char *path) {
+    if (!path) return 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    uint64_t hash = 0;
+    size_t got;
+
+    if (size <= READ_BUFFER_SIZE) {
+        uint8_t buffer[READ_BUFFER_SIZE];
+        if (read_fully(fd, buffer, size, &got)) {
+            hash = content_hash_nonzero(buffer, got);
+        }
+    } else {
+        void *view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            posix_madvise(view, size, POSIX_MADV_SEQUENTIAL);
+            hash = content_hash_nonzero(view, size);
+            munmap(view, size);
+        } else {
+            /* Some filesystems cannot be mapped; read the whole file */
+            uint8_t *buffer = malloc(size);
+            if (buffer && read_fully(fd, buffer, size, &got)) {
+                hash = content_hash_nonzero(buffer, got);
+            }
+            free(buffer);
+        }
+    }
+
+    close(fd);
+    return hash;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Content Hashing
+ * ==============================================================================
+ *
+ * Fast non-cryptographic 64-bit hash used to detect changed sources.
+ *
+ * The hash follows the XXH3 long-input design: 64-byte stripes feed eight
+ * 64-bit accumulators with a 32x32->64 multiply per lane, accumulators are
+ * scrambled every 1 KB block, and short inputs take a 128-bit multiply
+ * path. The SSE2 and NEON paths process a stripe in 4 vector ops and
+ * produce exactly the same values as the portable scalar path, so a
+ * cache written on one machine reads the same on another.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hash a buffer (vectorized where available)
+ *
+ * @param data  Bytes to hash (may be NULL when len is 0)
+ * @param len   Number of bytes
+ * @return      64-bit hash
+ */
+uint64_t content_hash_bytes(const void *data, size_t len);
+
+/**
+ * Hash a buffer with the portable scalar implementation
+ *
+ * Always equal to content_hash_bytes; exposed for tests and benchmarks.
+ *
+ * @param data  Bytes to hash
+ * @param len   Number of bytes
+ * @return      64-bit hash
+ */
+uint64_t content_hash_bytes_scalar(const void *data, size_t len);
+
+/**
+ * Hash a buffer with byte-at-a-time FNV-1a
+ *
+ * The content hash used by cache versions before 5; kept for comparison.
+ *
+ * @param data  Bytes to hash
+ * @param len   Number of bytes
+ * @return      64-bit hash
+ */
+uint64_t content_hash_fnv1a(const void *data, size_t len);
+
+/**
+ * SHA-256 of a buffer
+ *
+ * Much slower than content_hash_bytes; used where a key is shared with
+ * other machines and tools, such as remote cache digests.
+ *
+ * @param data    Bytes to hash (may be NULL when len is 0)
+ * @param len     Number of bytes
+ * @param digest  Receives the 32-byte digest
+ */
+void content_hash_sha256(const void *data, size_t len, uint8_t digest[32]);
+
+/**
+ * Hash a file's contents
+ *
+ * Small files are read with a single read into a stack buffer; larger
+ * ones are memory-mapped so the hash streams straight from the page
+ * cache without an intermediate copy.
+ *
+ * @param path  Path to file
+ * @return      64-bit hash (never 0), or 0 if the file cannot be read
+ */
+uint64_t content_hash_file(const char *path);
+
+/**
+ * Name of the implementation content_hash_bytes dispatches to
+ *
+ * @return  "sse2", "neon" or "scalar"
+ */
+const char *content_hash_implementation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTENT_HASH_H */
@@ -77,31 +77,37 @@ int main(int argc, char **argv) {
         printf("Found main() in: %s\n\n", main_file->path);
         
         /* Get all dependencies of main */
-        SourceFile *deps[MAX_SOURCE_FILES];
-        size_t dep_count;
-        dependency_graph_get_all_dependencies(graph, main_file, deps,
-                                             MAX_SOURCE_FILES, &dep_count);
+        SourceFile **deps = malloc((graph->file_count + 1) * sizeof(SourceFile *));
+        size_t dep_count = 0;
+        if (deps) {
+            dependency_graph_get_all_dependencies(graph, main_file, deps,
+                                                 graph->file_count, &dep_count);
+        }
         
         printf("  Main's dependencies (%zu):\n", dep_count);
         for (size_t i = 0; i < dep_count; i++) {
             printf("    - %s\n", deps[i]->path);
         }
         printf("\n");
+        free(deps);
     }
     
     /* Find library files */
     printf("Phase 5: Library Detection\n");
     printf("--------------------------------\n");
     
-    SourceFile *lib_files[MAX_SOURCE_FILES];
-    size_t lib_count;
-    dependency_graph_find_libraries(graph, lib_files, MAX_SOURCE_FILES, &lib_count);
+    SourceFile **lib_files = malloc((graph->file_count + 1) * sizeof(SourceFile *));
+    size_t lib_count = 0;
+    if (lib_files) {
+        dependency_graph_find_libraries(graph, lib_files, graph->file_count, &lib_count);
+    }
     
     printf("  Found %zu library file(s):\n", lib_count);
     for (size_t i = 0; i < lib_count; i++) {
         printf("    - %s\n", lib_files[i]->path);
     }
     printf("\n");
+    free(lib_files);
     
     /* Topological sort */
     printf("Phase 6: Build Order Determination\n");
@@ -112,6 +118,7 @@ int main(int argc, char **argv) {
     if (err != DEP_SUCCESS) {
         fprintf(stderr, "Failed to determine build order: %s\n",
                 dependency_error_string(err));
+        build_order_destroy(&order);
         dependency_graph_destroy(graph);
         return 1;
     }
@@ -151,6 +158,7 @@ int main(int argc, char **argv) {
     printf("gcc build/*.o -o build/program\n");
     
     /* Cleanup */
+    build_order_destroy(&order);
     dependency_graph_destroy(graph);
     
     return 0;
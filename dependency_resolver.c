@@ -4,7 +4,13 @@
  * ==============================================================================
  */
 
+/* d_type and the DT_* constants of <dirent.h> */
+#define _DEFAULT_SOURCE
+
 #include "dependency_resolver.h"
+#include "arena.h"
+#include "build_trace.h"
+#include "include/eventchains_platform.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -112,34 +118,115 @@ static bool file_exists(const char *path) {
 }
 
 /**
- * Resolve an include path relative to include directories
+ * IncludeMemo - Include resolutions, shared by every file of a graph
+ *
+ * Keyed by "<including directory>\n<include name>"; the directory part is
+ * empty for <...> includes, which do not depend on the including file.
+ * Names that resolve nowhere (most system headers) are stored too, so
+ * each distinct include costs its stat probes once per graph.
  */
-static bool resolve_include(
+struct IncludeMemo {
+    char **keys;                              /* Owned keys */
+    char **resolved;                          /* Resolved path, NULL if not found */
+    size_t count;                             /* Number of entries */
+    size_t capacity;                          /* Allocated entries */
+    PathIndex index;                          /* Key -> entry */
+    size_t lookups;                           /* resolve_include calls */
+    size_t probes;                            /* Files stat'ed to answer them */
+    ec_mutex_t mutex;                         /* Scan workers resolve in parallel */
+};
+
+static struct IncludeMemo *include_memo_create(void) {
+    struct IncludeMemo *memo = calloc(1, sizeof(struct IncludeMemo));
+    if (!memo) return NULL;
+
+    path_index_init(&memo->index);
+    if (ec_mutex_init(&memo->mutex) != 0) {
+        free(memo);
+        return NULL;
+    }
+    return memo;
+}
+
+/**
+ * Forget every resolution (called with mutex held, or single-threaded)
+ */
+static void include_memo_clear(struct IncludeMemo *memo) {
+    for (size_t i = 0; i < memo->count; i++) {
+        free(memo->keys[i]);
+        free(memo->resolved[i]);
+    }
+    memo->count = 0;
+    path_index_clear(&memo->index);
+}
+
+static void include_memo_destroy(struct IncludeMemo *memo) {
+    if (!memo) return;
+
+    include_memo_clear(memo);
+    free(memo->keys);
+    free(memo->resolved);
+    path_index_destroy(&memo->index);
+    ec_mutex_destroy(&memo->mutex);
+    free(memo);
+}
+
+/**
+ * Remember a resolution (called with mutex held); failures only cost a
+ * repeated lookup later
+ */
+static void include_memo_store(struct IncludeMemo *memo, const char *key, const char *resolved) {
+    if (path_index_find(&memo->index, key) != PATH_INDEX_NONE) return;
+
+    if (memo->count >= memo->capacity) {
+        size_t new_capacity = memo->capacity == 0 ? 64 : memo->capacity * 2;
+        char **new_keys = realloc(memo->keys, new_capacity * sizeof(char *));
+        if (!new_keys) return;
+        memo->keys = new_keys;
+        char **new_resolved = realloc(memo->resolved, new_capacity * sizeof(char *));
+        if (!new_resolved) return;
+        memo->resolved = new_resolved;
+        memo->capacity = new_capacity;
+    }
+
+    char *key_copy = strdup(key);
+    char *resolved_copy = resolved ? strdup(resolved) : NULL;
+    if (!key_copy || (resolved && !resolved_copy) ||
+        !path_index_insert(&memo->index, key_copy, memo->count)) {
+        free(key_copy);
+        free(resolved_copy);
+        return;
+    }
+
+    memo->keys[memo->count] = key_copy;
+    memo->resolved[memo->count] = resolved_copy;
+    memo->count++;
+}
+
+/**
+ * Search for an include on disk: the including file's directory for
+ * "..." includes, then the include paths, then the current directory
+ */
+static bool probe_include(
     const DependencyGraph *graph,
     const char *include_name,
-    const char *referencing_file,
+    const char *dir,
     char *resolved_path,
-    size_t path_size
+    size_t path_size,
+    size_t *probes
 ) {
-    /* Try as absolute or relative to referencing file */
-    if (include_name[0] == '"') {
-        /* Local include - try relative to referencing file */
-        char dir[MAX_PATH_LENGTH];
-        strncpy(dir, referencing_file, MAX_PATH_LENGTH - 1);
-        dir[MAX_PATH_LENGTH - 1] = '\0';
-
-        char *last_slash = strrchr(dir, '/');
-        if (last_slash) {
-            *(last_slash + 1) = '\0';
-            snprintf(resolved_path, path_size, "%s%s", dir, include_name);
-            if (file_exists(resolved_path)) {
-                return true;
-            }
+    /* Local include - try relative to referencing file */
+    if (dir[0]) {
+        (*probes)++;
+        snprintf(resolved_path, path_size, "%s%s", dir, include_name);
+        if (file_exists(resolved_path)) {
+            return true;
         }
     }
 
     /* Try include paths */
     for (size_t i = 0; i < graph->include_path_count; i++) {
+        (*probes)++;
         snprintf(resolved_path, path_size, "%s/%s",
                 graph->include_paths[i], include_name);
         if (file_exists(resolved_path)) {
@@ -148,6 +235,7 @@ static bool resolve_include(
     }
 
     /* Try current directory */
+    (*probes)++;
     if (file_exists(include_name)) {
         strncpy(resolved_path, include_name, path_size - 1);
         resolved_path[path_size - 1] = '\0';
@@ -157,73 +245,217 @@ static bool resolve_include(
     return false;
 }
 
+/**
+ * Resolve an include path relative to include directories
+ */
+static bool resolve_include(
+    const DependencyGraph *graph,
+    const char *include_name,
+    bool quoted,
+    const char *referencing_file,
+    char *resolved_path,
+    size_t path_size
+) {
+    /* Directory of the referencing file, with its trailing separator */
+    char dir[MAX_PATH_LENGTH] = "";
+    if (quoted) {
+        const char *slash = strrchr(referencing_file, '/');
+        const char *backslash = strrchr(referencing_file, '\\');
+        if (backslash > slash) slash = backslash;
+        if (slash) {
+            snprintf(dir, sizeof(dir), "%.*s", (int)(slash - referencing_file + 1),
+                     referencing_file);
+        }
+    }
+
+    struct IncludeMemo *memo = graph->include_memo;
+    char key[MAX_PATH_LENGTH * 2];
+    int key_length = snprintf(key, sizeof(key), "%s\n%s", dir, include_name);
+    bool memoize = memo && key_length > 0 && (size_t)key_length < sizeof(key);
+
+    if (memoize) {
+        ec_mutex_lock(&memo->mutex);
+        memo->lookups++;
+        size_t idx = path_index_find(&memo->index, key);
+        if (idx != PATH_INDEX_NONE) {
+            const char *known = memo->resolved[idx];
+            if (known) snprintf(resolved_path, path_size, "%s", known);
+            ec_mutex_unlock(&memo->mutex);
+            return known != NULL;
+        }
+        ec_mutex_unlock(&memo->mutex);
+    }
+
+    size_t probes = 0;
+    bool found = probe_include(graph, include_name, dir, resolved_path, path_size, &probes);
+
+    if (memoize) {
+        ec_mutex_lock(&memo->mutex);
+        memo->probes += probes;
+        include_memo_store(memo, key, found ? resolved_path : NULL);
+        ec_mutex_unlock(&memo->mutex);
+    }
+    return found;
+}
+
 /* ==============================================================================
- * Source File Management
+ * Graph Storage
  * ==============================================================================
  */
 
+#define INCLUDE_MIN_CAPACITY 4
+
 /**
- * Create a new source file
+ * GraphStore - Arena plus path interning for one graph
+ *
+ * Scan workers add includes in parallel, so every allocation takes the
+ * mutex; the arena itself is single-threaded.
  */
-static SourceFile *source_file_create(const char *path) {
-    SourceFile *file = malloc(sizeof(SourceFile));
-    if (!file) return NULL;
+struct GraphStore {
+    Arena arena;                              /* Nodes, include arrays, strings */
+    const char **strings;                     /* Interned strings, by id */
+    size_t string_count;                      /* Number of interned strings */
+    size_t string_capacity;                   /* Allocated string slots */
+    PathIndex string_index;                   /* String -> id */
+    ec_mutex_t mutex;
+};
 
-    normalize_path(file->path, path, MAX_PATH_LENGTH);
-    file->include_count = 0;
-    file->is_header = is_header_file(path);
-    file->visited = false;
-    file->in_stack = false;
-    file->sort_order = -1;
+static struct GraphStore *graph_store_create(void) {
+    struct GraphStore *store = calloc(1, sizeof(struct GraphStore));
+    if (!store) return NULL;
 
-    return file;
+    arena_init(&store->arena);
+    path_index_init(&store->string_index);
+    if (ec_mutex_init(&store->mutex) != 0) {
+        free(store);
+        return NULL;
+    }
+    return store;
+}
+
+static void graph_store_destroy(struct GraphStore *store) {
+    if (!store) return;
+
+    arena_destroy(&store->arena);
+    free(store->strings);
+    path_index_destroy(&store->string_index);
+    ec_mutex_destroy(&store->mutex);
+    free(store);
 }
 
 /**
- * Destroy a source file
+ * Intern a string (called with mutex held)
  */
-static void source_file_destroy(SourceFile *file) {
-    if (!file) return;
+static const char *graph_store_intern_locked(struct GraphStore *store, const char *str) {
+    size_t id = path_index_find(&store->string_index, str);
+    if (id != PATH_INDEX_NONE) return store->strings[id];
+
+    if (store->string_count >= store->string_capacity) {
+        size_t new_capacity = store->string_capacity == 0 ? 256 : store->string_capacity * 2;
+        const char **new_strings = realloc(store->strings, new_capacity * sizeof(char *));
+        if (!new_strings) return NULL;
+        store->strings = new_strings;
+        store->string_capacity = new_capacity;
+    }
 
-    for (size_t i = 0; i < file->include_count; i++) {
-        free(file->includes[i]);
+    char *copy = arena_strdup(&store->arena, str);
+    if (!copy || !path_index_insert(&store->string_index, copy, store->string_count)) {
+        return NULL;
     }
+    store->strings[store->string_count++] = copy;
+    return copy;
+}
 
-    free(file);
+/* ==============================================================================
+ * Source File Management
+ * ==============================================================================
+ */
+
+/**
+ * Create a new source file in a graph's storage
+ */
+static SourceFile *source_file_create(struct GraphStore *store, const char *path) {
+    char normalized[MAX_PATH_LENGTH];
+    normalize_path(normalized, path, MAX_PATH_LENGTH);
+
+    ec_mutex_lock(&store->mutex);
+    SourceFile *file = arena_alloc(&store->arena, sizeof(SourceFile));
+    const char *interned = file ? graph_store_intern_locked(store, normalized) : NULL;
+    ec_mutex_unlock(&store->mutex);
+    if (!interned) return NULL;
+
+    /* arena_alloc zeroes: no includes, nothing scanned or visited */
+    file->path = interned;
+    file->store = store;
+    file->is_header = is_header_file(path);
+    file->sort_order = -1;
+
+    return file;
 }
 
 /**
- * Add an include to a source file
+ * Drop every recorded include (the array is kept for reuse)
  */
-static DependencyErrorCode source_file_add_include(
+static void source_file_clear_includes(SourceFile *file) {
+    file->include_count = 0;
+}
+
+DependencyErrorCode source_file_add_include(
     SourceFile *file,
     const char *include_path
 ) {
-    if (!file || !include_path) return DEP_ERROR_NULL_POINTER;
-
-    if (file->include_count >= MAX_INCLUDES_PER_FILE) {
-        return DEP_ERROR_TOO_MANY_INCLUDES;
+    if (!file || !include_path || !file->store) return DEP_ERROR_NULL_POINTER;
+
+    struct GraphStore *store = file->store;
+    ec_mutex_lock(&store->mutex);
+
+    if (file->include_count >= file->include_capacity) {
+        /* The old array stays in the arena; growth is geometric, so the
+         * waste is bounded by the final array size */
+        size_t new_capacity = file->include_capacity == 0 ? INCLUDE_MIN_CAPACITY
+                                                          : file->include_capacity * 2;
+        const char **new_includes = arena_alloc(&store->arena, new_capacity * sizeof(char *));
+        if (!new_includes) {
+            ec_mutex_unlock(&store->mutex);
+            return DEP_ERROR_OUT_OF_MEMORY;
+        }
+        if (file->include_count > 0) {
+            memcpy(new_includes, file->includes, file->include_count * sizeof(char *));
+        }
+        file->includes = new_includes;
+        file->include_capacity = new_capacity;
     }
 
-    char *include_copy = strdup(include_path);
-    if (!include_copy) return DEP_ERROR_OUT_OF_MEMORY;
+    const char *interned = graph_store_intern_locked(store, include_path);
+    if (interned) {
+        file->includes[file->include_count++] = interned;
+    }
 
-    file->includes[file->include_count++] = include_copy;
-    return DEP_SUCCESS;
+    ec_mutex_unlock(&store->mutex);
+    return interned ? DEP_SUCCESS : DEP_ERROR_OUT_OF_MEMORY;
 }
 
 /**
  * Parse #include directives from a source file
+ *
+ * The same pass looks for main() (see has_main_function) so the file is
+ * read only once.
  */
 static DependencyErrorCode parse_includes(
-    DependencyGraph *graph,
+    const DependencyGraph *graph,
     SourceFile *file
 ) {
     FILE *fp = fopen(file->path, "r");
     if (!fp) return DEP_ERROR_FILE_NOT_FOUND;
 
+    bool found_main = false;
     char line[1024];
     while (fgets(line, sizeof(line), fp)) {
+        if (!found_main && !file->is_header &&
+            (strstr(line, "int main") || strstr(line, "void main"))) {
+            found_main = true;
+        }
+
         /* Skip leading whitespace */
         char *p = line;
         while (*p && isspace(*p)) p++;
@@ -242,7 +474,8 @@ static DependencyErrorCode parse_includes(
         char *dest = include_name;
 
         if (*p == '"' || *p == '<') {
-            char end_char = (*p == '"') ? '"' : '>';
+            bool quoted = *p == '"';
+            char end_char = quoted ? '"' : '>';
             p++; /* Skip opening quote/bracket */
 
             while (*p && *p != end_char && dest < include_name + MAX_PATH_LENGTH - 1) {
@@ -252,7 +485,7 @@ static DependencyErrorCode parse_includes(
 
             /* Resolve include path */
             char resolved[MAX_PATH_LENGTH];
-            if (resolve_include(graph, include_name, file->path,
+            if (resolve_include(graph, include_name, quoted, file->path,
                               resolved, MAX_PATH_LENGTH)) {
                 DependencyErrorCode err = source_file_add_include(file, resolved);
                 if (err != DEP_SUCCESS) {
@@ -265,6 +498,8 @@ static DependencyErrorCode parse_includes(
     }
 
     fclose(fp);
+    file->has_main = found_main;
+    file->main_known = true;
     return DEP_SUCCESS;
 }
 
@@ -294,17 +529,48 @@ static bool has_main_function(const SourceFile *file) {
     return found;
 }
 
+bool source_file_has_main(SourceFile *file) {
+    if (!file) return false;
+
+    if (!file->main_known) {
+        file->has_main = has_main_function(file);
+        file->main_known = true;
+    }
+    return file->has_main;
+}
+
 /* ==============================================================================
  * Dependency Graph Management
  * ==============================================================================
  */
 
+static void graph_adjacency_free(GraphAdjacency *adjacency);
+
 DependencyGraph *dependency_graph_create(void) {
     DependencyGraph *graph = malloc(sizeof(DependencyGraph));
     if (!graph) return NULL;
 
+    graph->files = NULL;
     graph->file_count = 0;
+    graph->file_capacity = 0;
     graph->include_path_count = 0;
+    path_index_init(&graph->file_index);
+    graph->include_provider = NULL;
+    graph->include_provider_data = NULL;
+    graph->parsed_count = 0;
+    graph->reused_count = 0;
+    graph->provided_count = 0;
+    graph->scan_threads = 1;
+    graph->prefetch = NULL;
+    memset(&graph->adjacency, 0, sizeof(GraphAdjacency));
+    graph->include_memo = include_memo_create();
+    graph->store = graph_store_create();
+    if (!graph->include_memo || !graph->store) {
+        include_memo_destroy(graph->include_memo);
+        graph_store_destroy(graph->store);
+        free(graph);
+        return NULL;
+    }
 
     return graph;
 }
@@ -312,14 +578,16 @@ DependencyGraph *dependency_graph_create(void) {
 void dependency_graph_destroy(DependencyGraph *graph) {
     if (!graph) return;
 
-    for (size_t i = 0; i < graph->file_count; i++) {
-        source_file_destroy(graph->files[i]);
-    }
-
     for (size_t i = 0; i < graph->include_path_count; i++) {
         free(graph->include_paths[i]);
     }
 
+    /* Every node and path lives in the store */
+    graph_store_destroy(graph->store);
+    free(graph->files);
+    graph_adjacency_free(&graph->adjacency);
+    include_memo_destroy(graph->include_memo);
+    path_index_destroy(&graph->file_index);
     free(graph);
 }
 
@@ -337,6 +605,9 @@ DependencyErrorCode dependency_graph_add_include_path(
     if (!path_copy) return DEP_ERROR_OUT_OF_MEMORY;
 
     graph->include_paths[graph->include_path_count++] = path_copy;
+
+    /* A new search path can change where includes resolve */
+    dependency_graph_clear_include_cache(graph);
     return DEP_SUCCESS;
 }
 
@@ -346,57 +617,301 @@ SourceFile *dependency_graph_find_file(
 ) {
     if (!graph || !path) return NULL;
 
-    for (size_t i = 0; i < graph->file_count; i++) {
-        if (strcmp(graph->files[i]->path, path) == 0) {
-            return graph->files[i];
-        }
+    size_t idx = path_index_find(&graph->file_index, path);
+    return idx == PATH_INDEX_NONE ? NULL : graph->files[idx];
+}
+
+void dependency_graph_clear_include_cache(DependencyGraph *graph) {
+    if (!graph || !graph->include_memo) return;
+
+    ec_mutex_lock(&graph->include_memo->mutex);
+    include_memo_clear(graph->include_memo);
+    ec_mutex_unlock(&graph->include_memo->mutex);
+}
+
+void dependency_graph_include_cache_stats(
+    const DependencyGraph *graph,
+    size_t *lookups,
+    size_t *probes
+) {
+    size_t lookup_count = 0;
+    size_t probe_count = 0;
+    if (graph && graph->include_memo) {
+        ec_mutex_lock(&graph->include_memo->mutex);
+        lookup_count = graph->include_memo->lookups;
+        probe_count = graph->include_memo->probes;
+        ec_mutex_unlock(&graph->include_memo->mutex);
     }
+    if (lookups) *lookups = lookup_count;
+    if (probes) *probes = probe_count;
+}
 
-    return NULL;
+void dependency_graph_set_scan_threads(DependencyGraph *graph, size_t threads) {
+    if (!graph) return;
+    graph->scan_threads = threads == 0 ? 1 : threads;
 }
 
-DependencyErrorCode dependency_graph_add_file(
+void dependency_graph_set_include_provider(
     DependencyGraph *graph,
-    const char *file_path
+    IncludeProvider provider,
+    void *user_data
 ) {
-    if (!graph || !file_path) return DEP_ERROR_NULL_POINTER;
+    if (!graph) return;
+    graph->include_provider = provider;
+    graph->include_provider_data = user_data;
+}
 
+static DependencyErrorCode graph_add_file(
+    DependencyGraph *graph,
+    const char *file_path,
+    bool scan
+);
+
+/**
+ * Ask the provider for a file's includes, then fall back to parsing
+ *
+ * Only reads the graph, so scan workers run it in parallel.
+ */
+static IncludeProvision source_file_load_includes(
+    const DependencyGraph *graph,
+    SourceFile *file,
+    DependencyErrorCode *err
+) {
+    IncludeProvision provision = INCLUDES_NOT_PROVIDED;
+    if (graph->include_provider) {
+        provision = graph->include_provider(graph->include_provider_data, file);
+        if (provision == INCLUDES_NOT_PROVIDED) {
+            source_file_clear_includes(file);
+            file->main_known = false;
+        }
+    }
+
+    *err = DEP_SUCCESS;
+    if (provision == INCLUDES_NOT_PROVIDED) {
+        uint64_t trace_start = build_trace_begin();
+        *err = parse_includes(graph, file);
+        build_trace_end(trace_start, "scan", "parse", file->path);
+        if (*err != DEP_SUCCESS) {
+            source_file_clear_includes(file);
+        }
+    }
+    return provision;
+}
+
+/**
+ * PreparedFile - One file loaded ahead of the merge by a scan worker
+ */
+typedef struct PreparedFile {
+    SourceFile *file;                         /* Loaded copy, not in the graph */
+    IncludeProvision provision;               /* What loading it produced */
+    DependencyErrorCode error;                /* Load result */
+    bool taken;                               /* Handed to a graph node */
+} PreparedFile;
+
+struct ScanPrefetch {
+    PreparedFile *items;                      /* One per file found by the walk */
+    size_t count;                             /* Number of items */
+    PathIndex index;                          /* Path -> item */
+    size_t next;                              /* Next item for a worker */
+    const DependencyGraph *graph;             /* Graph being scanned */
+    ec_mutex_t mutex;                         /* Guards next */
+};
+
+/**
+ * Move a prepared file's includes into a graph node
+ */
+static bool scan_prefetch_take(
+    struct ScanPrefetch *prefetch,
+    SourceFile *file,
+    IncludeProvision *provision,
+    DependencyErrorCode *err
+) {
+    if (!prefetch) return false;
+
+    size_t idx = path_index_find(&prefetch->index, file->path);
+    if (idx == PATH_INDEX_NONE || prefetch->items[idx].taken) return false;
+
+    PreparedFile *item = &prefetch->items[idx];
+    item->taken = true;
+
+    /* Both live in the graph's store, so the array can simply change hands */
+    file->includes = item->file->includes;
+    file->include_count = item->file->include_count;
+    file->include_capacity = item->file->include_capacity;
+    item->file->includes = NULL;
+    item->file->include_count = 0;
+    item->file->include_capacity = 0;
+    file->main_known = item->file->main_known;
+    file->has_main = item->file->has_main;
+
+    *provision = item->provision;
+    *err = item->error;
+    return true;
+}
+
+/**
+ * Fill in a file's includes, from the scan prefetch if it has them
+ */
+static DependencyErrorCode graph_load_includes(DependencyGraph *graph, SourceFile *file) {
+    IncludeProvision provision;
+    DependencyErrorCode err;
+    if (!scan_prefetch_take(graph->prefetch, file, &provision, &err)) {
+        provision = source_file_load_includes(graph, file, &err);
+    }
+    if (err != DEP_SUCCESS) return err;
+
+    if (provision == INCLUDES_NOT_PROVIDED) {
+        graph->parsed_count++;
+    } else if (provision == INCLUDES_TRANSITIVE) {
+        file->dependencies_provided = true;
+        graph->provided_count++;
+    } else {
+        graph->reused_count++;
+    }
+
+    file->scanned = true;
+    graph->adjacency.current = false;
+    return DEP_SUCCESS;
+}
+
+/**
+ * Add a scanned file's includes; a transitive list is already complete,
+ * so its files are only registered
+ */
+static void graph_add_includes(DependencyGraph *graph, const SourceFile *file) {
+    for (size_t i = 0; i < file->include_count; i++) {
+        graph_add_file(graph, file->includes[i], !file->dependencies_provided);
+        /* Ignore errors for system headers we can't find */
+    }
+}
+
+/**
+ * Add a file; with scan unset it is only registered (its includes are
+ * covered by a provided list)
+ */
+static DependencyErrorCode graph_add_file(
+    DependencyGraph *graph,
+    const char *file_path,
+    bool scan
+) {
     if (!file_exists(file_path)) return DEP_ERROR_FILE_NOT_FOUND;
 
     if (!is_source_file(file_path)) return DEP_ERROR_INVALID_PATH;
 
-    /* Check if already added */
-    if (dependency_graph_find_file(graph, file_path)) {
-        return DEP_SUCCESS; /* Already added */
+    /* Check if already added; registered-only files are scanned on demand */
+    SourceFile *existing = dependency_graph_find_file(graph, file_path);
+    if (existing) {
+        if (scan && !existing->scanned) {
+            DependencyErrorCode err = graph_load_includes(graph, existing);
+            if (err != DEP_SUCCESS) return err;
+            graph_add_includes(graph, existing);
+        }
+        return DEP_SUCCESS;
     }
 
-    if (graph->file_count >= MAX_SOURCE_FILES) {
-        return DEP_ERROR_TOO_MANY_FILES;
+    if (graph->file_count >= graph->file_capacity) {
+        size_t new_capacity = graph->file_capacity == 0 ? 64 : graph->file_capacity * 2;
+        SourceFile **new_files = realloc(graph->files, new_capacity * sizeof(SourceFile *));
+        if (!new_files) return DEP_ERROR_OUT_OF_MEMORY;
+        graph->files = new_files;
+        graph->file_capacity = new_capacity;
     }
 
-    /* Create source file */
-    SourceFile *file = source_file_create(file_path);
+    /* Create source file (a node that fails to load is left in the arena) */
+    SourceFile *file = source_file_create(graph->store, file_path);
     if (!file) return DEP_ERROR_OUT_OF_MEMORY;
 
-    /* Parse includes */
-    DependencyErrorCode err = parse_includes(graph, file);
-    if (err != DEP_SUCCESS) {
-        source_file_destroy(file);
-        return err;
+    if (scan) {
+        DependencyErrorCode err = graph_load_includes(graph, file);
+        if (err != DEP_SUCCESS) return err;
     }
 
     /* Add to graph */
+    if (!path_index_insert(&graph->file_index, file->path, graph->file_count)) {
+        return DEP_ERROR_OUT_OF_MEMORY;
+    }
+    file->id = graph->file_count;
     graph->files[graph->file_count++] = file;
+    graph->adjacency.current = false;
 
     /* Recursively add included files */
-    for (size_t i = 0; i < file->include_count; i++) {
-        dependency_graph_add_file(graph, file->includes[i]);
-        /* Ignore errors for system headers we can't find */
+    if (scan) {
+        graph_add_includes(graph, file);
     }
 
     return DEP_SUCCESS;
 }
 
+DependencyErrorCode dependency_graph_add_file(
+    DependencyGraph *graph,
+    const char *file_path
+) {
+    if (!graph || !file_path) return DEP_ERROR_NULL_POINTER;
+
+    /* With a provider, headers wait until a parsed file includes them */
+    bool scan = !(graph->include_provider && is_header_file(file_path));
+    return graph_add_file(graph, file_path, scan);
+}
+
+DependencyErrorCode dependency_graph_refresh_file(
+    DependencyGraph *graph,
+    const char *file_path
+) {
+    if (!graph || !file_path) return DEP_ERROR_NULL_POINTER;
+
+    SourceFile *file = dependency_graph_find_file(graph, file_path);
+    if (!file) {
+        /* A new file can shadow a header an include used to resolve to */
+        dependency_graph_clear_include_cache(graph);
+        return dependency_graph_add_file(graph, file_path);
+    }
+
+    if (!file_exists(file_path)) return DEP_ERROR_FILE_NOT_FOUND;
+
+    /* Registered only: covered by another file's provided list */
+    if (!file->scanned) return DEP_SUCCESS;
+
+    source_file_clear_includes(file);
+    file->scanned = false;
+    file->dependencies_provided = false;
+    file->main_known = false;
+    return graph_add_file(graph, file->path, true);
+}
+
+DependencyErrorCode dependency_graph_add_generated_file(
+    DependencyGraph *graph,
+    const char *file_path,
+    const char *const *includes,
+    size_t include_count
+) {
+    if (!graph || !file_path || (include_count > 0 && !includes)) {
+        return DEP_ERROR_NULL_POINTER;
+    }
+
+    /* Registered without a scan, then given its includes by hand */
+    SourceFile *file = dependency_graph_find_file(graph, file_path);
+    if (!file) {
+        DependencyErrorCode err = graph_add_file(graph, file_path, false);
+        if (err != DEP_SUCCESS) return err;
+        file = dependency_graph_find_file(graph, file_path);
+        if (!file) return DEP_ERROR_INVALID_PATH;
+    }
+
+    source_file_clear_includes(file);
+    for (size_t i = 0; i < include_count; i++) {
+        DependencyErrorCode err = source_file_add_include(file, includes[i]);
+        if (err != DEP_SUCCESS) return err;
+    }
+
+    file->scanned = true;
+    file->dependencies_provided = false;
+    file->main_known = true;
+    file->has_main = false;
+    file->generated = true;
+    graph->adjacency.current = false;
+    return DEP_SUCCESS;
+}
+
 /* ==============================================================================
  * Directory Exclusion Support
  * ==============================================================================
@@ -462,34 +977,142 @@ static bool should_exclude_directory(
     return false;
 }
 
-DependencyErrorCode dependency_graph_scan_directory(
-    DependencyGraph *graph,
-    const char *directory,
-    bool recursive
-) {
-    return dependency_graph_scan_directory_with_exclusions(
-        graph, directory, recursive, NULL, 0
-    );
+bool dependency_is_source_path(const char *path) {
+    return is_source_file(path);
 }
 
-DependencyErrorCode dependency_graph_scan_directory_with_exclusions(
-    DependencyGraph *graph,
-    const char *directory,
-    bool recursive,
+bool dependency_is_excluded_directory(
+    const char *dir_name,
     const char **exclude_dirs,
     size_t exclude_count
 ) {
-    if (!graph || !directory) return DEP_ERROR_NULL_POINTER;
+    return should_exclude_directory(dir_name, exclude_dirs, exclude_count);
+}
+
+bool dependency_graph_resolve_include(
+    const DependencyGraph *graph,
+    const char *include_name,
+    bool quoted,
+    const char *referencing_file,
+    char *resolved_path,
+    size_t path_size
+) {
+    if (!graph || !include_name || !referencing_file || !resolved_path || path_size == 0) {
+        return false;
+    }
+    return resolve_include(graph, include_name, quoted, referencing_file,
+                           resolved_path, path_size);
+}
+
+/* ==============================================================================
+ * Parallel Directory Scanning
+ * ==============================================================================
+ */
+
+/**
+ * PathList - Growable list of owned path strings
+ */
+typedef struct PathList {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} PathList;
+
+static bool path_list_push(PathList *list, char *path) {
+    if (list->count >= list->capacity) {
+        size_t new_capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        char **new_paths = realloc(list->paths, new_capacity * sizeof(char *));
+        if (!new_paths) return false;
+        list->paths = new_paths;
+        list->capacity = new_capacity;
+    }
+    list->paths[list->count++] = path;
+    return true;
+}
+
+static bool path_list_add(PathList *list, const char *path) {
+    char *copy = strdup(path);
+    if (!copy) return false;
+    if (!path_list_push(list, copy)) {
+        free(copy);
+        return false;
+    }
+    return true;
+}
+
+static void path_list_free(PathList *list) {
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    list->paths = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * Start worker threads running func; runs it on the calling thread if
+ * fewer than two workers are wanted or none could be started
+ */
+static void run_scan_workers(size_t count, ec_thread_func_t func, void *arg) {
+    ec_thread_t *threads = count > 1 ? malloc(count * sizeof(ec_thread_t)) : NULL;
+    size_t started = 0;
+    if (threads) {
+        for (; started < count; started++) {
+            if (ec_thread_create(&threads[started], func, arg) != 0) break;
+        }
+    }
+
+    if (started == 0) func(arg);
+
+    for (size_t i = 0; i < started; i++) {
+        ec_thread_join(threads[i]);
+    }
+    free(threads);
+}
+
+/**
+ * DirectoryWalk - Shared state of a directory walk
+ */
+typedef struct DirectoryWalk {
+    PathList pending;                         /* Directories not yet listed */
+    size_t active;                            /* Directories being listed */
+    PathList files;                           /* Source files found */
+    bool recursive;
+    const char **exclude_dirs;
+    size_t exclude_count;
+    bool out_of_memory;
+    ec_mutex_t mutex;
+    ec_cond_t cond;                           /* Work added or walk finished */
+} DirectoryWalk;
+
+/**
+ * List one directory into files and subdirectories (no shared state)
+ *
+ * Uses d_type where the file system reports it, so only entries of
+ * unknown type (and symlinks, to follow them) cost a stat.
+ */
+static bool list_directory(
+    const DirectoryWalk *walk,
+    const char *directory,
+    PathList *files,
+    PathList *subdirs,
+    bool *out_of_memory
+) {
+    bool ok = true;
 
 #ifdef _WIN32
-    /* Windows implementation using FindFirstFile/FindNextFile */
     WIN32_FIND_DATA find_data;
     char search_path[MAX_PATH_LENGTH];
     snprintf(search_path, MAX_PATH_LENGTH, "%s\\*", directory);
 
     HANDLE hFind = FindFirstFile(search_path, &find_data);
     if (hFind == INVALID_HANDLE_VALUE) {
-        return DEP_ERROR_FILE_NOT_FOUND;
+        return false;
     }
 
     do {
@@ -503,27 +1126,21 @@ DependencyErrorCode dependency_graph_scan_directory_with_exclusions(
         snprintf(full_path, MAX_PATH_LENGTH, "%s\\%s", directory, find_data.cFileName);
 
         if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            /* Check if directory should be excluded */
-            if (should_exclude_directory(find_data.cFileName, exclude_dirs, exclude_count)) {
-                continue;
-            }
-
-            if (recursive) {
-                dependency_graph_scan_directory_with_exclusions(
-                    graph, full_path, true, exclude_dirs, exclude_count
-                );
+            if (walk->recursive &&
+                !should_exclude_directory(find_data.cFileName, walk->exclude_dirs,
+                                          walk->exclude_count)) {
+                ok = ok && path_list_add(subdirs, full_path);
             }
         } else if (is_source_file(full_path)) {
-            dependency_graph_add_file(graph, full_path);
+            ok = ok && path_list_add(files, full_path);
         }
     } while (FindNextFile(hFind, &find_data) != 0);
 
     FindClose(hFind);
 
 #else
-    /* POSIX implementation using opendir/readdir */
     DIR *dir = opendir(directory);
-    if (!dir) return DEP_ERROR_FILE_NOT_FOUND;
+    if (!dir) return false;
 
     struct dirent *entry;
     while ((entry = readdir(dir)) != NULL) {
@@ -536,28 +1153,327 @@ DependencyErrorCode dependency_graph_scan_directory_with_exclusions(
         char full_path[MAX_PATH_LENGTH];
         snprintf(full_path, MAX_PATH_LENGTH, "%s/%s", directory, entry->d_name);
 
-        struct stat st;
-        if (stat(full_path, &st) != 0) continue;
-
-        if (S_ISDIR(st.st_mode)) {
-            /* Check if directory should be excluded */
-            if (should_exclude_directory(entry->d_name, exclude_dirs, exclude_count)) {
-                continue;
-            }
+        bool is_dir = false;
+        bool is_reg = false;
+#if defined(DT_DIR) && defined(DT_REG) && defined(DT_UNKNOWN) && defined(DT_LNK)
+        if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+            is_dir = entry->d_type == DT_DIR;
+            is_reg = entry->d_type == DT_REG;
+        } else
+#endif
+        {
+            struct stat st;
+            if (stat(full_path, &st) != 0) continue;
+            is_dir = S_ISDIR(st.st_mode);
+            is_reg = S_ISREG(st.st_mode);
+        }
 
-            if (recursive) {
-                dependency_graph_scan_directory_with_exclusions(
-                    graph, full_path, true, exclude_dirs, exclude_count
-                );
+        if (is_dir) {
+            if (walk->recursive &&
+                !should_exclude_directory(entry->d_name, walk->exclude_dirs,
+                                          walk->exclude_count)) {
+                ok = ok && path_list_add(subdirs, full_path);
             }
-        } else if (S_ISREG(st.st_mode) && is_source_file(full_path)) {
-            dependency_graph_add_file(graph, full_path);
+        } else if (is_reg && is_source_file(full_path)) {
+            ok = ok && path_list_add(files, full_path);
         }
     }
 
     closedir(dir);
 #endif
 
+    if (!ok) *out_of_memory = true;
+    return true;
+}
+
+/**
+ * Move a worker's results into the shared walk (called with mutex held)
+ */
+static void walk_collect(DirectoryWalk *walk, PathList *files, PathList *subdirs) {
+    for (size_t i = 0; i < files->count; i++) {
+        if (path_list_push(&walk->files, files->paths[i])) {
+            files->paths[i] = NULL;
+        } else {
+            walk->out_of_memory = true;
+        }
+    }
+    for (size_t i = 0; i < subdirs->count; i++) {
+        if (path_list_push(&walk->pending, subdirs->paths[i])) {
+            subdirs->paths[i] = NULL;
+        } else {
+            walk->out_of_memory = true;
+        }
+    }
+    path_list_free(files);
+    path_list_free(subdirs);
+}
+
+static void *directory_walk_worker(void *arg) {
+    DirectoryWalk *walk = (DirectoryWalk *)arg;
+
+    ec_mutex_lock(&walk->mutex);
+    for (;;) {
+        while (walk->pending.count == 0 && walk->active > 0) {
+            ec_cond_wait(&walk->cond, &walk->mutex);
+        }
+        if (walk->pending.count == 0) break;
+
+        char *directory = walk->pending.paths[--walk->pending.count];
+        walk->active++;
+        ec_mutex_unlock(&walk->mutex);
+
+        /* Subdirectories that cannot be opened are skipped */
+        PathList files = {NULL, 0, 0};
+        PathList subdirs = {NULL, 0, 0};
+        bool out_of_memory = false;
+        list_directory(walk, directory, &files, &subdirs, &out_of_memory);
+        free(directory);
+
+        ec_mutex_lock(&walk->mutex);
+        walk_collect(walk, &files, &subdirs);
+        if (out_of_memory) walk->out_of_memory = true;
+        walk->active--;
+        ec_cond_broadcast(&walk->cond);
+    }
+    ec_cond_broadcast(&walk->cond);
+    ec_mutex_unlock(&walk->mutex);
+    return NULL;
+}
+
+static void *scan_prefetch_worker(void *arg) {
+    struct ScanPrefetch *prefetch = (struct ScanPrefetch *)arg;
+
+    for (;;) {
+        ec_mutex_lock(&prefetch->mutex);
+        size_t idx = prefetch->next++;
+        ec_mutex_unlock(&prefetch->mutex);
+        if (idx >= prefetch->count) break;
+
+        PreparedFile *item = &prefetch->items[idx];
+        item->provision = source_file_load_includes(prefetch->graph, item->file, &item->error);
+    }
+    return NULL;
+}
+
+/**
+ * Load every file the merge will scan, in parallel
+ *
+ * Headers are skipped while a provider is set, since the merge only
+ * scans them once something includes them.
+ */
+static struct ScanPrefetch *scan_prefetch_create(DependencyGraph *graph, const PathList *files) {
+    struct ScanPrefetch *prefetch = calloc(1, sizeof(struct ScanPrefetch));
+    if (!prefetch) return NULL;
+
+    prefetch->items = calloc(files->count + 1, sizeof(PreparedFile));
+    path_index_init(&prefetch->index);
+    prefetch->graph = graph;
+    if (!prefetch->items || ec_mutex_init(&prefetch->mutex) != 0) {
+        free(prefetch->items);
+        path_index_destroy(&prefetch->index);
+        free(prefetch);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < files->count; i++) {
+        const char *path = files->paths[i];
+        if (graph->include_provider && is_header_file(path)) continue;
+
+        SourceFile *file = source_file_create(graph->store, path);
+        if (!file || !path_index_insert(&prefetch->index, file->path, prefetch->count)) {
+            break;
+        }
+        prefetch->items[prefetch->count++].file = file;
+    }
+
+    size_t workers = graph->scan_threads < prefetch->count ? graph->scan_threads
+                                                           : prefetch->count;
+    run_scan_workers(workers, scan_prefetch_worker, prefetch);
+    return prefetch;
+}
+
+static void scan_prefetch_destroy(struct ScanPrefetch *prefetch) {
+    if (!prefetch) return;
+
+    /* Prepared nodes live in the graph's store */
+    free(prefetch->items);
+    path_index_destroy(&prefetch->index);
+    ec_mutex_destroy(&prefetch->mutex);
+    free(prefetch);
+}
+
+DependencyErrorCode dependency_graph_scan_directory(
+    DependencyGraph *graph,
+    const char *directory,
+    bool recursive
+) {
+    return dependency_graph_scan_directory_with_exclusions(
+        graph, directory, recursive, NULL, 0
+    );
+}
+
+static DependencyErrorCode scan_directory(
+    DependencyGraph *graph,
+    const char *directory,
+    bool recursive,
+    const char **exclude_dirs,
+    size_t exclude_count
+) {
+
+    DirectoryWalk walk;
+    memset(&walk, 0, sizeof(walk));
+    walk.recursive = recursive;
+    walk.exclude_dirs = exclude_dirs;
+    walk.exclude_count = exclude_count;
+
+    /* The top directory is listed here so a missing one is reported */
+    PathList files = {NULL, 0, 0};
+    PathList subdirs = {NULL, 0, 0};
+    if (!list_directory(&walk, directory, &files, &subdirs, &walk.out_of_memory)) {
+        return DEP_ERROR_FILE_NOT_FOUND;
+    }
+    walk_collect(&walk, &files, &subdirs);
+
+    /* Phase 1: list the remaining directories on the worker pool */
+    if (walk.pending.count > 0) {
+        if (ec_mutex_init(&walk.mutex) != 0) {
+            path_list_free(&walk.pending);
+            path_list_free(&walk.files);
+            return DEP_ERROR_OUT_OF_MEMORY;
+        }
+        ec_cond_init(&walk.cond);
+        run_scan_workers(graph->scan_threads, directory_walk_worker, &walk);
+        ec_cond_destroy(&walk.cond);
+        ec_mutex_destroy(&walk.mutex);
+    }
+    path_list_free(&walk.pending);
+
+    /* Listing order depends on the file system and on thread timing */
+    qsort(walk.files.paths, walk.files.count, sizeof(char *), compare_paths);
+
+    /* Phase 2: parse in parallel, then merge on this thread in path order */
+    if (graph->scan_threads > 1) {
+        graph->prefetch = scan_prefetch_create(graph, &walk.files);
+    }
+
+    for (size_t i = 0; i < walk.files.count; i++) {
+        dependency_graph_add_file(graph, walk.files.paths[i]);
+    }
+
+    scan_prefetch_destroy(graph->prefetch);
+    graph->prefetch = NULL;
+
+    bool out_of_memory = walk.out_of_memory;
+    path_list_free(&walk.files);
+
+    if (out_of_memory) return DEP_ERROR_OUT_OF_MEMORY;
+    return dependency_graph_build_adjacency(graph);
+}
+
+DependencyErrorCode dependency_graph_scan_directory_with_exclusions(
+    DependencyGraph *graph,
+    const char *directory,
+    bool recursive,
+    const char **exclude_dirs,
+    size_t exclude_count
+) {
+    if (!graph || !directory) return DEP_ERROR_NULL_POINTER;
+
+    uint64_t trace_start = build_trace_begin();
+    DependencyErrorCode err = scan_directory(graph, directory, recursive,
+                                             exclude_dirs, exclude_count);
+    build_trace_end(trace_start, "scan", "scan", directory);
+    return err;
+}
+
+/* ==============================================================================
+ * Integer Adjacency
+ * ==============================================================================
+ */
+
+/**
+ * Free the edge arrays
+ */
+static void graph_adjacency_free(GraphAdjacency *adjacency) {
+    free(adjacency->forward_start);
+    free(adjacency->forward);
+    free(adjacency->reverse_start);
+    free(adjacency->reverse);
+    memset(adjacency, 0, sizeof(GraphAdjacency));
+}
+
+DependencyErrorCode dependency_graph_build_adjacency(DependencyGraph *graph) {
+    if (!graph) return DEP_ERROR_NULL_POINTER;
+
+    GraphAdjacency *adjacency = &graph->adjacency;
+    if (adjacency->current && adjacency->node_count == graph->file_count) {
+        return DEP_SUCCESS;
+    }
+
+    size_t node_count = graph->file_count;
+    size_t include_count = 0;
+    for (size_t i = 0; i < node_count; i++) {
+        include_count += graph->files[i]->include_count;
+    }
+    if (node_count >= UINT32_MAX || include_count >= UINT32_MAX) {
+        return DEP_ERROR_TOO_MANY_FILES;
+    }
+
+    graph_adjacency_free(adjacency);
+    uint32_t *forward_start = malloc((node_count + 1) * sizeof(uint32_t));
+    uint32_t *forward = malloc((include_count + 1) * sizeof(uint32_t));
+    uint32_t *reverse_start = calloc(node_count + 1, sizeof(uint32_t));
+    uint32_t *cursor = malloc((node_count + 1) * sizeof(uint32_t));
+    if (!forward_start || !forward || !reverse_start || !cursor) {
+        free(forward_start);
+        free(forward);
+        free(reverse_start);
+        free(cursor);
+        return DEP_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Forward edges: the only pass that looks paths up */
+    uint32_t edge_count = 0;
+    for (size_t i = 0; i < node_count; i++) {
+        const SourceFile *file = graph->files[i];
+        forward_start[i] = edge_count;
+        for (size_t j = 0; j < file->include_count; j++) {
+            size_t dep = path_index_find(&graph->file_index, file->includes[j]);
+            if (dep == PATH_INDEX_NONE) continue; /* System header or not found */
+
+            forward[edge_count++] = (uint32_t)dep;
+            reverse_start[dep + 1]++;
+        }
+    }
+    forward_start[node_count] = edge_count;
+
+    /* Reverse edges: counts become offsets, then a second pass fills them */
+    for (size_t i = 0; i < node_count; i++) {
+        reverse_start[i + 1] += reverse_start[i];
+    }
+    uint32_t *reverse = malloc((edge_count + 1) * sizeof(uint32_t));
+    if (!reverse) {
+        free(forward_start);
+        free(forward);
+        free(reverse_start);
+        free(cursor);
+        return DEP_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(cursor, reverse_start, (node_count + 1) * sizeof(uint32_t));
+    for (size_t i = 0; i < node_count; i++) {
+        for (uint32_t e = forward_start[i]; e < forward_start[i + 1]; e++) {
+            reverse[cursor[forward[e]]++] = (uint32_t)i;
+        }
+    }
+    free(cursor);
+
+    adjacency->forward_start = forward_start;
+    adjacency->forward = forward;
+    adjacency->reverse_start = reverse_start;
+    adjacency->reverse = reverse;
+    adjacency->node_count = node_count;
+    adjacency->edge_count = edge_count;
+    adjacency->current = true;
     return DEP_SUCCESS;
 }
 
@@ -567,110 +1483,154 @@ DependencyErrorCode dependency_graph_scan_directory_with_exclusions(
  */
 
 /**
- * DFS helper for topological sort
+ * Depth-first walk from one node, placing every node after the nodes it
+ * includes
+ *
+ * Iterative, so deep include chains cannot overflow the call stack.
+ * stack and next_edge hold one slot per node. With order NULL the walk
+ * only looks for cycles.
  */
-static bool topological_sort_dfs(
+static bool topological_sort_from(
     DependencyGraph *graph,
-    SourceFile *file,
+    uint32_t root,
+    uint32_t *stack,
+    uint32_t *next_edge,
     BuildOrder *order,
     char *cycle_path,
     size_t path_size
 ) {
-    file->visited = true;
-    file->in_stack = true;
-
-    /* Visit dependencies */
-    for (size_t i = 0; i < file->include_count; i++) {
-        SourceFile *dep = dependency_graph_find_file(graph, file->includes[i]);
-        if (!dep) continue; /* System header or not found */
-
-        if (dep->in_stack) {
-            /* Cycle detected */
-            if (cycle_path) {
-                snprintf(cycle_path, path_size, "%s -> %s",
-                        file->path, dep->path);
+    const GraphAdjacency *adjacency = &graph->adjacency;
+    size_t depth = 0;
+
+    stack[depth++] = root;
+    next_edge[root] = adjacency->forward_start[root];
+    graph->files[root]->visited = true;
+    graph->files[root]->in_stack = true;
+
+    while (depth > 0) {
+        uint32_t node = stack[depth - 1];
+
+        /* Visit dependencies */
+        if (next_edge[node] < adjacency->forward_start[node + 1]) {
+            uint32_t dep = adjacency->forward[next_edge[node]++];
+            SourceFile *dep_file = graph->files[dep];
+
+            if (dep_file->in_stack) {
+                /* Cycle detected */
+                if (cycle_path) {
+                    snprintf(cycle_path, path_size, "%s -> %s",
+                            graph->files[node]->path, dep_file->path);
+                }
+                return false;
             }
-            return false;
-        }
 
-        if (!dep->visited) {
-            if (!topological_sort_dfs(graph, dep, order, cycle_path, path_size)) {
-                return false;
+            if (!dep_file->visited) {
+                dep_file->visited = true;
+                dep_file->in_stack = true;
+                next_edge[dep] = adjacency->forward_start[dep];
+                stack[depth++] = dep;
             }
+            continue;
         }
-    }
 
-    file->in_stack = false;
+        SourceFile *file = graph->files[node];
+        file->in_stack = false;
+        depth--;
 
-    /* Add to build order (reverse postorder) */
-    file->sort_order = order->file_count;
-    order->ordered_files[order->file_count++] = file;
+        /* Add to build order (reverse postorder) */
+        if (order) {
+            file->sort_order = (int)order->file_count;
+            order->ordered_files[order->file_count++] = file;
+        }
+    }
 
     return true;
 }
 
-DependencyErrorCode dependency_graph_topological_sort(
+/**
+ * Walk every node, headers before sources when headers_first is set
+ */
+static DependencyErrorCode topological_sort_all(
     DependencyGraph *graph,
-    BuildOrder *order
+    BuildOrder *order,
+    bool headers_first,
+    char *cycle_path,
+    size_t path_size
 ) {
-    if (!graph || !order) return DEP_ERROR_NULL_POINTER;
+    DependencyErrorCode err = dependency_graph_build_adjacency(graph);
+    if (err != DEP_SUCCESS) return err;
 
     /* Reset visited flags */
     for (size_t i = 0; i < graph->file_count; i++) {
         graph->files[i]->visited = false;
         graph->files[i]->in_stack = false;
-        graph->files[i]->sort_order = -1;
+        if (order) graph->files[i]->sort_order = -1;
     }
 
-    order->file_count = 0;
+    uint32_t *stack = malloc((2 * graph->file_count + 1) * sizeof(uint32_t));
+    if (!stack) return DEP_ERROR_OUT_OF_MEMORY;
+    uint32_t *next_edge = stack + graph->file_count;
 
-    /* Process headers first, then sources */
-    for (int pass = 0; pass < 2; pass++) {
+    for (int pass = 0; pass < (headers_first ? 2 : 1); pass++) {
         bool processing_headers = (pass == 0);
 
         for (size_t i = 0; i < graph->file_count; i++) {
             SourceFile *file = graph->files[i];
 
-            if (file->is_header != processing_headers) continue;
+            if (headers_first && file->is_header != processing_headers) continue;
             if (file->visited) continue;
 
-            char cycle_path[MAX_PATH_LENGTH * 2];
-            if (!topological_sort_dfs(graph, file, order,
-                                     cycle_path, sizeof(cycle_path))) {
-                fprintf(stderr, "Circular dependency: %s\n", cycle_path);
+            if (!topological_sort_from(graph, (uint32_t)i, stack, next_edge, order,
+                                       cycle_path, path_size)) {
+                free(stack);
                 return DEP_ERROR_CIRCULAR_DEPENDENCY;
             }
         }
     }
 
+    free(stack);
     return DEP_SUCCESS;
 }
 
-bool dependency_graph_has_cycle(
+DependencyErrorCode dependency_graph_topological_sort(
     DependencyGraph *graph,
-    char *cycle_path,
-    size_t path_size
+    BuildOrder *order
 ) {
-    BuildOrder order;
+    if (!graph || !order) return DEP_ERROR_NULL_POINTER;
 
-    /* Reset visited flags */
-    for (size_t i = 0; i < graph->file_count; i++) {
-        graph->files[i]->visited = false;
-        graph->files[i]->in_stack = false;
+    order->file_count = 0;
+    order->ordered_files = malloc((graph->file_count + 1) * sizeof(SourceFile *));
+    if (!order->ordered_files) return DEP_ERROR_OUT_OF_MEMORY;
+
+    /* Process headers first, then sources */
+    char cycle_path[MAX_PATH_LENGTH * 2];
+    uint64_t trace_start = build_trace_begin();
+    DependencyErrorCode err = topological_sort_all(graph, order, true,
+                                                   cycle_path, sizeof(cycle_path));
+    build_trace_end(trace_start, "graph", "topological sort", NULL);
+    if (err == DEP_ERROR_CIRCULAR_DEPENDENCY) {
+        fprintf(stderr, "Circular dependency: %s\n", cycle_path);
     }
 
-    order.file_count = 0;
+    return err;
+}
 
-    for (size_t i = 0; i < graph->file_count; i++) {
-        if (!graph->files[i]->visited) {
-            if (!topological_sort_dfs(graph, graph->files[i], &order,
-                                     cycle_path, path_size)) {
-                return true;
-            }
-        }
-    }
+void build_order_destroy(BuildOrder *order) {
+    if (!order) return;
+    free(order->ordered_files);
+    order->ordered_files = NULL;
+    order->file_count = 0;
+}
 
-    return false;
+bool dependency_graph_has_cycle(
+    DependencyGraph *graph,
+    char *cycle_path,
+    size_t path_size
+) {
+    if (!graph) return false;
+
+    return topological_sort_all(graph, NULL, false, cycle_path, path_size) ==
+           DEP_ERROR_CIRCULAR_DEPENDENCY;
 }
 
 /* ==============================================================================
@@ -678,54 +1638,115 @@ bool dependency_graph_has_cycle(
  * ==============================================================================
  */
 
-static void collect_dependencies_recursive(
+DependencyErrorCode dependency_graph_get_all_dependencies(
     DependencyGraph *graph,
     SourceFile *file,
     SourceFile **deps,
     size_t max_deps,
-    size_t *dep_count,
-    bool *visited
+    size_t *dep_count
 ) {
-    size_t file_idx = 0;
-    for (size_t i = 0; i < graph->file_count; i++) {
-        if (graph->files[i] == file) {
-            file_idx = i;
-            break;
-        }
+    if (!graph || !file || !deps || !dep_count) {
+        return DEP_ERROR_NULL_POINTER;
     }
 
-    if (visited[file_idx]) return;
-    visited[file_idx] = true;
+    *dep_count = 0;
 
-    for (size_t i = 0; i < file->include_count; i++) {
-        SourceFile *dep = dependency_graph_find_file(graph, file->includes[i]);
-        if (!dep) continue;
+    DependencyErrorCode err = dependency_graph_build_adjacency(graph);
+    if (err != DEP_SUCCESS) return err;
+    if (file->id >= graph->file_count || graph->files[file->id] != file) {
+        return DEP_SUCCESS;
+    }
 
-        if (*dep_count < max_deps) {
-            deps[*dep_count] = dep;
-            (*dep_count)++;
+    /* Depth-first, listing each dependency when first reached */
+    const GraphAdjacency *adjacency = &graph->adjacency;
+    bool *seen = calloc(graph->file_count + 1, sizeof(bool));
+    uint32_t *stack = malloc((2 * graph->file_count + 1) * sizeof(uint32_t));
+    if (!seen || !stack) {
+        free(seen);
+        free(stack);
+        return DEP_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t *next_edge = stack + graph->file_count;
+
+    size_t depth = 0;
+    uint32_t root = (uint32_t)file->id;
+    seen[root] = true;
+    stack[depth++] = root;
+    next_edge[root] = adjacency->forward_start[root];
+
+    while (depth > 0) {
+        uint32_t node = stack[depth - 1];
+        if (next_edge[node] == adjacency->forward_start[node + 1]) {
+            depth--;
+            continue;
         }
 
-        collect_dependencies_recursive(graph, dep, deps, max_deps, dep_count, visited);
+        uint32_t dep = adjacency->forward[next_edge[node]++];
+        if (seen[dep]) continue;
+        seen[dep] = true;
+
+        if (*dep_count < max_deps) {
+            deps[(*dep_count)++] = graph->files[dep];
+        }
+        next_edge[dep] = adjacency->forward_start[dep];
+        stack[depth++] = dep;
     }
+
+    free(seen);
+    free(stack);
+    return DEP_SUCCESS;
 }
 
-DependencyErrorCode dependency_graph_get_all_dependencies(
+DependencyErrorCode dependency_graph_get_dependents(
     DependencyGraph *graph,
     SourceFile *file,
-    SourceFile **deps,
-    size_t max_deps,
-    size_t *dep_count
+    SourceFile **dependents,
+    size_t max_dependents,
+    size_t *dependent_count
 ) {
-    if (!graph || !file || !deps || !dep_count) {
+    if (!graph || !file || !dependents || !dependent_count) {
         return DEP_ERROR_NULL_POINTER;
     }
 
-    *dep_count = 0;
+    *dependent_count = 0;
 
-    bool visited[MAX_SOURCE_FILES] = {false};
-    collect_dependencies_recursive(graph, file, deps, max_deps, dep_count, visited);
+    DependencyErrorCode err = dependency_graph_build_adjacency(graph);
+    if (err != DEP_SUCCESS) return err;
+    if (file->id >= graph->file_count || graph->files[file->id] != file) {
+        return DEP_SUCCESS;
+    }
+
+    /* Breadth-first over reverse edges; queue doubles as the seen list */
+    const GraphAdjacency *adjacency = &graph->adjacency;
+    bool *seen = calloc(graph->file_count + 1, sizeof(bool));
+    uint32_t *queue = malloc((graph->file_count + 1) * sizeof(uint32_t));
+    if (!seen || !queue) {
+        free(seen);
+        free(queue);
+        return DEP_ERROR_OUT_OF_MEMORY;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    seen[file->id] = true;
+    queue[tail++] = (uint32_t)file->id;
+
+    while (head < tail) {
+        uint32_t node = queue[head++];
+        for (uint32_t e = adjacency->reverse_start[node]; e < adjacency->reverse_start[node + 1]; e++) {
+            uint32_t dependent = adjacency->reverse[e];
+            if (seen[dependent]) continue;
+            seen[dependent] = true;
+            queue[tail++] = dependent;
+
+            if (*dependent_count < max_dependents) {
+                dependents[(*dependent_count)++] = graph->files[dependent];
+            }
+        }
+    }
 
+    free(seen);
+    free(queue);
     return DEP_SUCCESS;
 }
 
@@ -733,7 +1754,7 @@ SourceFile *dependency_graph_find_main(const DependencyGraph *graph) {
     if (!graph) return NULL;
 
     for (size_t i = 0; i < graph->file_count; i++) {
-        if (has_main_function(graph->files[i])) {
+        if (source_file_has_main(graph->files[i])) {
             return graph->files[i];
         }
     }
@@ -757,7 +1778,7 @@ DependencyErrorCode dependency_graph_find_libraries(
         SourceFile *file = graph->files[i];
 
         /* Library files are non-header sources without main */
-        if (!file->is_header && !has_main_function(file)) {
+        if (!file->is_header && !source_file_has_main(file)) {
             if (*file_count < max_files) {
                 lib_files[*file_count] = file;
                 (*file_count)++;
@@ -14,16 +14,16 @@
 #ifndef DEPENDENCY_RESOLVER_H
 #define DEPENDENCY_RESOLVER_H
 
+#include "path_index.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* ==============================================================================
  * Configuration Constants
  * ==============================================================================
  */
 
-#define MAX_SOURCE_FILES 1024
-#define MAX_INCLUDES_PER_FILE 256
 #define MAX_PATH_LENGTH 4096
 #define MAX_INCLUDE_PATHS 64
 
@@ -50,34 +50,113 @@ typedef enum {
  * ==============================================================================
  */
 
+/* Arena and interned paths shared by a graph's files (internal) */
+struct GraphStore;
+
 /**
  * SourceFile - Represents a single C/C++ source or header file
+ *
+ * Nodes, their include arrays and every path string live in the graph's
+ * arena; paths are interned, so a header included by many files is stored
+ * once. All of it is freed by dependency_graph_destroy.
  */
 typedef struct SourceFile {
-    char path[MAX_PATH_LENGTH];              /* Full path to the file */
-    char *includes[MAX_INCLUDES_PER_FILE];   /* Included files */
+    const char *path;                         /* Full path to the file (interned) */
+    const char **includes;                    /* Included files (interned) */
     size_t include_count;                     /* Number of includes */
+    size_t include_capacity;                  /* Allocated include slots */
+    struct GraphStore *store;                 /* Storage of the owning graph */
+    size_t id;                                /* Position in graph->files */
     bool is_header;                           /* true if .h/.hpp file */
     bool visited;                             /* For graph traversal */
     bool in_stack;                            /* For cycle detection */
     int sort_order;                           /* Topological sort position */
+    bool scanned;                             /* includes[] is known (parsed or provided) */
+    bool dependencies_provided;               /* includes[] is a complete, transitive list */
+    bool main_known;                          /* has_main is set */
+    bool has_main;                            /* Defines main() (see source_file_has_main) */
+    bool generated;                           /* Written by the build (see dependency_graph_add_generated_file) */
 } SourceFile;
 
+/**
+ * IncludeProvision - What an IncludeProvider supplied
+ */
+typedef enum {
+    INCLUDES_NOT_PROVIDED = 0,                /* Parse the file */
+    INCLUDES_DIRECT,                          /* Direct includes, as parsing would find them */
+    INCLUDES_TRANSITIVE                       /* Every dependency, e.g. from a compiler depfile */
+} IncludeProvision;
+
+/**
+ * IncludeProvider - Supplies a file's dependencies so it need not be parsed
+ *
+ * Called before a file is parsed. Add its dependencies with
+ * source_file_add_include (and set main_known/has_main if known) and say
+ * what kind of list it is, or return INCLUDES_NOT_PROVIDED (adding
+ * nothing) to have it parsed as usual. Direct includes are followed like
+ * parsed ones. A transitive list is complete, so the files it names are
+ * registered without being scanned themselves. While a provider is set,
+ * headers found by a directory scan are only scanned once a scanned file
+ * includes them. With more than one scan thread the provider is called
+ * from several threads at once.
+ */
+typedef IncludeProvision (*IncludeProvider)(void *user_data, SourceFile *file);
+
+/**
+ * GraphAdjacency - Include edges between graph nodes, by node id
+ *
+ * Compressed sparse row form: the files node i includes are
+ * forward[forward_start[i]] .. forward[forward_start[i + 1] - 1], in
+ * include order, and the files that include node i are listed the same
+ * way in reverse/reverse_start. Node i is graph->files[i]; includes that
+ * are not in the graph (system headers) have no edge.
+ */
+typedef struct GraphAdjacency {
+    uint32_t *forward_start;                  /* node_count + 1 offsets into forward */
+    uint32_t *forward;                        /* Included node ids */
+    uint32_t *reverse_start;                  /* node_count + 1 offsets into reverse */
+    uint32_t *reverse;                        /* Including node ids */
+    size_t node_count;                        /* Nodes covered */
+    size_t edge_count;                        /* Edges in each direction */
+    bool current;                             /* Matches the graph's includes */
+} GraphAdjacency;
+
+/* Files parsed ahead of a directory scan's merge (internal) */
+struct ScanPrefetch;
+
+/* Memoized include resolutions (internal) */
+struct IncludeMemo;
+
 /**
  * DependencyGraph - Dependency graph for all source files
  */
 typedef struct DependencyGraph {
-    SourceFile *files[MAX_SOURCE_FILES];     /* Array of source files */
+    SourceFile **files;                       /* Array of source files */
     size_t file_count;                        /* Number of files */
+    size_t file_capacity;                     /* Allocated file slots */
+    PathIndex file_index;                     /* Path -> position in files */
+    struct GraphStore *store;                 /* Arena for nodes and paths */
     char *include_paths[MAX_INCLUDE_PATHS];  /* Search paths for headers */
     size_t include_path_count;                /* Number of include paths */
+    IncludeProvider include_provider;         /* Optional, see IncludeProvider */
+    void *include_provider_data;              /* Passed to include_provider */
+    size_t parsed_count;                      /* Files whose includes were parsed */
+    size_t reused_count;                      /* Files given INCLUDES_DIRECT */
+    size_t provided_count;                    /* Files given INCLUDES_TRANSITIVE */
+    size_t scan_threads;                      /* Directory scan workers (1 = serial) */
+    struct ScanPrefetch *prefetch;            /* Set only while a scan is merging */
+    struct IncludeMemo *include_memo;         /* (directory, name) -> resolved path */
+    GraphAdjacency adjacency;                 /* Integer edges, see dependency_graph_build_adjacency */
 } DependencyGraph;
 
 /**
  * BuildOrder - Topologically sorted build order
+ *
+ * Filled by dependency_graph_topological_sort; release with
+ * build_order_destroy.
  */
 typedef struct BuildOrder {
-    SourceFile *ordered_files[MAX_SOURCE_FILES];  /* Files in build order */
+    SourceFile **ordered_files;                    /* Files in build order */
     size_t file_count;                             /* Number of files */
 } BuildOrder;
 
@@ -109,6 +188,72 @@ DependencyErrorCode dependency_graph_add_include_path(
     const char *path
 );
 
+/**
+ * Set (or clear, with NULL) the include provider consulted before parsing
+ * @param graph      Pointer to DependencyGraph
+ * @param provider   Provider callback, or NULL
+ * @param user_data  Passed to the provider
+ */
+void dependency_graph_set_include_provider(
+    DependencyGraph *graph,
+    IncludeProvider provider,
+    void *user_data
+);
+
+/**
+ * Forget memoized include resolutions
+ *
+ * Each (including directory, include name) pair is resolved on disk once
+ * per graph, including names that are not found. Call this when files
+ * may have appeared or disappeared since the last scan; adding an include
+ * path does it automatically.
+ * @param graph  Pointer to DependencyGraph
+ */
+void dependency_graph_clear_include_cache(DependencyGraph *graph);
+
+/**
+ * Get include resolution counters
+ * @param graph    Pointer to DependencyGraph
+ * @param lookups  Receives the number of includes resolved (can be NULL)
+ * @param probes   Receives the number of files stat'ed for them (can be NULL)
+ */
+void dependency_graph_include_cache_stats(
+    const DependencyGraph *graph,
+    size_t *lookups,
+    size_t *probes
+);
+
+/**
+ * Set how many threads directory scans use
+ *
+ * Directories are listed and files parsed by a worker pool; the results
+ * are merged into the graph in sorted path order, so the graph (and the
+ * build order derived from it) does not depend on the thread count.
+ * @param graph    Pointer to DependencyGraph
+ * @param threads  Worker count (0 or 1 = scan on the calling thread)
+ */
+void dependency_graph_set_scan_threads(DependencyGraph *graph, size_t threads);
+
+/**
+ * Record a dependency of a source file (for include providers)
+ * @param file          Source file
+ * @param include_path  Path of the dependency (interned in the graph)
+ * @return              DEP_SUCCESS or error code
+ */
+DependencyErrorCode source_file_add_include(
+    SourceFile *file,
+    const char *include_path
+);
+
+/**
+ * Check whether a source file defines main()
+ *
+ * The answer is read from the file once and kept in the SourceFile.
+ * @param file  Source file
+ * @return      true if the file defines main()
+ */
+bool source_file_has_main(SourceFile *file);
+
 /**
  * Add a source file to the graph and parse its dependencies
  * @param graph      Pointer to DependencyGraph
@@ -120,8 +265,93 @@ DependencyErrorCode dependency_graph_add_file(
     const char *file_path
 );
 
+/**
+ * Read a file's includes again after it changed on disk
+ *
+ * A file the graph does not know yet is added, as by
+ * dependency_graph_add_file. Files it now includes are added too; those
+ * it no longer includes keep their nodes but lose the edge. Call
+ * dependency_graph_build_adjacency once the changes are all in.
+ *
+ * @param graph      Pointer to DependencyGraph
+ * @param file_path  Path to the changed file, spelled as the scan spelled it
+ * @return           DEP_SUCCESS or error code
+ */
+DependencyErrorCode dependency_graph_refresh_file(
+    DependencyGraph *graph,
+    const char *file_path
+);
+
+/**
+ * Add a file the build writes itself, with includes it already knows
+ *
+ * The file is not read: its includes are the given paths, spelled as the
+ * graph spells them, and it has no main(). Adding it again replaces its
+ * includes. The node is marked generated. Call
+ * dependency_graph_build_adjacency once the changes are all in.
+ *
+ * @param graph          Pointer to DependencyGraph
+ * @param file_path      Path to the generated file (must exist)
+ * @param includes       Files it includes
+ * @param include_count  Number of includes
+ * @return               DEP_SUCCESS or error code
+ */
+DependencyErrorCode dependency_graph_add_generated_file(
+    DependencyGraph *graph,
+    const char *file_path,
+    const char *const *includes,
+    size_t include_count
+);
+
+/**
+ * Whether a path names a file the scanner picks up (.c, .cc, .cpp, .h, .hpp)
+ * @param path  File path
+ * @return      true for C/C++ sources and headers
+ */
+bool dependency_is_source_path(const char *path);
+
+/**
+ * Whether the scanner skips a directory
+ * @param dir_name       Directory name or path (only the last component counts)
+ * @param exclude_dirs   Extra directory names to skip (can be NULL)
+ * @param exclude_count  Number of extra names
+ * @return               true if excluded by default or by exclude_dirs
+ */
+bool dependency_is_excluded_directory(
+    const char *dir_name,
+    const char **exclude_dirs,
+    size_t exclude_count
+);
+
+/**
+ * Resolve an #include the way the scanner does
+ *
+ * "..." includes are looked for next to the including file first, then
+ * in the include paths and the current directory; <...> includes skip
+ * the first step. Results are memoized with the scanner's.
+ *
+ * @param graph             Pointer to DependencyGraph (include paths)
+ * @param include_name      Name between the quotes or brackets
+ * @param quoted            true for "..." includes
+ * @param referencing_file  File the #include is in
+ * @param resolved_path     Set to the path found
+ * @param path_size         Size of resolved_path
+ * @return                  true if the file was found
+ */
+bool dependency_graph_resolve_include(
+    const DependencyGraph *graph,
+    const char *include_name,
+    bool quoted,
+    const char *referencing_file,
+    char *resolved_path,
+    size_t path_size
+);
+
 /**
  * Scan a directory and add all C/C++ source files
+ *
+ * Files are added in sorted path order, whatever order the file system
+ * lists them in.
  * @param graph      Pointer to DependencyGraph
  * @param directory  Directory to scan
  * @param recursive  Whether to scan subdirectories
@@ -161,10 +391,22 @@ SourceFile *dependency_graph_find_file(
     const char *path
 );
 
+/**
+ * Build the integer adjacency of the graph's include edges
+ *
+ * Scans build it when they finish; the graph algorithms below rebuild it
+ * when files or includes were added since. Includes edited directly with
+ * source_file_add_include are not tracked: call this again afterwards.
+ * @param graph  Pointer to DependencyGraph
+ * @return       DEP_SUCCESS or error code
+ */
+DependencyErrorCode dependency_graph_build_adjacency(DependencyGraph *graph);
+
 /**
  * Perform topological sort to determine build order
  * @param graph  Pointer to DependencyGraph
- * @param order  Pointer to BuildOrder to populate
+ * @param order  Pointer to BuildOrder to populate (release with
+ *               build_order_destroy, whatever the result)
  * @return       DEP_SUCCESS or error code
  */
 DependencyErrorCode dependency_graph_topological_sort(
@@ -172,6 +414,12 @@ DependencyErrorCode dependency_graph_topological_sort(
     BuildOrder *order
 );
 
+/**
+ * Free the array of a build order
+ * @param order  Pointer to BuildOrder
+ */
+void build_order_destroy(BuildOrder *order);
+
 /**
  * Detect circular dependencies in the graph
  * @param graph       Pointer to DependencyGraph
@@ -202,6 +450,26 @@ DependencyErrorCode dependency_graph_get_all_dependencies(
     size_t *dep_count
 );
 
+/**
+ * Get every file that depends on a file (transitive dependents)
+ *
+ * Files are listed nearest first: the files including it, then the files
+ * including those, and so on.
+ * @param graph            Pointer to DependencyGraph
+ * @param file             File whose dependents are wanted
+ * @param dependents       Array to store dependents
+ * @param max_dependents   Maximum number of dependents
+ * @param dependent_count  Pointer to store actual dependent count
+ * @return                 DEP_SUCCESS or error code
+ */
+DependencyErrorCode dependency_graph_get_dependents(
+    DependencyGraph *graph,
+    SourceFile *file,
+    SourceFile **dependents,
+    size_t max_dependents,
+    size_t *dependent_count
+);
+
 /**
  * Find the main entry point in the graph
  * @param graph  Pointer to DependencyGraph
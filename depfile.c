@@ -0,0 +1,192 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Compiler Depfiles Implementation
+ * ==============================================================================
+ */
+
+#include "depfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define DEPFILE_LIST_MIN_CAPACITY 32
+#define DEPFILE_MAX_SIZE (16u * 1024 * 1024)    /* Refuse anything implausibly large */
+
+/* ==============================================================================
+ * List Management
+ * ==============================================================================
+ */
+
+void depfile_list_init(DepfileList *list) {
+    if (!list) return;
+    list->paths = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+void depfile_list_destroy(DepfileList *list) {
+    if (!list) return;
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    depfile_list_init(list);
+}
+
+static bool depfile_list_add(DepfileList *list, const char *path) {
+    if (list->count >= list->capacity) {
+        size_t new_capacity = list->capacity == 0 ? DEPFILE_LIST_MIN_CAPACITY : list->capacity * 2;
+        char **new_paths = realloc(list->paths, new_capacity * sizeof(char *));
+        if (!new_paths) return false;
+        list->paths = new_paths;
+        list->capacity = new_capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy) return false;
+
+    list->paths[list->count++] = copy;
+    return true;
+}
+
+/* ==============================================================================
+ * Parsing
+ * ==============================================================================
+ */
+
+/**
+ * Read a whole file into a NUL-terminated buffer
+ */
+static char *read_text_file(const char *path, size_t *length) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0 || (unsigned long)size > DEPFILE_MAX_SIZE) {
+        fclose(fp);
+        return NULL;
+    }
+
+    char *text = malloc((size_t)size + 1);
+    if (!text) {
+        fclose(fp);
+        return NULL;
+    }
+
+    *length = fread(text, 1, (size_t)size, fp);
+    text[*length] = '\0';
+    fclose(fp);
+    return text;
+}
+
+bool depfile_path_for_object(const char *object_path, char *dest, size_t dest_size) {
+    if (!object_path || !dest || dest_size == 0) return false;
+
+    /* Only replace an extension in the last path component */
+    const char *dot = strrchr(object_path, '.');
+    const char *slash = strrchr(object_path, '/');
+    const char *backslash = strrchr(object_path, '\\');
+    if (backslash > slash) slash = backslash;
+
+    size_t stem = (dot && (!slash || dot > slash)) ? (size_t)(dot - object_path)
+                                                   : strlen(object_path);
+    int written = snprintf(dest, dest_size, "%.*s.d", (int)stem, object_path);
+    return written > 0 && (size_t)written < dest_size;
+}
+
+bool depfile_parse(const char *depfile_path, DepfileList *list) {
+    if (!depfile_path || !list) return false;
+
+    size_t length = 0;
+    char *text = read_text_file(depfile_path, &length);
+    if (!text) return false;
+
+    char token[MAX_PATH_LENGTH];
+    size_t token_length = 0;
+    bool in_prerequisites = false;          /* Past the ':' of the current rule */
+    bool seen_rule = false;                 /* A rule has ended */
+    bool skipped_source = false;            /* First prerequisite dropped */
+    bool ok = true;
+
+    for (size_t i = 0; ok && i <= length; i++) {
+        char c = text[i];
+        bool end_token = false;
+        bool end_rule = false;
+
+        if (c == '\\' && (text[i + 1] == '\n' ||
+                          (text[i + 1] == '\r' && text[i + 2] == '\n'))) {
+            /* Line continuation */
+            i += text[i + 1] == '\r' ? 2 : 1;
+            end_token = true;
+        } else if (c == '\\' && (text[i + 1] == ' ' || text[i + 1] == '#')) {
+            if (token_length + 1 < sizeof(token)) token[token_length++] = text[i + 1];
+            i++;
+        } else if (c == '$' && text[i + 1] == '$') {
+            if (token_length + 1 < sizeof(token)) token[token_length++] = '$';
+            i++;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            end_token = true;
+        } else if (c == '\n' || c == '\0') {
+            end_token = true;
+            end_rule = true;
+        } else if (c == ':' && !in_prerequisites &&
+                   (text[i + 1] == ' ' || text[i + 1] == '\t' || text[i + 1] == '\n' ||
+                    text[i + 1] == '\r' || text[i + 1] == '\0')) {
+            /* Target list ends; a ':' followed by a path is a drive letter */
+            token_length = 0;
+            in_prerequisites = true;
+        } else {
+            if (token_length + 1 < sizeof(token)) token[token_length++] = c;
+        }
+
+        if (end_token && token_length > 0) {
+            token[token_length] = '\0';
+            token_length = 0;
+
+            if (in_prerequisites) {
+                if (!seen_rule && !skipped_source) {
+                    skipped_source = true;
+                } else {
+                    ok = depfile_list_add(list, token);
+                }
+            }
+        }
+
+        if (end_rule && in_prerequisites) {
+            in_prerequisites = false;
+            seen_rule = true;
+        }
+    }
+
+    free(text);
+
+    /* A depfile without any rule is truncated or not a depfile at all */
+    return ok && seen_rule;
+}
+
+void depfile_canonical_path(const DependencyGraph *graph, const char *path,
+                            char *dest, size_t dest_size) {
+    if (!dest || dest_size == 0) return;
+    snprintf(dest, dest_size, "%s", path ? path : "");
+    if (!graph || !path || dependency_graph_find_file(graph, path)) return;
+
+    char alternate[MAX_PATH_LENGTH];
+    if (strncmp(path, "./", 2) == 0) {
+        snprintf(alternate, sizeof(alternate), "%s", path + 2);
+    } else if (path[0] != '/' && !(path[0] && path[1] == ':')) {
+        snprintf(alternate, sizeof(alternate), "./%s", path);
+    } else {
+        return;
+    }
+
+    if (dependency_graph_find_file(graph, alternate)) {
+        snprintf(dest, dest_size, "%s", alternate);
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Compiler Depfiles
+ * ==============================================================================
+ *
+ * Reads the Makefile-syntax dependency files that GCC and Clang write with
+ * -MMD -MF. A depfile lists every header the preprocessor actually opened,
+ * after macros and conditionals, so it is exact where the #include scanner
+ * in dependency_resolver.c is a heuristic. -MMD omits system headers.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef DEPFILE_H
+#define DEPFILE_H
+
+#include "dependency_resolver.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * DepfileList - Dependencies read from one depfile
+ */
+typedef struct DepfileList {
+    char **paths;                           /* Dependency paths, as the compiler wrote them */
+    size_t count;                           /* Number of paths */
+    size_t capacity;                        /* Allocated slots */
+} DepfileList;
+
+/**
+ * Initialize an empty list
+ *
+ * @param list  Pointer to DepfileList
+ */
+void depfile_list_init(DepfileList *list);
+
+/**
+ * Free every path in the list
+ *
+ * @param list  Pointer to DepfileList
+ */
+void depfile_list_destroy(DepfileList *list);
+
+/**
+ * Path of the depfile written next to an object file ("x.o" -> "x.d")
+ *
+ * @param object_path  Object file path
+ * @param dest         Destination buffer
+ * @param dest_size    Size of destination buffer
+ * @return             true on success, false if the path does not fit
+ */
+bool depfile_path_for_object(const char *object_path, char *dest, size_t dest_size);
+
+/**
+ * Parse a depfile
+ *
+ * Collects the prerequisites of every rule except the first prerequisite
+ * of the first rule, which is the source file itself. Handles line
+ * continuations, "\ " escaped spaces, "$$" and the empty phony rules
+ * added by -MP.
+ *
+ * @param depfile_path  Path to the .d file
+ * @param list          Initialized list to append to
+ * @return              true on success, false if the file is missing or malformed
+ */
+bool depfile_parse(const char *depfile_path, DepfileList *list);
+
+/**
+ * Spell a depfile path the way the dependency graph spells it
+ *
+ * Compilers drop a leading "./" that the directory scanner keeps; when the
+ * graph knows the file under either spelling, that spelling is used so
+ * cache entries and graph lookups agree.
+ *
+ * @param graph      Dependency graph (can be NULL)
+ * @param path       Path from a depfile
+ * @param dest       Destination buffer
+ * @param dest_size  Size of destination buffer
+ */
+void depfile_canonical_path(const DependencyGraph *graph, const char *path,
+                            char *dest, size_t dest_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEPFILE_H */
@@ -0,0 +1,945 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Distributed Compilation Implementation
+ * ==============================================================================
+ *
+ * Wire format (integers little-endian):
+ *
+ *   request   "ECD1", u32 argc, argc x (u32 length, bytes),
+ *             u32 language, u64 unit size, unit bytes
+ *   response  "ECD1", u32 status, i32 exit code,
+ *             u32 diagnostics size, diagnostics, u64 object size, object bytes
+ *
+ * argv[0] of a request is the compiler's base name and the rest are
+ * compile flags; the worker adds "-c <unit> -o <object>" itself.
+ */
+
+#include "distributed_compile.h"
+#include "build_trace.h"
+#include "net_socket.h"
+#include "process_spawn.h"
+#include "depfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define rmdir _rmdir
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define DIST_MAGIC "ECD1"
+#define DIST_MAX_ARGS 1024
+#define DIST_MAX_ARG_LENGTH 4096
+#define DIST_MAX_UNIT_BYTES (1024ull * 1024 * 1024)
+#define DIST_MAX_DIAGNOSTICS (64u * 1024)
+#define DIST_BUFFER_SIZE (64u * 1024)
+
+typedef enum {
+    DIST_LANGUAGE_C = 0,
+    DIST_LANGUAGE_CXX = 1
+} DistLanguage;
+
+typedef enum {
+    DIST_STATUS_COMPILED = 0,               /* Object follows */
+    DIST_STATUS_FAILED = 1,                 /* The compiler reported errors */
+    DIST_STATUS_REFUSED = 2                 /* Bad request, or the worker could not run it */
+} DistStatus;
+
+/* ==============================================================================
+ * Wire Helpers
+ * ==============================================================================
+ */
+
+static void encode_u32(unsigned char *dest, uint32_t value) {
+    for (int i = 0; i < 4; i++) dest[i] = (unsigned char)(value >> (8 * i));
+}
+
+static void encode_u64(unsigned char *dest, uint64_t value) {
+    for (int i = 0; i < 8; i++) dest[i] = (unsigned char)(value >> (8 * i));
+}
+
+static uint32_t decode_u32(const unsigned char *src) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)src[i] << (8 * i);
+    return value;
+}
+
+static uint64_t decode_u64(const unsigned char *src) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= (uint64_t)src[i] << (8 * i);
+    return value;
+}
+
+static bool send_u32(net_socket_t sock, uint32_t value) {
+    unsigned char bytes[4];
+    encode_u32(bytes, value);
+    return net_send_all(sock, bytes, sizeof(bytes));
+}
+
+static bool send_u64(net_socket_t sock, uint64_t value) {
+    unsigned char bytes[8];
+    encode_u64(bytes, value);
+    return net_send_all(sock, bytes, sizeof(bytes));
+}
+
+static bool recv_u32(net_socket_t sock, uint32_t *value) {
+    unsigned char bytes[4];
+    if (!net_recv_all(sock, bytes, sizeof(bytes))) return false;
+    *value = decode_u32(bytes);
+    return true;
+}
+
+static bool recv_u64(net_socket_t sock, uint64_t *value) {
+    unsigned char bytes[8];
+    if (!net_recv_all(sock, bytes, sizeof(bytes))) return false;
+    *value = decode_u64(bytes);
+    return true;
+}
+
+static bool send_string(net_socket_t sock, const char *str) {
+    size_t length = strlen(str);
+    return send_u32(sock, (uint32_t)length) && net_send_all(sock, str, length);
+}
+
+/**
+ * Send a file's size and then its bytes
+ */
+static bool send_file(net_socket_t sock, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    char *buffer = malloc(DIST_BUFFER_SIZE);
+    bool ok = buffer && size >= 0 && send_u64(sock, (uint64_t)size);
+    uint64_t remaining = (uint64_t)(size > 0 ? size : 0);
+    while (ok && remaining > 0) {
+        size_t count = fread(buffer, 1, DIST_BUFFER_SIZE, fp);
+        if (count == 0 || count > remaining) {
+            ok = false;
+            break;
+        }
+        ok = net_send_all(sock, buffer, count);
+        remaining -= count;
+    }
+
+    free(buffer);
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * Receive size bytes into a file
+ */
+static bool recv_file(net_socket_t sock, uint64_t size, const char *path) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    char *buffer = malloc(DIST_BUFFER_SIZE);
+    bool ok = buffer != NULL;
+    while (ok && size > 0) {
+        size_t want = size > DIST_BUFFER_SIZE ? DIST_BUFFER_SIZE : (size_t)size;
+        long count = net_recv(sock, buffer, want);
+        if (count <= 0) {
+            ok = false;
+            break;
+        }
+        ok = fwrite(buffer, 1, (size_t)count, fp) == (size_t)count;
+        size -= (uint64_t)count;
+    }
+
+    free(buffer);
+    if (fclose(fp) != 0) ok = false;
+    if (!ok) remove(path);
+    return ok;
+}
+
+static bool replace_file(const char *from, const char *to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+static const char *base_name(const char *path) {
+    const char *name = path;
+    for (const char *p = path; *p; p++) {
+        if (*p == '/' || *p == '\\') name = p + 1;
+    }
+    return name;
+}
+
+/* ==============================================================================
+ * Pool
+ * ==============================================================================
+ */
+
+/**
+ * Parse one "host[:port][/slots]" entry
+ */
+static bool parse_worker(const char *entry, size_t length, DistWorker *worker) {
+    memset(worker, 0, sizeof(DistWorker));
+    strcpy(worker->port, DIST_DEFAULT_PORT);
+    worker->slots = DIST_DEFAULT_SLOTS;
+
+    const char *slash = memchr(entry, '/', length);
+    if (slash) {
+        int slots = atoi(slash + 1);
+        if (slots < 1) return false;
+        worker->slots = slots;
+        length = (size_t)(slash - entry);
+    }
+
+    const char *host = entry;
+    size_t host_length = length;
+    const char *port = NULL;
+    if (length > 0 && entry[0] == '[') {
+        const char *close = memchr(entry, ']', length);
+        if (!close) return false;
+        host = entry + 1;
+        host_length = (size_t)(close - host);
+        if (close + 1 < entry + length) {
+            if (close[1] != ':') return false;
+            port = close + 2;
+        }
+    } else {
+        const char *colon = memchr(entry, ':', length);
+        if (colon) {
+            host_length = (size_t)(colon - entry);
+            port = colon + 1;
+        }
+    }
+
+    if (host_length == 0 || host_length >= sizeof(worker->host)) return false;
+    memcpy(worker->host, host, host_length);
+
+    if (port) {
+        size_t port_length = (size_t)(entry + length - port);
+        if (port_length == 0 || port_length >= sizeof(worker->port)) return false;
+        for (size_t i = 0; i < port_length; i++) {
+            if (port[i] < '0' || port[i] > '9') return false;
+        }
+        memcpy(worker->port, port, port_length);
+        worker->port[port_length] = '\0';
+    }
+    return true;
+}
+
+DistPool *dist_pool_create(const char *hosts) {
+    if (!hosts) return NULL;
+
+    size_t capacity = 1;
+    for (const char *p = hosts; *p; p++) {
+        if (*p == ',') capacity++;
+    }
+
+    DistPool *pool = calloc(1, sizeof(DistPool));
+    if (!pool) return NULL;
+    pool->workers = calloc(capacity, sizeof(DistWorker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+
+    const char *entry = hosts;
+    while (*entry) {
+        const char *end = strchr(entry, ',');
+        size_t length = end ? (size_t)(end - entry) : strlen(entry);
+
+        /* Tolerate spaces around entries */
+        while (length > 0 && entry[0] == ' ') {
+            entry++;
+            length--;
+        }
+        while (length > 0 && entry[length - 1] == ' ') length--;
+
+        if (length > 0) {
+            if (!parse_worker(entry, length, &pool->workers[pool->worker_count])) {
+                free(pool->workers);
+                free(pool);
+                return NULL;
+            }
+            pool->worker_count++;
+        }
+
+        if (!end) break;
+        entry = end + 1;
+    }
+
+    if (pool->worker_count == 0 || !net_startup()) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    ec_mutex_init(&pool->lock);
+    ec_cond_init(&pool->slot_free);
+    return pool;
+}
+
+void dist_pool_destroy(DistPool *pool) {
+    if (!pool) return;
+
+    ec_cond_destroy(&pool->slot_free);
+    ec_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+    net_cleanup();
+}
+
+size_t dist_pool_slots(const DistPool *pool) {
+    if (!pool) return 0;
+
+    size_t slots = 0;
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        slots += (size_t)pool->workers[i].slots;
+    }
+    return slots;
+}
+
+/**
+ * Take a slot on the least loaded worker, waiting while every worker is
+ * full; NULL once no worker is left
+ */
+static DistWorker *acquire_worker(DistPool *pool) {
+    ec_mutex_lock(&pool->lock);
+    for (;;) {
+        DistWorker *best = NULL;
+        bool any_enabled = false;
+
+        for (size_t i = 0; i < pool->worker_count; i++) {
+            DistWorker *worker = &pool->workers[i];
+            if (worker->disabled) continue;
+            any_enabled = true;
+            if (worker->busy >= worker->slots) continue;
+
+            /* Lowest busy/slots ratio, compared without division */
+            if (!best || (long)worker->busy * best->slots < (long)best->busy * worker->slots) {
+                best = worker;
+            }
+        }
+
+        if (best) {
+            best->busy++;
+            ec_mutex_unlock(&pool->lock);
+            return best;
+        }
+        if (!any_enabled) {
+            ec_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        ec_cond_wait(&pool->slot_free, &pool->lock);
+    }
+}
+
+/**
+ * Return a slot, counting whether the worker did its job
+ */
+static void release_worker(DistPool *pool, DistWorker *worker, bool healthy, bool compiled) {
+    ec_mutex_lock(&pool->lock);
+    worker->busy--;
+
+    if (healthy) {
+        worker->failures = 0;
+    } else if (++worker->failures >= DIST_MAX_FAILURES && !worker->disabled) {
+        worker->disabled = true;
+        fprintf(stderr, "Warning: Dropping compile worker %s:%s after %u failures\n",
+                worker->host, worker->port, worker->failures);
+    }
+
+    if (compiled) {
+        worker->compiled++;
+        pool->remote_compiles++;
+    } else {
+        pool->local_fallbacks++;
+    }
+
+    ec_cond_broadcast(&pool->slot_free);
+    ec_mutex_unlock(&pool->lock);
+}
+
+/* ==============================================================================
+ * Client
+ * ==============================================================================
+ */
+
+/**
+ * Number of arguments at flags[i] that only matter to the preprocessor
+ * (0 to send the flag to the worker)
+ */
+static size_t preprocessor_flag_width(char *const *flags, size_t count, size_t i) {
+    static const char *const separate[] = {
+        "-include", "-imacros", "-isystem", "-iquote", "-idirafter", "-iprefix",
+        "-MF", "-MT", "-MQ"
+    };
+    static const char *const joined[] = { "-I", "-D", "-U", "-isystem", "-iquote", "-idirafter" };
+    const char *flag = flags[i];
+
+    for (size_t j = 0; j < sizeof(separate) / sizeof(separate[0]); j++) {
+        if (strcmp(flag, separate[j]) == 0) return i + 1 < count ? 2 : 1;
+    }
+    if ((strcmp(flag, "-I") == 0 || strcmp(flag, "-D") == 0 || strcmp(flag, "-U") == 0) &&
+        i + 1 < count) {
+        return 2;
+    }
+    for (size_t j = 0; j < sizeof(joined) / sizeof(joined[0]); j++) {
+        if (strncmp(flag, joined[j], strlen(joined[j])) == 0) return 1;
+    }
+    if (strcmp(flag, "-MD") == 0 || strcmp(flag, "-MMD") == 0 || strcmp(flag, "-MP") == 0) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Run the preprocessor locally into unit_path
+ */
+static bool preprocess_source(
+    const SourceFile *source,
+    const BuildConfig *config,
+    const char *object_path,
+    const char *unit_path
+) {
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+
+    ProcessArgs args;
+    process_args_init(&args);
+    bool ok = process_args_add(&args, compiler) &&
+              process_args_add(&args, "-E") &&
+              process_args_add(&args, source->path) &&
+              process_args_add(&args, "-o") &&
+              process_args_add(&args, unit_path);
+
+    for (size_t i = 0; ok && i < config->include_path_count; i++) {
+        ok = process_args_addf(&args, "-I%s", config->include_paths[i]);
+    }
+    for (size_t i = 0; ok && i < config->cflag_count; i++) {
+        ok = process_args_add(&args, config->cflags[i]);
+    }
+
+    /* The depfile comes from here, named for the object rather than the unit */
+    if (ok && config->use_depfiles) {
+        char depfile[MAX_PATH_LENGTH];
+        ok = depfile_path_for_object(object_path, depfile, sizeof(depfile)) &&
+             process_args_add(&args, "-MMD") &&
+             process_args_add(&args, "-MF") &&
+             process_args_add(&args, depfile) &&
+             process_args_add(&args, "-MT") &&
+             process_args_add(&args, object_path);
+    }
+
+    char prefix[MAX_PATH_LENGTH + 8];
+    snprintf(prefix, sizeof(prefix), "  [%s] ", source->path);
+
+    ProcessCapture capture = {0};
+    capture.limit = MAX_COMPILE_OUTPUT;
+    if (config->verbose) {
+        capture.echo = stderr;
+        capture.echo_prefix = prefix;
+    }
+    ok = ok && process_run_captured(args.argv, &capture);
+    process_args_destroy(&args);
+
+    /* #warning and friends only show up here, not in the remote compile;
+     * a failure's diagnostics come from the local compile that follows */
+    if (ok && capture.output && !capture.echo) {
+        fputs(capture.output, stderr);
+    }
+    free(capture.output);
+    return ok;
+}
+
+/**
+ * Send one job and read back the result
+ *
+ * @return  false on a transport or protocol failure; *status says what
+ *          the worker did otherwise
+ */
+static bool run_remote_job(
+    const DistWorker *worker,
+    const BuildConfig *config,
+    DistLanguage language,
+    const char *unit_path,
+    const char *object_temp,
+    uint32_t *status,
+    int *exit_code,
+    char **diagnostics
+) {
+    net_socket_t sock = net_connect(worker->host, worker->port, DIST_TIMEOUT_MS);
+    if (sock == NET_SOCKET_NONE) return false;
+
+    const char *compiler = base_name(config->compiler_path ? config->compiler_path : "gcc");
+
+    uint32_t argc = 1;
+    for (size_t i = 0; i < config->cflag_count; ) {
+        size_t width = preprocessor_flag_width(config->cflags, config->cflag_count, i);
+        if (width == 0) {
+            argc++;
+            i++;
+        } else {
+            i += width;
+        }
+    }
+
+    bool ok = net_send_all(sock, DIST_MAGIC, 4) &&
+              send_u32(sock, argc) &&
+              send_string(sock, compiler);
+    for (size_t i = 0; ok && i < config->cflag_count; ) {
+        size_t width = preprocessor_flag_width(config->cflags, config->cflag_count, i);
+        if (width == 0) {
+            ok = send_string(sock, config->cflags[i]);
+            i++;
+        } else {
+            i += width;
+        }
+    }
+    ok = ok && send_u32(sock, (uint32_t)language) && send_file(sock, unit_path);
+
+    /* Response */
+    char magic[4];
+    uint32_t diagnostics_size = 0;
+    uint32_t exit_bits = 0;
+    ok = ok && net_recv_all(sock, magic, 4) && memcmp(magic, DIST_MAGIC, 4) == 0 &&
+         recv_u32(sock, status) && recv_u32(sock, &exit_bits) &&
+         recv_u32(sock, &diagnostics_size) && diagnostics_size <= DIST_MAX_DIAGNOSTICS;
+    *exit_code = (int)exit_bits;
+
+    if (ok && diagnostics_size > 0) {
+        *diagnostics = malloc(diagnostics_size + 1);
+        ok = *diagnostics && net_recv_all(sock, *diagnostics, diagnostics_size);
+        if (ok) (*diagnostics)[diagnostics_size] = '\0';
+    }
+
+    uint64_t object_size = 0;
+    ok = ok && recv_u64(sock, &object_size);
+    if (ok && *status == DIST_STATUS_COMPILED) {
+        ok = recv_file(sock, object_size, object_temp);
+    }
+
+    net_close(sock);
+    return ok;
+}
+
+bool dist_compile_source(
+    DistPool *pool,
+    const SourceFile *source,
+    const BuildConfig *config,
+    const char *object_path,
+    CompileResult *result
+) {
+    if (!pool || !source || !config || !object_path || !result) return false;
+    if (source->is_header || config->compiler == COMPILER_MSVC) return false;
+
+    memset(result, 0, sizeof(CompileResult));
+
+    const char *extension = strrchr(source->path, '.');
+    DistLanguage language = extension && strcmp(extension, ".c") == 0 ? DIST_LANGUAGE_C
+                                                                      : DIST_LANGUAGE_CXX;
+
+    char unit_path[MAX_PATH_LENGTH];
+    char object_temp[MAX_PATH_LENGTH];
+    int written = snprintf(unit_path, sizeof(unit_path), "%s.%s", object_path,
+                           language == DIST_LANGUAGE_C ? "i" : "ii");
+    int written_temp = snprintf(object_temp, sizeof(object_temp), "%s.dist", object_path);
+    if (written < 0 || (size_t)written >= sizeof(unit_path) ||
+        written_temp < 0 || (size_t)written_temp >= sizeof(object_temp)) {
+        return false;
+    }
+
+    /* Flags a worker would refuse keep the source here, without a
+     * refusal counting against the worker */
+    for (size_t i = 0; i < config->cflag_count; ) {
+        size_t width = preprocessor_flag_width(config->cflags, config->cflag_count, i);
+        if (width == 0 && !dist_flag_allowed(config->cflags[i])) {
+            ec_mutex_lock(&pool->lock);
+            pool->local_fallbacks++;
+            ec_mutex_unlock(&pool->lock);
+            return false;
+        }
+        i += width == 0 ? 1 : width;
+    }
+
+    double start = build_clock_seconds();
+
+    /* A source that does not preprocess gets its real diagnostics locally */
+    uint64_t trace_start = build_trace_begin();
+    bool preprocessed = preprocess_source(source, config, object_path, unit_path);
+    build_trace_end(trace_start, "compile", "preprocess", source->path);
+
+    DistWorker *worker = NULL;
+    if (!preprocessed || !(worker = acquire_worker(pool))) {
+        remove(unit_path);
+        ec_mutex_lock(&pool->lock);
+        pool->local_fallbacks++;
+        ec_mutex_unlock(&pool->lock);
+        return false;
+    }
+
+    if (config->verbose) {
+        printf("  [DIST] %s -> %s:%s\n", source->path, worker->host, worker->port);
+    }
+
+    uint32_t status = DIST_STATUS_REFUSED;
+    int exit_code = -1;
+    char *diagnostics = NULL;
+    trace_start = build_trace_begin();
+    bool reached = run_remote_job(worker, config, language, unit_path, object_temp,
+                                  &status, &exit_code, &diagnostics);
+    build_trace_end(trace_start, "compile", "remote compile", source->path);
+    remove(unit_path);
+
+    bool compiled = reached && status == DIST_STATUS_COMPILED &&
+                    replace_file(object_temp, object_path);
+    if (!compiled) remove(object_temp);
+
+    /* A compile error is the source's fault, not the worker's */
+    release_worker(pool, worker, reached && status != DIST_STATUS_REFUSED, compiled);
+
+    if (!compiled) {
+        free(diagnostics);
+        return false;
+    }
+
+    result->success = true;
+    result->object_file = strdup(object_path);
+    result->error_output = diagnostics;
+    result->exit_code = exit_code;
+    result->compile_time = build_clock_seconds() - start;
+
+    /* Warnings reach the user just as they do for local compiles */
+    if (result->error_output) {
+        fputs(result->error_output, stderr);
+    }
+    return true;
+}
+
+/* ==============================================================================
+ * Worker
+ * ==============================================================================
+ */
+
+struct DistServer {
+    DistServerOptions options;
+    char *host;                             /* Owned copies of the options' strings */
+    char *work_dir;
+    net_socket_t listener;
+    ec_thread_t *threads;
+    size_t thread_count;
+    ec_mutex_t lock;                        /* Guards the job counter */
+    unsigned long long next_job;
+    volatile bool stopping;
+};
+
+/**
+ * Whether a compiler name is one the worker will run: gcc, cc, clang or
+ * their C++ counterparts, optionally with a target prefix
+ * ("x86_64-linux-gnu-gcc") and a version suffix ("gcc-13")
+ */
+static bool compiler_allowed(const char *name) {
+    static const char *const allowed[] = { "gcc", "g++", "cc", "c++", "clang", "clang++" };
+
+    if (!name[0] || strpbrk(name, "/\\:") != NULL) return false;
+
+    char base[128];
+    size_t length = strlen(name);
+    if (length >= sizeof(base)) return false;
+    memcpy(base, name, length + 1);
+
+    if (length > 4 && strcmp(base + length - 4, ".exe") == 0) {
+        length -= 4;
+        base[length] = '\0';
+    }
+
+    /* Version suffix */
+    size_t end = length;
+    while (end > 0 && ((base[end - 1] >= '0' && base[end - 1] <= '9') || base[end - 1] == '.')) {
+        end--;
+    }
+    if (end < length && end > 0 && base[end - 1] == '-') {
+        length = end - 1;
+        base[length] = '\0';
+    }
+
+    for (size_t i = 0; i < sizeof(allowed) / sizeof(allowed[0]); i++) {
+        size_t n = strlen(allowed[i]);
+        if (length >= n && strcmp(base + length - n, allowed[i]) == 0 &&
+            (length == n || base[length - n - 1] == '-')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Whether text names no file: no path separators, no comma-separated
+ * list handed on to another tool, no response file
+ */
+static bool flag_value_plain(const char *text) {
+    return strpbrk(text, "/\\,@") == NULL;
+}
+
+bool dist_flag_allowed(const char *flag) {
+    static const char *const exact[] = {
+        "-c", "-w", "-W", "-pipe", "-pthread", "-ansi", "-pedantic", "-pedantic-errors"
+    };
+    /* -f flags that read or write files of their own */
+    static const char *const refused_f[] = {
+        "-fdump", "-fprofile", "-fauto-profile", "-fplugin", "-fopt-info",
+        "-fsave-optimization-record", "-fcallgraph-info", "-fstack-usage",
+        "-ftest-coverage", "-fcoverage", "-fdiagnostics-format",
+        "-fdiagnostics-add-output", "-fdiagnostics-set-output"
+    };
+
+    if (!flag) return false;
+    for (size_t i = 0; i < sizeof(exact) / sizeof(exact[0]); i++) {
+        if (strcmp(flag, exact[i]) == 0) return true;
+    }
+
+    /* Macros cannot matter to a preprocessed unit, but are harmless */
+    if ((strncmp(flag, "-D", 2) == 0 || strncmp(flag, "-U", 2) == 0) && flag[2] != '\0') {
+        return true;
+    }
+
+    if (strncmp(flag, "-std=", 5) == 0) return flag[5] != '\0' && flag_value_plain(flag);
+    if (strncmp(flag, "-O", 2) == 0 || strncmp(flag, "-g", 2) == 0) {
+        return flag_value_plain(flag);
+    }
+    if (strncmp(flag, "-W", 2) == 0 || strncmp(flag, "-m", 2) == 0) {
+        return flag[2] != '\0' && flag_value_plain(flag);
+    }
+    if (strncmp(flag, "-f", 2) == 0) {
+        if (flag[2] == '\0' || !flag_value_plain(flag)) return false;
+        for (size_t i = 0; i < sizeof(refused_f) / sizeof(refused_f[0]); i++) {
+            if (strncmp(flag, refused_f[i], strlen(refused_f[i])) == 0) return false;
+        }
+        return true;
+    }
+
+    /* Everything else, including -M*, -I, -include, -imacros, --sysroot,
+     * -o, -x, -B and -specs */
+    return false;
+}
+
+static bool send_response(net_socket_t sock, DistStatus status, int exit_code,
+                          const char *diagnostics, const char *object_path) {
+    size_t diagnostics_size = diagnostics ? strlen(diagnostics) : 0;
+    if (diagnostics_size > DIST_MAX_DIAGNOSTICS) diagnostics_size = DIST_MAX_DIAGNOSTICS;
+
+    bool ok = net_send_all(sock, DIST_MAGIC, 4) &&
+              send_u32(sock, (uint32_t)status) &&
+              send_u32(sock, (uint32_t)exit_code) &&
+              send_u32(sock, (uint32_t)diagnostics_size) &&
+              net_send_all(sock, diagnostics, diagnostics_size);
+
+    if (ok && status == DIST_STATUS_COMPILED) {
+        ok = send_file(sock, object_path);
+    } else if (ok) {
+        ok = send_u64(sock, 0);
+    }
+    return ok;
+}
+
+/**
+ * Read one request, compile it, and answer
+ */
+static void serve_job(DistServer *server, net_socket_t sock) {
+    ec_mutex_lock(&server->lock);
+    unsigned long long job = server->next_job++;
+    ec_mutex_unlock(&server->lock);
+
+    char magic[4];
+    uint32_t argc = 0;
+    if (!net_recv_all(sock, magic, 4) || memcmp(magic, DIST_MAGIC, 4) != 0 ||
+        !recv_u32(sock, &argc) || argc == 0 || argc > DIST_MAX_ARGS) {
+        return;
+    }
+
+    ProcessArgs args;
+    process_args_init(&args);
+    bool ok = true;
+    bool allowed = true;
+    for (uint32_t i = 0; ok && i < argc; i++) {
+        uint32_t length = 0;
+        char arg[DIST_MAX_ARG_LENGTH + 1];
+        ok = recv_u32(sock, &length) && length <= DIST_MAX_ARG_LENGTH &&
+             net_recv_all(sock, arg, length);
+        if (!ok) break;
+        arg[length] = '\0';
+
+        allowed = allowed && (i == 0 ? compiler_allowed(arg) : dist_flag_allowed(arg));
+        ok = process_args_add(&args, arg);
+    }
+
+    uint32_t language = 0;
+    uint64_t unit_size = 0;
+    ok = ok && recv_u32(sock, &language) && language <= DIST_LANGUAGE_CXX &&
+         recv_u64(sock, &unit_size) && unit_size <= DIST_MAX_UNIT_BYTES;
+    if (!ok) {
+        process_args_destroy(&args);
+        return;
+    }
+    if (!allowed) {
+        fprintf(stderr, "ecbuild worker: refused job %llu (%s)\n", job, args.argv[0]);
+        send_response(sock, DIST_STATUS_REFUSED, -1, "Refused by worker\n", NULL);
+        process_args_destroy(&args);
+        return;
+    }
+
+    char job_dir[MAX_PATH_LENGTH];
+    char unit_path[MAX_PATH_LENGTH + 16], object_path[MAX_PATH_LENGTH + 16];
+    int written = snprintf(job_dir, sizeof(job_dir), "%s/ecd-%ld-%llu", server->work_dir,
+                           (long)getpid(), job);
+    snprintf(unit_path, sizeof(unit_path), "%s/unit.%s", job_dir,
+             language == DIST_LANGUAGE_C ? "i" : "ii");
+    snprintf(object_path, sizeof(object_path), "%s/unit.o", job_dir);
+
+    if (written < 0 || (size_t)written >= sizeof(job_dir) ||
+        mkdir(job_dir, 0700) != 0 || !recv_file(sock, unit_size, unit_path)) {
+        send_response(sock, DIST_STATUS_REFUSED, -1, "Worker could not store the unit\n", NULL);
+        rmdir(job_dir);
+        process_args_destroy(&args);
+        return;
+    }
+
+    ok = process_args_add(&args, "-c") &&
+         process_args_add(&args, unit_path) &&
+         process_args_add(&args, "-o") &&
+         process_args_add(&args, object_path);
+
+    char *diagnostics = calloc(1, DIST_MAX_DIAGNOSTICS);
+    int exit_code = -1;
+    bool compiled = ok && diagnostics &&
+                    process_run(args.argv, diagnostics, DIST_MAX_DIAGNOSTICS, &exit_code);
+
+    DistStatus status = compiled ? DIST_STATUS_COMPILED
+                      : exit_code > 0 ? DIST_STATUS_FAILED
+                      : DIST_STATUS_REFUSED;     /* Compiler missing or killed */
+    send_response(sock, status, exit_code, diagnostics, object_path);
+
+    if (server->options.verbose) {
+        printf("ecbuild worker: job %llu %s (exit %d, %llu bytes in)\n", job,
+               status == DIST_STATUS_COMPILED ? "compiled" : "failed", exit_code,
+               (unsigned long long)unit_size);
+    }
+
+    free(diagnostics);
+    process_args_destroy(&args);
+    remove(unit_path);
+    remove(object_path);
+    rmdir(job_dir);
+}
+
+static void *server_thread(void *arg) {
+    DistServer *server = (DistServer *)arg;
+
+    while (!server->stopping) {
+        net_socket_t sock = net_accept(server->listener, DIST_TIMEOUT_MS);
+        if (sock == NET_SOCKET_NONE) continue;
+
+        if (server->stopping) {
+            net_close(sock);
+            break;
+        }
+        serve_job(server, sock);
+        net_close(sock);
+    }
+    return NULL;
+}
+
+DistServer *dist_server_start(const DistServerOptions *options) {
+    if (!options || !options->port || !options->work_dir) return NULL;
+
+    DistServer *server = calloc(1, sizeof(DistServer));
+    if (!server) return NULL;
+
+    server->options = *options;
+    server->host = options->host ? strdup(options->host) : NULL;
+    server->work_dir = strdup(options->work_dir);
+    server->options.host = server->host;
+    server->options.work_dir = server->work_dir;
+    if (server->options.jobs < 1) server->options.jobs = 1;
+
+    mkdir(server->work_dir, 0700);
+
+    if (!server->work_dir || !net_startup()) {
+        free(server->host);
+        free(server->work_dir);
+        free(server);
+        return NULL;
+    }
+
+    server->listener = net_listen(server->host ? server->host : DIST_DEFAULT_BIND,
+                                  options->port);
+    if (server->listener == NET_SOCKET_NONE) {
+        net_cleanup();
+        free(server->host);
+        free(server->work_dir);
+        free(server);
+        return NULL;
+    }
+
+    ec_mutex_init(&server->lock);
+    server->threads = calloc((size_t)server->options.jobs, sizeof(ec_thread_t));
+    for (int i = 0; server->threads && i < server->options.jobs; i++) {
+        if (ec_thread_create(&server->threads[i], server_thread, server) != 0) break;
+        server->thread_count++;
+    }
+
+    if (server->thread_count == 0) {
+        dist_server_stop(server);
+        return NULL;
+    }
+    return server;
+}
+
+int dist_server_port(const DistServer *server) {
+    return server ? net_local_port(server->listener) : 0;
+}
+
+void dist_server_wait(DistServer *server) {
+    if (!server) return;
+
+    for (size_t i = 0; i < server->thread_count; i++) {
+        ec_thread_join(server->threads[i]);
+    }
+    server->thread_count = 0;
+}
+
+void dist_server_stop(DistServer *server) {
+    if (!server) return;
+
+    server->stopping = true;
+
+    /* Each thread leaves after the next connection it accepts */
+    char port[8];
+    snprintf(port, sizeof(port), "%d", net_local_port(server->listener));
+    for (size_t i = 0; i < server->thread_count; i++) {
+        net_close(net_connect(server->host ? server->host : "localhost", port, 1000));
+    }
+
+    dist_server_wait(server);
+    net_close(server->listener);
+    ec_mutex_destroy(&server->lock);
+    free(server->threads);
+    free(server->host);
+    free(server->work_dir);
+    free(server);
+    net_cleanup();
+}
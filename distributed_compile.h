@@ -0,0 +1,196 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Distributed Compilation
+ * ==============================================================================
+ *
+ * Ships compile events to a pool of remote workers. The client
+ * preprocesses each source locally, so workers need only the compiler and
+ * none of the project's headers, and sends the preprocessed unit with the
+ * compile flags to the least busy worker. The worker compiles it and
+ * streams back the exit status, the diagnostics and the object file.
+ *
+ * Anything that goes wrong remotely - no worker reachable, a refused or
+ * timed-out job, even a compile error - makes the caller compile the
+ * source locally, so diagnostics always come from the local toolchain and
+ * a flaky pool can slow a build down but never break it. A worker that
+ * fails repeatedly is dropped from the pool for the rest of the build.
+ *
+ * Workers are "ecbuild --dist-serve [HOST:]PORT". They run only compilers
+ * named gcc, cc, clang and their C++ counterparts, from their own PATH,
+ * and refuse flags that load code (-fplugin, -specs, -wrapper, -B) or read
+ * extra files (@file); even so, a worker will compile whatever a client
+ * sends it, so expose it only to machines you trust.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef DISTRIBUTED_COMPILE_H
+#define DISTRIBUTED_COMPILE_H
+
+#include "compile_events.h"
+#include "include/eventchains_platform.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define DIST_DEFAULT_PORT "3633"
+#define DIST_DEFAULT_BIND "127.0.0.1"           /* Workers take no jobs from other hosts unless told */
+#define DIST_DEFAULT_SLOTS 4                    /* Concurrent jobs per worker */
+#define DIST_TIMEOUT_MS 120000                  /* Per send and receive */
+#define DIST_MAX_FAILURES 3                     /* Consecutive failures before a worker is dropped */
+
+/* ==============================================================================
+ * Client
+ * ==============================================================================
+ */
+
+/**
+ * DistWorker - One remote worker as the client sees it
+ */
+typedef struct DistWorker {
+    char host[256];                         /* Host name or address */
+    char port[8];                           /* Port */
+    int slots;                              /* Jobs it may run at once */
+    int busy;                               /* Jobs running on it now */
+    unsigned failures;                      /* Consecutive failures */
+    bool disabled;                          /* Dropped from the pool */
+    size_t compiled;                        /* Jobs it completed */
+} DistWorker;
+
+/**
+ * DistPool - The workers a build may use
+ */
+typedef struct DistPool {
+    DistWorker *workers;
+    size_t worker_count;
+    ec_mutex_t lock;                        /* Guards everything below */
+    ec_cond_t slot_free;                    /* A job finished or a worker was dropped */
+    size_t remote_compiles;                 /* Sources compiled remotely */
+    size_t local_fallbacks;                 /* Sources handed back for a local compile */
+} DistPool;
+
+/**
+ * Create a pool from a host list
+ *
+ * @param hosts  Comma-separated "host[:port][/slots]" entries
+ *               (IPv6 addresses in brackets)
+ * @return       Pointer to DistPool, or NULL if the list is empty or malformed
+ */
+DistPool *dist_pool_create(const char *hosts);
+
+/**
+ * Destroy a pool
+ *
+ * @param pool  Pointer to DistPool
+ */
+void dist_pool_destroy(DistPool *pool);
+
+/**
+ * Total job slots of the pool's workers
+ *
+ * @param pool  Pointer to DistPool
+ * @return      Sum of every worker's slots
+ */
+size_t dist_pool_slots(const DistPool *pool);
+
+/**
+ * Compile a source on a remote worker
+ *
+ * Preprocesses locally (writing the depfile too, when depfiles are on),
+ * waits for a free worker slot, and places the returned object at
+ * object_path. Safe to call from parallel workers.
+ *
+ * @param pool         Pointer to DistPool
+ * @param source       Source file (not a header)
+ * @param config       Build configuration (GCC or Clang)
+ * @param object_path  Where the object belongs
+ * @param result       Filled on success: warnings, exit code and time
+ * @return             true if the object was built remotely; false means
+ *                     compile it locally
+ */
+bool dist_compile_source(
+    DistPool *pool,
+    const SourceFile *source,
+    const BuildConfig *config,
+    const char *object_path,
+    CompileResult *result
+);
+
+/* ==============================================================================
+ * Worker
+ * ==============================================================================
+ */
+
+/**
+ * Whether a worker passes a compiler flag on to its compiler
+ *
+ * Units arrive preprocessed, so only flags of the kind ecbuild sends are
+ * accepted: -c, -O*, -g*, -std=, warnings (-W, but not -Wa,/-Wp,/-Wl,),
+ * code generation (-f*, but not dumps, profiles or plugins), -m* and
+ * -D/-U. Anything that names a file is refused, as are -M*, -I,
+ * -include, -imacros and --sysroot.
+ *
+ * @param flag  Flag as it would appear on the command line
+ * @return      true if a worker runs jobs carrying it
+ */
+bool dist_flag_allowed(const char *flag);
+
+/**
+ * DistServerOptions - How a worker listens and where it works
+ */
+typedef struct DistServerOptions {
+    const char *host;                       /* Address to bind (NULL for DIST_DEFAULT_BIND) */
+    const char *port;                       /* Port ("0" for any free port) */
+    int jobs;                               /* Concurrent jobs */
+    const char *work_dir;                   /* Scratch directory for units and objects */
+    bool verbose;                           /* Log each job */
+} DistServerOptions;
+
+/* A running worker (internal) */
+typedef struct DistServer DistServer;
+
+/**
+ * Start serving compile jobs
+ *
+ * @param options  Listen address, job count and scratch directory
+ * @return         Pointer to DistServer, or NULL if the port cannot be bound
+ */
+DistServer *dist_server_start(const DistServerOptions *options);
+
+/**
+ * Port a worker is listening on
+ *
+ * @param server  Pointer to DistServer
+ * @return        Port number
+ */
+int dist_server_port(const DistServer *server);
+
+/**
+ * Serve until the process is killed
+ *
+ * @param server  Pointer to DistServer
+ */
+void dist_server_wait(DistServer *server);
+
+/**
+ * Stop serving, finish the jobs in progress and free the worker
+ *
+ * @param server  Pointer to DistServer
+ */
+void dist_server_stop(DistServer *server);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISTRIBUTED_COMPILE_H */
@@ -14,6 +14,12 @@
 
 #include "dependency_resolver.h"
 #include "compile_events.h"
+#include "eventchains_build.h"
+#include "cache_metadata.h"
+#include "distributed_compile.h"
+#include "build_trace.h"
+#include "file_watch.h"
+#include "object_store.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,6 +43,16 @@ typedef struct Arguments {
     char *source_dir;
     char *output_dir;
     char *output_binary;
+    char *what_rebuilds;     /* File to list the affected sources of, or NULL */
+    char *object_store;      /* Shared object store directory, or NULL */
+    long object_store_mb;    /* Object store size limit in MB (0 for the default) */
+    long memory_budget_mb;   /* Compiler memory allowed at once in MB (0 for no limit) */
+    char *remote_cache;      /* Remote object cache URL, or NULL */
+    bool remote_readonly;    /* Download from the remote cache but never upload */
+    char *dist_hosts;        /* Compile worker list, or NULL */
+    char *dist_serve;        /* [HOST:]PORT to serve compile jobs on, or NULL */
+    char *linker;            /* -fuse-ld= linker, or NULL to pick the fastest */
+    char *trace;             /* Chrome trace output file, or NULL */
     char **exclude_dirs;     /* Directories to exclude from scanning */
     size_t exclude_count;    /* Number of excluded directories */
     bool verbose;
@@ -45,7 +61,15 @@ typedef struct Arguments {
     bool clean;
     bool help;
     bool version;
+    bool always_hash;
+    bool depfiles;
+    bool pch;                /* Precompile the headers most sources start with */
+    bool watch;              /* Rebuild whenever a source changes */
+    bool cache_stats;        /* Report what the build cache holds and exit */
+    bool cache_gc;           /* Drop stale cache entries, trim the object store and exit */
     int parallel_jobs;
+    int unity_size;          /* Sources per unity source (0 = no unity build) */
+    bool jobs_given;         /* -j was on the command line */
 } Arguments;
 
 static void print_usage(const char *program_name) {
@@ -61,6 +85,36 @@ static void print_usage(const char *program_name) {
     printf("  -b, --build-dir DIR     Build directory (default: build)\n");
     printf("  -j, --jobs N            Number of parallel jobs (default: 1)\n");
     printf("  -c, --clean             Clean build directory before building\n");
+    printf("  -w, --watch             Keep running; rebuild what a saved change affects\n");
+    printf("      --memory-budget MB  Hold back compiles whose recorded peak memory\n");
+    printf("                          would take the running total past MB\n");
+    printf("      --always-hash       Hash every file instead of trusting mtime/size/inode\n");
+    printf("      --depfiles          Take dependencies from compiler .d files (-MMD)\n");
+    printf("      --pch               Precompile the headers most sources start with\n");
+    printf("      --unity N           Compile the sources of each directory N at a time,\n");
+    printf("                          as one translation unit (sources that change often\n");
+    printf("                          are taken out and compiled alone)\n");
+    printf("      --what-rebuilds FILE  List the sources a change to FILE would rebuild\n");
+    printf("      --cache-stats       Show what the build cache and object store hold\n");
+    printf("      --cache-gc          Drop cache entries of deleted files, compact the cache\n");
+    printf("                          and trim the object store to its size limit\n");
+    printf("      --object-store DIR  Share compiled objects between checkouts through DIR\n");
+    printf("                          (default: $ECBUILD_OBJECT_STORE, if set)\n");
+    printf("      --object-store-size MB  Evict least recently used objects past MB (default: 2048)\n");
+    printf("      --remote-cache URL  Share objects through an HTTP cache at URL (http://host:port/prefix)\n");
+    printf("                          (default: $ECBUILD_REMOTE_CACHE, if set)\n");
+    printf("      --remote-cache-readonly  Download from the remote cache, never upload\n");
+    printf("      --dist HOSTS        Compile on workers host[:port][/slots],... (default port %s)\n",
+           DIST_DEFAULT_PORT);
+    printf("                          (default: $ECBUILD_DIST_HOSTS, if set)\n");
+    printf("      --dist-serve [HOST:]PORT  Run a compile worker for -j jobs, until killed\n");
+    printf("                          (HOST defaults to %s; 0.0.0.0 takes jobs from any\n",
+           DIST_DEFAULT_BIND);
+    printf("                          machine, with no authentication)\n");
+    printf("      --linker NAME       Link with NAME: mold, lld, gold, bfd\n");
+    printf("                          (default: the fastest the compiler accepts)\n");
+    printf("      --trace FILE        Write a Chrome trace of the build to FILE\n");
+    printf("                          (open in chrome://tracing or ui.perfetto.dev)\n");
     printf("  -e, --exclude DIRS      Exclude directories (comma-separated)\n");
     printf("                          Example: -e tests,examples,docs\n");
     printf("\n");
@@ -81,9 +135,12 @@ static void print_usage(const char *program_name) {
     printf("  ecbuild automatically:\n");
     printf("  - Finds all .c/.cpp/.h files\n");
     printf("  - Determines dependencies from #include directives\n");
-    printf("  - Calculates correct build order\n");
-    printf("  - Detects main() entry point\n");
-    printf("  - Compiles and links everything\n");
+    printf("  - Calculates correct build order, starting the compiles\n");
+    printf("    that took longest last time first\n");
+    printf("  - Detects main() entry points\n");
+    printf("  - Compiles each file once and links everything\n");
+    printf("    (several main()s: an executable each, named after its source,\n");
+    printf("     linked against the static archive lib<NAME>.a of the common code)\n");
     printf("\n");
     printf("No Makefile, no CMakeLists.txt, no configuration needed!\n");
 }
@@ -119,6 +176,103 @@ static bool parse_arguments(int argc, char **argv, Arguments *args) {
             args->no_optimize = true;
         } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--clean") == 0) {
             args->clean = true;
+        } else if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--watch") == 0) {
+            args->watch = true;
+        } else if (strcmp(argv[i], "--pch") == 0) {
+            args->pch = true;
+        } else if (strcmp(argv[i], "--depfiles") == 0) {
+            args->depfiles = true;
+        } else if (strcmp(argv[i], "--always-hash") == 0) {
+            args->always_hash = true;
+        } else if (strcmp(argv[i], "--what-rebuilds") == 0) {
+            if (i + 1 < argc) {
+                free(args->what_rebuilds);
+                args->what_rebuilds = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --what-rebuilds requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--cache-stats") == 0) {
+            args->cache_stats = true;
+        } else if (strcmp(argv[i], "--cache-gc") == 0) {
+            args->cache_gc = true;
+        } else if (strcmp(argv[i], "--object-store") == 0) {
+            if (i + 1 < argc) {
+                free(args->object_store);
+                args->object_store = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --object-store requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--object-store-size") == 0) {
+            if (i + 1 < argc) {
+                args->object_store_mb = atol(argv[++i]);
+                if (args->object_store_mb < 1) args->object_store_mb = 0;
+            } else {
+                fprintf(stderr, "Error: --object-store-size requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--memory-budget") == 0) {
+            if (i + 1 < argc) {
+                args->memory_budget_mb = atol(argv[++i]);
+                if (args->memory_budget_mb < 1) args->memory_budget_mb = 0;
+            } else {
+                fprintf(stderr, "Error: --memory-budget requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--unity") == 0) {
+            if (i + 1 < argc) {
+                args->unity_size = atoi(argv[++i]);
+                if (args->unity_size < 2) {
+                    fprintf(stderr, "Error: --unity needs at least 2 sources per unit\n");
+                    return false;
+                }
+            } else {
+                fprintf(stderr, "Error: --unity requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--remote-cache") == 0) {
+            if (i + 1 < argc) {
+                free(args->remote_cache);
+                args->remote_cache = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --remote-cache requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--remote-cache-readonly") == 0) {
+            args->remote_readonly = true;
+        } else if (strcmp(argv[i], "--dist") == 0) {
+            if (i + 1 < argc) {
+                free(args->dist_hosts);
+                args->dist_hosts = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --dist requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 < argc) {
+                free(args->trace);
+                args->trace = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --trace requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--linker") == 0) {
+            if (i + 1 < argc) {
+                free(args->linker);
+                args->linker = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --linker requires an argument\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--dist-serve") == 0) {
+            if (i + 1 < argc) {
+                free(args->dist_serve);
+                args->dist_serve = strdup(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: --dist-serve requires an argument\n");
+                return false;
+            }
         } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
             if (i + 1 < argc) {
                 free(args->output_binary);
@@ -139,6 +293,7 @@ static bool parse_arguments(int argc, char **argv, Arguments *args) {
             if (i + 1 < argc) {
                 args->parallel_jobs = atoi(argv[++i]);
                 if (args->parallel_jobs < 1) args->parallel_jobs = 1;
+                args->jobs_given = true;
             } else {
                 fprintf(stderr, "Error: -j requires an argument\n");
                 return false;
@@ -202,6 +357,13 @@ static void cleanup_arguments(Arguments *args) {
     free(args->source_dir);
     free(args->output_dir);
     free(args->output_binary);
+    free(args->what_rebuilds);
+    free(args->object_store);
+    free(args->remote_cache);
+    free(args->dist_hosts);
+    free(args->linker);
+    free(args->trace);
+    free(args->dist_serve);
 
     /* Free exclude directories */
     if (args->exclude_dirs) {
@@ -213,96 +375,513 @@ static void cleanup_arguments(Arguments *args) {
 }
 
 /* ==============================================================================
- * Main Entry Point
+ * Queries
  * ==============================================================================
  */
 
-int main(int argc, char **argv) {
-    Arguments args;
+/**
+ * The shared object store directory: the flag wins over the environment
+ *
+ * @return  Directory, or NULL if there is no object store
+ */
+static const char *object_store_dir(const Arguments *args) {
+    const char *object_store = args->object_store ? args->object_store
+                                                  : getenv("ECBUILD_OBJECT_STORE");
+    if (object_store && object_store[0] == '\0') object_store = NULL;
+    return object_store;
+}
 
-    /* Parse command line arguments */
-    if (!parse_arguments(argc, argv, &args)) {
-        print_usage(argv[0]);
+/**
+ * Print what the build cache and the object store hold (--cache-stats)
+ */
+static int print_cache_stats(const Arguments *args) {
+    BuildCache *cache = build_cache_create(args->source_dir);
+    if (!cache) {
+        fprintf(stderr, "Failed to open the build cache in %s\n", args->source_dir);
         return 1;
     }
 
-    /* Handle --help */
-    if (args.help) {
-        print_usage(argv[0]);
-        cleanup_arguments(&args);
-        return 0;
+    printf("Build cache: %s\n", cache->cache_dir);
+    build_cache_print_stats(cache);
+    printf("  Paths:         %zu\n", cache->string_count);
+    printf("  File Size:     %llu KB\n",
+           (unsigned long long)(build_cache_file_bytes(cache) / 1024));
+
+    /* Counted on this copy only; nothing is saved */
+    size_t stale = build_cache_prune(cache, NULL);
+    printf("  Stale Entries: %zu%s\n", stale,
+           stale > 0 ? " (sources deleted; ecbuild --cache-gc drops them)" : "");
+    build_cache_destroy(cache);
+
+    const char *directory = object_store_dir(args);
+    if (directory) {
+        uint64_t limit = (uint64_t)args->object_store_mb * 1024 * 1024;
+        ObjectStore *store = object_store_open(directory, limit);
+        size_t objects = 0;
+        uint64_t bytes = 0;
+        if (!store || !object_store_usage(store, &objects, &bytes)) {
+            fprintf(stderr, "Failed to read the object store in %s\n", directory);
+            object_store_close(store);
+            return 1;
+        }
+
+        printf("\nObject store: %s\n", directory);
+        printf("  Objects:       %zu\n", objects);
+        printf("  Size:          %llu MB of %llu MB\n",
+               (unsigned long long)(bytes / (1024 * 1024)),
+               (unsigned long long)(store->max_bytes / (1024 * 1024)));
+        object_store_close(store);
     }
 
-    /* Handle --version */
-    if (args.version) {
-        print_version();
-        cleanup_arguments(&args);
-        return 0;
+    return 0;
+}
+
+/**
+ * Print the sources the last build's cache says a change to a file would
+ * rebuild; no scan and no compiler are needed
+ */
+static int print_affected_sources(const Arguments *args) {
+    BuildCache *cache = build_cache_create(args->source_dir);
+    if (!cache) {
+        fprintf(stderr, "Failed to open the build cache in %s\n", args->source_dir);
+        return 1;
     }
 
-    printf("\n");
-    printf("|----------------------------------------------------------------|\n");
-    printf("|               ecbuild - EventChains Build System               |\n");
-    printf("|----------------------------------------------------------------|\n\n");
+    /* Accept the path as typed or relative to the source directory */
+    const char *file = args->what_rebuilds;
+    char candidates[3][MAX_PATH_LENGTH];
+    snprintf(candidates[0], MAX_PATH_LENGTH, "%s", file);
+    snprintf(candidates[1], MAX_PATH_LENGTH, "%s/%s", args->source_dir,
+             strncmp(file, "./", 2) == 0 ? file + 2 : file);
+    snprintf(candidates[2], MAX_PATH_LENGTH, "%s", strncmp(file, "./", 2) == 0 ? file + 2 : file);
+
+    size_t count = 0;
+    const char *known = NULL;
+    for (size_t i = 0; !known && i < 3; i++) {
+        if (build_cache_get_affected_sources(cache, candidates[i], NULL, 0, &count)) {
+            known = candidates[i];
+        }
+    }
+
+    if (!known) {
+        fprintf(stderr, "%s is not in the build cache (build the project once first)\n", file);
+        build_cache_destroy(cache);
+        return 1;
+    }
+
+    const char **sources = malloc((count + 1) * sizeof(const char *));
+    if (!sources) {
+        fprintf(stderr, "Out of memory\n");
+        build_cache_destroy(cache);
+        return 1;
+    }
+    build_cache_get_affected_sources(cache, known, sources, count, &count);
+
+    printf("Changing %s rebuilds %zu source file%s:\n", known, count, count == 1 ? "" : "s");
+    for (size_t i = 0; i < count; i++) {
+        printf("  %s\n", sources[i]);
+    }
+
+    free(sources);
+    build_cache_destroy(cache);
+    return 0;
+}
+
+/**
+ * Serve compile jobs for other machines' builds (--dist-serve)
+ */
+static int run_compile_worker(const Arguments *args) {
+    char host[256] = "";
+    const char *port = args->dist_serve;
+    const char *colon = strrchr(args->dist_serve, ':');
+    if (colon) {
+        size_t length = (size_t)(colon - args->dist_serve);
+        if (length >= sizeof(host)) length = sizeof(host) - 1;
+        memcpy(host, args->dist_serve, length);
+        host[length] = '\0';
+        port = colon + 1;
+
+        /* [::1]:3633 */
+        length = strlen(host);
+        if (length >= 2 && host[0] == '[' && host[length - 1] == ']') {
+            memmove(host, host + 1, length - 2);
+            host[length - 2] = '\0';
+        }
+    }
+
+#ifdef _WIN32
+    const char *temp = getenv("TEMP");
+    if (!temp) temp = ".";
+#else
+    const char *temp = getenv("TMPDIR");
+    if (!temp) temp = "/tmp";
+#endif
+    char work_dir[4096];
+    snprintf(work_dir, sizeof(work_dir), "%s/ecbuild-worker", temp);
 
-    /* Create dependency graph */
+    DistServerOptions options;
+    options.host = host[0] ? host : NULL;
+    options.port = port;
+    options.jobs = args->jobs_given ? args->parallel_jobs : DIST_DEFAULT_SLOTS;
+    options.work_dir = work_dir;
+    options.verbose = args->verbose;
+
+    DistServer *server = dist_server_start(&options);
+    if (!server) {
+        fprintf(stderr, "Error: Cannot listen on %s\n", args->dist_serve);
+        return 1;
+    }
+
+    printf("Compile worker listening on %s port %d, %d jobs, scratch %s\n",
+           host[0] ? host : DIST_DEFAULT_BIND, dist_server_port(server), options.jobs, work_dir);
+    fflush(stdout);
+
+    dist_server_wait(server);
+    dist_server_stop(server);
+    return 0;
+}
+
+/* ==============================================================================
+ * Scanning and Watching
+ * ==============================================================================
+ */
+
+/**
+ * Scan the source directory into a new dependency graph
+ *
+ * Files unchanged since the cache last recorded the graph take their
+ * includes from it. Reports its own errors.
+ *
+ * @return  The graph, or NULL on error
+ */
+static DependencyGraph *scan_project(const Arguments *args, BuildCache *graph_cache) {
     DependencyGraph *graph = dependency_graph_create();
     if (!graph) {
         fprintf(stderr, "Failed to create dependency graph\n");
-        cleanup_arguments(&args);
-        return 1;
+        return NULL;
     }
 
     /* Add source directory to include paths */
-    dependency_graph_add_include_path(graph, args.source_dir);
+    dependency_graph_add_include_path(graph, args->source_dir);
     dependency_graph_add_include_path(graph, ".");
+    dependency_graph_set_scan_threads(graph, args->parallel_jobs > 0 ? (size_t)args->parallel_jobs : 1);
 
     /* Scan source directory */
-    printf("Scanning: %s\n", args.source_dir);
+    printf("Scanning: %s\n", args->source_dir);
 
-    if (args.exclude_count > 0) {
+    if (args->exclude_count > 0) {
         printf("Excluding: ");
-        for (size_t i = 0; i < args.exclude_count; i++) {
-            printf("%s%s", args.exclude_dirs[i],
-                   i < args.exclude_count - 1 ? ", " : "");
+        for (size_t i = 0; i < args->exclude_count; i++) {
+            printf("%s%s", args->exclude_dirs[i],
+                   i < args->exclude_count - 1 ? ", " : "");
         }
         printf("\n");
     }
     printf("\n");
 
+    if (graph_cache) {
+        build_cache_provide_includes(graph_cache, graph);
+    }
+
     DependencyErrorCode err = dependency_graph_scan_directory_with_exclusions(
-        graph, args.source_dir, true,
-        (const char**)args.exclude_dirs, args.exclude_count
+        graph, args->source_dir, true,
+        (const char**)args->exclude_dirs, args->exclude_count
     );
+
+    if (graph_cache) {
+        dependency_graph_set_include_provider(graph, NULL, NULL);
+        if (err == DEP_SUCCESS) {
+            build_cache_record_graph(graph_cache, graph);
+            build_cache_save(graph_cache);
+        }
+    }
     if (err != DEP_SUCCESS) {
         fprintf(stderr, "Failed to scan directory: %s\n", dependency_error_string(err));
         dependency_graph_destroy(graph);
-        cleanup_arguments(&args);
-        return 1;
+        return NULL;
     }
     
     if (graph->file_count == 0) {
-        fprintf(stderr, "No source files found in %s\n", args.source_dir);
+        fprintf(stderr, "No source files found in %s\n", args->source_dir);
         dependency_graph_destroy(graph);
-        cleanup_arguments(&args);
-        return 1;
+        return NULL;
     }
     
-    printf("Found %zu source files\n\n", graph->file_count);
+    printf("Found %zu source files\n", graph->file_count);
+    printf("Dependency scan: %zu parsed, %zu reused from last build",
+           graph->parsed_count, graph->reused_count);
+    if (args->depfiles) {
+        printf(", %zu from depfiles", graph->provided_count);
+    }
+    printf("\n");
+    printf("\n");
     
     /* Check for circular dependencies */
     char cycle_path[1024];
     if (dependency_graph_has_cycle(graph, cycle_path, sizeof(cycle_path))) {
         fprintf(stderr, "Circular dependency detected: %s\n", cycle_path);
         dependency_graph_destroy(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+/**
+ * Drop what the cache keeps for files that are gone (--cache-gc)
+ *
+ * Scans the project so that entries of sources still in the tree stay,
+ * saves the cache without the rest and with only the paths something
+ * still names, and trims the object store to its limit.
+ */
+static int collect_cache_garbage(const Arguments *args) {
+    BuildCache *cache = build_cache_create(args->source_dir);
+    if (!cache) {
+        fprintf(stderr, "Failed to open the build cache in %s\n", args->source_dir);
+        return 1;
+    }
+    uint64_t size_before = build_cache_file_bytes(cache);
+    size_t entries_before = cache->entry_count;
+
+    DependencyGraph *graph = scan_project(args, cache);
+    if (!graph) {
+        build_cache_destroy(cache);
+        return 1;
+    }
+
+    size_t pruned = build_cache_prune(cache, graph);
+    bool saved = build_cache_save(cache);
+    dependency_graph_destroy(graph);
+
+    if (!saved) {
+        fprintf(stderr, "Failed to save the build cache in %s\n", cache->cache_dir);
+        build_cache_destroy(cache);
+        return 1;
+    }
+    printf("Build cache: %zu entries, %zu stale dropped (%zu before), %llu KB -> %llu KB\n",
+           cache->entry_count, pruned, entries_before,
+           (unsigned long long)(size_before / 1024),
+           (unsigned long long)(build_cache_file_bytes(cache) / 1024));
+    build_cache_destroy(cache);
+
+    const char *directory = object_store_dir(args);
+    if (directory) {
+        ObjectStore *store = object_store_open(directory,
+                                               (uint64_t)args->object_store_mb * 1024 * 1024);
+        size_t removed = 0;
+        uint64_t bytes = 0;
+        if (!store || !object_store_trim(store, &removed, &bytes)) {
+            fprintf(stderr, "Failed to trim the object store in %s\n", directory);
+            object_store_close(store);
+            return 1;
+        }
+        printf("Object store: %zu objects evicted, %llu MB of %llu MB in use\n",
+               removed, (unsigned long long)(bytes / (1024 * 1024)),
+               (unsigned long long)(store->max_bytes / (1024 * 1024)));
+        object_store_close(store);
+    }
+
+    return 0;
+}
+
+/**
+ * Bring a graph up to date with a burst of changes
+ *
+ * Edited and new files are read again in place. The graph cannot drop
+ * nodes, so a removed file, or a burst the watcher could not follow,
+ * means scanning the tree again.
+ *
+ * @return  true if the graph is current, false if it must be rescanned
+ */
+static bool refresh_graph(DependencyGraph *graph, const FileChangeList *changes) {
+    if (changes->rescan) return false;
+
+    for (size_t i = 0; i < changes->count; i++) {
+        if (changes->changes[i].kind == FILE_CHANGE_REMOVED ||
+            dependency_graph_refresh_file(graph, changes->changes[i].path) != DEP_SUCCESS) {
+            return false;
+        }
+    }
+
+    char cycle_path[1024];
+    if (dependency_graph_build_adjacency(graph) != DEP_SUCCESS ||
+        dependency_graph_has_cycle(graph, cycle_path, sizeof(cycle_path))) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Write the spans recorded so far to the --trace file, if tracing
+ */
+static void write_trace(const Arguments *args) {
+    if (!build_trace_enabled()) return;
+
+    size_t span_count = 0;
+    if (build_trace_write(args->trace, &span_count)) {
+        printf("Trace: %zu spans written to %s\n", span_count, args->trace);
+    } else {
+        fprintf(stderr, "Warning: Failed to write trace %s\n", args->trace);
+    }
+}
+
+/**
+ * Build, then rebuild after every change until killed (--watch)
+ *
+ * The graph, the cache and its hash memo stay in memory between builds,
+ * so a change costs reading the changed files again plus the compiles and
+ * link it makes necessary, rather than a scan and a cache load. The trace
+ * is written after every build, since the loop only ends when killed.
+ *
+ * @param graph_ptr    Graph scanned at startup; replaced by rescans
+ * @param graph_cache  Cache the scan used (can be NULL)
+ * @return             Non-zero if the watcher fails
+ */
+static int watch_project(const Arguments *args, BuildConfig *config,
+                         DependencyGraph **graph_ptr, BuildCache *graph_cache) {
+    /* One cache serves both the scan and the build when they share a
+     * directory; two open on the same file would overwrite each other */
+    char project_dir[MAX_PATH_LENGTH];
+    build_project_dir(config, project_dir, sizeof(project_dir));
+    bool shared = graph_cache && strcmp(project_dir, graph_cache->project_dir) == 0;
+    BuildCache *cache = shared ? graph_cache : build_cache_create(project_dir);
+
+    FileWatch *watch = file_watch_create(args->source_dir, (const char **)args->exclude_dirs,
+                                         args->exclude_count);
+    if (!watch) {
+        fprintf(stderr, "Error: Cannot watch %s\n", args->source_dir);
+        if (!shared) build_cache_destroy(cache);
+        return 1;
+    }
+
+    BuildStatistics stats;
+    eventchains_build_project_with_cache(*graph_ptr, config, cache, &stats);
+    write_trace(args);
+
+    int status = 0;
+    for (;;) {
+        printf("\nWatching %s for changes%s (Ctrl-C to stop)\n", args->source_dir,
+               file_watch_is_polling(watch) ? ", polling" : "");
+        fflush(stdout);
+
+        FileChangeList changes;
+        file_change_list_init(&changes);
+        if (file_watch_wait(watch, -1, &changes) < 0) {
+            fprintf(stderr, "Error: Watching %s failed\n", args->source_dir);
+            file_change_list_destroy(&changes);
+            status = 1;
+            break;
+        }
+
+        double start = build_clock_seconds();
+        printf("\n");
+        for (size_t i = 0; i < changes.count; i++) {
+            static const char *const kinds[] = { "Changed", "Added", "Removed" };
+            printf("%-8s %s\n", kinds[changes.changes[i].kind], changes.changes[i].path);
+        }
+
+        if (!refresh_graph(*graph_ptr, &changes)) {
+            printf("Rescanning the source tree\n");
+            DependencyGraph *rescanned = scan_project(args, graph_cache);
+            if (!rescanned) {
+                /* Keep the old graph and wait for the tree to be fixed */
+                file_change_list_destroy(&changes);
+                continue;
+            }
+            dependency_graph_destroy(*graph_ptr);
+            *graph_ptr = rescanned;
+        }
+        file_change_list_destroy(&changes);
+
+        eventchains_build_project_with_cache(*graph_ptr, config, cache, &stats);
+        printf("Rebuilt %.3f seconds after the change\n", build_clock_seconds() - start);
+        write_trace(args);
+    }
+
+    file_watch_destroy(watch);
+    if (!shared) build_cache_destroy(cache);
+    return status;
+}
+
+/* ==============================================================================
+ * Main Entry Point
+ * ==============================================================================
+ */
+
+int main(int argc, char **argv) {
+    Arguments args;
+
+    /* Parse command line arguments */
+    if (!parse_arguments(argc, argv, &args)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    /* Handle --help */
+    if (args.help) {
+        print_usage(argv[0]);
+        cleanup_arguments(&args);
+        return 0;
+    }
+
+    /* Handle --version */
+    if (args.version) {
+        print_version();
+        cleanup_arguments(&args);
+        return 0;
+    }
+
+    /* Handle --what-rebuilds */
+    if (args.what_rebuilds) {
+        int status = print_affected_sources(&args);
+        cleanup_arguments(&args);
+        return status;
+    }
+
+    /* Handle --cache-stats and --cache-gc */
+    if (args.cache_stats || args.cache_gc) {
+        int status = args.cache_gc ? collect_cache_garbage(&args) : print_cache_stats(&args);
+        cleanup_arguments(&args);
+        return status;
+    }
+
+    /* Handle --dist-serve */
+    if (args.dist_serve) {
+        int status = run_compile_worker(&args);
+        cleanup_arguments(&args);
+        return status;
+    }
+
+    /* Trace from the scan on, before any worker thread starts */
+    if (args.trace && !build_trace_start()) {
+        fprintf(stderr, "Warning: Failed to start tracing\n");
+    }
+
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|               ecbuild - EventChains Build System               |\n");
+    printf("|----------------------------------------------------------------|\n\n");
+
+    /* Files unchanged since the last build take their includes from the
+     * cache (depfile entries, else the graph snapshot) instead of being parsed */
+    BuildCache *graph_cache = build_cache_create(args.source_dir);
+    DependencyGraph *graph = scan_project(&args, graph_cache);
+
+    /* Watching keeps the cache for the next scan */
+    if (!args.watch || !graph) {
+        build_cache_destroy(graph_cache);
+        graph_cache = NULL;
+    }
+    if (!graph) {
         cleanup_arguments(&args);
         return 1;
     }
-    
+
     /* Create build configuration */
     BuildConfig *config = build_config_create();
     if (!config) {
         fprintf(stderr, "Failed to create build configuration\n");
+        build_cache_destroy(graph_cache);
         dependency_graph_destroy(graph);
         cleanup_arguments(&args);
         return 1;
@@ -315,6 +894,34 @@ int main(int argc, char **argv) {
     config->debug = args.debug;
     config->optimize = !args.no_optimize;
     config->parallel_jobs = args.parallel_jobs;
+    config->always_hash = args.always_hash;
+    config->use_depfiles = args.depfiles;
+    config->use_pch = args.pch;
+    config->unity_size = args.unity_size;
+    config->memory_budget = (uint64_t)args.memory_budget_mb * 1024 * 1024;
+    
+    /* Shared object store: the flag wins over the environment */
+    build_config_set_object_store(config, object_store_dir(&args),
+                                  (uint64_t)args.object_store_mb * 1024 * 1024);
+    
+    /* Remote object cache, likewise */
+    const char *remote_cache = args.remote_cache ? args.remote_cache
+                                                 : getenv("ECBUILD_REMOTE_CACHE");
+    if (remote_cache && remote_cache[0] != '\0') {
+        build_config_set_remote_cache(config, remote_cache, !args.remote_readonly);
+    }
+    
+    /* Compile workers, likewise; without -j, keep every worker slot busy */
+    const char *dist_hosts = args.dist_hosts ? args.dist_hosts : getenv("ECBUILD_DIST_HOSTS");
+    if (dist_hosts && dist_hosts[0] != '\0') {
+        build_config_set_dist_hosts(config, dist_hosts);
+        
+        DistPool *pool = dist_pool_create(dist_hosts);
+        if (pool && !args.jobs_given) {
+            config->parallel_jobs = (int)dist_pool_slots(pool) + 1;
+        }
+        dist_pool_destroy(pool);
+    }
     
     /* Add source directory as include path */
     build_config_add_include_path(config, args.source_dir);
@@ -324,19 +931,20 @@ int main(int argc, char **argv) {
         build_config_add_cflag(config, "-g");
     }
     
+    /* Construct absolute build path */
+    char absolute_build_dir[4096];
+    if (args.output_dir[0] == '/' || (args.output_dir[0] && args.output_dir[1] == ':')) {
+        /* Already absolute */
+        snprintf(absolute_build_dir, sizeof(absolute_build_dir), "%s", args.output_dir);
+    } else {
+        /* Make relative to source dir */
+        snprintf(absolute_build_dir, sizeof(absolute_build_dir), "%s/%s",
+                args.source_dir, args.output_dir);
+    }
+    build_config_set_output_dir(config, absolute_build_dir);
+
     /* Clean if requested */
     if (args.clean) {
-        /* Construct absolute build path */
-        char absolute_build_dir[4096];
-        if (args.output_dir[0] == '/' || (args.output_dir[0] && args.output_dir[1] == ':')) {
-            /* Already absolute */
-            snprintf(absolute_build_dir, sizeof(absolute_build_dir), "%s", args.output_dir);
-        } else {
-            /* Make relative to source dir */
-            snprintf(absolute_build_dir, sizeof(absolute_build_dir), "%s/%s",
-                    args.source_dir, args.output_dir);
-        }
-
         printf("Cleaning build directory: %s\n\n", absolute_build_dir);
         char clean_cmd[512];
 #ifdef _WIN32
@@ -347,10 +955,45 @@ int main(int argc, char **argv) {
         system(clean_cmd);
     }
 
-    /* Build the project */
-    int result = build_project(graph, config, args.source_dir);
+    /* Auto-detect compiler */
+    if (!build_config_auto_detect_compiler(config)) {
+        fprintf(stderr, "No compiler found (tried gcc, clang, cl)\n");
+        build_cache_destroy(graph_cache);
+        build_config_destroy(config);
+        dependency_graph_destroy(graph);
+        cleanup_arguments(&args);
+        return 1;
+    }
+    printf("Using compiler: %s\n", config->compiler_path);
+
+    /* Linker: as asked, or the fastest one installed */
+    if (args.linker) {
+        build_config_set_linker(config, args.linker);
+    } else {
+        build_config_detect_linker(config);
+    }
+    if (config->linker) {
+        printf("Using linker: %s\n", config->linker);
+    }
+
+    /* Build the project with EventChains (parallel when -j > 1) */
+    event_chain_initialize();
+
+    int result;
+    if (args.watch) {
+        result = watch_project(&args, config, &graph, graph_cache);
+    } else {
+        BuildStatistics stats;
+        result = eventchains_build_project(graph, config, &stats);
+    }
+
+    event_chain_cleanup();
+
+    if (!args.watch) write_trace(&args);
+    build_trace_stop();
 
     /* Cleanup */
+    build_cache_destroy(graph_cache);
     build_config_destroy(config);
     dependency_graph_destroy(graph);
     cleanup_arguments(&args);
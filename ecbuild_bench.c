@@ -0,0 +1,717 @@
+/**
+ * ==============================================================================
+ * ecbuild - Build System Benchmark
+ * ==============================================================================
+ *
+ * Generates synthetic source trees of a given size and times the phases
+ * of a build on each: the cold scan (directory walk plus include
+ * parsing), the scan with includes taken from the cache, the topological
+ * sort, loading and saving the cache, a no-op incremental build and the
+ * rebuild after touching one header. Results are written as JSON so runs
+ * can be compared across releases.
+ *
+ * A tree of N files holds N/10 headers and N - N/10 sources in
+ * directories of BENCH_SOURCES_PER_DIR. Each source includes --fan-in
+ * headers picked by a fixed pseudo-random sequence; each header includes
+ * its parent in a binary heap, so include closures are about log2(N/10)
+ * deep. One more header, touched.h, is included by every
+ * BENCH_TOUCH_STRIDE-th source and is what the touch rebuild edits.
+ *
+ * Builds go through the same calls as ecbuild, but compile and link with
+ * this program standing in for the compiler: it only creates the file
+ * named by -o. The timings are the build system's own overhead, whatever
+ * compiler is installed.
+ *
+ * Usage: ecbuild_bench [--sizes 1000,10000,50000] [--fan-in 8] [-j N]
+ *                      [--repeat 3] [--dir DIR] [--output FILE] [--keep]
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#include "eventchains_build.h"
+#include "cache_metadata.h"
+#include "build_trace.h"
+#include "process_spawn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #include <io.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define dup _dup
+    #define dup2 _dup2
+    #define close _close
+    #define fileno _fileno
+    #define BENCH_NULL_DEVICE "NUL"
+#else
+    #include <unistd.h>
+    #define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+#define BENCH_VERSION "1.0.0"
+#define BENCH_STUB_ENV "ECBUILD_BENCH_STUB"     /* Set for children: act as the compiler */
+#define BENCH_DEFAULT_SIZES "1000,10000,50000"
+#define BENCH_DEFAULT_FAN_IN 8                  /* Headers each source includes */
+#define BENCH_DEFAULT_REPEAT 3                  /* Runs per phase; the fastest is reported */
+#define BENCH_MAX_SIZES 16
+#define BENCH_SOURCES_PER_DIR 100
+#define BENCH_TOUCH_STRIDE 100                  /* Sources per one including touched.h */
+
+/* ==============================================================================
+ * Options and Results
+ * ==============================================================================
+ */
+
+typedef struct BenchOptions {
+    size_t sizes[BENCH_MAX_SIZES];
+    size_t size_count;
+    size_t fan_in;
+    int jobs;
+    int repeat;
+    const char *work_dir;
+    const char *output;                         /* JSON file, or NULL for stdout */
+    bool keep;                                  /* Leave the generated trees behind */
+} BenchOptions;
+
+typedef struct BenchResult {
+    size_t files;
+    size_t sources;
+    size_t headers;
+    size_t include_edges;
+    size_t touch_dependents;                    /* Sources that include touched.h */
+    double generate_s;
+    double scan_parse_s;                        /* Walk, read and parse every file */
+    double scan_cached_s;                       /* Walk; includes from the cache */
+    double topo_sort_s;
+    double initial_build_s;                     /* Everything compiled (stub compiler) */
+    double cache_load_s;
+    double cache_save_s;
+    size_t cache_bytes;
+    double noop_build_s;                        /* Cache load, scan, build, save */
+    size_t noop_compiled;
+    double touch_rebuild_s;
+    size_t touch_compiled;
+    bool ok;
+} BenchResult;
+
+/* ==============================================================================
+ * Stub Compiler
+ * ==============================================================================
+ */
+
+/**
+ * Create the (empty) output a command line names with -o
+ */
+static int stub_create_output(const char *path) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return 1;
+    return fclose(fp) == 0 ? 0 : 1;
+}
+
+/**
+ * Find -o in a response file, as the link writes it: one quoted,
+ * backslash-escaped argument per line
+ */
+static int stub_read_response_file(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 1;
+
+    char line[MAX_PATH_LENGTH + 8];
+    char previous[MAX_PATH_LENGTH + 8] = "";
+    int status = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        /* Unquote in place */
+        char *out = line;
+        for (const char *in = line; *in && *in != '\n'; in++) {
+            if (*in == '"') continue;
+            if (*in == '\\' && in[1]) in++;
+            *out++ = *in;
+        }
+        *out = '\0';
+
+        if (strcmp(previous, "-o") == 0) {
+            status = stub_create_output(line);
+            break;
+        }
+        snprintf(previous, sizeof(previous), "%s", line);
+    }
+    fclose(fp);
+    return status;
+}
+
+/**
+ * Stand in for the compiler and linker: create the -o output, empty
+ */
+static int stub_compiler_main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '@') {
+            return stub_read_response_file(argv[i] + 1);
+        }
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            return stub_create_output(argv[i + 1]);
+        }
+    }
+    return 0;
+}
+
+static bool stub_compiler_path(const char *argv0, char *dest, size_t dest_size) {
+#ifdef _WIN32
+    (void)argv0;
+    DWORD length = GetModuleFileNameA(NULL, dest, (DWORD)dest_size);
+    return length > 0 && length < dest_size;
+#else
+    char found[MAX_PATH_LENGTH];
+    if (!process_find_executable(argv0, found, sizeof(found))) return false;
+    if (found[0] == '/') {
+        return (size_t)snprintf(dest, dest_size, "%s", found) < dest_size;
+    }
+
+    /* The builds spawn it from other directories */
+    char cwd[MAX_PATH_LENGTH];
+    if (!getcwd(cwd, sizeof(cwd))) return false;
+    return (size_t)snprintf(dest, dest_size, "%s/%s", cwd, found) < dest_size;
+#endif
+}
+
+/* ==============================================================================
+ * Helpers
+ * ==============================================================================
+ */
+
+/* The builds report on stdout; the JSON may be going there too */
+static int quiet_saved_stdout = -1;
+
+static void quiet_begin(void) {
+    fflush(stdout);
+    quiet_saved_stdout = dup(fileno(stdout));
+    FILE *null_device = fopen(BENCH_NULL_DEVICE, "w");
+    if (null_device) {
+        dup2(fileno(null_device), fileno(stdout));
+        fclose(null_device);
+    }
+}
+
+static void quiet_end(void) {
+    fflush(stdout);
+    if (quiet_saved_stdout >= 0) {
+        dup2(quiet_saved_stdout, fileno(stdout));
+        close(quiet_saved_stdout);
+        quiet_saved_stdout = -1;
+    }
+}
+
+static void remove_tree(const char *path) {
+    char command[MAX_PATH_LENGTH + 32];
+#ifdef _WIN32
+    snprintf(command, sizeof(command), "rmdir /s /q \"%s\" 2>nul", path);
+#else
+    snprintf(command, sizeof(command), "rm -rf \"%s\"", path);
+#endif
+    if (system(command) != 0) {
+        /* Nothing to remove the first time */
+    }
+}
+
+static bool write_text(const char *path, const char *text) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+    fputs(text, fp);
+    return fclose(fp) == 0;
+}
+
+static bool parse_sizes(const char *list, BenchOptions *options) {
+    options->size_count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end = NULL;
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p || value < 10 || options->size_count == BENCH_MAX_SIZES) return false;
+        options->sizes[options->size_count++] = (size_t)value;
+        if (*end == ',') end++;
+        else if (*end != '\0') return false;
+        p = end;
+    }
+    return options->size_count > 0;
+}
+
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n\n"
+            "Options:\n"
+            "  --sizes N,N,...   Files per generated tree (default: %s)\n"
+            "  --fan-in N        Headers each source includes (default: %d)\n"
+            "  -j, --jobs N      Parallel jobs for builds and scans (default: 1)\n"
+            "  --repeat N        Runs per phase; the fastest is reported (default: %d)\n"
+            "  --dir DIR         Where trees are generated (default: ecbuild_bench_trees)\n"
+            "  --output FILE     Write the JSON report to FILE (default: stdout)\n"
+            "  --keep            Leave the generated trees behind\n",
+            program, BENCH_DEFAULT_SIZES, BENCH_DEFAULT_FAN_IN, BENCH_DEFAULT_REPEAT);
+}
+
+/* ==============================================================================
+ * Tree Generation
+ * ==============================================================================
+ */
+
+/* Numerical Recipes LCG: the same tree for the same size on every machine */
+static uint32_t bench_random(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static bool generate_header(const char *root, size_t index) {
+    char path[MAX_PATH_LENGTH + 32];
+    char text[1024];
+    snprintf(path, sizeof(path), "%s/include/h%05zu.h", root, index);
+
+    int length = snprintf(text, sizeof(text), "#ifndef H%05zu_H\n#define H%05zu_H\n\n",
+                          index, index);
+    if (index > 0) {
+        length += snprintf(text + length, sizeof(text) - length,
+                           "#include \"h%05zu.h\"\n\n", (index - 1) / 2);
+    }
+    snprintf(text + length, sizeof(text) - length,
+             "/* Declarations of module %zu */\n"
+             "typedef struct H%05zu { int value; int flags; } H%05zu;\n"
+             "int h%05zu_get(const H%05zu *h);\n"
+             "void h%05zu_set(H%05zu *h, int value);\n\n"
+             "#endif\n",
+             index, index, index, index, index, index, index);
+    return write_text(path, text);
+}
+
+static bool generate_source(const char *root, size_t index, size_t header_count,
+                            size_t fan_in, uint32_t *state) {
+    char dir[MAX_PATH_LENGTH + 32];
+    snprintf(dir, sizeof(dir), "%s/src/d%03zu", root, index / BENCH_SOURCES_PER_DIR);
+    if (index % BENCH_SOURCES_PER_DIR == 0) mkdir(dir, 0755);
+
+    char path[MAX_PATH_LENGTH + 64];
+    snprintf(path, sizeof(path), "%s/s%05zu.c", dir, index);
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+
+    fprintf(fp, "#include <stddef.h>\n");
+    if (index % BENCH_TOUCH_STRIDE == 0) {
+        fprintf(fp, "#include \"touched.h\"\n");
+    }
+    for (size_t i = 0; i < fan_in; i++) {
+        fprintf(fp, "#include \"h%05zu.h\"\n", (size_t)bench_random(state) % header_count);
+    }
+    fprintf(fp,
+            "\n"
+            "/* Module %zu: a few functions of typical size */\n"
+            "static int s%05zu_table[16];\n\n"
+            "int s%05zu_sum(size_t count) {\n"
+            "    int total = 0;\n"
+            "    for (size_t i = 0; i < count && i < 16; i++) {\n"
+            "        total += s%05zu_table[i];\n"
+            "    }\n"
+            "    return total;\n"
+            "}\n\n"
+            "void s%05zu_fill(int value) {\n"
+            "    for (size_t i = 0; i < 16; i++) {\n"
+            "        s%05zu_table[i] = value + (int)i;\n"
+            "    }\n"
+            "}\n",
+            index, index, index, index, index, index);
+    return fclose(fp) == 0;
+}
+
+/**
+ * Write a tree of about file_count files under root
+ */
+static bool generate_tree(const char *root, size_t file_count, size_t fan_in,
+                          BenchResult *result) {
+    size_t header_count = file_count / 10;
+    size_t source_count = file_count - header_count - 2;   /* touched.h, main.c */
+
+    char path[MAX_PATH_LENGTH + 32];
+    mkdir(root, 0755);
+    snprintf(path, sizeof(path), "%s/include", root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/src", root);
+    mkdir(path, 0755);
+
+    for (size_t i = 0; i < header_count; i++) {
+        if (!generate_header(root, i)) return false;
+    }
+
+    snprintf(path, sizeof(path), "%s/include/touched.h", root);
+    if (!write_text(path, "#ifndef TOUCHED_H\n#define TOUCHED_H\n\n"
+                          "#define TOUCHED_REVISION 0\n\n#endif\n")) {
+        return false;
+    }
+
+    uint32_t state = 0x2545F491u;
+    for (size_t i = 0; i < source_count; i++) {
+        if (!generate_source(root, i, header_count, fan_in, &state)) return false;
+    }
+
+    snprintf(path, sizeof(path), "%s/src/main.c", root);
+    if (!write_text(path, "#include \"h00000.h\"\n\n"
+                          "int main(void) {\n    return 0;\n}\n")) {
+        return false;
+    }
+
+    result->files = header_count + source_count + 2;
+    result->sources = source_count + 1;
+    result->headers = header_count + 1;
+    result->touch_dependents = (source_count + BENCH_TOUCH_STRIDE - 1) / BENCH_TOUCH_STRIDE;
+    return true;
+}
+
+/**
+ * Change touched.h so that both stat stamps and content hashes see it
+ */
+static bool touch_header(const char *root, int revision) {
+    char path[MAX_PATH_LENGTH + 32];
+    char text[128];
+    snprintf(path, sizeof(path), "%s/include/touched.h", root);
+    snprintf(text, sizeof(text), "#ifndef TOUCHED_H\n#define TOUCHED_H\n\n"
+                                 "#define TOUCHED_REVISION %d /* %*s */\n\n#endif\n",
+             revision, revision % 8, "");
+    return write_text(path, text);
+}
+
+/* ==============================================================================
+ * Phases
+ * ==============================================================================
+ */
+
+static DependencyGraph *bench_graph_create(const char *root, int jobs) {
+    DependencyGraph *graph = dependency_graph_create();
+    if (!graph) return NULL;
+
+    char include_dir[MAX_PATH_LENGTH + 16];
+    snprintf(include_dir, sizeof(include_dir), "%s/include", root);
+    dependency_graph_add_include_path(graph, include_dir);
+    dependency_graph_add_include_path(graph, root);
+    dependency_graph_set_scan_threads(graph, (size_t)jobs);
+    return graph;
+}
+
+/**
+ * Scan the tree, with includes from cache when one is given (as ecbuild
+ * does, recording the graph back into it)
+ */
+static DependencyGraph *bench_scan(const char *root, int jobs, BuildCache *cache,
+                                   double *seconds) {
+    DependencyGraph *graph = bench_graph_create(root, jobs);
+    if (!graph) return NULL;
+
+    if (cache) build_cache_provide_includes(cache, graph);
+
+    double start = build_clock_seconds();
+    DependencyErrorCode err = dependency_graph_scan_directory(graph, root, true);
+    if (seconds) *seconds = build_clock_seconds() - start;
+
+    if (cache) {
+        dependency_graph_set_include_provider(graph, NULL, NULL);
+        if (err == DEP_SUCCESS) {
+            build_cache_record_graph(cache, graph);
+            build_cache_save(cache);
+        }
+    }
+    if (err != DEP_SUCCESS || graph->file_count == 0) {
+        fprintf(stderr, "Failed to scan %s: %s\n", root, dependency_error_string(err));
+        dependency_graph_destroy(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+/**
+ * One ecbuild run: load the cache, scan with it, build
+ */
+static bool bench_build(const char *root, BuildConfig *config, int jobs,
+                        double *seconds, size_t *compiled) {
+    double start = build_clock_seconds();
+    quiet_begin();
+
+    BuildCache *graph_cache = build_cache_create(root);
+    DependencyGraph *graph = bench_scan(root, jobs, graph_cache, NULL);
+    build_cache_destroy(graph_cache);
+
+    BuildStatistics stats;
+    memset(&stats, 0, sizeof(stats));
+    int status = graph ? eventchains_build_project(graph, config, &stats) : 1;
+    dependency_graph_destroy(graph);
+
+    quiet_end();
+    *seconds = build_clock_seconds() - start;
+    *compiled = stats.compiled_files;
+    if (status != 0) {
+        fprintf(stderr, "Build of %s failed\n", root);
+    }
+    return status == 0;
+}
+
+#define KEEP_FASTEST(best, value) \
+    if (run == 0 || (value) < (best)) (best) = (value)
+
+static bool bench_size(const BenchOptions *options, const char *stub, size_t file_count,
+                       BenchResult *result) {
+    memset(result, 0, sizeof(BenchResult));
+
+    char root[MAX_PATH_LENGTH];
+    snprintf(root, sizeof(root), "%s/files_%zu", options->work_dir, file_count);
+    remove_tree(root);
+
+    fprintf(stderr, "[%zu files] generating\n", file_count);
+    double start = build_clock_seconds();
+    if (!generate_tree(root, file_count, options->fan_in, result)) {
+        fprintf(stderr, "Failed to generate %s\n", root);
+        return false;
+    }
+    result->generate_s = build_clock_seconds() - start;
+
+    /* Cold scans; the last graph is kept for the sort */
+    fprintf(stderr, "[%zu files] scanning\n", file_count);
+    DependencyGraph *graph = NULL;
+    for (int run = 0; run < options->repeat; run++) {
+        dependency_graph_destroy(graph);
+        double seconds = 0.0;
+        graph = bench_scan(root, options->jobs, NULL, &seconds);
+        if (!graph) return false;
+        KEEP_FASTEST(result->scan_parse_s, seconds);
+    }
+    for (size_t i = 0; i < graph->file_count; i++) {
+        result->include_edges += graph->files[i]->include_count;
+    }
+
+    for (int run = 0; run < options->repeat; run++) {
+        BuildOrder order;
+        start = build_clock_seconds();
+        DependencyErrorCode err = dependency_graph_topological_sort(graph, &order);
+        double seconds = build_clock_seconds() - start;
+        build_order_destroy(&order);
+        if (err != DEP_SUCCESS) {
+            fprintf(stderr, "Failed to sort %s: %s\n", root, dependency_error_string(err));
+            dependency_graph_destroy(graph);
+            return false;
+        }
+        KEEP_FASTEST(result->topo_sort_s, seconds);
+    }
+    dependency_graph_destroy(graph);
+
+    BuildConfig *config = build_config_create();
+    if (!config) return false;
+    char output_dir[MAX_PATH_LENGTH + 8];
+    char include_dir[MAX_PATH_LENGTH + 8];
+    snprintf(output_dir, sizeof(output_dir), "%s/build", root);
+    snprintf(include_dir, sizeof(include_dir), "%s/include", root);
+    build_config_set_output_dir(config, output_dir);
+    build_config_set_output_binary(config, "bench");
+    build_config_add_include_path(config, include_dir);
+    free(config->compiler_path);
+    config->compiler = COMPILER_GCC;
+    config->compiler_path = strdup(stub);
+    config->parallel_jobs = options->jobs;
+
+    bool ok = true;
+    fprintf(stderr, "[%zu files] initial build\n", file_count);
+    size_t compiled = 0;
+    ok = bench_build(root, config, options->jobs, &result->initial_build_s, &compiled);
+
+    /* The cache as the build left it: graph snapshot and compile entries */
+    fprintf(stderr, "[%zu files] cache load and save\n", file_count);
+    for (int run = 0; ok && run < options->repeat; run++) {
+        quiet_begin();
+        start = build_clock_seconds();
+        BuildCache *cache = build_cache_create(root);
+        double seconds = build_clock_seconds() - start;
+        quiet_end();
+        if (!cache) {
+            ok = false;
+            break;
+        }
+        KEEP_FASTEST(result->cache_load_s, seconds);
+        result->cache_bytes = build_cache_size_bytes(cache);
+
+        /* An unchanged cache is not written at all; time a full write */
+        cache->dirty = true;
+        quiet_begin();
+        start = build_clock_seconds();
+        bool saved = build_cache_save(cache);
+        seconds = build_clock_seconds() - start;
+        quiet_end();
+        build_cache_destroy(cache);
+        if (!saved) {
+            ok = false;
+            break;
+        }
+        KEEP_FASTEST(result->cache_save_s, seconds);
+    }
+
+    for (int run = 0; ok && run < options->repeat; run++) {
+        quiet_begin();
+        BuildCache *cache = build_cache_create(root);
+        double seconds = 0.0;
+        DependencyGraph *cached = cache ? bench_scan(root, options->jobs, cache, &seconds) : NULL;
+        quiet_end();
+        build_cache_destroy(cache);
+        dependency_graph_destroy(cached);
+        if (!cached) {
+            ok = false;
+            break;
+        }
+        KEEP_FASTEST(result->scan_cached_s, seconds);
+    }
+
+    fprintf(stderr, "[%zu files] no-op builds\n", file_count);
+    for (int run = 0; ok && run < options->repeat; run++) {
+        double seconds = 0.0;
+        ok = bench_build(root, config, options->jobs, &seconds, &compiled);
+        KEEP_FASTEST(result->noop_build_s, seconds);
+        if (run == 0 || compiled > result->noop_compiled) result->noop_compiled = compiled;
+    }
+
+    fprintf(stderr, "[%zu files] header-touch rebuilds\n", file_count);
+    for (int run = 0; ok && run < options->repeat; run++) {
+        double seconds = 0.0;
+        ok = touch_header(root, run + 1) &&
+             bench_build(root, config, options->jobs, &seconds, &compiled);
+        KEEP_FASTEST(result->touch_rebuild_s, seconds);
+        result->touch_compiled = compiled;
+    }
+
+    build_config_destroy(config);
+    if (!options->keep) remove_tree(root);
+
+    result->ok = ok;
+    return ok;
+}
+
+/* ==============================================================================
+ * Report
+ * ==============================================================================
+ */
+
+static void write_report(FILE *fp, const BenchOptions *options, const BenchResult *results,
+                         size_t count) {
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"benchmark\": \"ecbuild_bench\",\n");
+    fprintf(fp, "  \"version\": \"%s\",\n", BENCH_VERSION);
+    fprintf(fp, "  \"compiler\": \"stub\",\n");
+    fprintf(fp, "  \"fan_in\": %zu,\n", options->fan_in);
+    fprintf(fp, "  \"jobs\": %d,\n", options->jobs);
+    fprintf(fp, "  \"repeat\": %d,\n", options->repeat);
+    fprintf(fp, "  \"results\": [");
+    for (size_t i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        fprintf(fp, "%s\n    {\n", i > 0 ? "," : "");
+        fprintf(fp, "      \"files\": %zu,\n", r->files);
+        fprintf(fp, "      \"sources\": %zu,\n", r->sources);
+        fprintf(fp, "      \"headers\": %zu,\n", r->headers);
+        fprintf(fp, "      \"include_edges\": %zu,\n", r->include_edges);
+        fprintf(fp, "      \"ok\": %s,\n", r->ok ? "true" : "false");
+        fprintf(fp, "      \"generate_s\": %.6f,\n", r->generate_s);
+        fprintf(fp, "      \"scan_parse_s\": %.6f,\n", r->scan_parse_s);
+        fprintf(fp, "      \"scan_cached_s\": %.6f,\n", r->scan_cached_s);
+        fprintf(fp, "      \"topo_sort_s\": %.6f,\n", r->topo_sort_s);
+        fprintf(fp, "      \"initial_build_s\": %.6f,\n", r->initial_build_s);
+        fprintf(fp, "      \"cache_load_s\": %.6f,\n", r->cache_load_s);
+        fprintf(fp, "      \"cache_save_s\": %.6f,\n", r->cache_save_s);
+        fprintf(fp, "      \"cache_bytes\": %zu,\n", r->cache_bytes);
+        fprintf(fp, "      \"noop_build_s\": %.6f,\n", r->noop_build_s);
+        fprintf(fp, "      \"noop_compiled\": %zu,\n", r->noop_compiled);
+        fprintf(fp, "      \"touch_rebuild_s\": %.6f,\n", r->touch_rebuild_s);
+        fprintf(fp, "      \"touch_dependents\": %zu,\n", r->touch_dependents);
+        fprintf(fp, "      \"touch_compiled\": %zu\n", r->touch_compiled);
+        fprintf(fp, "    }");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+    if (getenv(BENCH_STUB_ENV)) {
+        return stub_compiler_main(argc, argv);
+    }
+
+    BenchOptions options;
+    memset(&options, 0, sizeof(options));
+    parse_sizes(BENCH_DEFAULT_SIZES, &options);
+    options.fan_in = BENCH_DEFAULT_FAN_IN;
+    options.jobs = 1;
+    options.repeat = BENCH_DEFAULT_REPEAT;
+    options.work_dir = "ecbuild_bench_trees";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--keep") == 0) {
+            options.keep = true;
+            continue;
+        } else if (!value) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        bool valid = true;
+        if (strcmp(arg, "--sizes") == 0) {
+            valid = parse_sizes(value, &options);
+        } else if (strcmp(arg, "--fan-in") == 0) {
+            options.fan_in = (size_t)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "-j") == 0 || strcmp(arg, "--jobs") == 0) {
+            options.jobs = atoi(value);
+            valid = options.jobs > 0;
+        } else if (strcmp(arg, "--repeat") == 0) {
+            options.repeat = atoi(value);
+            valid = options.repeat > 0;
+        } else if (strcmp(arg, "--dir") == 0) {
+            options.work_dir = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            options.output = value;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            fprintf(stderr, "Invalid option: %s %s\n\n", arg, value);
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    char stub[MAX_PATH_LENGTH];
+    if (!stub_compiler_path(argv[0], stub, sizeof(stub))) {
+        fprintf(stderr, "Cannot find this program's own path to use as the compiler\n");
+        return 1;
+    }
+#ifdef _WIN32
+    _putenv(BENCH_STUB_ENV "=1");
+#else
+    setenv(BENCH_STUB_ENV, "1", 1);
+#endif
+
+    mkdir(options.work_dir, 0755);
+    event_chain_initialize();
+
+    BenchResult results[BENCH_MAX_SIZES];
+    bool all_ok = true;
+    for (size_t i = 0; i < options.size_count; i++) {
+        if (!bench_size(&options, stub, options.sizes[i], &results[i])) all_ok = false;
+    }
+
+    event_chain_cleanup();
+
+    FILE *fp = options.output ? fopen(options.output, "w") : stdout;
+    if (!fp) {
+        fprintf(stderr, "Cannot write %s\n", options.output);
+        return 1;
+    }
+    write_report(fp, &options, results, options.size_count);
+    if (options.output) fclose(fp);
+
+    return all_ok ? 0 : 1;
+}
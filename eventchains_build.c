@@ -6,6 +6,12 @@
 
 #include "eventchains_build.h"
 #include "cache_metadata.h"
+#include "object_store.h"
+#include "remote_cache.h"
+#include "distributed_compile.h"
+#include "precompiled_header.h"
+#include "unity_build.h"
+#include "build_trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +19,7 @@
 
 #ifdef _WIN32
     #include <direct.h>
+    #include <sys/stat.h>
     #define mkdir(path, mode) _mkdir(path)
 #else
     #include <sys/stat.h>
@@ -48,6 +55,7 @@ EventResult compile_event_execute(EventContext *context, void *user_data) {
 
     /* Store results */
     data->compile_time = compile_result.compile_time;
+    data->peak_memory = compile_result.peak_memory;
     data->cache_hit = false;
 
     if (compile_result.object_file) {
@@ -64,9 +72,22 @@ EventResult compile_event_execute(EventContext *context, void *user_data) {
     if (success) {
         event_result_success(&result);
     } else {
-        char error_msg[1024];
-        snprintf(error_msg, sizeof(error_msg), "Compilation failed: %s",
-                compile_result.error_output ? compile_result.error_output : "Unknown error");
+        char error_msg[EVENTCHAINS_MAX_ERROR_LENGTH];
+        const char *diagnostics = compile_result.error_output;
+        int needed = snprintf(error_msg, sizeof(error_msg), "Compilation failed: %s",
+                              diagnostics ? diagnostics : "Unknown error");
+        if (needed < 0 || (size_t)needed >= sizeof(error_msg)) {
+            /* Too long for the event's message: show the diagnostics in
+             * full here (verbose builds echoed them already) and point
+             * the failure list at them */
+            if (!data->config->verbose) {
+                fprintf(stderr, "Failed to compile %s\n%s", data->source->path, diagnostics);
+                if (diagnostics[strlen(diagnostics) - 1] != '\n') fputc('\n', stderr);
+            }
+            snprintf(error_msg, sizeof(error_msg),
+                     "Compilation failed with exit code %d; diagnostics printed above",
+                     compile_result.exit_code);
+        }
         event_result_failure(&result, error_msg, EC_ERROR_EVENT_EXECUTION_FAILED,
                            ERROR_DETAIL_FULL);
     }
@@ -85,9 +106,9 @@ EventResult link_event_execute(EventContext *context, void *user_data) {
         return result;
     }
 
-    /* Collect object files from context */
-    /* For now, use the object files already collected in LinkEventData */
-    /* In a more sophisticated implementation, we'd scan the context for all "object:*" keys */
+    /* Links the objects listed in LinkEventData. eventchains_build_project
+     * does not chain link events; it links after the chain, from the
+     * compile events' object paths (see link_project) */
 
     if (data->object_count == 0) {
         event_result_failure(&result, "No object files to link",
@@ -127,6 +148,12 @@ EventResult link_event_execute(EventContext *context, void *user_data) {
     return result;
 }
 
+CompileEventData *compile_event_data(const ChainableEvent *event) {
+    /* Identified by what the event runs, not by guessing at its user data */
+    if (!event || event->execute != compile_event_execute) return NULL;
+    return (CompileEventData *)event->user_data;
+}
+
 /* ==============================================================================
  * Event Creation Functions
  * ==============================================================================
@@ -147,6 +174,7 @@ ChainableEvent *create_compile_event(
     data->object_path[0] = '\0';
     data->cache_hit = false;
     data->compile_time = 0.0;
+    data->peak_memory = 0;
 
     /* Get object file path */
     get_object_file_path(source->path, config->output_dir,
@@ -203,6 +231,41 @@ ChainableEvent *create_link_event(const BuildConfig *config) {
  * ==============================================================================
  */
 
+static int compare_event_objects(const void *a, const void *b) {
+    const CompileEventData *left = *(const CompileEventData *const *)a;
+    const CompileEventData *right = *(const CompileEventData *const *)b;
+    return strcmp(left->object_path, right->object_path);
+}
+
+/**
+ * Check that no two sources compile to the same object
+ *
+ * Objects are named after the source's file name alone, so src/app.c and
+ * tools/app.c would overwrite each other's app.o and one of them would be
+ * linked twice.
+ */
+static bool check_object_paths(EventChain *chain) {
+    CompileEventData **data = malloc((chain->event_count + 1) * sizeof(CompileEventData *));
+    if (!data) return true;
+
+    for (size_t i = 0; i < chain->event_count; i++) {
+        data[i] = (CompileEventData *)chainable_event_get_user_data(chain->events[i]);
+    }
+    qsort(data, chain->event_count, sizeof(CompileEventData *), compare_event_objects);
+
+    bool unique = true;
+    for (size_t i = 1; i < chain->event_count; i++) {
+        if (strcmp(data[i - 1]->object_path, data[i]->object_path) == 0) {
+            fprintf(stderr, "%s and %s both compile to %s; rename one of them\n",
+                    data[i - 1]->source->path, data[i]->source->path, data[i]->object_path);
+            unique = false;
+        }
+    }
+
+    free(data);
+    return unique;
+}
+
 EventChain *build_compilation_chain(
     DependencyGraph *graph,
     BuildConfig *config
@@ -215,6 +278,7 @@ EventChain *build_compilation_chain(
     if (err != DEP_SUCCESS) {
         fprintf(stderr, "Failed to determine build order: %s\n",
                 dependency_error_string(err));
+        build_order_destroy(&order);
         return NULL;
     }
 
@@ -222,24 +286,41 @@ EventChain *build_compilation_chain(
     EventChain *chain = event_chain_create(FAULT_TOLERANCE_STRICT);
     if (!chain) {
         fprintf(stderr, "Failed to create event chain\n");
+        build_order_destroy(&order);
         return NULL;
     }
 
     /* Store build config in context */
     event_context_set(chain->context, CONTEXT_KEY_BUILD_CONFIG, (void *)config);
 
+    /* Map build-order positions to event indices so include edges between
+     * translation units can be turned into event dependencies */
+    long *event_for_order = malloc((order.file_count + 1) * sizeof(long));
+    if (!event_for_order) {
+        fprintf(stderr, "Failed to allocate event index map\n");
+        event_chain_destroy(chain);
+        build_order_destroy(&order);
+        return NULL;
+    }
+    for (size_t i = 0; i < order.file_count; i++) {
+        event_for_order[i] = -1;
+    }
+
     /* Create compilation events for each source file */
     size_t compiled_count = 0;
     for (size_t i = 0; i < order.file_count; i++) {
         SourceFile *file = order.ordered_files[i];
 
-        /* Skip headers - they don't compile */
-        if (file->is_header) continue;
+        /* Skip headers - they don't compile - and sources compiled inside
+         * a unity source */
+        if (file->is_header || unity_build_skips(config->unity, file)) continue;
 
         ChainableEvent *event = create_compile_event(file, config);
         if (!event) {
             fprintf(stderr, "Failed to create compile event for %s\n", file->path);
+            free(event_for_order);
             event_chain_destroy(chain);
+            build_order_destroy(&order);
             return NULL;
         }
 
@@ -248,19 +329,45 @@ EventChain *build_compilation_chain(
             fprintf(stderr, "Failed to add event to chain: %s\n",
                     event_chain_error_string(add_err));
             chainable_event_destroy(event);
+            free(event_for_order);
             event_chain_destroy(chain);
+            build_order_destroy(&order);
             return NULL;
         }
 
+        size_t event_index = chain->event_count - 1;
+        event_for_order[i] = (long)event_index;
+
+        /* A translation unit that #includes another one (generated or
+         * amalgamated sources) must wait for that unit's compile step.
+         * Topological order guarantees the prerequisite already has an event. */
+        for (size_t j = 0; j < file->include_count; j++) {
+            SourceFile *dep = dependency_graph_find_file(graph, file->includes[j]);
+            if (!dep || dep->is_header || dep->sort_order < 0) continue;
+
+            long dep_event = event_for_order[dep->sort_order];
+            if (dep_event >= 0) {
+                event_chain_add_dependency(chain, event_index, (size_t)dep_event);
+            }
+        }
+
         compiled_count++;
     }
 
+    free(event_for_order);
+    build_order_destroy(&order);
+
     if (compiled_count == 0) {
         fprintf(stderr, "No source files to compile\n");
         event_chain_destroy(chain);
         return NULL;
     }
 
+    if (!check_object_paths(chain)) {
+        event_chain_destroy(chain);
+        return NULL;
+    }
+
     /* Note: Linking event will be added separately after we know we need it */
     /* This allows for library-only builds */
 
@@ -268,41 +375,588 @@ EventChain *build_compilation_chain(
 }
 
 /* ==============================================================================
- * High-Level Build API
+ * Linking
  * ==============================================================================
  */
 
-int eventchains_build_project(
-    DependencyGraph *graph,
-    BuildConfig *config,
-    BuildStatistics *stats
-) {
-    if (!graph || !config) return 1;
+/**
+ * LinkTarget - One executable or static library to produce
+ */
+typedef struct LinkTarget {
+    char name[256];                    /* Output name, without directory or suffix */
+    const char **inputs;               /* Objects and libraries to link */
+    size_t input_count;
+    bool is_library;                   /* Archive instead of link */
+    CompileResult result;
+    bool attempted;
+    bool success;
+} LinkTarget;
+
+/**
+ * LinkQueue - Executables shared out between link workers
+ */
+typedef struct LinkQueue {
+    LinkTarget *targets;
+    size_t count;
+    size_t next;                       /* First target not yet taken */
+    const BuildConfig *config;
+    ec_mutex_t lock;
+} LinkQueue;
+
+static bool run_link_target(LinkTarget *target, const BuildConfig *config) {
+    target->attempted = true;
+    target->success = target->is_library
+        ? create_static_library(target->inputs, target->input_count, target->name,
+                                config, &target->result)
+        : link_executable_named(target->inputs, target->input_count, target->name,
+                                config, &target->result);
+    return target->success;
+}
+
+static void *link_worker(void *arg) {
+    LinkQueue *queue = (LinkQueue *)arg;
+    for (;;) {
+        ec_mutex_lock(&queue->lock);
+        size_t index = queue->next < queue->count ? queue->next++ : queue->count;
+        ec_mutex_unlock(&queue->lock);
+        if (index == queue->count) break;
+
+        run_link_target(&queue->targets[index], queue->config);
+    }
+    return NULL;
+}
+
+/**
+ * Name an executable after its main() source: "tools/gen.c" becomes "gen"
+ *
+ * The names cannot clash, since check_object_paths has already refused
+ * two sources that share a file name.
+ */
+static void executable_name(const SourceFile *source, char *dest, size_t dest_size) {
+    const char *base = source->path;
+    for (const char *p = source->path; *p; p++) {
+        if (*p == '/' || *p == '\\') base = p + 1;
+    }
+    snprintf(dest, dest_size, "%s", base);
+
+    char *ext = strrchr(dest, '.');
+    if (ext && ext != dest) *ext = '\0';
+}
+
+/**
+ * Link every output the compiled objects make up
+ *
+ * With one main() source - or none, when the objects are only archived -
+ * the project links as it always has, into output_binary. With several,
+ * everything but the entry points is archived once into
+ * lib<output_binary>, and each entry point is linked against it into an
+ * executable of its own, up to parallel_jobs at a time, so shared code is
+ * compiled and archived once however many programs use it. Outputs
+ * newer than their inputs and made by the same command are left alone.
+ */
+static bool link_project(EventChain *chain, const BuildConfig *config,
+                         BuildStatistics *stats) {
+    size_t capacity = chain->event_count;
+    const char **objects = malloc((capacity + 1 + PCH_LANGUAGE_COUNT) * sizeof(const char *));
+    const char **library_objects =
+        malloc((capacity + 1 + PCH_LANGUAGE_COUNT) * sizeof(const char *));
+    const SourceFile **mains = malloc((capacity + 1) * sizeof(const SourceFile *));
+    const char **main_objects = malloc((capacity + 1) * sizeof(const char *));
+    LinkTarget *targets = calloc(capacity + 1, sizeof(LinkTarget));
+    const char **inputs = malloc(2 * (capacity + 1) * sizeof(const char *));
+    if (!objects || !library_objects || !mains || !main_objects || !targets || !inputs) {
+        fprintf(stderr, "Failed to allocate object file list\n");
+        free(objects);
+        free(library_objects);
+        free(mains);
+        free(main_objects);
+        free(targets);
+        free(inputs);
+        return false;
+    }
+
+    size_t object_count = 0;
+    size_t library_count = 0;
+    size_t main_count = 0;
+    for (size_t i = 0; i < chain->event_count; i++) {
+        CompileEventData *data =
+            (CompileEventData *)chainable_event_get_user_data(chain->events[i]);
+        if (!data || data->object_path[0] == '\0' || data->source->is_header) continue;
+
+        objects[object_count++] = data->object_path;
+        if (source_file_has_main((SourceFile *)data->source)) {
+            mains[main_count] = data->source;
+            main_objects[main_count++] = data->object_path;
+        } else {
+            library_objects[library_count++] = data->object_path;
+        }
+    }
+
+    /* MSVC keeps what a precompiled header defines in its /Yc object, which
+     * objects compiled against the header, now or before, need */
+    for (int language = 0; config->pch && language < PCH_LANGUAGE_COUNT; language++) {
+        const PrecompiledHeader *header = &config->pch->headers[language];
+        if (header->object_path[0] != '\0' && file_exists_cache(header->object_path)) {
+            objects[object_count++] = header->object_path;
+            library_objects[library_count++] = header->object_path;
+        }
+    }
+
+    /* Plan: the library first, since the executables link against it */
+    size_t target_count = 0;
+    char library_path[MAX_PATH_LENGTH] = {0};
+    if (main_count <= 1) {
+        LinkTarget *target = &targets[target_count++];
+        snprintf(target->name, sizeof(target->name), "%s", config->output_binary);
+        target->inputs = objects;
+        target->input_count = object_count;
+        target->is_library = main_count == 0;
+    } else {
+        if (library_count > 0) {
+            LinkTarget *target = &targets[target_count++];
+            snprintf(target->name, sizeof(target->name), "%s", config->output_binary);
+            target->inputs = library_objects;
+            target->input_count = library_count;
+            target->is_library = true;
+            static_library_path(config, target->name, library_path, sizeof(library_path));
+        }
+        for (size_t i = 0; i < main_count; i++) {
+            LinkTarget *target = &targets[target_count++];
+            executable_name(mains[i], target->name, sizeof(target->name));
+            target->inputs = &inputs[2 * i];
+            target->inputs[0] = main_objects[i];
+            target->input_count = 1;
+            if (library_path[0] != '\0') {
+                target->inputs[target->input_count++] = library_path;
+            }
+        }
+    }
+
+    bool success = true;
+    size_t first_executable = 0;
+    if (targets[0].is_library) {
+        success = run_link_target(&targets[0], config);
+        first_executable = 1;
+    }
+
+    if (success && first_executable < target_count) {
+        LinkQueue queue;
+        queue.targets = &targets[first_executable];
+        queue.count = target_count - first_executable;
+        queue.next = 0;
+        queue.config = config;
+        ec_mutex_init(&queue.lock);
+
+        size_t workers = config->parallel_jobs > 1 ? (size_t)config->parallel_jobs : 1;
+        if (workers > queue.count) workers = queue.count;
+
+        ec_thread_t *threads = workers > 1 ? malloc(workers * sizeof(ec_thread_t)) : NULL;
+        size_t started = 0;
+        for (; threads && started < workers; started++) {
+            if (ec_thread_create(&threads[started], link_worker, &queue) != 0) break;
+        }
+        if (started == 0) link_worker(&queue);
+        for (size_t i = 0; i < started; i++) {
+            ec_thread_join(threads[i]);
+        }
+        free(threads);
+        ec_mutex_destroy(&queue.lock);
+    }
+
+    double link_time = 0.0;
+    for (size_t i = 0; i < target_count; i++) {
+        LinkTarget *target = &targets[i];
+        if (target->success) {
+            printf("%s: %s\n", target->result.up_to_date ? "Up to date"
+                                : target->is_library ? "Archived" : "Linked",
+                   target->result.object_file);
+        } else if (target->attempted) {
+            fprintf(stderr, "Failed to %s %s\n", target->is_library ? "archive" : "link",
+                    target->name);
+            if (target->result.error_output) {
+                fprintf(stderr, "%s\n", target->result.error_output);
+            }
+            success = false;
+        }
+        link_time += target->result.compile_time;
+        compile_result_destroy(&target->result);
+    }
+    printf("\n");
 
-    /* Initialize statistics */
     if (stats) {
-        memset(stats, 0, sizeof(BuildStatistics));
-        stats->total_files = graph->file_count;
+        stats->link_time = link_time;
+    }
+
+    free(objects);
+    free(library_objects);
+    free(mains);
+    free(main_objects);
+    free(targets);
+    free(inputs);
+    return success;
+}
+
+/* ==============================================================================
+ * Scheduling
+ * ==============================================================================
+ */
+
+#define SCHEDULE_DEFAULT_SECONDS 1.0       /* Expected compile time with no history at all */
+
+static int compare_dependencies_descending(const void *a, const void *b) {
+    size_t left = ((const EventDependency *)a)->event_index;
+    size_t right = ((const EventDependency *)b)->event_index;
+    return (left < right) - (left > right);
+}
+
+/**
+ * Prioritize compiles by the critical path through them
+ *
+ * Each source's expected compile time is what its last compile took, as
+ * recorded in the cache; sources the cache will skip cost nothing, and
+ * sources never timed are assumed average. A compile's priority is its
+ * own time plus the longest chain of compiles waiting on it, so the
+ * parallel executor starts the long poles first instead of finding them
+ * at the end of the build with every other worker idle. Everything feeds
+ * the link, so the path ends there. The recorded peak memory becomes the
+ * compile's cost against config->memory_budget.
+ */
+static void schedule_compiles(EventChain *chain, BuildCache *cache, const BuildConfig *config) {
+    size_t n = chain->event_count;
+    double *seconds = malloc((n + 1) * sizeof(double));
+    double *level = malloc((n + 1) * sizeof(double));
+    uint64_t *memory = malloc((n + 1) * sizeof(uint64_t));
+    bool *known = malloc((n + 1) * sizeof(bool));
+    EventDependency *edges = malloc((chain->dependency_count + 1) * sizeof(EventDependency));
+    if (!seconds || !level || !memory || !known || !edges) {
+        free(seconds);
+        free(level);
+        free(memory);
+        free(known);
+        free(edges);
+        return;
+    }
+
+    double known_seconds = 0.0;
+    uint64_t known_memory = 0;
+    size_t known_count = 0;
+    size_t current_count = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const CompileEventData *data =
+            (const CompileEventData *)chainable_event_get_user_data(chain->events[i]);
+        seconds[i] = 0.0;
+        memory[i] = 0;
+        known[i] = true;
+
+        struct stat st;
+        if (cache && build_cache_is_current(cache, data->source) &&
+            stat(data->object_path, &st) == 0) {
+            current_count++;
+            continue;  /* Cache hit, nothing to run */
+        }
+
+        known[i] = build_cache_get_compile_stats(cache, data->source->path,
+                                                 &seconds[i], &memory[i]);
+        if (known[i]) {
+            known_seconds += seconds[i];
+            known_memory += memory[i];
+            known_count++;
+        }
+    }
+
+    double average_seconds = known_count > 0 ? known_seconds / (double)known_count
+                                             : SCHEDULE_DEFAULT_SECONDS;
+    uint64_t average_memory = known_count > 0 ? known_memory / known_count : 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!known[i]) {
+            seconds[i] = average_seconds;
+            memory[i] = average_memory;
+        }
+        level[i] = seconds[i];
+    }
+
+    /* Dependencies point backwards, so walking dependents before their
+     * prerequisites finalizes each level before it is propagated */
+    memcpy(edges, chain->dependencies, chain->dependency_count * sizeof(EventDependency));
+    qsort(edges, chain->dependency_count, sizeof(EventDependency),
+          compare_dependencies_descending);
+    for (size_t e = 0; e < chain->dependency_count; e++) {
+        size_t pre = edges[e].prerequisite_index;
+        double through = seconds[pre] + level[edges[e].event_index];
+        if (through > level[pre]) level[pre] = through;
     }
 
+    double critical_path = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        event_chain_set_event_schedule(chain, i, level[i], memory[i]);
+        if (level[i] > critical_path) critical_path = level[i];
+    }
+    event_chain_set_memory_budget(chain, config->memory_budget);
+
+    printf("Scheduling: %zu cached, %zu timed by earlier builds, %zu new; "
+           "critical path ~%.1fs\n", current_count, known_count,
+           n - current_count - known_count, critical_path);
+    if (config->memory_budget > 0) {
+        printf("Memory budget: %llu MB of compiler memory at once\n",
+               (unsigned long long)(config->memory_budget / (1024 * 1024)));
+    }
     printf("\n");
-    printf("|----------------------------------------------------------------|\n");
-    printf("|        EventChains Build System - Building with Events        |\n");
-    printf("|----------------------------------------------------------------|\n\n");
 
-    /* Create output directory */
-    printf("Creating output directory: %s\n", config->output_dir);
-    mkdir(config->output_dir, 0755);
+    free(seconds);
+    free(level);
+    free(memory);
+    free(known);
+    free(edges);
+}
 
-    /* Create/load persistent cache in PROJECT directory (not build directory!)
-     * We need to extract the project directory from the output_dir path */
-    printf("\nPhase 0: Cache Initialization\n");
-    printf("----------------------------------------------------------------\n");
+/* ==============================================================================
+ * High-Level Build API
+ * ==============================================================================
+ */
+
+/**
+ * Open the shared object store named by the configuration, if any
+ *
+ * A remote cache without a store directory gets a private store inside
+ * the project's cache directory, since remote objects always land in a
+ * local store first.
+ */
+static ObjectStore *open_object_store(const BuildConfig *config, const BuildCache *cache) {
+    char default_dir[MAX_PATH_LENGTH + sizeof("/objects")];
+    const char *directory = config->object_store_dir;
+    if (!directory && config->remote_cache_url && cache) {
+        snprintf(default_dir, sizeof(default_dir), "%s/objects", cache->cache_dir);
+        directory = default_dir;
+    }
+    if (!directory) return NULL;
+
+    ObjectStore *store = object_store_open(directory, config->object_store_max_bytes);
+    if (!store || !object_store_set_toolchain(store, config)) {
+        printf("Warning: Failed to open object store %s, proceeding without it\n\n",
+               directory);
+        object_store_close(store);
+        return NULL;
+    }
+
+    printf("Object store: %s (limit %llu MB)\n", store->directory,
+           (unsigned long long)(store->max_bytes / (1024 * 1024)));
+
+    if (config->remote_cache_url) {
+        ObjectBackend *backend = remote_cache_http_create(config->remote_cache_url);
+        if (!backend) {
+            printf("Warning: Unsupported remote cache URL %s (only http:// is spoken)\n",
+                   config->remote_cache_url);
+        } else if (!object_store_set_remote(store, backend, config->remote_cache_upload)) {
+            printf("Warning: Failed to start remote cache transfers\n");
+        } else {
+            printf("Remote cache: %s (%s)\n", config->remote_cache_url,
+                   config->remote_cache_upload ? "read-write" : "read-only");
+        }
+    }
+    printf("\n");
+    return store;
+}
+
+/**
+ * Queue remote downloads for every object the build is going to want
+ *
+ * Sources the build cache already considers current, and whose object is
+ * still on disk, will not be compiled and are skipped. The rest are keyed
+ * in chain order so the workers fetch what the build needs first.
+ */
+static void prefetch_objects(ObjectStore *store, BuildCache *cache,
+                             DependencyGraph *graph, EventChain *chain) {
+    if (!store || !store->remote) return;
+
+    char (*keys)[OBJECT_KEY_LENGTH + 1] = malloc(chain->event_count * sizeof(*keys));
+    const char **key_list = malloc(chain->event_count * sizeof(const char *));
+    size_t count = 0;
+
+    for (size_t i = 0; keys && key_list && i < chain->event_count; i++) {
+        CompileEventData *data =
+            (CompileEventData *)chainable_event_get_user_data(chain->events[i]);
+        if (!data || !data->source || data->source->is_header) continue;
+
+        struct stat st;
+        if (cache && build_cache_is_current(cache, data->source) &&
+            stat(data->object_path, &st) == 0) {
+            continue;
+        }
+
+        if (object_store_key_for_source(store, cache, graph, data->source, keys[count])) {
+            key_list[count] = keys[count];
+            count++;
+        }
+    }
+
+    size_t queued = object_store_prefetch(store, key_list, count);
+    if (queued > 0) {
+        printf("Remote cache: prefetching %zu of %zu objects to build\n\n", queued, count);
+    }
+
+    free(key_list);
+    free(keys);
+}
+
+/**
+ * Report on the object store, evict if this build grew it, and close it
+ */
+static void close_object_store(ObjectStore *store) {
+    if (!store) return;
+
+    /* Uploads finish before the counts are reported */
+    object_store_flush(store);
+
+    printf("Object store: %zu hits, %zu misses, %zu objects added\n",
+           store->hits, store->misses, store->insertions);
+    if (store->remote) {
+        printf("Remote cache: %zu downloaded, %zu missing, %zu uploaded",
+               store->remote_hits, store->remote_misses, store->uploads_done);
+        if (store->upload_failures > 0) {
+            printf(", %zu uploads failed", store->upload_failures);
+        }
+        printf("\n");
+    }
+
+    if (store->insertions > 0) {
+        size_t removed = 0;
+        uint64_t total = 0;
+        if (object_store_trim(store, &removed, &total) && removed > 0) {
+            printf("Object store: evicted %zu objects, %llu MB remain\n", removed,
+                   (unsigned long long)(total / (1024 * 1024)));
+        }
+    }
+    printf("\n");
+
+    object_store_close(store);
+}
+
+/**
+ * Set up the compile worker pool named by the configuration, if any
+ */
+static DistPool *open_dist_pool(const BuildConfig *config) {
+    if (!config->dist_hosts) return NULL;
+
+    if (config->compiler == COMPILER_MSVC) {
+        printf("Warning: Distributed compilation needs GCC or Clang, compiling locally\n\n");
+        return NULL;
+    }
+
+    DistPool *pool = dist_pool_create(config->dist_hosts);
+    if (!pool) {
+        printf("Warning: Bad compile worker list \"%s\", compiling locally\n\n",
+               config->dist_hosts);
+        return NULL;
+    }
+
+    printf("Compile workers: %zu (%zu slots)\n\n", pool->worker_count, dist_pool_slots(pool));
+    return pool;
+}
+
+/**
+ * Report where sources were compiled and free the pool
+ */
+static void close_dist_pool(DistPool *pool) {
+    if (!pool) return;
+
+    printf("Distributed: %zu compiled remotely, %zu handed back to the local compiler\n",
+           pool->remote_compiles, pool->local_fallbacks);
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        const DistWorker *worker = &pool->workers[i];
+        printf("  %s:%s  %zu compiled%s\n", worker->host, worker->port, worker->compiled,
+               worker->disabled ? " (dropped)" : "");
+    }
+    printf("\n");
+
+    dist_pool_destroy(pool);
+}
+
+/**
+ * Choose and build the precompiled headers, if the configuration asks
+ *
+ * Sets config->pch, so compile commands use the headers that are ready.
+ */
+static PchSet *open_precompiled_headers(DependencyGraph *graph, BuildConfig *config,
+                                        BuildCache *cache) {
+    if (!config->use_pch) return NULL;
+
+    PchSet *set = pch_set_plan(graph, config);
+    if (!set) {
+        printf("Warning: Failed to plan precompiled headers, compiling without them\n\n");
+        return NULL;
+    }
+
+    pch_set_build(set, graph, config, cache);
+    for (int language = 0; language < PCH_LANGUAGE_COUNT; language++) {
+        const PrecompiledHeader *header = &set->headers[language];
+        if (header->language_sources == 0) continue;
+
+        printf("Precompiled header (%s): ", pch_language_name((PchLanguage)language));
+        if (header->include_count == 0) {
+            printf("none; no includes shared by enough of %zu sources\n",
+                   header->language_sources);
+            continue;
+        }
+        printf("%zu includes, used by %zu of %zu sources, %s\n", header->include_count,
+               header->source_count, header->language_sources,
+               !header->ready ? "not needed this build"
+                              : header->rebuilt ? "precompiled" : "up to date");
+    }
+    printf("\n");
+
+    config->pch = set;
+    return set;
+}
+
+static void close_precompiled_headers(PchSet *set, BuildConfig *config) {
+    if (config->pch == set) config->pch = NULL;
+    pch_set_destroy(set);
+}
+
+/**
+ * Group the sources into unity sources, if the configuration asks
+ *
+ * Sets config->unity, so the chain compiles each group as one event.
+ */
+static UnityBuild *open_unity_build(DependencyGraph *graph, BuildConfig *config,
+                                    BuildCache *cache) {
+    if (config->unity_size < 2) return NULL;
+
+    UnityBuild *unity = unity_build_plan(graph, config, (size_t)config->unity_size, cache);
+    if (!unity) {
+        printf("Warning: Failed to plan the unity build, compiling sources alone\n\n");
+        return NULL;
+    }
+
+    printf("Unity build: %zu of %zu sources in %zu unity sources of up to %d\n",
+           unity->grouped_count, unity->candidate_count, unity->group_count,
+           config->unity_size);
+    for (size_t i = 0; i < unity->hot_count; i++) {
+        printf("  Compiled alone, changed often: %s\n", unity->hot[i]);
+    }
+    for (size_t i = 0; i < unity->apart_count; i++) {
+        printf("  Compiled alone, failed in a unity source: %s\n", unity->apart[i]);
+    }
+    printf("\n");
+
+    config->unity = unity;
+    return unity;
+}
+
+static void close_unity_build(UnityBuild *unity, BuildConfig *config) {
+    if (config->unity == unity) config->unity = NULL;
+    unity_build_destroy(unity);
+}
+
+void build_project_dir(const BuildConfig *config, char *project_dir, size_t size) {
+    if (!project_dir || size == 0) return;
+    project_dir[0] = '\0';
+    if (!config || !config->output_dir) return;
 
     /* Get project directory - go up one level from output_dir if it's a subdir */
-    char project_dir[MAX_PATH_LENGTH];
-    strncpy(project_dir, config->output_dir, MAX_PATH_LENGTH - 1);
-    project_dir[MAX_PATH_LENGTH - 1] = '\0';
+    strncpy(project_dir, config->output_dir, size - 1);
+    project_dir[size - 1] = '\0';
 
     /* Remove trailing slash if present */
     size_t len = strlen(project_dir);
@@ -317,29 +971,57 @@ int eventchains_build_project(
     if (last_slash) {
         *last_slash = '\0'; /* Truncate to get parent directory */
     }
+}
+
+int eventchains_build_project(
+    DependencyGraph *graph,
+    BuildConfig *config,
+    BuildStatistics *stats
+) {
+    if (!graph || !config) return 1;
 
+    /* Create/load persistent cache in PROJECT directory (not build directory!) */
+    char project_dir[MAX_PATH_LENGTH];
+    build_project_dir(config, project_dir, sizeof(project_dir));
     BuildCache *cache = build_cache_create(project_dir);
-    if (!cache) {
-        printf("Warning: Failed to create cache, proceeding without caching\n\n");
-    } else {
-        printf("Cache directory: %s\n", cache->cache_dir);
-        printf("Cache loaded: %zu entries\n\n", cache->entry_count);
+
+    int result = eventchains_build_project_with_cache(graph, config, cache, stats);
+
+    if (cache) {
+        build_cache_destroy(cache);
     }
+    return result;
+}
 
+/**
+ * Create the compilation chain, attach the middleware and run it
+ *
+ * @return  The executed chain (result says how it went), or NULL if no
+ *          chain could be built
+ */
+static EventChain *run_compilation_chain(DependencyGraph *graph, BuildConfig *config,
+                                         BuildCache *cache, BuildStatistics *stats,
+                                         ObjectStore *store, DistPool *pool,
+                                         ChainResult *result) {
     /* Build the compilation chain */
     printf("Phase 1: Creating Event Chain\n");
     printf("----------------------------------------------------------------\n");
 
     EventChain *chain = build_compilation_chain(graph, config);
-    if (!chain) {
-        if (cache) build_cache_destroy(cache);
-        return 1;
-    }
+    if (!chain) return NULL;
 
     printf("Created chain with %zu compilation events\n\n", chain->event_count);
 
+    if (config->parallel_jobs > 1) {
+        schedule_compiles(chain, cache, config);
+    }
+
     /* Store dependency graph in context for middleware */
     event_context_set(chain->context, "dependency_graph", graph);
+    if (store) {
+        event_context_set(chain->context, "object_store", store);
+        prefetch_objects(store, cache, graph, chain);
+    }
 
     /* Add middleware */
     printf("Phase 2: Attaching Middleware\n");
@@ -386,24 +1068,140 @@ int eventchains_build_project(
         }
     }
 
+    /* Distributed compilation (attached after everything, so it sits
+     * innermost, in place of the local compiler, and the cache and
+     * statistics see its results) */
+    if (pool) {
+        EventMiddleware *dist_mw = create_distributed_middleware(pool);
+        if (dist_mw) {
+            event_chain_use_middleware(chain, dist_mw);
+            printf("Attached: Distributed Middleware\n");
+        }
+    }
+
     printf("\n");
 
     /* Execute the chain */
     printf("Phase 3: Executing Build Chain\n");
     printf("----------------------------------------------------------------\n");
 
-    clock_t start_time = clock();
+    double start_time = build_clock_seconds();
+    uint64_t trace_start = build_trace_begin();
 
-    ChainResult result;
-    event_chain_execute(chain, &result);
+    if (config->parallel_jobs > 1) {
+        printf("Dispatching to %d parallel jobs\n", config->parallel_jobs);
+        event_chain_execute_parallel(chain, (size_t)config->parallel_jobs, result);
+    } else {
+        event_chain_execute(chain, result);
+    }
+
+    build_trace_end(trace_start, "build", "execute chain", NULL);
+    double end_time = build_clock_seconds();
+
+    if (stats) {
+        stats->total_time = end_time - start_time;
+    }
+
+    printf("\n");
+
+    return chain;
+}
+
+/**
+ * Split the unity sources among a failed build's failures
+ *
+ * @return  Number of unity sources split; their members compile alone
+ *          once the unity build is planned again
+ */
+static size_t split_failed_unity_sources(UnityBuild *unity, const ChainResult *result) {
+    size_t split = 0;
+    for (size_t i = 0; unity && i < result->failure_count; i++) {
+        const FailureInfo *failure = &((const FailureInfo *)result->failures)[i];
+        const char *name = failure->event_name;
+        if (strncmp(name, "Compile:", 8) != 0) continue;
+
+        size_t members = unity_build_split(unity, name + 8);
+        if (members > 0) {
+            printf("Unity source %s failed; compiling its %zu sources alone\n",
+                   name + 8, members);
+            split++;
+        }
+    }
+    return split;
+}
 
-    clock_t end_time = clock();
+int eventchains_build_project_with_cache(
+    DependencyGraph *graph,
+    BuildConfig *config,
+    BuildCache *cache,
+    BuildStatistics *stats
+) {
+    if (!graph || !config) return 1;
 
+    /* Initialize statistics */
     if (stats) {
-        stats->total_time = (double)(end_time - start_time) / CLOCKS_PER_SEC;
+        memset(stats, 0, sizeof(BuildStatistics));
+        stats->total_files = graph->file_count;
     }
 
     printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|        EventChains Build System - Building with Events        |\n");
+    printf("|----------------------------------------------------------------|\n\n");
+
+    /* Create output directory */
+    printf("Creating output directory: %s\n", config->output_dir);
+    mkdir(config->output_dir, 0755);
+
+    printf("\nPhase 0: Cache Initialization\n");
+    printf("----------------------------------------------------------------\n");
+
+    if (!cache) {
+        printf("Warning: Failed to create cache, proceeding without caching\n\n");
+    } else {
+        /* A cache kept from an earlier build has seen these files before
+         * they last changed */
+        build_cache_reset_hash_memo(cache);
+        build_cache_set_check_mode(cache, config->always_hash ? CACHE_CHECK_CONTENT
+                                                              : CACHE_CHECK_STAT);
+        printf("Cache directory: %s\n", cache->cache_dir);
+        printf("Cache loaded: %zu entries\n", cache->entry_count);
+        printf("Change detection: %s\n\n",
+               config->always_hash ? "content hash" : "stat, then content hash");
+    }
+
+    PchSet *pch = open_precompiled_headers(graph, config, cache);
+    UnityBuild *unity = open_unity_build(graph, config, cache);
+    ObjectStore *store = open_object_store(config, cache);
+    DistPool *pool = open_dist_pool(config);
+
+    ChainResult result;
+    EventChain *chain = run_compilation_chain(graph, config, cache, stats, store, pool, &result);
+
+    /* Members of a unity source may fail only together, such as two
+     * defining the same static function: retry them one by one, and fail
+     * the build only if that fails too */
+    while (chain && !result.success && split_failed_unity_sources(unity, &result) > 0) {
+        printf("\n");
+        chain_result_destroy(&result);
+        event_chain_destroy(chain);
+        close_unity_build(unity, config);
+        if (stats) {
+            memset(stats, 0, sizeof(BuildStatistics));
+            stats->total_files = graph->file_count;
+        }
+
+        unity = open_unity_build(graph, config, cache);
+        chain = run_compilation_chain(graph, config, cache, stats, store, pool, &result);
+    }
+
+    if (!chain) {
+        close_object_store(store);
+        close_dist_pool(pool);
+        close_precompiled_headers(pch, config);
+        close_unity_build(unity, config);
+        return 1;
+    }
 
     /* Check results */
     if (!result.success) {
@@ -419,18 +1217,25 @@ int eventchains_build_project(
         event_chain_destroy(chain);
         if (cache) {
             build_cache_save(cache);
-            build_cache_destroy(cache);
         }
+        close_object_store(store);
+        close_dist_pool(pool);
+        close_precompiled_headers(pch, config);
+        close_unity_build(unity, config);
         return 1;
     }
 
     printf("All compilation events succeeded\n\n");
 
-    /* Save cache after successful compilation */
+    /* Save cache after successful compilation; when files were added,
+     * deleted or renamed, without the entries of the ones that are gone */
     if (cache) {
+        size_t pruned = build_cache_prune_changed(cache, graph);
         printf("Saving cache...\n");
         if (build_cache_save(cache)) {
-            printf("Cache saved: %zu entries\n\n", cache->entry_count);
+            printf("Cache saved: %zu entries", cache->entry_count);
+            if (pruned > 0) printf(" (%zu stale dropped)", pruned);
+            printf("\n\n");
         } else {
             printf("Warning: Failed to save cache\n\n");
         }
@@ -440,46 +1245,20 @@ int eventchains_build_project(
     printf("Phase 4: Linking\n");
     printf("----------------------------------------------------------------\n");
 
-    /* Collect object files from events */
-    const char *object_files[1024];
-    size_t object_count = 0;
-
-    for (size_t i = 0; i < chain->event_count; i++) {
-        ChainableEvent *event = chain->events[i];
-        CompileEventData *data = (CompileEventData *)chainable_event_get_user_data(event);
-
-        if (data && data->object_path[0] != '\0' && !data->source->is_header) {
-            object_files[object_count++] = data->object_path;
-        }
-    }
-
-    /* Link executable */
-    CompileResult link_result;
-    bool link_success = link_executable(
-        object_files,
-        object_count,
-        config,
-        &link_result
-    );
-
-    if (!link_success) {
+    uint64_t trace_start = build_trace_begin();
+    bool linked = link_project(chain, config, stats);
+    build_trace_end(trace_start, "build", "link phase", NULL);
+    if (!linked) {
         fprintf(stderr, "Linking failed\n");
-        if (link_result.error_output) {
-            fprintf(stderr, "%s\n", link_result.error_output);
-        }
-        compile_result_destroy(&link_result);
         chain_result_destroy(&result);
         event_chain_destroy(chain);
-        if (cache) build_cache_destroy(cache);
+        close_object_store(store);
+        close_dist_pool(pool);
+        close_precompiled_headers(pch, config);
+        close_unity_build(unity, config);
         return 1;
     }
 
-    printf("Linked: %s\n\n", link_result.object_file);
-
-    if (stats) {
-        stats->link_time = link_result.compile_time;
-    }
-
     /* Success! */
     printf("|----------------------------------------------------------------|\n");
     printf("|                      Build Complete!                           |\n");
@@ -493,15 +1272,14 @@ int eventchains_build_project(
     if (cache) {
         build_cache_print_stats(cache);
     }
+    close_object_store(store);
+    close_dist_pool(pool);
+    close_precompiled_headers(pch, config);
+    close_unity_build(unity, config);
 
-    compile_result_destroy(&link_result);
     chain_result_destroy(&result);
     event_chain_destroy(chain);
 
-    if (cache) {
-        build_cache_destroy(cache);
-    }
-
     return 0;
 }
 
@@ -27,6 +27,9 @@ extern "C" {
 /* Forward declaration for cache */
 typedef struct BuildCache BuildCache;
 
+/* Forward declaration for distributed compilation (see distributed_compile.h) */
+struct DistPool;
+
 /* ==============================================================================
  * Event Data Structures
  * ==============================================================================
@@ -41,6 +44,7 @@ typedef struct CompileEventData {
     char object_path[MAX_PATH_LENGTH]; /* Path to output object file */
     bool cache_hit;                    /* Whether compilation was skipped (cached) */
     double compile_time;               /* Time taken to compile (seconds) */
+    uint64_t peak_memory;              /* Compiler's peak RSS in bytes, 0 if unknown */
 } CompileEventData;
 
 /**
@@ -98,6 +102,13 @@ ChainableEvent *create_link_event(const BuildConfig *config);
  */
 EventResult compile_event_execute(EventContext *context, void *user_data);
 
+/**
+ * Compilation data of an event, if it is a compilation event
+ * @param event  Event to inspect
+ * @return       The event's CompileEventData, or NULL for any other event
+ */
+CompileEventData *compile_event_data(const ChainableEvent *event);
+
 /**
  * Event execution function for linking
  * @param context    Event context
@@ -189,10 +200,27 @@ EventMiddleware *create_logging_middleware(bool quiet);
  * - Tracks total time spent in each phase
  * - Stores statistics in BuildStatistics structure
  *
+ * Parallel workers count into their own slots; the totals are added to
+ * the BuildStatistics when the chain finishes executing.
+ *
  * @param stats  Pointer to BuildStatistics to populate
  */
 EventMiddleware *create_statistics_middleware(BuildStatistics *stats);
 
+/**
+ * Distributed Middleware - Compiles out-of-date sources on remote workers
+ *
+ * This middleware:
+ * - Preprocesses locally and ships the unit to the least busy worker
+ * - Places the returned object, as a local compile would
+ * - Passes the event on to the local compiler when anything goes wrong
+ *
+ * Attach it last, so caching and statistics wrap it.
+ *
+ * @param pool  Pointer to DistPool (owned by the caller)
+ */
+EventMiddleware *create_distributed_middleware(struct DistPool *pool);
+
 /* ==============================================================================
  * High-Level Build API
  * ==============================================================================
@@ -218,6 +246,35 @@ int eventchains_build_project(
     BuildStatistics *stats
 );
 
+/**
+ * Build a project with a cache kept between builds
+ *
+ * Same as eventchains_build_project, except the cache is the caller's: it
+ * is saved after the build but stays open, so the next build in this
+ * process starts from it rather than from disk (ecbuild --watch).
+ *
+ * @param graph    Dependency graph with all source files
+ * @param config   Build configuration
+ * @param cache    Cache opened in build_project_dir (NULL to build without one)
+ * @param stats    Pointer to store build statistics (can be NULL)
+ * @return         0 on success, non-zero on error
+ */
+int eventchains_build_project_with_cache(
+    DependencyGraph *graph,
+    BuildConfig *config,
+    BuildCache *cache,
+    BuildStatistics *stats
+);
+
+/**
+ * Directory whose cache a build uses: the parent of the output directory
+ *
+ * @param config       Build configuration
+ * @param project_dir  Destination buffer
+ * @param size         Size of destination buffer
+ */
+void build_project_dir(const BuildConfig *config, char *project_dir, size_t size);
+
 /**
  * Print build statistics in a formatted report
  * @param stats  Build statistics to print
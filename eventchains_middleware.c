@@ -5,6 +5,10 @@
  */
 
 #include "eventchains_build.h"
+#include "depfile.h"
+#include "object_store.h"
+#include "distributed_compile.h"
+#include "build_trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -34,27 +38,21 @@ static void timing_middleware_execute(
         printf("  [TIMING] Starting: %s\n", event_name);
     }
 
-    clock_t start = clock();
+    double start = build_clock_seconds();
 
     /* Call next layer */
     next(result_ptr, event, context, next_data);
 
-    clock_t end = clock();
-    double elapsed = (double)(end - start) / CLOCKS_PER_SEC;
+    double elapsed = build_clock_seconds() - start;
 
     if (data->verbose) {
         printf("  [TIMING] Completed: %s (%.3f seconds)\n", event_name, elapsed);
     }
 
     /* Store timing in event data if it's a compile event */
-    void *event_data = chainable_event_get_user_data(event);
-    if (event_data) {
-        /* Try to detect if this is CompileEventData */
-        CompileEventData *compile_data = (CompileEventData *)event_data;
-        /* This is a simple heuristic - in production, you'd want better type safety */
-        if (compile_data->source != NULL) {
-            compile_data->compile_time = elapsed;
-        }
+    CompileEventData *compile_data = compile_event_data(event);
+    if (compile_data) {
+        compile_data->compile_time = elapsed;
     }
 }
 
@@ -83,6 +81,48 @@ EventMiddleware *create_timing_middleware(bool verbose) {
  * ==============================================================================
  */
 
+/**
+ * Record a compiled source with the dependencies from its depfile
+ */
+static bool update_cache_from_depfile(
+    BuildCache *cache,
+    const CompileEventData *compile_data,
+    const DependencyGraph *graph
+) {
+    if (!compile_data->config->use_depfiles) return false;
+
+    char depfile[MAX_PATH_LENGTH];
+    if (!depfile_path_for_object(compile_data->object_path, depfile, sizeof(depfile))) {
+        return false;
+    }
+
+    DepfileList deps;
+    depfile_list_init(&deps);
+    if (!depfile_parse(depfile, &deps)) {
+        depfile_list_destroy(&deps);
+        return false;
+    }
+
+    /* Use the graph's spelling of each path so lookups by path agree */
+    for (size_t i = 0; i < deps.count; i++) {
+        char canonical[MAX_PATH_LENGTH];
+        depfile_canonical_path(graph, deps.paths[i], canonical, sizeof(canonical));
+        if (strcmp(canonical, deps.paths[i]) != 0) {
+            char *copy = strdup(canonical);
+            if (copy) {
+                free(deps.paths[i]);
+                deps.paths[i] = copy;
+            }
+        }
+    }
+
+    build_cache_update_dependencies(cache, compile_data->source->path,
+                                    compile_data->object_path,
+                                    (const char *const *)deps.paths, deps.count);
+    depfile_list_destroy(&deps);
+    return true;
+}
+
 static void cache_middleware_execute(
     EventResult *result_ptr,
     ChainableEvent *event,
@@ -93,17 +133,8 @@ static void cache_middleware_execute(
 ) {
     BuildCache *cache = (BuildCache *)user_data;
 
-    /* Get event data */
-    void *event_data = chainable_event_get_user_data(event);
-    if (!event_data) {
-        /* Not a compile event, just pass through */
-        next(result_ptr, event, context, next_data);
-        return;
-    }
-
-    /* Check if this is a compile event */
-    CompileEventData *compile_data = (CompileEventData *)event_data;
-    if (!compile_data->source) {
+    CompileEventData *compile_data = compile_event_data(event);
+    if (!compile_data || !compile_data->source) {
         /* Not a compile event, pass through */
         next(result_ptr, event, context, next_data);
         return;
@@ -118,8 +149,11 @@ static void cache_middleware_execute(
 
     /* Check cache using persistent metadata */
     bool skip_compilation = false;
-    if (cache && !build_cache_needs_recompilation(cache, compile_data->source,
-                                                   compile_data->object_path)) {
+    uint64_t trace_start = build_trace_begin();
+    bool needs_recompilation = !cache ||
+        build_cache_needs_recompilation(cache, compile_data->source, compile_data->object_path);
+    build_trace_end(trace_start, "cache", "cache check", compile_data->source->path);
+    if (!needs_recompilation) {
         /* Cache says source is unchanged, but we MUST verify .o file exists
          * Otherwise linking will fail! */
         bool object_exists = file_exists_cache(compile_data->object_path);
@@ -148,23 +182,69 @@ static void cache_middleware_execute(
     }
 
     if (!skip_compilation) {
-        /* Cache MISS or .o missing - proceed with compilation */
+        /* Cache MISS or .o missing - try the shared store, then compile */
         compile_data->cache_hit = false;
-        next(result_ptr, event, context, next_data);
+
+        DependencyGraph *graph = NULL;
+        event_context_get(context, "dependency_graph", (void **)&graph);
+
+        ObjectStore *store = NULL;
+        event_context_get(context, "object_store", (void **)&store);
+
+        char store_key[OBJECT_KEY_LENGTH + 1];
+        bool keyed = store && object_store_key_for_source(store, cache, graph,
+                                                          compile_data->source, store_key);
+        bool fetched = keyed && object_store_fetch(store, store_key,
+                                                   compile_data->object_path);
+
+        if (fetched) {
+            /* Built before, in this checkout or another one */
+            compile_data->cache_hit = true;
+            compile_data->compile_time = 0.0;
+
+            char key[512];
+            snprintf(key, sizeof(key), "object:%s", compile_data->source->path);
+            event_context_set(context, key, strdup(compile_data->object_path));
+            event_result_success(result_ptr);
+        } else {
+            /* The old object may be a hard link into the store; the
+             * compiler must write a new file rather than overwrite it.
+             * Removing it also keeps the compile step's own mtime check
+             * from skipping a source whose header changed. */
+            remove(compile_data->object_path);
+            next(result_ptr, event, context, next_data);
+
+            if (keyed && result_ptr->success) {
+                object_store_insert(store, store_key, compile_data->object_path);
+            }
+        }
 
         /* Update cache after successful compilation */
         if (cache && result_ptr->success) {
-            /* Get dependency graph from context */
-            DependencyGraph *graph = NULL;
-            event_context_get(context, "dependency_graph", (void **)&graph);
-
-            /* Update cache metadata */
-            build_cache_update(
-                cache,
-                compile_data->source->path,
-                compile_data->object_path,
-                graph
-            );
+            /* Prefer the exact list the compiler wrote, if it wrote one; a
+             * fetched object comes without a fresh depfile */
+            if (fetched || !update_cache_from_depfile(cache, compile_data, graph)) {
+                if (compile_data->source->generated) {
+                    /* A unity source's includes are sources; what they
+                     * include must count too */
+                    build_cache_update_closure(cache, compile_data->source->path,
+                                               compile_data->object_path, graph);
+                } else {
+                    build_cache_update(
+                        cache,
+                        compile_data->source->path,
+                        compile_data->object_path,
+                        graph
+                    );
+                }
+            }
+
+            /* How long it took, for scheduling the next build */
+            if (!fetched) {
+                build_cache_record_compile(cache, compile_data->source->path,
+                                           compile_data->compile_time,
+                                           compile_data->peak_memory);
+            }
         }
     }
 }
@@ -211,17 +291,8 @@ static void logging_middleware_execute(
     LoggingMiddlewareData *data = (LoggingMiddlewareData *)user_data;
     const char *event_name = chainable_event_get_name(event);
 
-    /* Get event data to determine type */
-    void *event_data = chainable_event_get_user_data(event);
-    CompileEventData *compile_data = NULL;
-    bool is_compile_event = false;
-
-    if (event_data) {
-        compile_data = (CompileEventData *)event_data;
-        if (compile_data->source != NULL) {
-            is_compile_event = true;
-        }
-    }
+    CompileEventData *compile_data = compile_event_data(event);
+    bool is_compile_event = compile_data && compile_data->source;
 
     /* Log start (if not quiet) */
     if (!data->quiet && is_compile_event) {
@@ -274,6 +345,61 @@ EventMiddleware *create_logging_middleware(bool quiet) {
  * ==============================================================================
  */
 
+/**
+ * StatisticsSlot - One worker's share of the counts
+ *
+ * Padded to a cache line so workers counting side by side do not keep
+ * stealing the line from each other.
+ */
+typedef union StatisticsSlot {
+    struct {
+        size_t compiled_files;
+        size_t cached_files;
+        size_t failed_files;
+        double compilation_time;
+    } counts;
+    char padding[64];
+} StatisticsSlot;
+
+typedef struct StatisticsMiddlewareData {
+    BuildStatistics *stats;
+    StatisticsSlot *slots;      /* One per worker during a batch, else NULL */
+    size_t slot_count;
+    bool in_batch;
+} StatisticsMiddlewareData;
+
+static void statistics_add(BuildStatistics *stats, const StatisticsSlot *slot) {
+    stats->compiled_files += slot->counts.compiled_files;
+    stats->cached_files += slot->counts.cached_files;
+    stats->failed_files += slot->counts.failed_files;
+    stats->compilation_time += slot->counts.compilation_time;
+}
+
+static void statistics_before_batch(const EventBatch *batch, void *user_data) {
+    StatisticsMiddlewareData *data = (StatisticsMiddlewareData *)user_data;
+
+    data->in_batch = true;
+    data->slots = calloc(batch->worker_count, sizeof(StatisticsSlot));
+    data->slot_count = data->slots ? batch->worker_count : 0;
+    if (!data->slots) {
+        printf("Warning: Out of memory; build statistics will be incomplete\n");
+    }
+}
+
+static void statistics_after_batch(const EventBatch *batch, void *user_data) {
+    StatisticsMiddlewareData *data = (StatisticsMiddlewareData *)user_data;
+    (void)batch;
+
+    for (size_t i = 0; i < data->slot_count; i++) {
+        statistics_add(data->stats, &data->slots[i]);
+    }
+
+    free(data->slots);
+    data->slots = NULL;
+    data->slot_count = 0;
+    data->in_batch = false;
+}
+
 static void statistics_middleware_execute(
     EventResult *result_ptr,
     ChainableEvent *event,
@@ -282,52 +408,132 @@ static void statistics_middleware_execute(
     void *next_data,
     void *user_data
 ) {
-    BuildStatistics *stats = (BuildStatistics *)user_data;
-    if (!stats) {
+    StatisticsMiddlewareData *data = (StatisticsMiddlewareData *)user_data;
+    CompileEventData *compile_data = compile_event_data(event);
+    if (!data || !data->stats || !compile_data || !compile_data->source) {
         next(result_ptr, event, context, next_data);
         return;
     }
 
-    /* Get event data */
-    void *event_data = chainable_event_get_user_data(event);
-    CompileEventData *compile_data = NULL;
-    bool is_compile_event = false;
+    /* Execute next layer */
+    double start = build_clock_seconds();
+    next(result_ptr, event, context, next_data);
 
-    if (event_data) {
-        compile_data = (CompileEventData *)event_data;
-        if (compile_data->source != NULL) {
-            is_compile_event = true;
-        }
+    double elapsed = build_clock_seconds() - start;
+
+    /* Each worker owns its slot, so no lock; an event run outside any
+     * batch has the statistics to itself */
+    StatisticsSlot single;
+    StatisticsSlot *slot = &single;
+    if (data->in_batch) {
+        size_t worker = event_chain_worker_index();
+        if (worker >= data->slot_count) return;
+        slot = &data->slots[worker];
+    } else {
+        memset(&single, 0, sizeof(single));
     }
 
-    /* Execute next layer */
-    clock_t start = clock();
-    next(result_ptr, event, context, next_data);
-    clock_t end = clock();
-
-    double elapsed = (double)(end - start) / CLOCKS_PER_SEC;
-
-    /* Update statistics */
-    if (is_compile_event) {
-        if (result_ptr->success) {
-            if (compile_data->cache_hit) {
-                stats->cached_files++;
-            } else {
-                stats->compiled_files++;
-                stats->compilation_time += elapsed;
-            }
+    if (result_ptr->success) {
+        if (compile_data->cache_hit) {
+            slot->counts.cached_files++;
         } else {
-            stats->failed_files++;
+            slot->counts.compiled_files++;
+            slot->counts.compilation_time += elapsed;
         }
+    } else {
+        slot->counts.failed_files++;
+    }
+
+    if (!data->in_batch) {
+        statistics_add(data->stats, &single);
     }
 }
 
 EventMiddleware *create_statistics_middleware(BuildStatistics *stats) {
+    StatisticsMiddlewareData *data = malloc(sizeof(StatisticsMiddlewareData));
+    if (!data) return NULL;
+
+    data->stats = stats;
+    data->slots = NULL;
+    data->slot_count = 0;
+    data->in_batch = false;
+
     EventMiddleware *middleware = event_middleware_create(
         statistics_middleware_execute,
-        stats,
+        data,
         "StatisticsMiddleware"
     );
 
+    if (!middleware) {
+        free(data);
+        return NULL;
+    }
+
+    if (stats) {
+        event_middleware_set_batch_hooks(middleware, statistics_before_batch,
+                                         statistics_after_batch);
+    }
+
     return middleware;
-}
\ No newline at end of file
+}
+
+/* ==============================================================================
+ * Distributed Compilation Middleware
+ * ==============================================================================
+ */
+
+static void distributed_middleware_execute(
+    EventResult *result_ptr,
+    ChainableEvent *event,
+    EventContext *context,
+    void (*next)(EventResult *, ChainableEvent *, EventContext *, void *),
+    void *next_data,
+    void *user_data
+) {
+    DistPool *pool = (DistPool *)user_data;
+    CompileEventData *compile_data = compile_event_data(event);
+
+    /* Only out-of-date sources go out; everything else takes the local path */
+    char object_path[MAX_PATH_LENGTH];
+    if (!pool || !compile_data || !compile_data->source || compile_data->source->is_header ||
+        !get_object_file_path(compile_data->source->path, compile_data->config->output_dir,
+                              object_path, sizeof(object_path)) ||
+        !needs_recompilation(compile_data->source->path, object_path)) {
+        next(result_ptr, event, context, next_data);
+        return;
+    }
+
+    CompileResult compile_result;
+    if (!dist_compile_source(pool, compile_data->source, compile_data->config,
+                             object_path, &compile_result)) {
+        /* Remote failures of any kind fall back to the local compiler */
+        next(result_ptr, event, context, next_data);
+        return;
+    }
+
+    /* Same bookkeeping as compile_event_execute; the worker's memory is
+     * not this machine's */
+    compile_data->compile_time = compile_result.compile_time;
+    compile_data->peak_memory = 0;
+    compile_data->cache_hit = false;
+    strncpy(compile_data->object_path, object_path, MAX_PATH_LENGTH - 1);
+    compile_data->object_path[MAX_PATH_LENGTH - 1] = '\0';
+
+    char key[512];
+    snprintf(key, sizeof(key), "object:%s", compile_data->source->path);
+    event_context_set(context, key, strdup(compile_data->object_path));
+
+    compile_result_destroy(&compile_result);
+    event_result_success(result_ptr);
+}
+
+EventMiddleware *create_distributed_middleware(DistPool *pool) {
+    /* The pool is owned by the caller */
+    EventMiddleware *middleware = event_middleware_create(
+        distributed_middleware_execute,
+        pool,
+        "DistributedMiddleware"
+    );
+
+    return middleware;
+}
@@ -0,0 +1,716 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Source Tree Watching Implementation
+ * ==============================================================================
+ */
+
+/* d_type and the DT_* constants of <dirent.h> */
+#define _DEFAULT_SOURCE
+
+#include "file_watch.h"
+#include "dependency_resolver.h"
+#include "cache_metadata.h"
+#include "build_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <errno.h>
+    #include <poll.h>
+    #include <time.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #ifdef __linux__
+        #include <sys/inotify.h>
+    #endif
+#endif
+
+/* ==============================================================================
+ * Change Lists
+ * ==============================================================================
+ */
+
+void file_change_list_init(FileChangeList *list) {
+    if (!list) return;
+    list->changes = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    list->rescan = false;
+}
+
+void file_change_list_destroy(FileChangeList *list) {
+    if (!list) return;
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->changes[i].path);
+    }
+    free(list->changes);
+    file_change_list_init(list);
+}
+
+bool file_change_list_add(FileChangeList *list, const char *path, FileChangeKind kind) {
+    if (!list || !path) return false;
+
+    for (size_t i = 0; i < list->count; i++) {
+        FileChange *change = &list->changes[i];
+        if (strcmp(change->path, path) != 0) continue;
+
+        if (change->kind == FILE_CHANGE_ADDED && kind == FILE_CHANGE_REMOVED) {
+            /* Came and went within the burst (an editor's scratch file) */
+            free(change->path);
+            list->changes[i] = list->changes[--list->count];
+        } else if (change->kind == FILE_CHANGE_REMOVED && kind == FILE_CHANGE_ADDED) {
+            /* Replaced, as editors save by renaming over the old file */
+            change->kind = FILE_CHANGE_MODIFIED;
+        } else if (change->kind != FILE_CHANGE_ADDED) {
+            change->kind = kind;
+        }
+        return true;
+    }
+
+    if (list->count >= list->capacity) {
+        size_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        FileChange *changes = realloc(list->changes, capacity * sizeof(FileChange));
+        if (!changes) return false;
+        list->changes = changes;
+        list->capacity = capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy) return false;
+    list->changes[list->count].path = copy;
+    list->changes[list->count].kind = kind;
+    list->count++;
+    return true;
+}
+
+/* ==============================================================================
+ * Watcher State
+ * ==============================================================================
+ */
+
+/**
+ * PolledFile - A source seen by the last poll
+ */
+typedef struct PolledFile {
+    char *path;
+    FileStamp stamp;
+} PolledFile;
+
+/**
+ * WatchedDirectory - An inotify watch and the directory it covers
+ */
+typedef struct WatchedDirectory {
+    int wd;
+    char *path;
+} WatchedDirectory;
+
+struct FileWatch {
+    char *root;
+    char **exclude_dirs;
+    size_t exclude_count;
+    bool polling;
+
+    /* Polling: the tree as last seen, sorted by path */
+    PolledFile *files;
+    size_t file_count;
+    size_t file_capacity;
+
+#ifdef _WIN32
+    HANDLE directory;
+    OVERLAPPED overlapped;
+    bool read_pending;
+    DWORD buffer[16384];                    /* FILE_NOTIFY_INFORMATION records */
+#elif defined(__linux__)
+    int inotify_fd;                         /* -1 when polling */
+    WatchedDirectory *dirs;
+    size_t dir_count;
+    size_t dir_capacity;
+#endif
+};
+
+static bool watch_excludes(const FileWatch *watch, const char *name) {
+    return dependency_is_excluded_directory(name, (const char **)watch->exclude_dirs,
+                                            watch->exclude_count);
+}
+
+/* ==============================================================================
+ * Polling
+ * ==============================================================================
+ */
+
+#ifndef _WIN32
+
+static void sleep_ms(long ms) {
+    struct timespec delay;
+    delay.tv_sec = ms / 1000;
+    delay.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&delay, NULL);
+}
+
+typedef bool (*WalkVisitFunc)(FileWatch *watch, const char *path, void *ctx);
+
+/**
+ * Visit every directory (root included) and source under root that the
+ * scanner would visit, spelling paths the way it does
+ */
+static bool watch_walk(FileWatch *watch, const char *directory,
+                       WalkVisitFunc on_directory, WalkVisitFunc on_file, void *ctx) {
+    if (on_directory && !on_directory(watch, directory, ctx)) return false;
+
+    DIR *dir = opendir(directory);
+    if (!dir) return true;  /* Vanished meanwhile */
+
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char full_path[MAX_PATH_LENGTH];
+        snprintf(full_path, sizeof(full_path), "%s/%s", directory, entry->d_name);
+
+        bool is_dir = false;
+        bool is_reg = false;
+#if defined(DT_DIR) && defined(DT_REG) && defined(DT_UNKNOWN) && defined(DT_LNK)
+        if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+            is_dir = entry->d_type == DT_DIR;
+            is_reg = entry->d_type == DT_REG;
+        } else
+#endif
+        {
+            struct stat st;
+            if (stat(full_path, &st) != 0) continue;
+            is_dir = S_ISDIR(st.st_mode);
+            is_reg = S_ISREG(st.st_mode);
+        }
+
+        if (is_dir) {
+            if (!watch_excludes(watch, entry->d_name)) {
+                ok = watch_walk(watch, full_path, on_directory, on_file, ctx);
+            }
+        } else if (is_reg && on_file && dependency_is_source_path(full_path)) {
+            ok = on_file(watch, full_path, ctx);
+        }
+    }
+
+    closedir(dir);
+    return ok;
+}
+
+typedef struct PollSnapshot {
+    PolledFile *files;
+    size_t count;
+    size_t capacity;
+} PollSnapshot;
+
+static bool snapshot_add(FileWatch *watch, const char *path, void *ctx) {
+    (void)watch;
+    PollSnapshot *snapshot = (PollSnapshot *)ctx;
+
+    PolledFile file;
+    if (!file_stamp_get(path, &file.stamp)) return true;
+
+    if (snapshot->count >= snapshot->capacity) {
+        size_t capacity = snapshot->capacity == 0 ? 256 : snapshot->capacity * 2;
+        PolledFile *files = realloc(snapshot->files, capacity * sizeof(PolledFile));
+        if (!files) return false;
+        snapshot->files = files;
+        snapshot->capacity = capacity;
+    }
+
+    file.path = strdup(path);
+    if (!file.path) return false;
+    snapshot->files[snapshot->count++] = file;
+    return true;
+}
+
+static int compare_polled_files(const void *a, const void *b) {
+    return strcmp(((const PolledFile *)a)->path, ((const PolledFile *)b)->path);
+}
+
+static void free_polled_files(PolledFile *files, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(files[i].path);
+    }
+    free(files);
+}
+
+static bool poll_snapshot(FileWatch *watch, PollSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    if (!watch_walk(watch, watch->root, NULL, snapshot_add, snapshot)) {
+        free_polled_files(snapshot->files, snapshot->count);
+        return false;
+    }
+    qsort(snapshot->files, snapshot->count, sizeof(PolledFile), compare_polled_files);
+    return true;
+}
+
+/**
+ * Take a fresh snapshot and report how it differs from the last one
+ *
+ * @return  Number of changes recorded, or -1 on error
+ */
+static int poll_changes(FileWatch *watch, FileChangeList *changes) {
+    PollSnapshot now;
+    if (!poll_snapshot(watch, &now)) return -1;
+
+    /* Both lists are sorted, so one merge pass finds every difference */
+    int found = 0;
+    size_t i = 0, j = 0;
+    bool ok = true;
+    while (ok && (i < watch->file_count || j < now.count)) {
+        int order = i >= watch->file_count ? 1 :
+                    j >= now.count ? -1 :
+                    strcmp(watch->files[i].path, now.files[j].path);
+        if (order < 0) {
+            ok = file_change_list_add(changes, watch->files[i++].path, FILE_CHANGE_REMOVED);
+            found++;
+        } else if (order > 0) {
+            ok = file_change_list_add(changes, now.files[j++].path, FILE_CHANGE_ADDED);
+            found++;
+        } else {
+            if (memcmp(&watch->files[i].stamp, &now.files[j].stamp, sizeof(FileStamp)) != 0) {
+                ok = file_change_list_add(changes, now.files[j].path, FILE_CHANGE_MODIFIED);
+                found++;
+            }
+            i++;
+            j++;
+        }
+    }
+
+    free_polled_files(watch->files, watch->file_count);
+    watch->files = now.files;
+    watch->file_count = now.count;
+    watch->file_capacity = now.capacity;
+    return ok ? found : -1;
+}
+
+static bool start_polling(FileWatch *watch) {
+    PollSnapshot snapshot;
+    if (!poll_snapshot(watch, &snapshot)) return false;
+
+    watch->files = snapshot.files;
+    watch->file_count = snapshot.count;
+    watch->file_capacity = snapshot.capacity;
+    watch->polling = true;
+    return true;
+}
+
+#endif /* !_WIN32 */
+
+/* ==============================================================================
+ * inotify (Linux)
+ * ==============================================================================
+ */
+
+#if defined(__linux__)
+
+#define INOTIFY_FILE_EVENTS (IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | \
+                             IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF)
+
+static bool inotify_watch_directory(FileWatch *watch, const char *path, void *ctx) {
+    (void)ctx;
+
+    int wd = inotify_add_watch(watch->inotify_fd, path, INOTIFY_FILE_EVENTS | IN_ONLYDIR);
+    if (wd < 0) {
+        /* Gone already is fine; out of watches is not */
+        return errno == ENOENT || errno == ENOTDIR || errno == EACCES;
+    }
+
+    /* The same directory reached twice keeps one entry */
+    for (size_t i = 0; i < watch->dir_count; i++) {
+        if (watch->dirs[i].wd == wd) {
+            char *copy = strdup(path);
+            if (!copy) return false;
+            free(watch->dirs[i].path);
+            watch->dirs[i].path = copy;
+            return true;
+        }
+    }
+
+    if (watch->dir_count >= watch->dir_capacity) {
+        size_t capacity = watch->dir_capacity == 0 ? 64 : watch->dir_capacity * 2;
+        WatchedDirectory *dirs = realloc(watch->dirs, capacity * sizeof(WatchedDirectory));
+        if (!dirs) return false;
+        watch->dirs = dirs;
+        watch->dir_capacity = capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy) return false;
+    watch->dirs[watch->dir_count].wd = wd;
+    watch->dirs[watch->dir_count].path = copy;
+    watch->dir_count++;
+    return true;
+}
+
+static void inotify_close(FileWatch *watch) {
+    for (size_t i = 0; i < watch->dir_count; i++) {
+        free(watch->dirs[i].path);
+    }
+    free(watch->dirs);
+    watch->dirs = NULL;
+    watch->dir_count = 0;
+    watch->dir_capacity = 0;
+    if (watch->inotify_fd >= 0) close(watch->inotify_fd);
+    watch->inotify_fd = -1;
+}
+
+static bool inotify_start(FileWatch *watch) {
+    watch->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->inotify_fd < 0) return false;
+
+    if (!watch_walk(watch, watch->root, inotify_watch_directory, NULL, NULL)) {
+        inotify_close(watch);
+        return false;
+    }
+    return true;
+}
+
+static WatchedDirectory *inotify_find(FileWatch *watch, int wd) {
+    for (size_t i = 0; i < watch->dir_count; i++) {
+        if (watch->dirs[i].wd == wd) return &watch->dirs[i];
+    }
+    return NULL;
+}
+
+static void inotify_forget(FileWatch *watch, int wd) {
+    WatchedDirectory *dir = inotify_find(watch, wd);
+    if (!dir) return;
+    free(dir->path);
+    *dir = watch->dirs[--watch->dir_count];
+}
+
+/**
+ * Wait up to wait_ms (-1 for ever) for events and record the relevant ones
+ *
+ * @return  Number of changes recorded, or -1 on error
+ */
+static int inotify_read(FileWatch *watch, long wait_ms, FileChangeList *changes) {
+    struct pollfd pfd;
+    pfd.fd = watch->inotify_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, wait_ms < 0 ? -1 : (int)wait_ms);
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+    if (ready == 0) return 0;
+
+    char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int found = 0;
+    for (;;) {
+        ssize_t length = read(watch->inotify_fd, buffer, sizeof(buffer));
+        if (length < 0) {
+            if (errno == EAGAIN || errno == EINTR) break;
+            return -1;
+        }
+        if (length == 0) break;
+
+        for (char *p = buffer; p < buffer + length; ) {
+            const struct inotify_event *event = (const struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                changes->rescan = true;
+                found++;
+                continue;
+            }
+            if (event->mask & (IN_IGNORED | IN_MOVE_SELF)) {
+                /* The directory itself went away or moved; its old path is stale */
+                if (event->mask & IN_MOVE_SELF) inotify_rm_watch(watch->inotify_fd, event->wd);
+                inotify_forget(watch, event->wd);
+                continue;
+            }
+
+            WatchedDirectory *dir = inotify_find(watch, event->wd);
+            if (!dir || event->len == 0) continue;
+
+            char path[MAX_PATH_LENGTH];
+            snprintf(path, sizeof(path), "%s/%s", dir->path, event->name);
+
+            if (event->mask & IN_ISDIR) {
+                if (watch_excludes(watch, event->name)) continue;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    /* Watch the new subtree before anything lands in it */
+                    if (!watch_walk(watch, path, inotify_watch_directory, NULL, NULL)) {
+                        return -1;
+                    }
+                }
+                /* Whatever sources it holds came or went with it */
+                changes->rescan = true;
+                found++;
+                continue;
+            }
+
+            if (!dependency_is_source_path(path)) continue;
+
+            FileChangeKind kind = FILE_CHANGE_MODIFIED;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) kind = FILE_CHANGE_ADDED;
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM)) kind = FILE_CHANGE_REMOVED;
+            if (!file_change_list_add(changes, path, kind)) return -1;
+            found++;
+        }
+    }
+
+    return found;
+}
+
+#endif /* __linux__ */
+
+/* ==============================================================================
+ * ReadDirectoryChangesW (Windows)
+ * ==============================================================================
+ */
+
+#ifdef _WIN32
+
+#define WINDOWS_NOTIFY_FILTER (FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | \
+                               FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE)
+
+static bool windows_issue_read(FileWatch *watch) {
+    ResetEvent(watch->overlapped.hEvent);
+    watch->read_pending = ReadDirectoryChangesW(watch->directory, watch->buffer,
+                                                sizeof(watch->buffer), TRUE,
+                                                WINDOWS_NOTIFY_FILTER, NULL,
+                                                &watch->overlapped, NULL) != 0;
+    return watch->read_pending;
+}
+
+static bool windows_start(FileWatch *watch) {
+    watch->directory = CreateFileA(watch->root, FILE_LIST_DIRECTORY,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   NULL, OPEN_EXISTING,
+                                   FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (watch->directory == INVALID_HANDLE_VALUE) return false;
+
+    memset(&watch->overlapped, 0, sizeof(watch->overlapped));
+    watch->overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!watch->overlapped.hEvent || !windows_issue_read(watch)) {
+        if (watch->overlapped.hEvent) CloseHandle(watch->overlapped.hEvent);
+        CloseHandle(watch->directory);
+        watch->overlapped.hEvent = NULL;
+        watch->directory = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    return true;
+}
+
+static void windows_close(FileWatch *watch) {
+    if (watch->directory == INVALID_HANDLE_VALUE) return;
+
+    if (watch->read_pending) {
+        CancelIo(watch->directory);
+        DWORD ignored;
+        GetOverlappedResult(watch->directory, &watch->overlapped, &ignored, TRUE);
+    }
+    CloseHandle(watch->overlapped.hEvent);
+    CloseHandle(watch->directory);
+}
+
+/**
+ * Whether any directory on a path relative to the root is excluded
+ */
+static bool windows_path_excluded(const FileWatch *watch, char *relative) {
+    for (char *slash = strchr(relative, '\\'); slash; slash = strchr(slash + 1, '\\')) {
+        *slash = '\0';
+        const char *name = strrchr(relative, '\\');
+        bool excluded = watch_excludes(watch, name ? name + 1 : relative);
+        *slash = '\\';
+        if (excluded) return true;
+    }
+    return false;
+}
+
+/**
+ * Wait up to wait_ms (-1 for ever) for notifications and record the relevant ones
+ *
+ * @return  Number of changes recorded, or -1 on error
+ */
+static int windows_read(FileWatch *watch, long wait_ms, FileChangeList *changes) {
+    DWORD waited = WaitForSingleObject(watch->overlapped.hEvent,
+                                       wait_ms < 0 ? INFINITE : (DWORD)wait_ms);
+    if (waited == WAIT_TIMEOUT) return 0;
+    if (waited != WAIT_OBJECT_0) return -1;
+
+    DWORD length = 0;
+    watch->read_pending = false;
+    if (!GetOverlappedResult(watch->directory, &watch->overlapped, &length, FALSE)) {
+        return -1;
+    }
+
+    int found = 0;
+    if (length == 0) {
+        /* The buffer overflowed and the notifications were lost */
+        changes->rescan = true;
+        found++;
+    }
+
+    for (const BYTE *p = (const BYTE *)watch->buffer; length > 0; ) {
+        const FILE_NOTIFY_INFORMATION *info = (const FILE_NOTIFY_INFORMATION *)p;
+
+        char relative[MAX_PATH_LENGTH];
+        int written = WideCharToMultiByte(CP_ACP, 0, info->FileName,
+                                          (int)(info->FileNameLength / sizeof(WCHAR)),
+                                          relative, (int)sizeof(relative) - 1, NULL, NULL);
+        relative[written > 0 ? written : 0] = '\0';
+
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s\\%s", watch->root, relative);
+
+        if (written > 0 && !windows_path_excluded(watch, relative)) {
+            if (dependency_is_source_path(path)) {
+                FileChangeKind kind = FILE_CHANGE_MODIFIED;
+                if (info->Action == FILE_ACTION_ADDED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    kind = FILE_CHANGE_ADDED;
+                } else if (info->Action == FILE_ACTION_REMOVED ||
+                           info->Action == FILE_ACTION_RENAMED_OLD_NAME) {
+                    kind = FILE_CHANGE_REMOVED;
+                }
+                if (!file_change_list_add(changes, path, kind)) return -1;
+                found++;
+            } else if (info->Action != FILE_ACTION_MODIFIED &&
+                       info->Action != FILE_ACTION_REMOVED) {
+                /* A directory that came or moved brings or takes its sources */
+                DWORD attributes = GetFileAttributesA(path);
+                if (info->Action == FILE_ACTION_RENAMED_OLD_NAME ||
+                    (attributes != INVALID_FILE_ATTRIBUTES &&
+                     (attributes & FILE_ATTRIBUTE_DIRECTORY))) {
+                    changes->rescan = true;
+                    found++;
+                }
+            }
+        }
+
+        if (info->NextEntryOffset == 0) break;
+        p += info->NextEntryOffset;
+    }
+
+    if (!windows_issue_read(watch)) return -1;
+    return found;
+}
+
+#endif /* _WIN32 */
+
+/* ==============================================================================
+ * Watching
+ * ==============================================================================
+ */
+
+FileWatch *file_watch_create(const char *root, const char **exclude_dirs,
+                             size_t exclude_count) {
+    if (!root) return NULL;
+
+    FileWatch *watch = calloc(1, sizeof(FileWatch));
+    if (!watch) return NULL;
+#ifdef _WIN32
+    watch->directory = INVALID_HANDLE_VALUE;
+#elif defined(__linux__)
+    watch->inotify_fd = -1;
+#endif
+
+    watch->root = strdup(root);
+    watch->exclude_dirs = exclude_count > 0 ? calloc(exclude_count, sizeof(char *)) : NULL;
+    bool ok = watch->root && (exclude_count == 0 || watch->exclude_dirs);
+    for (size_t i = 0; ok && i < exclude_count; i++) {
+        watch->exclude_dirs[i] = strdup(exclude_dirs[i]);
+        ok = watch->exclude_dirs[i] != NULL;
+        watch->exclude_count = i + 1;
+    }
+
+#ifdef _WIN32
+    ok = ok && windows_start(watch);
+#else
+    struct stat st;
+    ok = ok && stat(root, &st) == 0 && S_ISDIR(st.st_mode);
+#ifdef __linux__
+    if (ok && !inotify_start(watch)) {
+        printf("Warning: Cannot watch %s with inotify (raise fs.inotify.max_user_watches), "
+               "polling instead\n", root);
+        ok = start_polling(watch);
+    }
+#else
+    ok = ok && start_polling(watch);
+#endif
+#endif
+
+    if (!ok) {
+        file_watch_destroy(watch);
+        return NULL;
+    }
+    return watch;
+}
+
+/**
+ * One wait on whichever mechanism is in use
+ *
+ * @return  Number of changes recorded, or -1 on error
+ */
+static int watch_read(FileWatch *watch, long wait_ms, FileChangeList *changes) {
+#ifdef _WIN32
+    return windows_read(watch, wait_ms, changes);
+#else
+#ifdef __linux__
+    if (!watch->polling) return inotify_read(watch, wait_ms, changes);
+#endif
+    sleep_ms(wait_ms < 0 || wait_ms > FILE_WATCH_POLL_MS ? FILE_WATCH_POLL_MS : wait_ms);
+    return poll_changes(watch, changes);
+#endif
+}
+
+int file_watch_wait(FileWatch *watch, long timeout_ms, FileChangeList *changes) {
+    if (!watch || !changes) return -1;
+
+    double deadline = build_clock_seconds() + (double)timeout_ms / 1000.0;
+    bool settling = false;
+
+    for (;;) {
+        long wait_ms = -1;
+        if (settling) {
+            wait_ms = FILE_WATCH_SETTLE_MS;
+        } else if (timeout_ms >= 0) {
+            wait_ms = (long)((deadline - build_clock_seconds()) * 1000.0);
+            if (wait_ms <= 0) return 0;
+        }
+
+        int found = watch_read(watch, wait_ms, changes);
+        if (found < 0) return -1;
+        if (found > 0) {
+            settling = true;
+            continue;
+        }
+
+        if (settling) {
+            /* Quiet again; a burst can cancel itself out (a scratch file) */
+            if (changes->count > 0 || changes->rescan) return 1;
+            settling = false;
+        }
+    }
+}
+
+bool file_watch_is_polling(const FileWatch *watch) {
+    return watch && watch->polling;
+}
+
+void file_watch_destroy(FileWatch *watch) {
+    if (!watch) return;
+
+#ifdef _WIN32
+    windows_close(watch);
+#else
+#ifdef __linux__
+    inotify_close(watch);
+#endif
+    free_polled_files(watch->files, watch->file_count);
+#endif
+
+    for (size_t i = 0; i < watch->exclude_count; i++) {
+        free(watch->exclude_dirs[i]);
+    }
+    free(watch->exclude_dirs);
+    free(watch->root);
+    free(watch);
+}
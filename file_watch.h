@@ -0,0 +1,157 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Source Tree Watching
+ * ==============================================================================
+ *
+ * Reports the C/C++ sources and headers that change under a directory, for
+ * ecbuild --watch. Uses inotify on Linux and ReadDirectoryChangesW on
+ * Windows; elsewhere, or when inotify runs out of watches, the tree is
+ * polled, comparing each file's mtime and size.
+ *
+ * Directories the scanner skips (build, .git, .eventchains, the -e list)
+ * are not watched, so a build writing its objects does not wake the
+ * watcher up again.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define FILE_WATCH_SETTLE_MS 100                /* Quiet time that ends a burst of changes */
+#define FILE_WATCH_POLL_MS 500                  /* Interval between polls of the tree */
+
+/* ==============================================================================
+ * Types
+ * ==============================================================================
+ */
+
+/**
+ * FileChangeKind - What happened to a file
+ */
+typedef enum {
+    FILE_CHANGE_MODIFIED = 0,
+    FILE_CHANGE_ADDED,
+    FILE_CHANGE_REMOVED
+} FileChangeKind;
+
+/**
+ * FileChange - One changed file
+ */
+typedef struct FileChange {
+    char *path;                             /* Spelled as the scanner spells it */
+    FileChangeKind kind;
+} FileChange;
+
+/**
+ * FileChangeList - The files a burst of changes touched, each listed once
+ *
+ * When rescan is set the list may be incomplete, and the whole tree
+ * should be scanned again.
+ */
+typedef struct FileChangeList {
+    FileChange *changes;
+    size_t count;
+    size_t capacity;
+    bool rescan;                            /* Directories came or went, or events were lost */
+} FileChangeList;
+
+/* Watcher state (opaque) */
+typedef struct FileWatch FileWatch;
+
+/* ==============================================================================
+ * Change Lists
+ * ==============================================================================
+ */
+
+/**
+ * Initialize an empty list
+ *
+ * @param list  Pointer to FileChangeList
+ */
+void file_change_list_init(FileChangeList *list);
+
+/**
+ * Free every entry and empty the list
+ *
+ * @param list  Pointer to FileChangeList
+ */
+void file_change_list_destroy(FileChangeList *list);
+
+/**
+ * Record a change, merging it with an earlier change to the same file
+ *
+ * A file added and then modified stays added; one added and then removed
+ * is dropped entirely.
+ *
+ * @param list  Pointer to FileChangeList
+ * @param path  Changed file (copied)
+ * @param kind  What happened to it
+ * @return      true on success, false if out of memory
+ */
+bool file_change_list_add(FileChangeList *list, const char *path, FileChangeKind kind);
+
+/* ==============================================================================
+ * Watching
+ * ==============================================================================
+ */
+
+/**
+ * Start watching a directory tree
+ *
+ * @param root           Directory to watch, spelled as it is passed to the scanner
+ * @param exclude_dirs   Extra directory names to skip (can be NULL)
+ * @param exclude_count  Number of extra names
+ * @return               FileWatch, or NULL on error
+ */
+FileWatch *file_watch_create(const char *root, const char **exclude_dirs,
+                             size_t exclude_count);
+
+/**
+ * Wait for sources to change
+ *
+ * Returns once at least one source or header changed and no further
+ * change arrived for FILE_WATCH_SETTLE_MS, so saving several files at once
+ * is one burst.
+ *
+ * @param watch       Pointer to FileWatch
+ * @param timeout_ms  Longest wait for the first change, or -1 to wait forever
+ * @param changes     Initialized list to append the changes to
+ * @return            1 when changes were added, 0 on timeout, -1 on error
+ */
+int file_watch_wait(FileWatch *watch, long timeout_ms, FileChangeList *changes);
+
+/**
+ * Whether the watcher fell back to polling
+ *
+ * @param watch  Pointer to FileWatch
+ * @return       true when the tree is polled rather than watched
+ */
+bool file_watch_is_polling(const FileWatch *watch);
+
+/**
+ * Stop watching and free the watcher
+ *
+ * @param watch  Pointer to FileWatch (can be NULL)
+ */
+void file_watch_destroy(FileWatch *watch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FILE_WATCH_H */
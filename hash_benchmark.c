@@ -0,0 +1,186 @@
+/**
+ * ==============================================================================
+ * Content Hash - Micro-Benchmark
+ * ==============================================================================
+ *
+ * Compares the byte-at-a-time FNV-1a hash used by cache versions before 5
+ * with the stripe hash from content_hash.c on the sources of a real tree.
+ *
+ * Usage: hash_benchmark [directory]
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#include "dependency_resolver.h"
+#include "content_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MIN_BENCH_SECONDS 0.5                   /* Repeat each pass until this long */
+#define MIN_BENCH_BYTES (64u * 1024 * 1024)     /* ...and at least this much data */
+
+typedef uint64_t (*bytes_hash_func)(const void *data, size_t len);
+
+typedef struct LoadedFile {
+    const char *path;
+    unsigned char *data;
+    size_t size;
+} LoadedFile;
+
+static unsigned char *load_file(const char *path, size_t *size) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (length < 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    unsigned char *data = malloc((size_t)length + 1);
+    if (data) {
+        *size = fread(data, 1, (size_t)length, fp);
+    }
+    fclose(fp);
+    return data;
+}
+
+static double elapsed_seconds(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**
+ * Hash every in-memory file repeatedly; returns throughput in MB/s
+ */
+static double bench_bytes(bytes_hash_func hash, const LoadedFile *files, size_t count,
+                          size_t total_bytes, uint64_t *checksum) {
+    size_t rounds = 0;
+    uint64_t sum = 0;
+    clock_t start = clock();
+    double seconds;
+    volatile uint64_t sink = 0;
+
+    /* Checksum of one pass, so implementations can be compared */
+    for (size_t i = 0; i < count; i++) {
+        sum += hash(files[i].data, files[i].size);
+    }
+
+    do {
+        for (size_t i = 0; i < count; i++) {
+            sink += hash(files[i].data, files[i].size);
+        }
+        rounds++;
+        seconds = elapsed_seconds(start);
+    } while (seconds < MIN_BENCH_SECONDS || rounds * total_bytes < MIN_BENCH_BYTES);
+
+    (void)sink;
+    *checksum = sum;
+    return (double)(rounds * total_bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+/**
+ * Hash files from disk (page cache) the way the build cache does
+ */
+static double bench_files(const LoadedFile *files, size_t count, size_t total_bytes,
+                          size_t *files_per_second) {
+    size_t rounds = 0;
+    clock_t start = clock();
+    double seconds;
+    volatile uint64_t sink = 0;
+
+    do {
+        for (size_t i = 0; i < count; i++) {
+            sink += content_hash_file(files[i].path);
+        }
+        rounds++;
+        seconds = elapsed_seconds(start);
+    } while (seconds < MIN_BENCH_SECONDS);
+
+    (void)sink;
+    *files_per_second = (size_t)((double)(rounds * count) / seconds);
+    return (double)(rounds * total_bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+int main(int argc, char **argv) {
+    const char *source_dir = argc > 1 ? argv[1] : ".";
+
+    printf("|----------------------------------------------------------------|\n");
+    printf("|              Content Hash - Micro-Benchmark                    |\n");
+    printf("|----------------------------------------------------------------|\n\n");
+
+    DependencyGraph *graph = dependency_graph_create();
+    if (!graph) {
+        fprintf(stderr, "Failed to create dependency graph\n");
+        return 1;
+    }
+
+    dependency_graph_add_include_path(graph, source_dir);
+    if (dependency_graph_scan_directory(graph, source_dir, true) != DEP_SUCCESS) {
+        fprintf(stderr, "Failed to scan %s\n", source_dir);
+        dependency_graph_destroy(graph);
+        return 1;
+    }
+
+    LoadedFile *files = calloc(graph->file_count ? graph->file_count : 1, sizeof(LoadedFile));
+    size_t count = 0;
+    size_t total_bytes = 0;
+    for (size_t i = 0; files && i < graph->file_count; i++) {
+        size_t size = 0;
+        unsigned char *data = load_file(graph->files[i]->path, &size);
+        if (!data) continue;
+
+        files[count].path = graph->files[i]->path;
+        files[count].data = data;
+        files[count].size = size;
+        total_bytes += size;
+        count++;
+    }
+
+    if (count == 0 || total_bytes == 0) {
+        fprintf(stderr, "No readable source files under %s\n", source_dir);
+        free(files);
+        dependency_graph_destroy(graph);
+        return 1;
+    }
+
+    printf("Tree:            %s\n", source_dir);
+    printf("Files:           %zu (%.1f KB)\n", count, total_bytes / 1024.0);
+    printf("Implementation:  %s\n\n", content_hash_implementation());
+
+    uint64_t fnv_sum, scalar_sum, vector_sum;
+    double fnv = bench_bytes(content_hash_fnv1a, files, count, total_bytes, &fnv_sum);
+    double scalar = bench_bytes(content_hash_bytes_scalar, files, count, total_bytes, &scalar_sum);
+    double vector = bench_bytes(content_hash_bytes, files, count, total_bytes, &vector_sum);
+
+    size_t files_per_second = 0;
+    double from_disk = bench_files(files, count, total_bytes, &files_per_second);
+
+    printf("In-memory throughput\n");
+    printf("--------------------\n");
+    printf("  FNV-1a (cache v4):   %10.1f MB/s\n", fnv);
+    printf("  Stripe hash scalar:  %10.1f MB/s  (%.1fx)\n", scalar, scalar / fnv);
+    char label[32];
+    snprintf(label, sizeof(label), "Stripe hash %s:", content_hash_implementation());
+    printf("  %-20s %10.1f MB/s  (%.1fx)\n", label, vector, vector / fnv);
+    printf("\nFile hashing (content_hash_file)\n");
+    printf("--------------------------------\n");
+    printf("  %10.1f MB/s, %zu files/s\n", from_disk, files_per_second);
+
+    if (scalar_sum != vector_sum) {
+        printf("\nERROR: vector and scalar hashes disagree\n");
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        free(files[i].data);
+    }
+    free(files);
+    dependency_graph_destroy(graph);
+
+    return scalar_sum == vector_sum ? 0 : 1;
+}
@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 /* ==============================================================================
  * Internal Constants
@@ -123,7 +124,7 @@ size_t event_chain_get_max_middleware(void) {
 }
 
 size_t event_chain_get_max_context_entries(void) {
-    return EVENTCHAINS_MAX_CONTEXT_ENTRIES;
+    return SIZE_MAX;
 }
 
 size_t event_chain_get_max_context_memory(void) {
@@ -375,11 +376,23 @@ size_t ref_counted_value_get_count(const RefCountedValue *value) {
  * ==============================================================================
  */
 
+/**
+ * FNV-1a over a context key
+ */
+static uint64_t context_hash_key(const char *key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)key; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 EventContext *event_context_create(void) {
     EventContext *ctx = malloc(sizeof(EventContext));
     if (!ctx) return NULL;
 
-    ctx->entries = malloc(INITIAL_CAPACITY * sizeof(ContextEntry));
+    ctx->entries = calloc(INITIAL_CAPACITY, sizeof(ContextEntry));
     if (!ctx->entries) {
         free(ctx);
         return NULL;
@@ -390,7 +403,7 @@ EventContext *event_context_create(void) {
     ctx->total_memory_bytes = sizeof(EventContext) +
                               (INITIAL_CAPACITY * sizeof(ContextEntry));
 
-    if (ec_mutex_init(&ctx->mutex) != 0) {
+    if (ec_rwlock_init(&ctx->lock) != 0) {
         free(ctx->entries);
         free(ctx);
         return NULL;
@@ -402,55 +415,87 @@ EventContext *event_context_create(void) {
 void event_context_destroy(EventContext *context) {
     if (!context) return;
 
-    ec_mutex_lock(&context->mutex);
+    ec_rwlock_write_lock(&context->lock);
 
     /* Release all values */
-    for (size_t i = 0; i < context->count; i++) {
+    for (size_t i = 0; i < context->capacity; i++) {
+        if (!context->entries[i].key) continue;
         free(context->entries[i].key);
         ref_counted_value_release(context->entries[i].value);
     }
 
     free(context->entries);
-    ec_mutex_unlock(&context->mutex);
-    ec_mutex_destroy(&context->mutex);
+    ec_rwlock_write_unlock(&context->lock);
+    ec_rwlock_destroy(&context->lock);
     free(context);
 }
 
-static int find_entry(EventContext *context, const char *key) {
-    for (size_t i = 0; i < context->count; i++) {
-        if (strcmp(context->entries[i].key, key) == 0) {
-            return (int)i;
+/**
+ * Find the slot holding key, or the empty slot ending its probe sequence
+ * (called with the lock held either way)
+ */
+static size_t find_slot(const EventContext *context, const char *key, uint64_t hash) {
+    size_t mask = context->capacity - 1;
+    size_t slot = (size_t)hash & mask;
+
+    for (;;) {
+        const ContextEntry *entry = &context->entries[slot];
+        if (!entry->key ||
+            (entry->hash == hash && strcmp(entry->key, key) == 0)) {
+            return slot;
         }
+        slot = (slot + 1) & mask;
     }
-    return -1;
 }
 
+static int find_entry(const EventContext *context, const char *key) {
+    size_t slot = find_slot(context, key, context_hash_key(key));
+    return context->entries[slot].key ? (int)slot : -1;
+}
+
+/**
+ * Make room for one more entry, keeping the table at most 3/4 full
+ * (called with the lock held exclusively)
+ */
 static EventChainErrorCode ensure_capacity(EventContext *context) {
-    if (context->count < context->capacity) {
+    if ((context->count + 1) * 4 <= context->capacity * 3) {
         return EC_SUCCESS;
     }
 
-    if (context->count >= EVENTCHAINS_MAX_CONTEXT_ENTRIES) {
-        return EC_ERROR_CAPACITY_EXCEEDED;
-    }
-
-    size_t new_capacity = context->capacity * GROWTH_FACTOR;
-    if (new_capacity > EVENTCHAINS_MAX_CONTEXT_ENTRIES) {
-        new_capacity = EVENTCHAINS_MAX_CONTEXT_ENTRIES;
-    }
-
+    size_t new_capacity;
     size_t new_size;
-    if (!safe_multiply(new_capacity, sizeof(ContextEntry), &new_size)) {
+    if (!safe_multiply(context->capacity, GROWTH_FACTOR, &new_capacity) ||
+        !safe_multiply(new_capacity, sizeof(ContextEntry), &new_size)) {
         return EC_ERROR_OVERFLOW;
     }
 
-    ContextEntry *new_entries = realloc(context->entries, new_size);
+    size_t added_bytes = (new_capacity - context->capacity) * sizeof(ContextEntry);
+    if (context->total_memory_bytes + added_bytes > EVENTCHAINS_MAX_CONTEXT_MEMORY) {
+        return EC_ERROR_MEMORY_LIMIT_EXCEEDED;
+    }
+
+    ContextEntry *new_entries = calloc(new_capacity, sizeof(ContextEntry));
     if (!new_entries) {
         return EC_ERROR_OUT_OF_MEMORY;
     }
 
+    /* Rehash into the larger table */
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < context->capacity; i++) {
+        ContextEntry *entry = &context->entries[i];
+        if (!entry->key) continue;
+
+        size_t slot = (size_t)entry->hash & mask;
+        while (new_entries[slot].key) {
+            slot = (slot + 1) & mask;
+        }
+        new_entries[slot] = *entry;
+    }
+
+    free(context->entries);
     context->entries = new_entries;
     context->capacity = new_capacity;
+    context->total_memory_bytes += added_bytes;
 
     return EC_SUCCESS;
 }
@@ -468,53 +513,52 @@ EventChainErrorCode event_context_set_with_cleanup(
         return EC_ERROR_KEY_TOO_LONG;
     }
 
-    ec_mutex_lock(&context->mutex);
+    /* Allocate outside the lock; other workers may be reading */
+    uint64_t hash = context_hash_key(key);
+    RefCountedValue *ref_value = ref_counted_value_create(value, cleanup);
+    if (!ref_value) {
+        return EC_ERROR_OUT_OF_MEMORY;
+    }
+
+    ec_rwlock_write_lock(&context->lock);
+
+    size_t slot = find_slot(context, key, hash);
+    if (context->entries[slot].key) {
+        /* Update existing entry */
+        RefCountedValue *old_value = context->entries[slot].value;
+        context->entries[slot].value = ref_value;
+        ec_rwlock_write_unlock(&context->lock);
+        ref_counted_value_release(old_value);
+        return EC_SUCCESS;
+    }
 
     /* Check memory limit */
     size_t additional_memory = key_len + 1 + sizeof(RefCountedValue);
     if (context->total_memory_bytes + additional_memory >
         EVENTCHAINS_MAX_CONTEXT_MEMORY) {
-        ec_mutex_unlock(&context->mutex);
+        ec_rwlock_write_unlock(&context->lock);
+        ref_counted_value_release(ref_value);
         return EC_ERROR_MEMORY_LIMIT_EXCEEDED;
     }
 
-    /* Check if key exists */
-    int idx = find_entry(context, key);
-
-    /* Create ref-counted value */
-    RefCountedValue *ref_value = ref_counted_value_create(value, cleanup);
-    if (!ref_value) {
-        ec_mutex_unlock(&context->mutex);
-        return EC_ERROR_OUT_OF_MEMORY;
+    /* Add new entry */
+    EventChainErrorCode err = ensure_capacity(context);
+    char *key_copy = err == EC_SUCCESS ? strdup(key) : NULL;
+    if (!key_copy) {
+        ec_rwlock_write_unlock(&context->lock);
+        ref_counted_value_release(ref_value);
+        return err != EC_SUCCESS ? err : EC_ERROR_OUT_OF_MEMORY;
     }
 
-    if (idx >= 0) {
-        /* Update existing entry */
-        ref_counted_value_release(context->entries[idx].value);
-        context->entries[idx].value = ref_value;
-    } else {
-        /* Add new entry */
-        EventChainErrorCode err = ensure_capacity(context);
-        if (err != EC_SUCCESS) {
-            ref_counted_value_release(ref_value);
-            ec_mutex_unlock(&context->mutex);
-            return err;
-        }
-
-        char *key_copy = strdup(key);
-        if (!key_copy) {
-            ref_counted_value_release(ref_value);
-            ec_mutex_unlock(&context->mutex);
-            return EC_ERROR_OUT_OF_MEMORY;
-        }
+    /* Growing rehashed the table */
+    slot = find_slot(context, key, hash);
+    context->entries[slot].key = key_copy;
+    context->entries[slot].value = ref_value;
+    context->entries[slot].hash = hash;
+    context->count++;
+    context->total_memory_bytes += additional_memory;
 
-        context->entries[context->count].key = key_copy;
-        context->entries[context->count].value = ref_value;
-        context->count++;
-        context->total_memory_bytes += additional_memory;
-    }
-
-    ec_mutex_unlock(&context->mutex);
+    ec_rwlock_write_unlock(&context->lock);
     return EC_SUCCESS;
 }
 
@@ -533,17 +577,18 @@ EventChainErrorCode event_context_get(
 ) {
     if (!context || !key || !value_out) return EC_ERROR_NULL_POINTER;
 
-    ec_mutex_lock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_t *lock = (ec_rwlock_t *)&context->lock;
+    ec_rwlock_read_lock(lock);
 
-    int idx = find_entry((EventContext *)context, key);
+    int idx = find_entry(context, key);
     if (idx < 0) {
-        ec_mutex_unlock((ec_mutex_t *)&context->mutex);
+        ec_rwlock_read_unlock(lock);
         return EC_ERROR_NOT_FOUND;
     }
 
     *value_out = ref_counted_value_get_data(context->entries[idx].value);
 
-    ec_mutex_unlock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_read_unlock(lock);
     return EC_SUCCESS;
 }
 
@@ -554,19 +599,20 @@ EventChainErrorCode event_context_get_ref(
 ) {
     if (!context || !key || !value_out) return EC_ERROR_NULL_POINTER;
 
-    ec_mutex_lock(&context->mutex);
+    ec_rwlock_read_lock(&context->lock);
 
     int idx = find_entry(context, key);
     if (idx < 0) {
-        ec_mutex_unlock(&context->mutex);
+        ec_rwlock_read_unlock(&context->lock);
         return EC_ERROR_NOT_FOUND;
     }
 
+    /* The reference count is atomic, so readers may retain side by side */
     RefCountedValue *value = context->entries[idx].value;
     ref_counted_value_retain(value);
     *value_out = value;
 
-    ec_mutex_unlock(&context->mutex);
+    ec_rwlock_read_unlock(&context->lock);
     return EC_SUCCESS;
 }
 
@@ -577,56 +623,74 @@ bool event_context_has(
 ) {
     if (!context || !key) return false;
 
-    ec_mutex_lock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_t *lock = (ec_rwlock_t *)&context->lock;
+    ec_rwlock_read_lock(lock);
 
     bool found;
     if (constant_time) {
+        /* Visit every slot, so the time taken says nothing about the key */
         found = false;
-        for (size_t i = 0; i < context->count; i++) {
-            if (constant_time_strcmp(context->entries[i].key, key,
-                                    EVENTCHAINS_MAX_KEY_LENGTH)) {
+        for (size_t i = 0; i < context->capacity; i++) {
+            const char *slot_key = context->entries[i].key;
+            if (constant_time_strcmp(slot_key ? slot_key : "", key,
+                                    EVENTCHAINS_MAX_KEY_LENGTH) && slot_key) {
                 found = true;
             }
         }
     } else {
-        found = find_entry((EventContext *)context, key) >= 0;
+        found = find_entry(context, key) >= 0;
     }
 
-    ec_mutex_unlock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_read_unlock(lock);
     return found;
 }
 
 EventChainErrorCode event_context_remove(EventContext *context, const char *key) {
     if (!context || !key) return EC_ERROR_NULL_POINTER;
 
-    ec_mutex_lock(&context->mutex);
+    ec_rwlock_write_lock(&context->lock);
 
     int idx = find_entry(context, key);
     if (idx < 0) {
-        ec_mutex_unlock(&context->mutex);
+        ec_rwlock_write_unlock(&context->lock);
         return EC_ERROR_NOT_FOUND;
     }
 
     /* Free key and release value */
+    size_t key_len = strlen(context->entries[idx].key);
     free(context->entries[idx].key);
-    ref_counted_value_release(context->entries[idx].value);
-
-    /* Shift remaining entries */
-    for (size_t i = idx; i < context->count - 1; i++) {
-        context->entries[i] = context->entries[i + 1];
-    }
+    RefCountedValue *old_value = context->entries[idx].value;
     context->count--;
+    context->total_memory_bytes -= key_len + 1 + sizeof(RefCountedValue);
+
+    /* Shift later members of the probe run back into the hole, so
+     * lookups never need tombstones */
+    size_t mask = context->capacity - 1;
+    size_t hole = (size_t)idx;
+    size_t slot = (hole + 1) & mask;
+    while (context->entries[slot].key) {
+        size_t home = (size_t)context->entries[slot].hash & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            context->entries[hole] = context->entries[slot];
+            hole = slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    context->entries[hole].key = NULL;
+    context->entries[hole].value = NULL;
 
-    ec_mutex_unlock(&context->mutex);
+    ec_rwlock_write_unlock(&context->lock);
+    ref_counted_value_release(old_value);
     return EC_SUCCESS;
 }
 
 size_t event_context_count(const EventContext *context) {
     if (!context) return 0;
 
-    ec_mutex_lock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_t *lock = (ec_rwlock_t *)&context->lock;
+    ec_rwlock_read_lock(lock);
     size_t count = context->count;
-    ec_mutex_unlock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_read_unlock(lock);
 
     return count;
 }
@@ -634,9 +698,10 @@ size_t event_context_count(const EventContext *context) {
 size_t event_context_memory_usage(const EventContext *context) {
     if (!context) return 0;
 
-    ec_mutex_lock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_t *lock = (ec_rwlock_t *)&context->lock;
+    ec_rwlock_read_lock(lock);
     size_t memory = context->total_memory_bytes;
-    ec_mutex_unlock((ec_mutex_t *)&context->mutex);
+    ec_rwlock_read_unlock(lock);
 
     return memory;
 }
@@ -644,18 +709,21 @@ size_t event_context_memory_usage(const EventContext *context) {
 void event_context_clear(EventContext *context) {
     if (!context) return;
 
-    ec_mutex_lock(&context->mutex);
+    ec_rwlock_write_lock(&context->lock);
 
-    for (size_t i = 0; i < context->count; i++) {
+    for (size_t i = 0; i < context->capacity; i++) {
+        if (!context->entries[i].key) continue;
         free(context->entries[i].key);
         ref_counted_value_release(context->entries[i].value);
+        context->entries[i].key = NULL;
+        context->entries[i].value = NULL;
     }
 
     context->count = 0;
     context->total_memory_bytes = sizeof(EventContext) +
                                   (context->capacity * sizeof(ContextEntry));
 
-    ec_mutex_unlock(&context->mutex);
+    ec_rwlock_write_unlock(&context->lock);
 }
 
 /* ==============================================================================
@@ -723,6 +791,8 @@ EventMiddleware *event_middleware_create(
     if (!middleware) return NULL;
 
     middleware->execute = execute;
+    middleware->before_batch = NULL;
+    middleware->after_batch = NULL;
     middleware->user_data = user_data;
 
     if (name) {
@@ -739,18 +809,36 @@ void event_middleware_destroy(EventMiddleware *middleware) {
     free(middleware);
 }
 
-/* Forward declaration for middleware execution */
-static void execute_next_middleware(
-    EventResult *result_ptr,
-    ChainableEvent *event,
-    EventContext *context,
-    void *next_data
-);
+void event_middleware_set_batch_hooks(
+    EventMiddleware *middleware,
+    MiddlewareBatchFunc before_batch,
+    MiddlewareBatchFunc after_batch
+) {
+    if (!middleware) return;
 
-typedef struct MiddlewareContext {
-    EventChain *chain;
-    size_t current_index;
-} MiddlewareContext;
+    middleware->before_batch = before_batch;
+    middleware->after_batch = after_batch;
+}
+
+/* Worker running the calling thread's events; see event_chain_worker_index */
+static EC_THREAD_LOCAL size_t current_worker_index;
+
+size_t event_chain_worker_index(void) {
+    return current_worker_index;
+}
+
+/**
+ * MiddlewareStage - One layer of a chain's flattened pipeline
+ *
+ * The stages are copied out of the middlewares into one array whenever a
+ * middleware is added, ending with a stage whose execute is NULL. Each
+ * layer's next_data is simply the following stage, so running an event
+ * neither allocates nor copies anything per layer.
+ */
+struct MiddlewareStage {
+    MiddlewareExecuteFunc execute;
+    void *user_data;
+};
 
 static void execute_event_direct(
     EventResult *result_ptr,
@@ -770,34 +858,27 @@ static void execute_event_direct(
     *result_ptr = event->execute(context, event->user_data);
 }
 
-static void execute_next_middleware(
+static void execute_pipeline_stage(
     EventResult *result_ptr,
     ChainableEvent *event,
     EventContext *context,
     void *next_data
 ) {
-    MiddlewareContext *mw_ctx = (MiddlewareContext *)next_data;
+    const struct MiddlewareStage *stage = (const struct MiddlewareStage *)next_data;
 
-    if (mw_ctx->current_index >= mw_ctx->chain->middleware_count) {
+    if (!stage->execute) {
         /* No more middleware, execute event */
         execute_event_direct(result_ptr, event, context, NULL);
         return;
     }
 
-    /* Execute current middleware */
-    EventMiddleware *middleware =
-        mw_ctx->chain->middlewares[mw_ctx->current_index];
-
-    MiddlewareContext next_ctx = *mw_ctx;
-    next_ctx.current_index++;
-
-    middleware->execute(
+    stage->execute(
         result_ptr,
         event,
         context,
-        execute_next_middleware,
-        &next_ctx,
-        middleware->user_data
+        execute_pipeline_stage,
+        (void *)(stage + 1),
+        stage->user_data
     );
 }
 
@@ -814,16 +895,34 @@ void execute_event_with_middleware(
         return;
     }
 
-    if (chain->middleware_count == 0) {
+    if (!chain->pipeline) {
         /* No middleware, execute directly */
         execute_event_direct(result_ptr, event, chain->context, NULL);
     } else {
-        /* Start middleware pipeline */
-        MiddlewareContext mw_ctx = {
-            .chain = chain,
-            .current_index = 0
-        };
-        execute_next_middleware(result_ptr, event, chain->context, &mw_ctx);
+        execute_pipeline_stage(result_ptr, event, chain->context, chain->pipeline);
+    }
+}
+
+/**
+ * Run every middleware's before_batch (in order) or after_batch (in
+ * reverse order) hook
+ */
+static void run_batch_hooks(EventChain *chain, size_t worker_count, bool before) {
+    EventBatch batch = {
+        .chain = chain,
+        .events = (ChainableEvent *const *)chain->events,
+        .event_count = chain->event_count,
+        .worker_count = worker_count
+    };
+
+    for (size_t i = 0; i < chain->middleware_count; i++) {
+        const EventMiddleware *middleware =
+            chain->middlewares[before ? i : chain->middleware_count - 1 - i];
+        MiddlewareBatchFunc hook = before ? middleware->before_batch
+                                          : middleware->after_batch;
+        if (hook) {
+            hook(&batch, middleware->user_data);
+        }
     }
 }
 
@@ -847,9 +946,18 @@ EventChain *event_chain_create_with_detail(
     chain->event_count = 0;
     chain->event_capacity = 0;
 
+    chain->dependencies = NULL;
+    chain->dependency_count = 0;
+    chain->dependency_capacity = 0;
+
+    chain->schedule = NULL;
+    chain->schedule_count = 0;
+    chain->memory_budget = 0;
+
     chain->middlewares = NULL;
     chain->middleware_count = 0;
     chain->middleware_capacity = 0;
+    chain->pipeline = NULL;
 
     chain->context = event_context_create();
     if (!chain->context) {
@@ -875,12 +983,15 @@ void event_chain_destroy(EventChain *chain) {
         chainable_event_destroy(chain->events[i]);
     }
     free(chain->events);
+    free(chain->dependencies);
+    free(chain->schedule);
 
     /* Free all middleware */
     for (size_t i = 0; i < chain->middleware_count; i++) {
         event_middleware_destroy(chain->middlewares[i]);
     }
     free(chain->middlewares);
+    free(chain->pipeline);
 
     /* Free context */
     event_context_destroy(chain->context);
@@ -938,6 +1049,99 @@ EventChainErrorCode event_chain_add_event(
     return EC_SUCCESS;
 }
 
+EventChainErrorCode event_chain_add_dependency(
+    EventChain *chain,
+    size_t event_index,
+    size_t prerequisite_index
+) {
+    if (!chain) return EC_ERROR_NULL_POINTER;
+
+    if (ec_atomic_load(&chain->is_executing)) {
+        return EC_ERROR_REENTRANCY;
+    }
+
+    if (event_index >= chain->event_count ||
+        prerequisite_index >= event_index) {
+        return EC_ERROR_INVALID_PARAMETER;
+    }
+
+    if (chain->dependency_count >= chain->dependency_capacity) {
+        size_t new_capacity = chain->dependency_capacity == 0 ?
+                             INITIAL_CAPACITY :
+                             chain->dependency_capacity * GROWTH_FACTOR;
+
+        size_t new_size;
+        if (!safe_multiply(new_capacity, sizeof(EventDependency), &new_size)) {
+            return EC_ERROR_OVERFLOW;
+        }
+
+        EventDependency *new_deps = realloc(chain->dependencies, new_size);
+        if (!new_deps) {
+            return EC_ERROR_OUT_OF_MEMORY;
+        }
+
+        chain->dependencies = new_deps;
+        chain->dependency_capacity = new_capacity;
+    }
+
+    chain->dependencies[chain->dependency_count].event_index = event_index;
+    chain->dependencies[chain->dependency_count].prerequisite_index = prerequisite_index;
+    chain->dependency_count++;
+
+    return EC_SUCCESS;
+}
+
+EventChainErrorCode event_chain_set_event_schedule(
+    EventChain *chain,
+    size_t event_index,
+    double priority,
+    uint64_t memory_cost
+) {
+    if (!chain) return EC_ERROR_NULL_POINTER;
+
+    if (ec_atomic_load(&chain->is_executing)) {
+        return EC_ERROR_REENTRANCY;
+    }
+
+    if (event_index >= chain->event_count || isnan(priority)) {
+        return EC_ERROR_INVALID_PARAMETER;
+    }
+
+    if (event_index >= chain->schedule_count) {
+        /* Grow to cover every event added so far */
+        size_t new_size;
+        if (!safe_multiply(chain->event_count, sizeof(EventSchedule), &new_size)) {
+            return EC_ERROR_OVERFLOW;
+        }
+
+        EventSchedule *new_schedule = realloc(chain->schedule, new_size);
+        if (!new_schedule) {
+            return EC_ERROR_OUT_OF_MEMORY;
+        }
+
+        memset(new_schedule + chain->schedule_count, 0,
+               (chain->event_count - chain->schedule_count) * sizeof(EventSchedule));
+        chain->schedule = new_schedule;
+        chain->schedule_count = chain->event_count;
+    }
+
+    chain->schedule[event_index].priority = priority;
+    chain->schedule[event_index].memory_cost = memory_cost;
+
+    return EC_SUCCESS;
+}
+
+EventChainErrorCode event_chain_set_memory_budget(EventChain *chain, uint64_t budget) {
+    if (!chain) return EC_ERROR_NULL_POINTER;
+
+    if (ec_atomic_load(&chain->is_executing)) {
+        return EC_ERROR_REENTRANCY;
+    }
+
+    chain->memory_budget = budget;
+    return EC_SUCCESS;
+}
+
 static EventChainErrorCode ensure_middleware_capacity(EventChain *chain) {
     if (chain->middleware_count < chain->middleware_capacity) {
         return EC_SUCCESS;
@@ -984,7 +1188,20 @@ EventChainErrorCode event_chain_use_middleware(
     EventChainErrorCode err = ensure_middleware_capacity(chain);
     if (err != EC_SUCCESS) return err;
 
+    /* Flatten the new stack up front rather than walking it per event */
+    struct MiddlewareStage *pipeline = realloc(
+        chain->pipeline, (chain->middleware_count + 2) * sizeof(struct MiddlewareStage));
+    if (!pipeline) return EC_ERROR_OUT_OF_MEMORY;
+    chain->pipeline = pipeline;
+
     chain->middlewares[chain->middleware_count++] = middleware;
+    for (size_t i = 0; i < chain->middleware_count; i++) {
+        pipeline[i].execute = chain->middlewares[i]->execute;
+        pipeline[i].user_data = chain->middlewares[i]->user_data;
+    }
+    pipeline[chain->middleware_count].execute = NULL;
+    pipeline[chain->middleware_count].user_data = NULL;
+
     return EC_SUCCESS;
 }
 
@@ -1031,6 +1248,11 @@ void event_chain_execute(EventChain *chain, ChainResult *result_ptr) {
 
     size_t failure_capacity = 0;
 
+    /* A sequential run is a single worker, even nested inside a parallel one */
+    size_t saved_worker_index = current_worker_index;
+    current_worker_index = 0;
+    run_batch_hooks(chain, 1, true);
+
     /* Execute each event */
     for (size_t i = 0; i < chain->event_count; i++) {
         EventResult event_result;
@@ -1101,6 +1323,460 @@ void event_chain_execute(EventChain *chain, ChainResult *result_ptr) {
         }
     }
 
+    run_batch_hooks(chain, 1, false);
+    current_worker_index = saved_worker_index;
+
+    /* Mark execution as complete */
+    ec_atomic_store(&chain->is_executing, 0);
+
+    /* Update result based on failure count */
+    if (result_ptr->failure_count > 0 &&
+        chain->fault_tolerance == FAULT_TOLERANCE_STRICT) {
+        result_ptr->success = false;
+    }
+}
+
+/* ==============================================================================
+ * Parallel Execution Implementation
+ * ==============================================================================
+ */
+
+typedef enum {
+    PARALLEL_EVENT_PENDING = 0,
+    PARALLEL_EVENT_RUNNING,
+    PARALLEL_EVENT_SUCCEEDED,
+    PARALLEL_EVENT_FAILED,
+    PARALLEL_EVENT_SKIPPED
+} ParallelEventState;
+
+typedef struct ParallelFailure {
+    size_t event_index;
+    FailureInfo info;
+} ParallelFailure;
+
+typedef struct ParallelExecutor {
+    EventChain *chain;
+
+    /* Prerequisite -> dependents adjacency (compressed rows) */
+    size_t *dependent_offsets;
+    size_t *dependents;
+    size_t *pending;                 /* Unfinished prerequisites per event */
+    unsigned char *state;            /* ParallelEventState per event */
+
+    /* Binary max-heap of ready events by priority, then lowest index;
+     * every event is enqueued at most once */
+    size_t *ready;
+    size_t ready_count;
+    size_t *skip_stack;              /* Work stack of parallel_skip_dependents */
+
+    size_t unfinished;               /* Events neither completed nor skipped */
+    size_t in_flight;
+    uint64_t memory_in_flight;       /* Memory cost of the running events */
+    size_t next_worker;              /* event_chain_worker_index of the next worker */
+    bool stop;                       /* No further dispatch (strict failure) */
+    bool success;
+
+    ParallelFailure *failures;
+    size_t failure_count;
+    size_t failure_capacity;
+
+    ec_mutex_t mutex;
+    ec_cond_t cond;
+} ParallelExecutor;
+
+static double parallel_priority(const ParallelExecutor *exec, size_t index) {
+    const EventChain *chain = exec->chain;
+    return index < chain->schedule_count ? chain->schedule[index].priority : 0.0;
+}
+
+static uint64_t parallel_memory_cost(const ParallelExecutor *exec, size_t index) {
+    const EventChain *chain = exec->chain;
+    return index < chain->schedule_count ? chain->schedule[index].memory_cost : 0;
+}
+
+/**
+ * Whether ready event a should start before ready event b
+ */
+static bool parallel_runs_before(const ParallelExecutor *exec, size_t a, size_t b) {
+    double pa = parallel_priority(exec, a);
+    double pb = parallel_priority(exec, b);
+    if (pa != pb) return pa > pb;
+    return a < b;
+}
+
+static void parallel_ready_push(ParallelExecutor *exec, size_t index) {
+    size_t pos = exec->ready_count++;
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!parallel_runs_before(exec, index, exec->ready[parent])) break;
+        exec->ready[pos] = exec->ready[parent];
+        pos = parent;
+    }
+    exec->ready[pos] = index;
+}
+
+static size_t parallel_ready_pop(ParallelExecutor *exec) {
+    size_t top = exec->ready[0];
+    size_t last = exec->ready[--exec->ready_count];
+    size_t pos = 0;
+
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= exec->ready_count) break;
+        if (child + 1 < exec->ready_count &&
+            parallel_runs_before(exec, exec->ready[child + 1], exec->ready[child])) {
+            child++;
+        }
+        if (!parallel_runs_before(exec, exec->ready[child], last)) break;
+        exec->ready[pos] = exec->ready[child];
+        pos = child;
+    }
+    if (exec->ready_count > 0) exec->ready[pos] = last;
+
+    return top;
+}
+
+/**
+ * Whether the best ready event may start now (called with mutex held)
+ *
+ * The best event waits for memory rather than letting cheaper ones pass
+ * it, so a heavy event on the critical path is not starved.
+ */
+static bool parallel_can_dispatch(const ParallelExecutor *exec) {
+    if (exec->ready_count == 0) return false;
+
+    uint64_t budget = exec->chain->memory_budget;
+    if (budget == 0 || exec->in_flight == 0) return true;
+
+    uint64_t cost = parallel_memory_cost(exec, exec->ready[0]);
+    return cost <= budget && exec->memory_in_flight <= budget - cost;
+}
+
+static void parallel_record_failure(
+    ParallelExecutor *exec,
+    size_t event_index,
+    const char *message,
+    EventChainErrorCode code
+) {
+    if (exec->failure_count >= exec->failure_capacity) {
+        size_t new_capacity = exec->failure_capacity == 0 ?
+                             4 : exec->failure_capacity * 2;
+        ParallelFailure *new_failures = realloc(
+            exec->failures, new_capacity * sizeof(ParallelFailure));
+        if (!new_failures) {
+            /* Out of memory, can't record failure */
+            exec->stop = true;
+            exec->success = false;
+            return;
+        }
+        exec->failures = new_failures;
+        exec->failure_capacity = new_capacity;
+    }
+
+    ParallelFailure *failure = &exec->failures[exec->failure_count++];
+    failure->event_index = event_index;
+    safe_strncpy(failure->info.event_name, exec->chain->events[event_index]->name,
+                 EVENTCHAINS_MAX_NAME_LENGTH);
+    safe_strncpy(failure->info.error_message, message, EVENTCHAINS_MAX_ERROR_LENGTH);
+    failure->info.error_code = code;
+}
+
+/**
+ * Skip everything downstream of a failed event (called with mutex held)
+ */
+static void parallel_skip_dependents(ParallelExecutor *exec, size_t failed_index) {
+    /* Each event is pushed at most once: the failed one, then each
+     * dependent as it turns from pending to skipped */
+    size_t *stack = exec->skip_stack;
+    size_t depth = 0;
+    stack[depth++] = failed_index;
+
+    while (depth > 0) {
+        size_t current = stack[--depth];
+
+        for (size_t i = exec->dependent_offsets[current];
+             i < exec->dependent_offsets[current + 1]; i++) {
+            size_t dep = exec->dependents[i];
+            if (exec->state[dep] != PARALLEL_EVENT_PENDING) continue;
+
+            exec->state[dep] = PARALLEL_EVENT_SKIPPED;
+            exec->unfinished--;
+
+            char message[EVENTCHAINS_MAX_ERROR_LENGTH];
+            snprintf(message, sizeof(message), "Skipped: prerequisite '%s' failed",
+                     exec->chain->events[current]->name);
+            parallel_record_failure(exec, dep, message, EC_ERROR_EVENT_EXECUTION_FAILED);
+
+            stack[depth++] = dep;
+        }
+    }
+}
+
+/**
+ * Apply an event's outcome to the schedule (called with mutex held)
+ */
+static void parallel_complete_event(
+    ParallelExecutor *exec,
+    size_t index,
+    EventResult *event_result
+) {
+    EventChain *chain = exec->chain;
+
+    exec->in_flight--;
+    exec->unfinished--;
+    exec->memory_in_flight -= parallel_memory_cost(exec, index);
+
+    if (event_result->success) {
+        exec->state[index] = PARALLEL_EVENT_SUCCEEDED;
+
+        for (size_t i = exec->dependent_offsets[index];
+             i < exec->dependent_offsets[index + 1]; i++) {
+            size_t dep = exec->dependents[i];
+            if (--exec->pending[dep] == 0 &&
+                exec->state[dep] == PARALLEL_EVENT_PENDING) {
+                parallel_ready_push(exec, dep);
+            }
+        }
+        return;
+    }
+
+    exec->state[index] = PARALLEL_EVENT_FAILED;
+
+    /* Handle failure based on fault tolerance mode */
+    bool should_continue = false;
+
+    switch (chain->fault_tolerance) {
+        case FAULT_TOLERANCE_STRICT:
+            should_continue = false;
+            break;
+
+        case FAULT_TOLERANCE_LENIENT:
+        case FAULT_TOLERANCE_BEST_EFFORT:
+            should_continue = true;
+            break;
+
+        case FAULT_TOLERANCE_CUSTOM:
+            if (chain->failure_handler) {
+                should_continue = chain->failure_handler(
+                    chain,
+                    chain->events[index],
+                    event_result,
+                    chain->failure_handler_data
+                );
+            } else {
+                should_continue = false;
+            }
+            break;
+    }
+
+    parallel_record_failure(exec, index, event_result->error_message,
+                            event_result->error_code);
+
+    if (!should_continue) {
+        exec->stop = true;
+        exec->success = false;
+        return;
+    }
+
+    parallel_skip_dependents(exec, index);
+}
+
+static void *parallel_worker(void *arg) {
+    ParallelExecutor *exec = (ParallelExecutor *)arg;
+
+    ec_mutex_lock(&exec->mutex);
+    current_worker_index = exec->next_worker++;
+
+    for (;;) {
+        while (!exec->stop && exec->unfinished > 0 &&
+               !parallel_can_dispatch(exec) && exec->in_flight > 0) {
+            ec_cond_wait(&exec->cond, &exec->mutex);
+        }
+
+        if (exec->stop || exec->unfinished == 0) break;
+
+        if (exec->ready_count == 0) {
+            /* Nothing ready and nothing running: the remaining events can
+             * never become ready. Dependencies only point backwards, so this
+             * is purely defensive. */
+            exec->stop = true;
+            exec->success = false;
+            break;
+        }
+
+        size_t index = parallel_ready_pop(exec);
+        exec->state[index] = PARALLEL_EVENT_RUNNING;
+        exec->in_flight++;
+        exec->memory_in_flight += parallel_memory_cost(exec, index);
+
+        ec_mutex_unlock(&exec->mutex);
+
+        EventResult event_result;
+        execute_event_with_middleware(exec->chain, exec->chain->events[index],
+                                      &event_result);
+
+        ec_mutex_lock(&exec->mutex);
+        parallel_complete_event(exec, index, &event_result);
+        ec_cond_broadcast(&exec->cond);
+    }
+
+    ec_cond_broadcast(&exec->cond);
+    ec_mutex_unlock(&exec->mutex);
+    return NULL;
+}
+
+static int compare_parallel_failures(const void *a, const void *b) {
+    size_t ia = ((const ParallelFailure *)a)->event_index;
+    size_t ib = ((const ParallelFailure *)b)->event_index;
+    return (ia > ib) - (ia < ib);
+}
+
+static bool parallel_executor_init(ParallelExecutor *exec, EventChain *chain) {
+    size_t n = chain->event_count;
+
+    memset(exec, 0, sizeof(ParallelExecutor));
+    exec->chain = chain;
+    exec->unfinished = n;
+    exec->success = true;
+
+    exec->dependent_offsets = calloc(n + 1, sizeof(size_t));
+    exec->dependents = malloc((chain->dependency_count + 1) * sizeof(size_t));
+    exec->pending = calloc(n, sizeof(size_t));
+    exec->state = calloc(n, sizeof(unsigned char));
+    exec->ready = malloc(n * sizeof(size_t));
+    exec->skip_stack = malloc(n * sizeof(size_t));
+
+    if (!exec->dependent_offsets || !exec->dependents || !exec->pending ||
+        !exec->state || !exec->ready || !exec->skip_stack) {
+        return false;
+    }
+
+    /* Counting sort of the edge list into per-prerequisite rows */
+    for (size_t i = 0; i < chain->dependency_count; i++) {
+        exec->dependent_offsets[chain->dependencies[i].prerequisite_index + 1]++;
+        exec->pending[chain->dependencies[i].event_index]++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        exec->dependent_offsets[i + 1] += exec->dependent_offsets[i];
+    }
+
+    size_t *fill = malloc((n + 1) * sizeof(size_t));
+    if (!fill) return false;
+    memcpy(fill, exec->dependent_offsets, (n + 1) * sizeof(size_t));
+    for (size_t i = 0; i < chain->dependency_count; i++) {
+        size_t pre = chain->dependencies[i].prerequisite_index;
+        exec->dependents[fill[pre]++] = chain->dependencies[i].event_index;
+    }
+    free(fill);
+
+    for (size_t i = 0; i < n; i++) {
+        if (exec->pending[i] == 0) {
+            parallel_ready_push(exec, i);
+        }
+    }
+
+    if (ec_mutex_init(&exec->mutex) != 0) return false;
+    if (ec_cond_init(&exec->cond) != 0) {
+        ec_mutex_destroy(&exec->mutex);
+        return false;
+    }
+
+    return true;
+}
+
+static void parallel_executor_free(ParallelExecutor *exec) {
+    free(exec->dependent_offsets);
+    free(exec->dependents);
+    free(exec->pending);
+    free(exec->state);
+    free(exec->ready);
+    free(exec->skip_stack);
+    free(exec->failures);
+}
+
+void event_chain_execute_parallel(
+    EventChain *chain,
+    size_t worker_count,
+    ChainResult *result_ptr
+) {
+    if (!chain || !result_ptr || worker_count <= 1 || chain->event_count <= 1) {
+        event_chain_execute(chain, result_ptr);
+        return;
+    }
+
+    /* Check for reentrancy */
+    int expected = 0;
+    if (!ec_atomic_compare_exchange_strong(&chain->is_executing, &expected, 1)) {
+        result_ptr->success = false;
+        result_ptr->failures = NULL;
+        result_ptr->failure_count = 0;
+        return;
+    }
+
+    /* Initialize result */
+    result_ptr->success = true;
+    result_ptr->failures = NULL;
+    result_ptr->failure_count = 0;
+
+    ParallelExecutor exec;
+    if (!parallel_executor_init(&exec, chain)) {
+        parallel_executor_free(&exec);
+        ec_atomic_store(&chain->is_executing, 0);
+        result_ptr->success = false;
+        return;
+    }
+
+    if (worker_count > chain->event_count) {
+        worker_count = chain->event_count;
+    }
+
+    size_t saved_worker_index = current_worker_index;
+    run_batch_hooks(chain, worker_count, true);
+
+    ec_thread_t *threads = malloc(worker_count * sizeof(ec_thread_t));
+    size_t started = 0;
+    if (threads) {
+        for (; started < worker_count; started++) {
+            if (ec_thread_create(&threads[started], parallel_worker, &exec) != 0) {
+                break;
+            }
+        }
+    }
+
+    if (started == 0) {
+        /* Could not spawn any worker; run the schedule on this thread */
+        parallel_worker(&exec);
+    }
+
+    for (size_t i = 0; i < started; i++) {
+        ec_thread_join(threads[i]);
+    }
+    free(threads);
+    current_worker_index = saved_worker_index;
+
+    run_batch_hooks(chain, worker_count, false);
+
+    ec_cond_destroy(&exec.cond);
+    ec_mutex_destroy(&exec.mutex);
+
+    /* Report failures in event order so output is reproducible */
+    if (exec.failure_count > 0) {
+        qsort(exec.failures, exec.failure_count, sizeof(ParallelFailure),
+              compare_parallel_failures);
+
+        FailureInfo *failures = malloc(exec.failure_count * sizeof(FailureInfo));
+        if (failures) {
+            for (size_t i = 0; i < exec.failure_count; i++) {
+                failures[i] = exec.failures[i].info;
+            }
+            result_ptr->failures = failures;
+            result_ptr->failure_count = exec.failure_count;
+        }
+    }
+
+    result_ptr->success = exec.success;
+    parallel_executor_free(&exec);
+
     /* Mark execution as complete */
     ec_atomic_store(&chain->is_executing, 0);
 
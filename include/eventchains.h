@@ -51,15 +51,12 @@ extern "C" {
  * ==============================================================================
  */
 
-/* Maximum number of events in a chain */
-#define EVENTCHAINS_MAX_EVENTS 1024
+/* Maximum number of events in a chain (a build has one per translation unit) */
+#define EVENTCHAINS_MAX_EVENTS 1048576
 
 /* Maximum number of middleware in a chain */
 #define EVENTCHAINS_MAX_MIDDLEWARE 16
 
-/* Maximum number of context entries */
-#define EVENTCHAINS_MAX_CONTEXT_ENTRIES 512
-
 /* Maximum context memory (10 MB) */
 #define EVENTCHAINS_MAX_CONTEXT_MEMORY 10485760
 
@@ -153,6 +150,13 @@ typedef void (*MiddlewareExecuteFunc)(
     void *user_data
 );
 
+/**
+ * MiddlewareBatchFunc - Hook run once around a whole chain execution
+ */
+typedef struct EventBatch EventBatch;
+
+typedef void (*MiddlewareBatchFunc)(const EventBatch *batch, void *user_data);
+
 /**
  * FailureHandlerFunc - Custom failure handler for FAULT_TOLERANCE_CUSTOM mode
  */
@@ -189,22 +193,27 @@ struct RefCountedValue {
 };
 
 /**
- * ContextEntry - Single key-value pair in context
+ * ContextEntry - One slot of the context's hash table
  */
 typedef struct ContextEntry {
-    char *key;
+    char *key;                              /* NULL for an empty slot */
     RefCountedValue *value;
+    uint64_t hash;                          /* Hash of key */
 } ContextEntry;
 
 /**
  * EventContext - Thread-safe key-value storage
+ *
+ * An open-addressing hash table with linear probing, kept at most three
+ * quarters full. Lookups take the lock shared, so parallel events reading
+ * the context do not wait for each other; only changes are exclusive.
  */
 struct EventContext {
-    ContextEntry *entries;
-    size_t count;
-    size_t capacity;
+    ContextEntry *entries;                  /* capacity slots */
+    size_t count;                           /* Occupied slots */
+    size_t capacity;                        /* Power of two */
     size_t total_memory_bytes;
-    ec_mutex_t mutex;
+    ec_rwlock_t lock;
 };
 
 /**
@@ -221,10 +230,50 @@ struct ChainableEvent {
  */
 struct EventMiddleware {
     MiddlewareExecuteFunc execute;
+    MiddlewareBatchFunc before_batch;       /* Can be NULL */
+    MiddlewareBatchFunc after_batch;        /* Can be NULL */
     void *user_data;
     char name[EVENTCHAINS_MAX_NAME_LENGTH];
 };
 
+/**
+ * EventBatch - The events one chain execution is about to run, or just ran
+ *
+ * worker_count bounds event_chain_worker_index() for every event in the
+ * batch, so a middleware can keep one slot per worker and update it
+ * without locking.
+ */
+struct EventBatch {
+    EventChain *chain;
+    ChainableEvent *const *events;
+    size_t event_count;
+    size_t worker_count;
+};
+
+/**
+ * EventDependency - Ordering edge between two events in a chain
+ *
+ * The event at event_index may only start once the event at
+ * prerequisite_index has completed successfully. Only honored by the
+ * parallel executor; sequential execution already runs in insertion order.
+ */
+typedef struct EventDependency {
+    size_t event_index;
+    size_t prerequisite_index;
+} EventDependency;
+
+/**
+ * EventSchedule - Scheduling hints for one event
+ *
+ * Among events that are ready, the parallel executor starts the one with
+ * the highest priority first. An event's memory cost counts against the
+ * chain's memory budget while it runs.
+ */
+typedef struct EventSchedule {
+    double priority;
+    uint64_t memory_cost;
+} EventSchedule;
+
 /**
  * EventChain - Collection of events with middleware
  */
@@ -233,9 +282,18 @@ struct EventChain {
     size_t event_count;
     size_t event_capacity;
 
+    EventDependency *dependencies;
+    size_t dependency_count;
+    size_t dependency_capacity;
+
+    EventSchedule *schedule;                /* Per event, or NULL when no hints were set */
+    size_t schedule_count;
+    uint64_t memory_budget;                 /* Largest memory cost in flight, 0 = unlimited */
+
     EventMiddleware **middlewares;
     size_t middleware_count;
     size_t middleware_capacity;
+    struct MiddlewareStage *pipeline;       /* Flattened middlewares, rebuilt as they are added */
 
     EventContext *context;
     FaultToleranceMode fault_tolerance;
@@ -356,7 +414,10 @@ size_t event_chain_get_max_middleware(void);
 
 /**
  * Get maximum number of context entries
- * @return Maximum context entry count
+ *
+ * Entries are only limited by EVENTCHAINS_MAX_CONTEXT_MEMORY.
+ *
+ * @return SIZE_MAX
  */
 size_t event_chain_get_max_context_entries(void);
 
@@ -658,6 +719,34 @@ EventMiddleware *event_middleware_create(
  */
 void event_middleware_destroy(EventMiddleware *middleware);
 
+/**
+ * Set hooks run once per chain execution rather than once per event
+ *
+ * before_batch hooks run in middleware order before the first event
+ * starts; after_batch hooks run in reverse order once every event has
+ * finished. Batch hooks run on the executing thread, never concurrently
+ * with events of the same chain.
+ *
+ * @param middleware    Pointer to EventMiddleware
+ * @param before_batch  Hook run before the batch (can be NULL)
+ * @param after_batch   Hook run after the batch (can be NULL)
+ */
+void event_middleware_set_batch_hooks(
+    EventMiddleware *middleware,
+    MiddlewareBatchFunc before_batch,
+    MiddlewareBatchFunc after_batch
+);
+
+/**
+ * Index of the worker running the calling event
+ *
+ * 0 in sequential execution, otherwise below the worker_count of the
+ * current EventBatch. Meant for middleware keeping per-worker state.
+ *
+ * @return  Worker index of the calling thread
+ */
+size_t event_chain_worker_index(void);
+
 /**
  * Execute an event with middleware pipeline
  * @param chain       Pointer to EventChain
@@ -738,6 +827,56 @@ EventChainErrorCode event_chain_set_failure_handler(
  */
 EventContext *event_chain_get_context(EventChain *chain);
 
+/**
+ * Declare that one event must wait for another to succeed
+ *
+ * Events are identified by their insertion index. The prerequisite must have
+ * been added before the dependent event, which keeps the graph acyclic and
+ * consistent with sequential execution order.
+ *
+ * @param chain               Pointer to EventChain
+ * @param event_index         Index of the dependent event
+ * @param prerequisite_index  Index of the event it waits for
+ * @return                    EC_SUCCESS or error code
+ */
+EventChainErrorCode event_chain_add_dependency(
+    EventChain *chain,
+    size_t event_index,
+    size_t prerequisite_index
+);
+
+/**
+ * Give an event a scheduling priority and memory cost
+ *
+ * Only honored by the parallel executor. Events without hints have
+ * priority 0 and cost nothing.
+ *
+ * @param chain        Pointer to EventChain
+ * @param event_index  Index of the event
+ * @param priority     Higher starts sooner among ready events
+ * @param memory_cost  Memory the event needs while it runs, in bytes
+ * @return             EC_SUCCESS or error code
+ */
+EventChainErrorCode event_chain_set_event_schedule(
+    EventChain *chain,
+    size_t event_index,
+    double priority,
+    uint64_t memory_cost
+);
+
+/**
+ * Limit the total memory cost of the events running at once
+ *
+ * An event that would take the running total past the budget waits for
+ * others to finish; one is always allowed to run, so an event costing
+ * more than the whole budget runs alone.
+ *
+ * @param chain   Pointer to EventChain
+ * @param budget  Budget in bytes, 0 for no limit
+ * @return        EC_SUCCESS or error code
+ */
+EventChainErrorCode event_chain_set_memory_budget(EventChain *chain, uint64_t budget);
+
 /**
  * Execute the entire event chain
  * @param chain       Pointer to EventChain
@@ -745,6 +884,31 @@ EventContext *event_chain_get_context(EventChain *chain);
  */
 void event_chain_execute(EventChain *chain, ChainResult *result_ptr);
 
+/**
+ * Execute the event chain on a pool of worker threads
+ *
+ * Events whose prerequisites have all succeeded are dispatched to up to
+ * worker_count threads, highest priority first and otherwise in insertion
+ * order (see event_chain_set_event_schedule), within the chain's memory
+ * budget. Fault tolerance follows the
+ * chain's mode: STRICT stops dispatching after the first failure and waits
+ * for in-flight events; LENIENT and BEST_EFFORT keep going but skip events
+ * whose prerequisites failed (recorded as failures). Failures are reported
+ * in event order regardless of completion order.
+ *
+ * Middleware and event functions must be thread-safe when worker_count > 1.
+ * A worker_count of 0 or 1 falls back to event_chain_execute().
+ *
+ * @param chain         Pointer to EventChain
+ * @param worker_count  Maximum number of events executing at once
+ * @param result_ptr    Pointer to store ChainResult
+ */
+void event_chain_execute_parallel(
+    EventChain *chain,
+    size_t worker_count,
+    ChainResult *result_ptr
+);
+
 /**
  * Check if the chain was interrupted by a signal
  * @param chain  Pointer to EventChain
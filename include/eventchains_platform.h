@@ -175,6 +175,146 @@ extern "C" {
     #error "Unsupported platform for threading"
 #endif
 
+/* ==============================================================================
+ * Reader-Writer Lock Abstraction
+ * ==============================================================================
+ */
+
+#if EC_PLATFORM_POSIX
+    typedef pthread_rwlock_t ec_rwlock_t;
+
+    #define ec_rwlock_init(lock) pthread_rwlock_init(lock, NULL)
+    #define ec_rwlock_destroy(lock) pthread_rwlock_destroy(lock)
+    #define ec_rwlock_read_lock(lock) pthread_rwlock_rdlock(lock)
+    #define ec_rwlock_read_unlock(lock) pthread_rwlock_unlock(lock)
+    #define ec_rwlock_write_lock(lock) pthread_rwlock_wrlock(lock)
+    #define ec_rwlock_write_unlock(lock) pthread_rwlock_unlock(lock)
+
+#elif EC_PLATFORM_WINDOWS
+    /* Slim reader-writer locks: no cleanup, and shared and exclusive
+     * ownership are released separately */
+    typedef SRWLOCK ec_rwlock_t;
+
+    static inline int ec_rwlock_init(ec_rwlock_t *lock) {
+        InitializeSRWLock(lock);
+        return 0;
+    }
+
+    static inline int ec_rwlock_destroy(ec_rwlock_t *lock) {
+        (void)lock;
+        return 0;
+    }
+
+    static inline int ec_rwlock_read_lock(ec_rwlock_t *lock) {
+        AcquireSRWLockShared(lock);
+        return 0;
+    }
+
+    static inline int ec_rwlock_read_unlock(ec_rwlock_t *lock) {
+        ReleaseSRWLockShared(lock);
+        return 0;
+    }
+
+    static inline int ec_rwlock_write_lock(ec_rwlock_t *lock) {
+        AcquireSRWLockExclusive(lock);
+        return 0;
+    }
+
+    static inline int ec_rwlock_write_unlock(ec_rwlock_t *lock) {
+        ReleaseSRWLockExclusive(lock);
+        return 0;
+    }
+#endif
+
+/* ==============================================================================
+ * Thread and Condition Variable Abstraction
+ * ==============================================================================
+ */
+
+/* Thread entry point signature (POSIX style on every platform) */
+typedef void *(*ec_thread_func_t)(void *arg);
+
+#if EC_PLATFORM_POSIX
+    typedef pthread_t ec_thread_t;
+    typedef pthread_cond_t ec_cond_t;
+
+    static inline int ec_thread_create(ec_thread_t *thread, ec_thread_func_t func, void *arg) {
+        return pthread_create(thread, NULL, func, arg);
+    }
+
+    static inline int ec_thread_join(ec_thread_t thread) {
+        return pthread_join(thread, NULL);
+    }
+
+    #define ec_cond_init(cond) pthread_cond_init(cond, NULL)
+    #define ec_cond_destroy(cond) pthread_cond_destroy(cond)
+    #define ec_cond_wait(cond, mutex) pthread_cond_wait(cond, mutex)
+    #define ec_cond_signal(cond) pthread_cond_signal(cond)
+    #define ec_cond_broadcast(cond) pthread_cond_broadcast(cond)
+
+#elif EC_PLATFORM_WINDOWS
+    typedef HANDLE ec_thread_t;
+    typedef CONDITION_VARIABLE ec_cond_t;
+
+    /* Win32 threads use a different entry signature, so trampoline through a
+     * small heap record that carries the POSIX-style function and argument. */
+    typedef struct ec_thread_start {
+        ec_thread_func_t func;
+        void *arg;
+    } ec_thread_start;
+
+    static DWORD WINAPI ec_thread_trampoline(LPVOID param) {
+        ec_thread_start start = *(ec_thread_start *)param;
+        HeapFree(GetProcessHeap(), 0, param);
+        start.func(start.arg);
+        return 0;
+    }
+
+    static inline int ec_thread_create(ec_thread_t *thread, ec_thread_func_t func, void *arg) {
+        ec_thread_start *start = (ec_thread_start *)HeapAlloc(
+            GetProcessHeap(), 0, sizeof(ec_thread_start));
+        if (!start) return -1;
+        start->func = func;
+        start->arg = arg;
+        *thread = CreateThread(NULL, 0, ec_thread_trampoline, start, 0, NULL);
+        if (*thread == NULL) {
+            HeapFree(GetProcessHeap(), 0, start);
+            return -1;
+        }
+        return 0;
+    }
+
+    static inline int ec_thread_join(ec_thread_t thread) {
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+        return 0;
+    }
+
+    static inline int ec_cond_init(ec_cond_t *cond) {
+        InitializeConditionVariable(cond);
+        return 0;
+    }
+
+    static inline int ec_cond_destroy(ec_cond_t *cond) {
+        (void)cond;  /* Win32 condition variables need no cleanup */
+        return 0;
+    }
+
+    static inline int ec_cond_wait(ec_cond_t *cond, ec_mutex_t *mutex) {
+        return SleepConditionVariableCS(cond, mutex, INFINITE) ? 0 : -1;
+    }
+
+    static inline int ec_cond_signal(ec_cond_t *cond) {
+        WakeConditionVariable(cond);
+        return 0;
+    }
+
+    static inline int ec_cond_broadcast(ec_cond_t *cond) {
+        WakeAllConditionVariable(cond);
+        return 0;
+    }
+#endif
+
 /* ==============================================================================
  * Utility Macros
  * ==============================================================================
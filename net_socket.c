@@ -0,0 +1,161 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - TCP Sockets Implementation
+ * ==============================================================================
+ */
+
+#ifdef _WIN32
+    /* Winsock must come before anything that pulls in windows.h */
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+#include "net_socket.h"
+#include <string.h>
+
+#ifdef _WIN32
+    #define close_socket closesocket
+#else
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+    #define close_socket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0                      /* A closed peer must not raise SIGPIPE */
+#endif
+
+#define NET_CHUNK (64u * 1024)                  /* Largest single send or receive */
+
+bool net_startup(void) {
+#ifdef _WIN32
+    WSADATA wsa;
+    return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+#else
+    return true;
+#endif
+}
+
+void net_cleanup(void) {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+static void set_timeouts(net_socket_t sock, int timeout_ms) {
+#ifdef _WIN32
+    DWORD timeout = (DWORD)timeout_ms;
+#else
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+}
+
+net_socket_t net_connect(const char *host, const char *port, int timeout_ms) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo *addresses = NULL;
+    if (getaddrinfo(host, port, &hints, &addresses) != 0) return NET_SOCKET_NONE;
+
+    net_socket_t sock = NET_SOCKET_NONE;
+    for (struct addrinfo *ai = addresses; ai; ai = ai->ai_next) {
+        sock = (net_socket_t)socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (sock == NET_SOCKET_NONE) continue;
+
+        set_timeouts(sock, timeout_ms);
+        if (connect(sock, ai->ai_addr, (int)ai->ai_addrlen) == 0) break;
+
+        close_socket(sock);
+        sock = NET_SOCKET_NONE;
+    }
+
+    freeaddrinfo(addresses);
+    return sock;
+}
+
+net_socket_t net_listen(const char *host, const char *port) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    struct addrinfo *addresses = NULL;
+    if (getaddrinfo(host, port, &hints, &addresses) != 0) return NET_SOCKET_NONE;
+
+    net_socket_t sock = NET_SOCKET_NONE;
+    for (struct addrinfo *ai = addresses; ai; ai = ai->ai_next) {
+        sock = (net_socket_t)socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (sock == NET_SOCKET_NONE) continue;
+
+        int reuse = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+        if (bind(sock, ai->ai_addr, (int)ai->ai_addrlen) == 0 && listen(sock, 64) == 0) break;
+
+        close_socket(sock);
+        sock = NET_SOCKET_NONE;
+    }
+
+    freeaddrinfo(addresses);
+    return sock;
+}
+
+int net_local_port(net_socket_t sock) {
+    struct sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    if (getsockname(sock, (struct sockaddr *)&address, &length) != 0) return 0;
+
+    if (address.ss_family == AF_INET) {
+        return ntohs(((struct sockaddr_in *)&address)->sin_port);
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(((struct sockaddr_in6 *)&address)->sin6_port);
+    }
+    return 0;
+}
+
+net_socket_t net_accept(net_socket_t listener, int timeout_ms) {
+    net_socket_t sock = (net_socket_t)accept(listener, NULL, NULL);
+    if (sock != NET_SOCKET_NONE) set_timeouts(sock, timeout_ms);
+    return sock;
+}
+
+bool net_send_all(net_socket_t sock, const void *data, size_t length) {
+    const char *bytes = (const char *)data;
+    while (length > 0) {
+        int sent = (int)send(sock, bytes, (int)(length > NET_CHUNK ? NET_CHUNK : length),
+                             MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        bytes += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+long net_recv(net_socket_t sock, void *buffer, size_t length) {
+    return (long)recv(sock, (char *)buffer, (int)(length > NET_CHUNK ? NET_CHUNK : length), 0);
+}
+
+bool net_recv_all(net_socket_t sock, void *buffer, size_t length) {
+    char *bytes = (char *)buffer;
+    while (length > 0) {
+        long count = net_recv(sock, bytes, length);
+        if (count <= 0) return false;
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return true;
+}
+
+void net_close(net_socket_t sock) {
+    if (sock != NET_SOCKET_NONE) close_socket(sock);
+}
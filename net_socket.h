@@ -0,0 +1,114 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - TCP Sockets
+ * ==============================================================================
+ *
+ * The few socket operations the remote cache and distributed compilation
+ * need, over BSD sockets on POSIX and Winsock on Windows. Every socket
+ * made here has send and receive timeouts, and sends never raise SIGPIPE.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+    typedef uintptr_t net_socket_t;             /* SOCKET */
+    #define NET_SOCKET_NONE ((net_socket_t)~(uintptr_t)0)
+#else
+    typedef int net_socket_t;
+    #define NET_SOCKET_NONE (-1)
+#endif
+
+/**
+ * Initialize the socket library (a no-op outside Windows)
+ *
+ * Calls nest; each successful net_startup needs a net_cleanup.
+ *
+ * @return  true on success
+ */
+bool net_startup(void);
+
+/**
+ * Release the socket library
+ */
+void net_cleanup(void);
+
+/**
+ * Connect to a host
+ *
+ * @param host        Host name or address
+ * @param port        Port number or service name
+ * @param timeout_ms  Send and receive timeout for the connection
+ * @return            Connected socket, or NET_SOCKET_NONE
+ */
+net_socket_t net_connect(const char *host, const char *port, int timeout_ms);
+
+/**
+ * Listen for connections
+ *
+ * @param host  Address to bind (NULL for every interface)
+ * @param port  Port ("0" for any free port)
+ * @return      Listening socket, or NET_SOCKET_NONE
+ */
+net_socket_t net_listen(const char *host, const char *port);
+
+/**
+ * Port a listening socket is bound to
+ *
+ * @param sock  Listening socket
+ * @return      Port number, or 0 on error
+ */
+int net_local_port(net_socket_t sock);
+
+/**
+ * Accept one connection
+ *
+ * @param listener    Listening socket
+ * @param timeout_ms  Send and receive timeout for the connection
+ * @return            Connected socket, or NET_SOCKET_NONE
+ */
+net_socket_t net_accept(net_socket_t listener, int timeout_ms);
+
+/**
+ * Send a whole buffer
+ *
+ * @return  true if every byte was sent
+ */
+bool net_send_all(net_socket_t sock, const void *data, size_t length);
+
+/**
+ * Receive up to length bytes
+ *
+ * @return  Bytes received, 0 when the peer closed, negative on error or timeout
+ */
+long net_recv(net_socket_t sock, void *buffer, size_t length);
+
+/**
+ * Receive exactly length bytes
+ *
+ * @return  true if every byte arrived
+ */
+bool net_recv_all(net_socket_t sock, void *buffer, size_t length);
+
+/**
+ * Close a socket
+ */
+void net_close(net_socket_t sock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCKET_H */
@@ -0,0 +1,932 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Shared Object Store Implementation
+ * ==============================================================================
+ */
+
+#include "object_store.h"
+#include "content_hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #include <sys/utime.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define getpid _getpid
+    #define utime _utime
+    #define stat _stat
+    #define S_ISDIR(m) (((m) & _S_IFMT) == _S_IFDIR)
+    #define S_ISREG(m) (((m) & _S_IFMT) == _S_IFREG)
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define OBJECT_KEY_MIN_CAPACITY 256
+#define OBJECT_STORE_VERSION "ecbuild-object-store-1"
+#define OBJECT_STORE_TEMP_MARKER ".tmp."
+#define OBJECT_STORE_STALE_TEMP_SECONDS 3600    /* Leftovers of an interrupted insert */
+#define OBJECT_STORE_COPY_BUFFER (64u * 1024)
+
+/* ==============================================================================
+ * Keys
+ * ==============================================================================
+ */
+
+static void object_key_append(ObjectKey *key, const void *bytes, size_t length) {
+    if (key->failed) return;
+
+    if (key->length + length > key->capacity) {
+        size_t new_capacity = key->capacity == 0 ? OBJECT_KEY_MIN_CAPACITY : key->capacity;
+        while (new_capacity < key->length + length) new_capacity *= 2;
+
+        unsigned char *new_data = realloc(key->data, new_capacity);
+        if (!new_data) {
+            key->failed = true;
+            return;
+        }
+        key->data = new_data;
+        key->capacity = new_capacity;
+    }
+
+    memcpy(key->data + key->length, bytes, length);
+    key->length += length;
+}
+
+void object_key_init(ObjectKey *key, const ObjectStore *store) {
+    if (!key) return;
+    key->data = NULL;
+    key->length = 0;
+    key->capacity = 0;
+    key->failed = false;
+
+    if (store) object_key_add_u64(key, store->toolchain_hash);
+}
+
+void object_key_destroy(ObjectKey *key) {
+    if (!key) return;
+    free(key->data);
+    key->data = NULL;
+    key->length = 0;
+    key->capacity = 0;
+}
+
+void object_key_add_u64(ObjectKey *key, uint64_t value) {
+    if (!key) return;
+
+    /* Little-endian regardless of host, so keys agree between machines */
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+    object_key_append(key, bytes, sizeof(bytes));
+}
+
+void object_key_add_string(ObjectKey *key, const char *str) {
+    if (!key) return;
+
+    size_t length = str ? strlen(str) : 0;
+    object_key_add_u64(key, (uint64_t)length);
+    if (length > 0) object_key_append(key, str, length);
+}
+
+bool object_key_finish(const ObjectKey *key, char *dest) {
+    if (!key || !dest || key->failed) return false;
+
+    /* SHA-256, so a remote cache can treat the key as a digest */
+    uint8_t digest[32];
+    content_hash_sha256(key->data, key->length, digest);
+    for (size_t i = 0; i < sizeof(digest); i++) {
+        snprintf(dest + 2 * i, 3, "%02x", digest[i]);
+    }
+    return true;
+}
+
+static int compare_source_paths(const void *a, const void *b) {
+    const SourceFile *x = *(const SourceFile *const *)a;
+    const SourceFile *y = *(const SourceFile *const *)b;
+    return strcmp(x->path, y->path);
+}
+
+bool object_store_key_for_source(
+    const ObjectStore *store,
+    BuildCache *cache,
+    DependencyGraph *graph,
+    const SourceFile *source,
+    char *dest
+) {
+    /* Without the graph the dependencies are unknown */
+    if (!graph || !source || !dest ||
+        source->id >= graph->file_count || graph->files[source->id] != source) {
+        return false;
+    }
+
+    uint64_t source_hash = build_cache_file_hash(cache, source->path);
+    if (source_hash == 0) return false;
+
+    SourceFile **deps = malloc(graph->file_count * sizeof(SourceFile *));
+    size_t dep_count = 0;
+    if (!deps || dependency_graph_get_all_dependencies(graph, graph->files[source->id], deps,
+                                                       graph->file_count,
+                                                       &dep_count) != DEP_SUCCESS) {
+        free(deps);
+        return false;
+    }
+    qsort(deps, dep_count, sizeof(SourceFile *), compare_source_paths);
+
+    ObjectKey key;
+    object_key_init(&key, store);
+    object_key_add_string(&key, source->path);
+    object_key_add_u64(&key, source_hash);
+    object_key_add_u64(&key, (uint64_t)dep_count);
+    for (size_t i = 0; i < dep_count; i++) {
+        object_key_add_string(&key, deps[i]->path);
+        object_key_add_u64(&key, build_cache_file_hash(cache, deps[i]->path));
+    }
+    free(deps);
+
+    bool ok = object_key_finish(&key, dest);
+    object_key_destroy(&key);
+    return ok;
+}
+
+/* ==============================================================================
+ * File Helpers
+ * ==============================================================================
+ */
+
+/**
+ * Check that a key is OBJECT_KEY_LENGTH lowercase hex digits
+ */
+static bool key_is_valid(const char *key) {
+    if (!key) return false;
+
+    size_t i = 0;
+    for (; key[i]; i++) {
+        char c = key[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return i == OBJECT_KEY_LENGTH;
+}
+
+static bool stored_object_path(const ObjectStore *store, const char *key,
+                               char *dest, size_t dest_size) {
+    if (!key_is_valid(key)) return false;
+    int written = snprintf(dest, dest_size, "%s/%.2s/%s.o", store->directory, key, key);
+    return written > 0 && (size_t)written < dest_size;
+}
+
+/**
+ * Create a directory and any missing parents
+ */
+static bool make_directories(const char *path) {
+    char partial[MAX_PATH_LENGTH];
+    size_t length = strlen(path);
+    if (length == 0 || length >= sizeof(partial)) return false;
+    memcpy(partial, path, length + 1);
+
+    for (size_t i = 1; i <= length; i++) {
+        if (partial[i] != '/' && partial[i] != '\\' && partial[i] != '\0') continue;
+
+        /* Skip the root and drive letters ("C:") */
+        if (i == 2 && partial[1] == ':') continue;
+
+        char saved = partial[i];
+        partial[i] = '\0';
+        mkdir(partial, 0755);
+        partial[i] = saved;
+    }
+
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool replace_file(const char *from, const char *to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+/**
+ * Name a temporary file beside dest, unique across threads and processes
+ */
+static bool temp_path_for(ObjectStore *store, const char *dest, char *temp, size_t temp_size) {
+    ec_mutex_lock(&store->lock);
+    unsigned long long counter = (unsigned long long)store->temp_counter++;
+    ec_mutex_unlock(&store->lock);
+
+    int written = snprintf(temp, temp_size, "%s" OBJECT_STORE_TEMP_MARKER "%ld.%llu",
+                           dest, (long)getpid(), counter);
+    return written > 0 && (size_t)written < temp_size;
+}
+
+/**
+ * Copy a file to a temporary name beside dest, then rename it into place
+ * so no reader ever sees a partial file
+ */
+static bool copy_file_atomic(ObjectStore *store, const char *source, const char *dest) {
+    char temp[MAX_PATH_LENGTH];
+    if (!temp_path_for(store, dest, temp, sizeof(temp))) return false;
+
+    FILE *in = fopen(source, "rb");
+    if (!in) return false;
+    FILE *out = fopen(temp, "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+
+    char *buffer = malloc(OBJECT_STORE_COPY_BUFFER);
+    bool ok = buffer != NULL;
+    while (ok) {
+        size_t count = fread(buffer, 1, OBJECT_STORE_COPY_BUFFER, in);
+        if (count == 0) {
+            ok = !ferror(in);
+            break;
+        }
+        ok = fwrite(buffer, 1, count, out) == count;
+    }
+    free(buffer);
+    fclose(in);
+    if (fclose(out) != 0) ok = false;
+
+    if (ok) ok = replace_file(temp, dest);
+    if (!ok) remove(temp);
+    return ok;
+}
+
+static bool link_file(const char *existing, const char *new_path) {
+#ifdef _WIN32
+    return CreateHardLinkA(new_path, existing, NULL) != 0;
+#else
+    return link(existing, new_path) == 0;
+#endif
+}
+
+/**
+ * Call visit for each entry of a directory except "." and ".."
+ */
+static bool for_each_entry(const char *directory,
+                           void (*visit)(const char *directory, const char *name, void *context),
+                           void *context) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA find_data;
+    char search_path[MAX_PATH_LENGTH];
+    snprintf(search_path, sizeof(search_path), "%s\\*", directory);
+
+    HANDLE find = FindFirstFileA(search_path, &find_data);
+    if (find == INVALID_HANDLE_VALUE) return false;
+
+    do {
+        const char *name = find_data.cFileName;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        visit(directory, name, context);
+    } while (FindNextFileA(find, &find_data));
+
+    FindClose(find);
+#else
+    DIR *dir = opendir(directory);
+    if (!dir) return false;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char *name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        visit(directory, name, context);
+    }
+
+    closedir(dir);
+#endif
+    return true;
+}
+
+/* ==============================================================================
+ * Remote Tier
+ * ==============================================================================
+ */
+
+typedef enum {
+    STORE_JOB_QUEUED,
+    STORE_JOB_RUNNING,
+    STORE_JOB_DONE
+} StoreJobState;
+
+struct StoreJob {
+    struct StoreJob *next;                  /* Upload queue link */
+    StoreJobState state;
+    char key[OBJECT_KEY_LENGTH + 1];
+};
+
+/**
+ * Download one object into the local store
+ */
+static bool remote_download(ObjectStore *store, const char *key) {
+    char stored[MAX_PATH_LENGTH];
+    if (!stored_object_path(store, key, stored, sizeof(stored))) return false;
+
+    struct stat st;
+    if (stat(stored, &st) == 0) return true;
+
+    char subdirectory[MAX_PATH_LENGTH];
+    snprintf(subdirectory, sizeof(subdirectory), "%s/%.2s", store->directory, key);
+    mkdir(subdirectory, 0755);
+
+    char temp[MAX_PATH_LENGTH];
+    bool hit = temp_path_for(store, stored, temp, sizeof(temp)) &&
+               store->remote->get(store->remote->self, key, temp) &&
+               replace_file(temp, stored);
+    if (!hit) remove(temp);
+
+    ec_mutex_lock(&store->lock);
+    if (hit) {
+        store->remote_hits++;
+    } else {
+        store->remote_misses++;
+    }
+    ec_mutex_unlock(&store->lock);
+    return hit;
+}
+
+static void remote_upload(ObjectStore *store, const char *key) {
+    char stored[MAX_PATH_LENGTH];
+    bool ok = stored_object_path(store, key, stored, sizeof(stored)) &&
+              store->remote->put(store->remote->self, key, stored);
+
+    ec_mutex_lock(&store->lock);
+    if (ok) {
+        store->uploads_done++;
+    } else {
+        store->upload_failures++;
+    }
+    ec_mutex_unlock(&store->lock);
+}
+
+/**
+ * Transfer thread: downloads in build order first, then uploads
+ */
+static void *store_worker(void *arg) {
+    ObjectStore *store = (ObjectStore *)arg;
+
+    ec_mutex_lock(&store->lock);
+    for (;;) {
+        while (store->next_download < store->download_count &&
+               store->downloads[store->next_download].state != STORE_JOB_QUEUED) {
+            store->next_download++;
+        }
+
+        struct StoreJob *job = NULL;
+        bool upload = false;
+        if (store->next_download < store->download_count) {
+            job = &store->downloads[store->next_download++];
+        } else if (store->uploads) {
+            job = store->uploads;
+            store->uploads = job->next;
+            if (!store->uploads) store->uploads_tail = NULL;
+            upload = true;
+        } else if (store->stopping) {
+            break;
+        } else {
+            ec_cond_wait(&store->jobs_changed, &store->lock);
+            continue;
+        }
+
+        job->state = STORE_JOB_RUNNING;
+        ec_mutex_unlock(&store->lock);
+
+        if (upload) {
+            remote_upload(store, job->key);
+        } else {
+            remote_download(store, job->key);
+        }
+
+        ec_mutex_lock(&store->lock);
+        job->state = STORE_JOB_DONE;
+        store->jobs_pending--;
+        if (upload) free(job);
+        ec_cond_broadcast(&store->jobs_changed);
+    }
+    ec_mutex_unlock(&store->lock);
+
+    return NULL;
+}
+
+static int compare_job_keys(const void *a, const void *b) {
+    const struct StoreJob *x = *(const struct StoreJob *const *)a;
+    const struct StoreJob *y = *(const struct StoreJob *const *)b;
+    return strcmp(x->key, y->key);
+}
+
+/**
+ * Find the prefetch of a key (called with lock held)
+ */
+static struct StoreJob *find_download(const ObjectStore *store, const char *key) {
+    size_t low = 0;
+    size_t high = store->download_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int order = strcmp(store->downloads_by_key[mid]->key, key);
+        if (order == 0) return store->downloads_by_key[mid];
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Get a locally missing object from the remote: wait for its prefetch if
+ * one is running, take the prefetch over if it has not started, or
+ * download it now
+ */
+static bool fetch_remote(ObjectStore *store, const char *key, const char *stored) {
+    ec_mutex_lock(&store->lock);
+    struct StoreJob *job = find_download(store, key);
+    bool claimed = false;
+    if (job && job->state == STORE_JOB_QUEUED) {
+        job->state = STORE_JOB_RUNNING;
+        claimed = true;
+    }
+    while (job && !claimed && job->state != STORE_JOB_DONE) {
+        ec_cond_wait(&store->jobs_changed, &store->lock);
+    }
+    ec_mutex_unlock(&store->lock);
+
+    bool hit;
+    if (!job || claimed) {
+        hit = remote_download(store, key);
+    } else {
+        struct stat st;
+        hit = stat(stored, &st) == 0;
+    }
+
+    if (claimed) {
+        ec_mutex_lock(&store->lock);
+        job->state = STORE_JOB_DONE;
+        store->jobs_pending--;
+        ec_cond_broadcast(&store->jobs_changed);
+        ec_mutex_unlock(&store->lock);
+    }
+    return hit;
+}
+
+static void queue_upload(ObjectStore *store, const char *key) {
+    struct StoreJob *job = malloc(sizeof(struct StoreJob));
+    if (!job) return;
+    job->next = NULL;
+    job->state = STORE_JOB_QUEUED;
+    snprintf(job->key, sizeof(job->key), "%s", key);
+
+    ec_mutex_lock(&store->lock);
+    if (store->uploads_tail) {
+        store->uploads_tail->next = job;
+    } else {
+        store->uploads = job;
+    }
+    store->uploads_tail = job;
+    store->jobs_pending++;
+    ec_cond_signal(&store->jobs_changed);
+    ec_mutex_unlock(&store->lock);
+}
+
+bool object_store_set_remote(ObjectStore *store, ObjectBackend *backend, bool upload) {
+    if (!backend) return false;
+    if (!store || store->remote || ec_cond_init(&store->jobs_changed) != 0) {
+        backend->destroy(backend);
+        return false;
+    }
+
+    store->workers = calloc(OBJECT_STORE_REMOTE_WORKERS, sizeof(ec_thread_t));
+    store->remote = backend;
+    store->remote_upload = upload;
+    store->stopping = false;
+
+    for (size_t i = 0; store->workers && i < OBJECT_STORE_REMOTE_WORKERS; i++) {
+        if (ec_thread_create(&store->workers[i], store_worker, store) != 0) break;
+        store->worker_count++;
+    }
+
+    if (store->worker_count == 0) {
+        free(store->workers);
+        store->workers = NULL;
+        store->remote = NULL;
+        ec_cond_destroy(&store->jobs_changed);
+        backend->destroy(backend);
+        return false;
+    }
+    return true;
+}
+
+size_t object_store_prefetch(ObjectStore *store, const char *const *keys, size_t count) {
+    if (!store || !store->remote || !keys || count == 0) return 0;
+
+    ec_mutex_lock(&store->lock);
+    bool busy = store->downloads != NULL;
+    ec_mutex_unlock(&store->lock);
+    if (busy) return 0;
+
+    struct StoreJob *jobs = malloc(count * sizeof(struct StoreJob));
+    struct StoreJob **by_key = malloc(count * sizeof(struct StoreJob *));
+    if (!jobs || !by_key) {
+        free(jobs);
+        free(by_key);
+        return 0;
+    }
+
+    size_t queued = 0;
+    for (size_t i = 0; i < count; i++) {
+        char stored[MAX_PATH_LENGTH];
+        struct stat st;
+        if (!stored_object_path(store, keys[i], stored, sizeof(stored)) ||
+            stat(stored, &st) == 0) {
+            continue;
+        }
+
+        struct StoreJob *job = &jobs[queued];
+        job->next = NULL;
+        job->state = STORE_JOB_QUEUED;
+        snprintf(job->key, sizeof(job->key), "%s", keys[i]);
+        by_key[queued++] = job;
+    }
+
+    if (queued == 0) {
+        free(jobs);
+        free(by_key);
+        return 0;
+    }
+    qsort(by_key, queued, sizeof(struct StoreJob *), compare_job_keys);
+
+    ec_mutex_lock(&store->lock);
+    store->downloads = jobs;
+    store->downloads_by_key = by_key;
+    store->download_count = queued;
+    store->next_download = 0;
+    store->jobs_pending += queued;
+    ec_cond_broadcast(&store->jobs_changed);
+    ec_mutex_unlock(&store->lock);
+
+    return queued;
+}
+
+void object_store_flush(ObjectStore *store) {
+    if (!store || !store->remote) return;
+
+    ec_mutex_lock(&store->lock);
+
+    /* Prefetches nobody waited for are no longer wanted */
+    for (size_t i = store->next_download; i < store->download_count; i++) {
+        if (store->downloads[i].state == STORE_JOB_QUEUED) {
+            store->downloads[i].state = STORE_JOB_DONE;
+            store->jobs_pending--;
+        }
+    }
+
+    while (store->jobs_pending > 0) {
+        ec_cond_wait(&store->jobs_changed, &store->lock);
+    }
+
+    free(store->downloads);
+    free(store->downloads_by_key);
+    store->downloads = NULL;
+    store->downloads_by_key = NULL;
+    store->download_count = 0;
+    store->next_download = 0;
+
+    ec_mutex_unlock(&store->lock);
+}
+
+/* ==============================================================================
+ * Store Implementation
+ * ==============================================================================
+ */
+
+ObjectStore *object_store_open(const char *directory, uint64_t max_bytes) {
+    if (!directory || directory[0] == '\0') return NULL;
+    if (!make_directories(directory)) return NULL;
+
+    ObjectStore *store = calloc(1, sizeof(ObjectStore));
+    if (!store) return NULL;
+
+    store->directory = strdup(directory);
+    if (!store->directory || ec_mutex_init(&store->lock) != 0) {
+        free(store->directory);
+        free(store);
+        return NULL;
+    }
+
+    /* Keep "dir/" and "dir" equivalent */
+    size_t length = strlen(store->directory);
+    while (length > 1 && (store->directory[length - 1] == '/' ||
+                          store->directory[length - 1] == '\\')) {
+        store->directory[--length] = '\0';
+    }
+
+    store->max_bytes = max_bytes ? max_bytes : OBJECT_STORE_DEFAULT_MAX_BYTES;
+    return store;
+}
+
+void object_store_close(ObjectStore *store) {
+    if (!store) return;
+
+    if (store->remote) {
+        object_store_flush(store);
+
+        ec_mutex_lock(&store->lock);
+        store->stopping = true;
+        ec_cond_broadcast(&store->jobs_changed);
+        ec_mutex_unlock(&store->lock);
+
+        for (size_t i = 0; i < store->worker_count; i++) {
+            ec_thread_join(store->workers[i]);
+        }
+        free(store->workers);
+        ec_cond_destroy(&store->jobs_changed);
+        store->remote->destroy(store->remote);
+    }
+
+    ec_mutex_destroy(&store->lock);
+    free(store->directory);
+    free(store);
+}
+
+bool object_store_set_toolchain(ObjectStore *store, const BuildConfig *config) {
+    if (!store || !config) return false;
+
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    char resolved[MAX_PATH_LENGTH];
+    if (!process_find_executable(compiler, resolved, sizeof(resolved))) {
+        return false;
+    }
+
+    ObjectKey key;
+    object_key_init(&key, NULL);
+    object_key_add_string(&key, OBJECT_STORE_VERSION);
+
+    /* Compiler identity */
+    struct stat st;
+    object_key_add_string(&key, resolved);
+    if (stat(resolved, &st) == 0) {
+        object_key_add_u64(&key, (uint64_t)st.st_size);
+        object_key_add_u64(&key, (uint64_t)st.st_mtime);
+    }
+
+    /* cl has no --version; its banner comes with no arguments at all */
+    char *const version_argv[] = {resolved, config->compiler == COMPILER_MSVC ? NULL
+                                                                             : "--version", NULL};
+    char version[4096] = {0};
+    int exit_code = 0;
+    process_run(version_argv, version, sizeof(version), &exit_code);
+    object_key_add_string(&key, version);
+
+    /* Everything compile_command_build turns into arguments */
+    object_key_add_u64(&key, (uint64_t)config->compiler);
+    object_key_add_string(&key, compiler);
+    object_key_add_u64(&key, (uint64_t)config->include_path_count);
+    for (size_t i = 0; i < config->include_path_count; i++) {
+        object_key_add_string(&key, config->include_paths[i]);
+    }
+    object_key_add_u64(&key, (uint64_t)config->cflag_count);
+    for (size_t i = 0; i < config->cflag_count; i++) {
+        object_key_add_string(&key, config->cflags[i]);
+    }
+    object_key_add_u64(&key, (uint64_t)config->use_depfiles);
+    object_key_add_u64(&key, (uint64_t)config->debug);
+    object_key_add_u64(&key, (uint64_t)config->optimize);
+
+    bool ok = !key.failed;
+    if (ok) store->toolchain_hash = content_hash_bytes(key.data, key.length);
+    object_key_destroy(&key);
+    return ok;
+}
+
+bool object_store_fetch(ObjectStore *store, const char *key, const char *object_path) {
+    if (!store || !object_path) return false;
+
+    char stored[MAX_PATH_LENGTH];
+    struct stat st;
+    bool valid = stored_object_path(store, key, stored, sizeof(stored));
+    bool placed = valid && stat(stored, &st) == 0;
+
+    if (valid && !placed && store->remote) {
+        placed = fetch_remote(store, key, stored);
+    }
+
+    if (placed) {
+        /* Never link over an existing file: it may itself be a link */
+        remove(object_path);
+        placed = link_file(stored, object_path) ||
+                 copy_file_atomic(store, stored, object_path);
+    }
+
+    if (placed) {
+        /* Recency for eviction */
+        utime(stored, NULL);
+    }
+
+    ec_mutex_lock(&store->lock);
+    if (placed) {
+        store->hits++;
+    } else {
+        store->misses++;
+    }
+    ec_mutex_unlock(&store->lock);
+
+    return placed;
+}
+
+bool object_store_insert(ObjectStore *store, const char *key, const char *object_path) {
+    if (!store || !object_path) return false;
+
+    char stored[MAX_PATH_LENGTH];
+    if (!stored_object_path(store, key, stored, sizeof(stored))) return false;
+
+    struct stat st;
+    if (stat(stored, &st) == 0) {
+        return true; /* Another build got there first */
+    }
+    if (stat(object_path, &st) != 0) return false;
+
+    char subdirectory[MAX_PATH_LENGTH];
+    snprintf(subdirectory, sizeof(subdirectory), "%s/%.2s", store->directory, key);
+    mkdir(subdirectory, 0755);
+
+    if (!copy_file_atomic(store, object_path, stored)) {
+        return false;
+    }
+
+    ec_mutex_lock(&store->lock);
+    store->insertions++;
+    store->bytes_inserted += (uint64_t)st.st_size;
+    ec_mutex_unlock(&store->lock);
+
+    if (store->remote && store->remote_upload) {
+        queue_upload(store, key);
+    }
+    return true;
+}
+
+/* ==============================================================================
+ * Eviction
+ * ==============================================================================
+ */
+
+typedef struct StoredObject {
+    char *path;
+    uint64_t size;
+    time_t last_used;
+} StoredObject;
+
+typedef struct StoreListing {
+    StoredObject *objects;
+    size_t count;
+    size_t capacity;
+    uint64_t total_bytes;
+    time_t now;
+    bool failed;
+} StoreListing;
+
+static void listing_add(StoreListing *listing, const char *path, const struct stat *st) {
+    if (listing->failed) return;
+
+    if (listing->count >= listing->capacity) {
+        size_t new_capacity = listing->capacity == 0 ? 256 : listing->capacity * 2;
+        StoredObject *new_objects = realloc(listing->objects,
+                                            new_capacity * sizeof(StoredObject));
+        if (!new_objects) {
+            listing->failed = true;
+            return;
+        }
+        listing->objects = new_objects;
+        listing->capacity = new_capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy) {
+        listing->failed = true;
+        return;
+    }
+
+    StoredObject *object = &listing->objects[listing->count++];
+    object->path = copy;
+    object->size = (uint64_t)st->st_size;
+    object->last_used = st->st_mtime;
+    listing->total_bytes += object->size;
+}
+
+static void visit_object(const char *directory, const char *name, void *context) {
+    StoreListing *listing = (StoreListing *)context;
+
+    char path[MAX_PATH_LENGTH];
+    int written = snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if (written <= 0 || (size_t)written >= sizeof(path)) return;
+
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return;
+
+    if (strstr(name, OBJECT_STORE_TEMP_MARKER)) {
+        /* A live insert renames its temporary file within moments */
+        if (st.st_mtime + OBJECT_STORE_STALE_TEMP_SECONDS < listing->now) remove(path);
+        return;
+    }
+
+    size_t length = strlen(name);
+    if (length == OBJECT_KEY_LENGTH + 2 && strcmp(name + OBJECT_KEY_LENGTH, ".o") == 0) {
+        listing_add(listing, path, &st);
+    }
+}
+
+static void visit_subdirectory(const char *directory, const char *name, void *context) {
+    if (strlen(name) != 2) return;
+
+    char path[MAX_PATH_LENGTH];
+    int written = snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if (written <= 0 || (size_t)written >= sizeof(path)) return;
+
+    for_each_entry(path, visit_object, context);
+}
+
+static int compare_last_used(const void *a, const void *b) {
+    const StoredObject *x = (const StoredObject *)a;
+    const StoredObject *y = (const StoredObject *)b;
+    if (x->last_used != y->last_used) return x->last_used < y->last_used ? -1 : 1;
+    return strcmp(x->path, y->path);
+}
+
+static void free_listing(StoreListing *listing) {
+    for (size_t i = 0; i < listing->count; i++) free(listing->objects[i].path);
+    free(listing->objects);
+    listing->objects = NULL;
+    listing->count = 0;
+}
+
+/**
+ * List the objects in a store; temporary files left by dead inserts are
+ * removed on the way
+ */
+static bool list_objects(const ObjectStore *store, StoreListing *listing) {
+    memset(listing, 0, sizeof(*listing));
+    listing->now = time(NULL);
+
+    if (!for_each_entry(store->directory, visit_subdirectory, listing) || listing->failed) {
+        free_listing(listing);
+        return false;
+    }
+    return true;
+}
+
+bool object_store_usage(ObjectStore *store, size_t *object_count, uint64_t *total_bytes) {
+    if (object_count) *object_count = 0;
+    if (total_bytes) *total_bytes = 0;
+    if (!store) return false;
+
+    StoreListing listing;
+    if (!list_objects(store, &listing)) return false;
+
+    if (object_count) *object_count = listing.count;
+    if (total_bytes) *total_bytes = listing.total_bytes;
+    free_listing(&listing);
+    return true;
+}
+
+bool object_store_trim(ObjectStore *store, size_t *removed_count, uint64_t *total_bytes) {
+    if (removed_count) *removed_count = 0;
+    if (total_bytes) *total_bytes = 0;
+    if (!store) return false;
+
+    StoreListing listing;
+    if (!list_objects(store, &listing)) return false;
+
+    size_t removed = 0;
+    if (listing.total_bytes > store->max_bytes) {
+        uint64_t target = store->max_bytes / 10 * 9;
+        qsort(listing.objects, listing.count, sizeof(StoredObject), compare_last_used);
+
+        for (size_t i = 0; i < listing.count && listing.total_bytes > target; i++) {
+            if (remove(listing.objects[i].path) == 0) {
+                listing.total_bytes -= listing.objects[i].size;
+                removed++;
+            }
+        }
+    }
+
+    free_listing(&listing);
+
+    if (removed_count) *removed_count = removed;
+    if (total_bytes) *total_bytes = listing.total_bytes;
+    return true;
+}
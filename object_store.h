@@ -0,0 +1,329 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Shared Object Store
+ * ==============================================================================
+ *
+ * Content-addressed cache of compiled objects that lives outside any one
+ * checkout. Each object is filed under a SHA-256 key covering everything
+ * the compiler reads: the compiler's identity, every BuildConfig setting
+ * that reaches the compile command, the source path and content, and the
+ * content of every transitive dependency. Fresh clones, CI runners and git
+ * worktrees pointed at the same directory reuse each other's objects.
+ *
+ * Layout: <directory>/<first two hex digits>/<64 hex digits>.o. An object
+ * is inserted by copying it to a temporary name and renaming it into
+ * place, so several builds may share a store concurrently. A hit
+ * hard-links the stored object into the build directory, copying when the
+ * two are on different filesystems, and refreshes its mtime; when the
+ * store grows past its size limit the least recently used objects are
+ * deleted.
+ *
+ * Because a hit may be a hard link, callers must delete an object before
+ * recompiling it rather than letting the compiler overwrite it in place.
+ *
+ * A store can be backed by a remote tier (an ObjectBackend, such as the
+ * HTTP cache in remote_cache.h). Local misses fall through to the remote,
+ * whose objects land in the local store first; a prefetch downloads the
+ * objects a build will want in the background before compilation starts,
+ * and objects the build compiles are uploaded in the background.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef OBJECT_STORE_H
+#define OBJECT_STORE_H
+
+#include "compile_events.h"
+#include "cache_metadata.h"
+#include "include/eventchains_platform.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define OBJECT_KEY_LENGTH 64                        /* Hex digits in a key */
+#define OBJECT_STORE_DEFAULT_MAX_BYTES (2048ull * 1024 * 1024)
+#define OBJECT_STORE_REMOTE_WORKERS 8               /* Concurrent remote transfers */
+
+/* ==============================================================================
+ * Backends
+ * ==============================================================================
+ */
+
+/**
+ * ObjectBackend - A remote tier behind the local store
+ *
+ * Both operations are synchronous and may be called from several threads
+ * at once; the store runs them on its own workers when they should not
+ * hold up the build.
+ */
+typedef struct ObjectBackend {
+    const char *name;                       /* For messages */
+    void *self;                             /* Backend state */
+
+    /* Download the object for key into path; true on a hit */
+    bool (*get)(void *self, const char *key, const char *path);
+
+    /* Upload the object at path under key */
+    bool (*put)(void *self, const char *key, const char *path);
+
+    /* Free the backend (and the ObjectBackend itself) */
+    void (*destroy)(struct ObjectBackend *backend);
+} ObjectBackend;
+
+/* One queued remote transfer (internal) */
+struct StoreJob;
+
+/* ==============================================================================
+ * Store
+ * ==============================================================================
+ */
+
+/**
+ * ObjectStore - An open shared store
+ */
+typedef struct ObjectStore {
+    char *directory;                        /* Root of the store */
+    uint64_t max_bytes;                     /* Size limit enforced by object_store_trim */
+    uint64_t toolchain_hash;                /* Compiler identity and flags */
+    ec_mutex_t lock;                        /* Guards the counters below */
+    uint64_t temp_counter;                  /* Unique suffix for temporary files */
+    size_t hits;                            /* Objects placed from the store */
+    size_t misses;                          /* Lookups that found nothing */
+    size_t insertions;                      /* Objects added */
+    uint64_t bytes_inserted;                /* Size of the objects added */
+
+    /* Remote tier */
+    ObjectBackend *remote;                  /* Backend, or NULL */
+    bool remote_upload;                     /* Upload what this build compiles */
+    ec_cond_t jobs_changed;                 /* A job was queued or finished */
+    ec_thread_t *workers;                   /* Transfer threads */
+    size_t worker_count;
+    bool stopping;                          /* Workers should exit */
+    struct StoreJob *downloads;             /* Prefetches, in build order */
+    struct StoreJob **downloads_by_key;     /* The same jobs, sorted by key */
+    size_t download_count;
+    size_t next_download;                   /* First download not yet claimed */
+    struct StoreJob *uploads;               /* Queued uploads, oldest first */
+    struct StoreJob *uploads_tail;
+    size_t jobs_pending;                    /* Queued or running */
+    size_t remote_hits;                     /* Objects downloaded */
+    size_t remote_misses;                   /* Downloads the remote did not have */
+    size_t uploads_done;                    /* Objects uploaded */
+    size_t upload_failures;                 /* Uploads the remote refused */
+} ObjectStore;
+
+/* ==============================================================================
+ * Keys
+ * ==============================================================================
+ */
+
+/**
+ * ObjectKey - Inputs of one compilation, accumulated before hashing
+ */
+typedef struct ObjectKey {
+    unsigned char *data;                    /* Serialized inputs */
+    size_t length;                          /* Bytes used */
+    size_t capacity;                        /* Bytes allocated */
+    bool failed;                            /* An allocation failed */
+} ObjectKey;
+
+/**
+ * Start a key, seeded with the store's toolchain and flag hash
+ *
+ * @param key    Pointer to ObjectKey
+ * @param store  Store the key is for (can be NULL for an unseeded key)
+ */
+void object_key_init(ObjectKey *key, const ObjectStore *store);
+
+/**
+ * Free a key's buffer
+ *
+ * @param key  Pointer to ObjectKey
+ */
+void object_key_destroy(ObjectKey *key);
+
+/**
+ * Append a string (length-prefixed, so "ab"+"c" differs from "a"+"bc")
+ *
+ * @param key  Pointer to ObjectKey
+ * @param str  String to add (NULL is added as an empty string)
+ */
+void object_key_add_string(ObjectKey *key, const char *str);
+
+/**
+ * Append a 64-bit value
+ *
+ * @param key    Pointer to ObjectKey
+ * @param value  Value to add
+ */
+void object_key_add_u64(ObjectKey *key, uint64_t value);
+
+/**
+ * Hash the accumulated inputs into a key
+ *
+ * @param key   Pointer to ObjectKey
+ * @param dest  Buffer of at least OBJECT_KEY_LENGTH + 1 bytes
+ * @return      true on success, false if an allocation failed along the way
+ */
+bool object_key_finish(const ObjectKey *key, char *dest);
+
+/**
+ * Key a source for the store
+ *
+ * Covers the source's path and content and the path and content of every
+ * transitive dependency in the graph, in path order so that the order a
+ * checkout happened to be scanned in does not matter. Content hashes go
+ * through the build cache, so files it has already checked are not read
+ * again. Safe to call from parallel workers.
+ *
+ * @param store   Pointer to ObjectStore (seeds the key with compiler and flags)
+ * @param cache   Pointer to BuildCache (can be NULL)
+ * @param graph   Dependency graph containing the source
+ * @param source  Source file
+ * @param dest    Buffer of at least OBJECT_KEY_LENGTH + 1 bytes
+ * @return        true on success, false if the source is unreadable or not in the graph
+ */
+bool object_store_key_for_source(
+    const ObjectStore *store,
+    BuildCache *cache,
+    DependencyGraph *graph,
+    const SourceFile *source,
+    char *dest
+);
+
+/* ==============================================================================
+ * Store API
+ * ==============================================================================
+ */
+
+/**
+ * Open a store, creating its directory if needed
+ *
+ * @param directory  Root directory (shared between checkouts)
+ * @param max_bytes  Size limit (0 for OBJECT_STORE_DEFAULT_MAX_BYTES)
+ * @return           Pointer to ObjectStore, or NULL if the directory cannot be created
+ */
+ObjectStore *object_store_open(const char *directory, uint64_t max_bytes);
+
+/**
+ * Close a store, waiting for background uploads first
+ *
+ * @param store  Pointer to ObjectStore
+ */
+void object_store_close(ObjectStore *store);
+
+/**
+ * Hash the compiler identity and the compile flags of a configuration
+ *
+ * The identity is the resolved compiler executable, its size and mtime,
+ * and what it prints for --version, so an upgraded compiler never reuses
+ * objects from the old one. The flags are every BuildConfig field that
+ * reaches compile_command_build; link settings are left out. The result
+ * seeds every key made with object_key_init.
+ *
+ * @param store   Pointer to ObjectStore
+ * @param config  Build configuration
+ * @return        true on success, false if the compiler cannot be found
+ */
+bool object_store_set_toolchain(ObjectStore *store, const BuildConfig *config);
+
+/**
+ * Add a remote tier and start its transfer threads
+ *
+ * @param store    Pointer to ObjectStore
+ * @param backend  Backend (owned by the store from now on)
+ * @param upload   Upload objects inserted from now on
+ * @return         true on success; on failure the backend is destroyed
+ */
+bool object_store_set_remote(ObjectStore *store, ObjectBackend *backend, bool upload);
+
+/**
+ * Start downloading the objects a build will want
+ *
+ * Keys already in the local store are skipped; the rest are fetched from
+ * the remote in the given order by the transfer threads. A later
+ * object_store_fetch for one of them waits for its download instead of
+ * starting another. Call once per build, before compiling.
+ *
+ * @param store  Pointer to ObjectStore
+ * @param keys   Keys from object_key_finish
+ * @param count  Number of keys
+ * @return       Number of downloads queued
+ */
+size_t object_store_prefetch(ObjectStore *store, const char *const *keys, size_t count);
+
+/**
+ * Wait for background transfers
+ *
+ * Queued prefetches nobody asked for are dropped; running transfers and
+ * queued uploads are waited for.
+ *
+ * @param store  Pointer to ObjectStore
+ */
+void object_store_flush(ObjectStore *store);
+
+/**
+ * Place a stored object at object_path
+ *
+ * Falls back to the remote tier on a local miss. Safe to call from
+ * parallel workers.
+ *
+ * @param store        Pointer to ObjectStore
+ * @param key          Key from object_key_finish
+ * @param object_path  Where the object is wanted
+ * @return             true on a hit, false if the store has no such object
+ */
+bool object_store_fetch(ObjectStore *store, const char *key, const char *object_path);
+
+/**
+ * Add a freshly compiled object
+ *
+ * Queues an upload when the store has a remote tier that accepts them.
+ * Safe to call from parallel workers.
+ *
+ * @param store        Pointer to ObjectStore
+ * @param key          Key from object_key_finish
+ * @param object_path  Object to copy into the store
+ * @return             true on success
+ */
+bool object_store_insert(ObjectStore *store, const char *key, const char *object_path);
+
+/**
+ * Evict least recently used objects until the store fits its limit
+ *
+ * Trimming goes down to 90% of the limit so that the next few builds
+ * do not each have to trim again.
+ *
+ * @param store          Pointer to ObjectStore
+ * @param removed_count  Pointer to store the number of objects removed (can be NULL)
+ * @param total_bytes    Pointer to store the size of the store afterwards (can be NULL)
+ * @return               true on success, false if the store cannot be listed
+ */
+bool object_store_trim(ObjectStore *store, size_t *removed_count, uint64_t *total_bytes);
+
+/**
+ * Count the objects in a store and their size, evicting nothing
+ *
+ * @param store         Pointer to ObjectStore
+ * @param object_count  Pointer to store the number of objects (can be NULL)
+ * @param total_bytes   Pointer to store their total size (can be NULL)
+ * @return              true on success, false if the store cannot be listed
+ */
+bool object_store_usage(ObjectStore *store, size_t *object_count, uint64_t *total_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OBJECT_STORE_H */
@@ -0,0 +1,117 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Path Index Implementation
+ * ==============================================================================
+ */
+
+#include "path_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define PATH_INDEX_MIN_CAPACITY 64
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+/* ==============================================================================
+ * Internal Helpers
+ * ==============================================================================
+ */
+
+/**
+ * Find the slot holding key, or the empty slot where it would go
+ */
+static PathIndexSlot *path_index_probe(const PathIndex *index, const char *key, uint64_t hash) {
+    size_t mask = index->capacity - 1;
+    size_t slot = (size_t)hash & mask;
+
+    while (index->slots[slot].key) {
+        if (index->slots[slot].hash == hash && strcmp(index->slots[slot].key, key) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return &index->slots[slot];
+}
+
+static bool path_index_grow(PathIndex *index) {
+    size_t new_capacity = index->capacity == 0 ? PATH_INDEX_MIN_CAPACITY : index->capacity * 2;
+    PathIndexSlot *new_slots = calloc(new_capacity, sizeof(PathIndexSlot));
+    if (!new_slots) return false;
+
+    PathIndex grown = {new_slots, new_capacity, 0};
+    for (size_t i = 0; i < index->capacity; i++) {
+        const PathIndexSlot *old = &index->slots[i];
+        if (!old->key) continue;
+
+        *path_index_probe(&grown, old->key, old->hash) = *old;
+        grown.count++;
+    }
+
+    free(index->slots);
+    *index = grown;
+    return true;
+}
+
+/* ==============================================================================
+ * Public API Implementation
+ * ==============================================================================
+ */
+
+uint64_t path_index_hash(const char *path) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+void path_index_init(PathIndex *index) {
+    if (!index) return;
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+void path_index_destroy(PathIndex *index) {
+    if (!index) return;
+    free(index->slots);
+    path_index_init(index);
+}
+
+void path_index_clear(PathIndex *index) {
+    if (!index || !index->slots) return;
+    memset(index->slots, 0, index->capacity * sizeof(PathIndexSlot));
+    index->count = 0;
+}
+
+bool path_index_insert(PathIndex *index, const char *key, size_t value) {
+    if (!index || !key) return false;
+
+    /* Keep the load factor at or below 1/2 */
+    if ((index->count + 1) * 2 > index->capacity && !path_index_grow(index)) {
+        return false;
+    }
+
+    uint64_t hash = path_index_hash(key);
+    PathIndexSlot *slot = path_index_probe(index, key, hash);
+    if (!slot->key) {
+        slot->key = key;
+        slot->hash = hash;
+        index->count++;
+    }
+    slot->value = value;
+    return true;
+}
+
+size_t path_index_find(const PathIndex *index, const char *key) {
+    if (!index || !key || index->count == 0) return PATH_INDEX_NONE;
+
+    const PathIndexSlot *slot = path_index_probe(index, key, path_index_hash(key));
+    return slot->key ? slot->value : PATH_INDEX_NONE;
+}
@@ -0,0 +1,103 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Path Index
+ * ==============================================================================
+ *
+ * Open-addressing hash table mapping path strings to array indices. Used by
+ * the dependency graph and the build cache so that lookups by path are O(1)
+ * instead of a strcmp scan over every file.
+ *
+ * The index does not own its keys: callers insert pointers to strings that
+ * stay alive (and unchanged) for as long as the index does.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef PATH_INDEX_H
+#define PATH_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PATH_INDEX_NONE SIZE_MAX                /* Lookup miss */
+
+/**
+ * PathIndexSlot - One bucket; key is NULL when the slot is empty
+ */
+typedef struct PathIndexSlot {
+    const char *key;
+    uint64_t hash;
+    size_t value;
+} PathIndexSlot;
+
+/**
+ * PathIndex - Path to index hash table
+ */
+typedef struct PathIndex {
+    PathIndexSlot *slots;                   /* Power-of-two bucket array */
+    size_t capacity;                        /* Number of slots */
+    size_t count;                           /* Occupied slots */
+} PathIndex;
+
+/**
+ * Hash a path (FNV-1a)
+ *
+ * Exposed so on-disk tables can use the same function.
+ *
+ * @param path  NUL-terminated path
+ * @return      64-bit hash
+ */
+uint64_t path_index_hash(const char *path);
+
+/**
+ * Initialize an empty index
+ *
+ * @param index  Pointer to PathIndex
+ */
+void path_index_init(PathIndex *index);
+
+/**
+ * Free the bucket array (keys are not owned)
+ *
+ * @param index  Pointer to PathIndex
+ */
+void path_index_destroy(PathIndex *index);
+
+/**
+ * Remove every key, keeping the bucket array
+ *
+ * @param index  Pointer to PathIndex
+ */
+void path_index_clear(PathIndex *index);
+
+/**
+ * Insert or replace the value for a key
+ *
+ * @param index  Pointer to PathIndex
+ * @param key    Path; must outlive the index
+ * @param value  Value to store
+ * @return       true on success, false on allocation failure
+ */
+bool path_index_insert(PathIndex *index, const char *key, size_t value);
+
+/**
+ * Look up a key
+ *
+ * @param index  Pointer to PathIndex
+ * @param key    Path to find
+ * @return       Stored value, or PATH_INDEX_NONE if absent
+ */
+size_t path_index_find(const PathIndex *index, const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PATH_INDEX_H */
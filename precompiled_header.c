@@ -0,0 +1,707 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Precompiled Headers Implementation
+ * ==============================================================================
+ */
+
+/* realpath() */
+#define _DEFAULT_SOURCE
+
+#include "precompiled_header.h"
+#include "cache_metadata.h"
+#include "content_hash.h"
+#include "build_trace.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+#endif
+
+/* ==============================================================================
+ * Reading Leading Includes
+ * ==============================================================================
+ */
+
+/**
+ * LeadingInclude - One of the #include lines a source starts with
+ */
+typedef struct LeadingInclude {
+    char *key;                              /* "<name>", or the quoted absolute path */
+    const char *graph_path;                 /* Project header in the graph, or NULL */
+} LeadingInclude;
+
+/**
+ * SourcePrefix - The leading includes of one translation unit
+ */
+typedef struct SourcePrefix {
+    const SourceFile *source;
+    PchLanguage language;
+    LeadingInclude includes[PCH_MAX_INCLUDES];
+    size_t count;
+} SourcePrefix;
+
+static bool source_language(const char *path, PchLanguage *language) {
+    size_t len = strlen(path);
+    if (len >= 2 && strcmp(path + len - 2, ".c") == 0) {
+        *language = PCH_LANGUAGE_C;
+        return true;
+    }
+    if ((len >= 4 && strcmp(path + len - 4, ".cpp") == 0) ||
+        (len >= 3 && strcmp(path + len - 3, ".cc") == 0)) {
+        *language = PCH_LANGUAGE_CXX;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Skip blanks and comments; a block comment may run on past the line
+ *
+ * @return  The first character of code, or the end of the line
+ */
+static char *skip_blank(char *p, bool *in_comment) {
+    for (;;) {
+        if (*in_comment) {
+            char *end = strstr(p, "*/");
+            if (!end) return p + strlen(p);
+            p = end + 2;
+            *in_comment = false;
+        }
+        while (*p && isspace((unsigned char)*p)) p++;
+        if (p[0] == '/' && p[1] == '*') {
+            p += 2;
+            *in_comment = true;
+        } else if (p[0] == '/' && p[1] == '/') {
+            return p + strlen(p);
+        } else {
+            return p;
+        }
+    }
+}
+
+/**
+ * Read a line's preprocessor directive name ("include", "pragma", ...)
+ *
+ * @return  The text after the name, or NULL if the line is not a directive
+ */
+static char *directive(char *p, const char *name) {
+    if (*p != '#') return NULL;
+    p++;
+    while (*p == ' ' || *p == '\t') p++;
+
+    size_t len = strlen(name);
+    if (strncmp(p, name, len) != 0) return NULL;
+    p += len;
+    if (*p && !isspace((unsigned char)*p) && *p != '"' && *p != '<') return NULL;
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+/**
+ * Whether a header can be included twice: it starts with #pragma once or
+ * with an #ifndef and the matching #define
+ */
+static bool header_is_guarded(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return false;
+
+    bool in_comment = false;
+    bool guarded = false;
+    char guard[256] = "";
+    char line[1024];
+    while (fgets(line, sizeof(line), fp)) {
+        char *p = skip_blank(line, &in_comment);
+        if (*p == '\0') continue;
+
+        char *rest;
+        if (guard[0] == '\0' && (rest = directive(p, "pragma")) && strncmp(rest, "once", 4) == 0) {
+            guarded = true;
+        } else if (guard[0] == '\0' && (rest = directive(p, "ifndef"))) {
+            size_t len = 0;
+            while (rest[len] && (isalnum((unsigned char)rest[len]) || rest[len] == '_') &&
+                   len < sizeof(guard) - 1) {
+                guard[len] = rest[len];
+                len++;
+            }
+            guard[len] = '\0';
+            if (len > 0) continue;
+        } else if (guard[0] != '\0' && (rest = directive(p, "define"))) {
+            size_t len = strlen(guard);
+            guarded = strncmp(rest, guard, len) == 0 &&
+                      !(isalnum((unsigned char)rest[len]) || rest[len] == '_');
+        }
+        break;
+    }
+
+    fclose(fp);
+    return guarded;
+}
+
+static bool absolute_path(const char *path, char *dest, size_t dest_size) {
+#ifdef _WIN32
+    return _fullpath(dest, path, dest_size) != NULL;
+#else
+    char resolved[4096];
+    if (!realpath(path, resolved)) return false;
+    int written = snprintf(dest, dest_size, "%s", resolved);
+    return written > 0 && (size_t)written < dest_size;
+#endif
+}
+
+/**
+ * Read the #include lines a source starts with
+ *
+ * Stops at the first line that is anything else, at a "..." include that
+ * cannot be found, and at a project header without an include guard.
+ */
+static void read_leading_includes(const DependencyGraph *graph, SourcePrefix *prefix) {
+    FILE *fp = fopen(prefix->source->path, "r");
+    if (!fp) return;
+
+    bool in_comment = false;
+    char line[1024];
+    while (prefix->count < PCH_MAX_INCLUDES && fgets(line, sizeof(line), fp)) {
+        char *p = skip_blank(line, &in_comment);
+        if (*p == '\0') continue;
+
+        p = directive(p, "include");
+        if (!p || (*p != '"' && *p != '<')) break;
+
+        bool quoted = *p == '"';
+        char *name = p + 1;
+        char *end = strchr(name, quoted ? '"' : '>');
+        if (!end || end == name) break;
+        *end = '\0';
+        if (*skip_blank(end + 1, &in_comment) != '\0') break;
+
+        char resolved[MAX_PATH_LENGTH];
+        char absolute[MAX_PATH_LENGTH];
+        char key[MAX_PATH_LENGTH + 2];
+        const char *graph_path = NULL;
+        if (dependency_graph_resolve_include(graph, name, quoted, prefix->source->path,
+                                             resolved, sizeof(resolved))) {
+            /* A project header: written with its absolute path, since the
+             * prefix header lives elsewhere */
+            if (!header_is_guarded(resolved) ||
+                !absolute_path(resolved, absolute, sizeof(absolute))) {
+                break;
+            }
+            snprintf(key, sizeof(key), "\"%s\"", absolute);
+            const SourceFile *header = dependency_graph_find_file(graph, resolved);
+            graph_path = header ? header->path : NULL;
+        } else if (quoted) {
+            break;
+        } else {
+            /* A system header, found the same way from anywhere */
+            snprintf(key, sizeof(key), "<%s>", name);
+        }
+
+        char *copy = strdup(key);
+        if (!copy) break;
+        prefix->includes[prefix->count].key = copy;
+        prefix->includes[prefix->count].graph_path = graph_path;
+        prefix->count++;
+    }
+
+    fclose(fp);
+}
+
+/* ==============================================================================
+ * Choosing Prefixes
+ * ==============================================================================
+ */
+
+static int compare_keys(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static const char *output_extension(const BuildConfig *config) {
+    switch (config->compiler) {
+        case COMPILER_CLANG: return ".pch";
+        case COMPILER_MSVC: return ".pch";
+        default: return ".gch";
+    }
+}
+
+static bool set_header_paths(PrecompiledHeader *header, PchLanguage language,
+                             const BuildConfig *config) {
+    const char *base = language == PCH_LANGUAGE_C ? "c_prefix" : "cxx_prefix";
+    const char *suffix = language == PCH_LANGUAGE_C ? ".h" : ".hpp";
+    int written = snprintf(header->header_path, sizeof(header->header_path), "%s/%s/%s%s",
+                           config->output_dir, PCH_DIRECTORY, base, suffix);
+    bool ok = written > 0 && (size_t)written < sizeof(header->header_path);
+
+    /* GCC finds <header>.gch by itself; the others are named on each use */
+    if (config->compiler == COMPILER_MSVC) {
+        written = snprintf(header->output_path, sizeof(header->output_path), "%s/%s/%s.pch",
+                           config->output_dir, PCH_DIRECTORY, base);
+        ok = ok && written > 0 && (size_t)written < sizeof(header->output_path);
+        written = snprintf(header->object_path, sizeof(header->object_path), "%s/%s/%s.obj",
+                           config->output_dir, PCH_DIRECTORY, base);
+        ok = ok && written > 0 && (size_t)written < sizeof(header->object_path);
+    } else {
+        written = snprintf(header->output_path, sizeof(header->output_path), "%s%s",
+                           header->header_path, output_extension(config));
+        ok = ok && written > 0 && (size_t)written < sizeof(header->output_path);
+    }
+    return ok;
+}
+
+/**
+ * Find the longest run of includes enough sources of a language start with
+ *
+ * Extends the run one include at a time with the include most of the
+ * sources still in the running have next, while enough of them do.
+ */
+static bool choose_prefix(PchSet *set, PchLanguage language, SourcePrefix *prefixes,
+                          size_t prefix_count, const BuildConfig *config) {
+    PrecompiledHeader *header = &set->headers[language];
+
+    size_t *members = malloc((prefix_count + 1) * sizeof(size_t));
+    const char **keys = malloc((prefix_count + 1) * sizeof(const char *));
+    if (!members || !keys) {
+        free(members);
+        free(keys);
+        return false;
+    }
+
+    size_t member_count = 0;
+    for (size_t i = 0; i < prefix_count; i++) {
+        if (prefixes[i].language == language) members[member_count++] = i;
+    }
+    header->language_sources = member_count;
+
+    size_t needed = (size_t)((double)member_count * PCH_MIN_SHARE + 0.999);
+    if (needed < PCH_MIN_SOURCES) needed = PCH_MIN_SOURCES;
+
+    size_t depth = 0;
+    while (member_count >= needed && depth < PCH_MAX_INCLUDES) {
+        size_t key_count = 0;
+        for (size_t i = 0; i < member_count; i++) {
+            const SourcePrefix *prefix = &prefixes[members[i]];
+            if (prefix->count > depth) keys[key_count++] = prefix->includes[depth].key;
+        }
+        qsort(keys, key_count, sizeof(const char *), compare_keys);
+
+        const char *best = NULL;
+        size_t best_count = 0;
+        for (size_t i = 0; i < key_count; ) {
+            size_t run = 1;
+            while (i + run < key_count && strcmp(keys[i], keys[i + run]) == 0) run++;
+            if (run > best_count) {
+                best = keys[i];
+                best_count = run;
+            }
+            i += run;
+        }
+        if (best_count < needed) break;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < member_count; i++) {
+            const SourcePrefix *prefix = &prefixes[members[i]];
+            if (prefix->count > depth && strcmp(prefix->includes[depth].key, best) == 0) {
+                members[kept++] = members[i];
+            }
+        }
+        member_count = kept;
+        depth++;
+    }
+
+    bool ok = true;
+    if (depth > 0) {
+        const SourcePrefix *first = &prefixes[members[0]];
+        header->includes = calloc(depth, sizeof(char *));
+        header->graph_paths = calloc(depth, sizeof(const char *));
+        ok = header->includes && header->graph_paths && set_header_paths(header, language, config);
+        for (size_t i = 0; ok && i < depth; i++) {
+            header->includes[i] = strdup(first->includes[i].key);
+            header->graph_paths[i] = first->includes[i].graph_path;
+            ok = header->includes[i] != NULL;
+            header->include_count = i + 1;
+        }
+        for (size_t i = 0; ok && i < member_count; i++) {
+            ok = path_index_insert(&set->sources, prefixes[members[i]].source->path,
+                                   (size_t)language);
+        }
+        header->source_count = ok ? member_count : 0;
+    }
+
+    free(members);
+    free(keys);
+    return ok;
+}
+
+PchSet *pch_set_plan(DependencyGraph *graph, const BuildConfig *config) {
+    if (!graph || !config || !config->output_dir) return NULL;
+
+    PchSet *set = calloc(1, sizeof(PchSet));
+    SourcePrefix *prefixes = calloc(graph->file_count + 1, sizeof(SourcePrefix));
+    if (!set || !prefixes) {
+        free(set);
+        free(prefixes);
+        return NULL;
+    }
+    path_index_init(&set->sources);
+
+    size_t prefix_count = 0;
+    for (size_t i = 0; i < graph->file_count; i++) {
+        const SourceFile *source = graph->files[i];
+        SourcePrefix *prefix = &prefixes[prefix_count];
+        if (source->is_header || source->generated ||
+            !source_language(source->path, &prefix->language)) continue;
+
+        prefix->source = source;
+        read_leading_includes(graph, prefix);
+        prefix_count++;
+    }
+
+    bool ok = true;
+    for (int language = 0; ok && language < PCH_LANGUAGE_COUNT; language++) {
+        ok = choose_prefix(set, (PchLanguage)language, prefixes, prefix_count, config);
+    }
+
+    for (size_t i = 0; i < prefix_count; i++) {
+        for (size_t j = 0; j < prefixes[i].count; j++) {
+            free(prefixes[i].includes[j].key);
+        }
+    }
+    free(prefixes);
+
+    if (!ok) {
+        pch_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+const PrecompiledHeader *pch_set_find(const PchSet *set, const char *source_path) {
+    if (!set || !source_path) return NULL;
+
+    size_t language = path_index_find(&set->sources, source_path);
+    if (language == PATH_INDEX_NONE) return NULL;
+
+    const PrecompiledHeader *header = &set->headers[language];
+    return header->ready ? header : NULL;
+}
+
+void pch_set_destroy(PchSet *set) {
+    if (!set) return;
+
+    for (int language = 0; language < PCH_LANGUAGE_COUNT; language++) {
+        PrecompiledHeader *header = &set->headers[language];
+        for (size_t i = 0; header->includes && i < header->include_count; i++) {
+            free(header->includes[i]);
+        }
+        free(header->includes);
+        free(header->graph_paths);
+    }
+    path_index_destroy(&set->sources);
+    free(set);
+}
+
+/* ==============================================================================
+ * Command Lines
+ * ==============================================================================
+ */
+
+const char *pch_language_name(PchLanguage language) {
+    return language == PCH_LANGUAGE_C ? "C" : "C++";
+}
+
+/**
+ * The source MSVC compiles to create the header: c_prefix.c beside c_prefix.h
+ */
+static bool msvc_stub_path(const PrecompiledHeader *header, PchLanguage language,
+                           char *dest, size_t dest_size) {
+    const char *dot = strrchr(header->header_path, '.');
+    int stem = dot ? (int)(dot - header->header_path) : (int)strlen(header->header_path);
+    int written = snprintf(dest, dest_size, "%.*s%s", stem, header->header_path,
+                           language == PCH_LANGUAGE_C ? ".c" : ".cpp");
+    return written > 0 && (size_t)written < dest_size;
+}
+
+bool pch_command_build(const PrecompiledHeader *header, PchLanguage language,
+                       const BuildConfig *config, ProcessArgs *args) {
+    if (!header || !config || !args) return false;
+
+    const char *compiler = config->compiler_path ? config->compiler_path : "gcc";
+    bool ok = process_args_add(args, compiler);
+
+    if (config->compiler == COMPILER_MSVC) {
+        /* /Yc needs a source to compile: an empty stub with the header forced in */
+        char stub[MAX_PATH_LENGTH];
+        ok = ok && msvc_stub_path(header, language, stub, sizeof(stub)) &&
+             process_args_add(args, "/nologo") &&
+             process_args_add(args, "/c") &&
+             process_args_add(args, stub) &&
+             process_args_addf(args, "/Yc%s", header->header_path) &&
+             process_args_addf(args, "/FI%s", header->header_path) &&
+             process_args_addf(args, "/Fp%s", header->output_path) &&
+             process_args_addf(args, "/Fo%s", header->object_path);
+        for (size_t i = 0; ok && i < config->include_path_count; i++) {
+            ok = process_args_addf(args, "/I%s", config->include_paths[i]);
+        }
+    } else {
+        ok = ok && process_args_add(args, "-x") &&
+             process_args_add(args, language == PCH_LANGUAGE_C ? "c-header" : "c++-header") &&
+             process_args_add(args, header->header_path) &&
+             process_args_add(args, "-o") &&
+             process_args_add(args, header->output_path);
+        for (size_t i = 0; ok && i < config->include_path_count; i++) {
+            ok = process_args_addf(args, "-I%s", config->include_paths[i]);
+        }
+    }
+
+    /* The same flags as the sources, or the compiler refuses to use it */
+    for (size_t i = 0; ok && i < config->cflag_count; i++) {
+        ok = process_args_add(args, config->cflags[i]);
+    }
+    return ok;
+}
+
+bool pch_add_compile_flags(const PrecompiledHeader *header, const BuildConfig *config,
+                           ProcessArgs *args) {
+    if (!header || !config || !args) return false;
+
+    switch (config->compiler) {
+        case COMPILER_MSVC:
+            return process_args_addf(args, "/Yu%s", header->header_path) &&
+                   process_args_addf(args, "/FI%s", header->header_path) &&
+                   process_args_addf(args, "/Fp%s", header->output_path);
+        case COMPILER_CLANG:
+            return process_args_add(args, "-include-pch") &&
+                   process_args_add(args, header->output_path);
+        default:
+            /* Warn rather than quietly parse the header if the .gch is refused */
+            return process_args_add(args, "-include") &&
+                   process_args_add(args, header->header_path) &&
+                   process_args_add(args, "-Winvalid-pch");
+    }
+}
+
+/* ==============================================================================
+ * Building
+ * ==============================================================================
+ */
+
+static uint64_t args_hash(const ProcessArgs *args) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < args->count; i++) {
+        uint64_t part = content_hash_bytes(args->argv[i], strlen(args->argv[i]) + 1);
+        hash = hash * 1099511628211ULL ^ part;
+    }
+    return hash;
+}
+
+/**
+ * Write the prefix header, leaving the file alone if it already says the
+ * same, so its stamp and hash stay put
+ */
+static bool write_prefix_header(const PrecompiledHeader *header, PchLanguage language,
+                                uint64_t command_hash) {
+    size_t size = 256;
+    for (size_t i = 0; i < header->include_count; i++) {
+        size += strlen(header->includes[i]) + 16;
+    }
+    char *text = malloc(size);
+    if (!text) return false;
+
+    int length = snprintf(text, size,
+                          "/* Generated by ecbuild; do not edit. The headers most %s sources\n"
+                          " * start with, precompiled once for all of them. Command %016llx */\n",
+                          pch_language_name(language), (unsigned long long)command_hash);
+    for (size_t i = 0; length > 0 && i < header->include_count; i++) {
+        length += snprintf(text + length, size - (size_t)length, "#include %s\n",
+                           header->includes[i]);
+    }
+
+    bool same = false;
+    FILE *fp = fopen(header->header_path, "rb");
+    if (fp) {
+        char *old = malloc((size_t)length + 2);
+        if (old) {
+            size_t read = fread(old, 1, (size_t)length + 1, fp);
+            same = read == (size_t)length && memcmp(old, text, (size_t)length) == 0;
+            free(old);
+        }
+        fclose(fp);
+    }
+
+    bool ok = same;
+    if (!same && (fp = fopen(header->header_path, "wb")) != NULL) {
+        ok = fwrite(text, 1, (size_t)length, fp) == (size_t)length;
+        ok = fclose(fp) == 0 && ok;
+    }
+    free(text);
+    return ok;
+}
+
+/**
+ * Whether any source the header serves is going to be compiled
+ */
+static bool header_users_stale(const PchSet *set, PchLanguage language,
+                               const DependencyGraph *graph, const BuildConfig *config,
+                               BuildCache *cache) {
+    if (!cache) return true;
+
+    for (size_t i = 0; i < graph->file_count; i++) {
+        const SourceFile *source = graph->files[i];
+        if (path_index_find(&set->sources, source->path) != (size_t)language) continue;
+
+        char object_path[MAX_PATH_LENGTH];
+        if (!get_object_file_path(source->path, config->output_dir, object_path,
+                                  sizeof(object_path)) ||
+            !file_exists_cache(object_path) || !build_cache_is_current(cache, source)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Record what the precompiled header was built from: the project headers
+ * it includes and everything they include
+ */
+static void record_header(const PrecompiledHeader *header, DependencyGraph *graph,
+                          BuildCache *cache) {
+    SourceFile **deps = malloc((graph->file_count + 1) * sizeof(SourceFile *));
+    const char **paths = malloc((graph->file_count + header->include_count + 1) *
+                                sizeof(const char *));
+    PathIndex seen;
+    path_index_init(&seen);
+
+    size_t path_count = 0;
+    for (size_t i = 0; deps && paths && i < header->include_count; i++) {
+        SourceFile *file = header->graph_paths[i]
+            ? dependency_graph_find_file(graph, header->graph_paths[i]) : NULL;
+        if (!file) continue;
+
+        size_t dep_count = 0;
+        dependency_graph_get_all_dependencies(graph, file, deps, graph->file_count, &dep_count);
+        deps[dep_count++] = file;
+        for (size_t j = 0; j < dep_count; j++) {
+            if (path_index_find(&seen, deps[j]->path) != PATH_INDEX_NONE) continue;
+            path_index_insert(&seen, deps[j]->path, path_count);
+            paths[path_count++] = deps[j]->path;
+        }
+    }
+
+    if (deps && paths) {
+        build_cache_update_dependencies(cache, header->header_path, header->output_path,
+                                        paths, path_count);
+    }
+
+    path_index_destroy(&seen);
+    free(deps);
+    free(paths);
+}
+
+static bool build_header(PchSet *set, PchLanguage language, DependencyGraph *graph,
+                         const BuildConfig *config, BuildCache *cache) {
+    PrecompiledHeader *header = &set->headers[language];
+
+    char directory[MAX_PATH_LENGTH];
+    snprintf(directory, sizeof(directory), "%s/%s", config->output_dir, PCH_DIRECTORY);
+    mkdir(directory, 0755);
+
+    if (config->compiler == COMPILER_MSVC) {
+        char stub[MAX_PATH_LENGTH];
+        FILE *fp = msvc_stub_path(header, language, stub, sizeof(stub)) ? fopen(stub, "w") : NULL;
+        if (fp) {
+            fputs("/* Generated by ecbuild; compiled with /Yc to create the header */\n", fp);
+            fclose(fp);
+        }
+    }
+
+    ProcessArgs args;
+    process_args_init(&args);
+    if (!pch_command_build(header, language, config, &args) ||
+        !write_prefix_header(header, language, args_hash(&args))) {
+        process_args_destroy(&args);
+        printf("Warning: Cannot write %s\n", header->header_path);
+        return false;
+    }
+
+    /* The prefix header names the command, so new flags make it stale too */
+    SourceFile stub;
+    memset(&stub, 0, sizeof(stub));
+    stub.path = header->header_path;
+    stub.is_header = true;
+    bool current = cache && file_exists_cache(header->output_path) &&
+                   (!header->object_path[0] || file_exists_cache(header->object_path)) &&
+                   build_cache_is_current(cache, &stub);
+
+    if (!current && !header_users_stale(set, language, graph, config, cache)) {
+        process_args_destroy(&args);
+        return false;
+    }
+
+    if (!current) {
+        if (config->verbose) {
+            char command[MAX_COMMAND_LENGTH];
+            process_args_format(&args, command, sizeof(command));
+            printf("  [PRECOMPILE] %s\n", header->header_path);
+            printf("               %s\n", command);
+        }
+
+        /* A half-written file must not be taken for a good one */
+        remove(header->output_path);
+
+        double start = build_clock_seconds();
+        uint64_t trace_start = build_trace_begin();
+        char prefix[MAX_PATH_LENGTH + 8];
+        snprintf(prefix, sizeof(prefix), "  [%s] ", header->header_path);
+
+        ProcessCapture capture = {0};
+        capture.limit = MAX_COMPILE_OUTPUT;
+        if (config->verbose) {
+            capture.echo = stderr;
+            capture.echo_prefix = prefix;
+        }
+        bool success = process_run_captured(args.argv, &capture);
+        build_trace_end(trace_start, "compile", "precompile header", header->header_path);
+
+        if (!success) {
+            printf("Warning: Precompiling %s failed (exit code %d); compiling without it\n",
+                   header->header_path, capture.exit_code);
+            if (capture.output && !capture.echo) printf("%s\n", capture.output);
+            free(capture.output);
+            remove(header->output_path);
+            process_args_destroy(&args);
+            return false;
+        }
+        if (capture.output && !capture.echo) fputs(capture.output, stderr);
+        free(capture.output);
+
+        if (cache) record_header(header, graph, cache);
+        header->rebuilt = true;
+        if (config->verbose) {
+            printf("  Precompiled in %.3f seconds\n", build_clock_seconds() - start);
+        }
+    }
+
+    process_args_destroy(&args);
+    header->ready = true;
+    return true;
+}
+
+size_t pch_set_build(PchSet *set, DependencyGraph *graph, const BuildConfig *config,
+                     BuildCache *cache) {
+    if (!set || !graph || !config) return 0;
+
+    size_t ready = 0;
+    for (int language = 0; language < PCH_LANGUAGE_COUNT; language++) {
+        PrecompiledHeader *header = &set->headers[language];
+        header->ready = false;
+        header->rebuilt = false;
+        if (header->include_count == 0) continue;
+
+        if (build_header(set, (PchLanguage)language, graph, config, cache)) ready++;
+    }
+    return ready;
+}
@@ -0,0 +1,180 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Precompiled Headers
+ * ==============================================================================
+ *
+ * Finds the run of #include lines that most translation units of one
+ * language start with, writes it into a generated prefix header under
+ * <output_dir>/pch and precompiles that once (.gch for GCC, .pch for
+ * Clang and MSVC). Each source starting with the run is then compiled
+ * with the prefix header forced in first (-include, -include-pch, or /FI
+ * with /Yu): its own copies of those includes become no-ops, and the
+ * compiler loads the parsed headers instead of parsing them again.
+ *
+ * Only a source's leading #include lines count - up to the first line
+ * that is not blank, a comment or an #include - so a source that defines
+ * a macro ahead of its includes is never given headers before it.
+ * Project headers in the prefix must be guarded (#pragma once, or
+ * #ifndef and #define), since each source now includes them twice.
+ *
+ * The precompiled header is kept in the persistent cache like an object:
+ * it is rebuilt when a header it covers or its compile command changes,
+ * and only when a source that uses it is about to be compiled.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef PRECOMPILED_HEADER_H
+#define PRECOMPILED_HEADER_H
+
+#include "compile_events.h"
+#include "path_index.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Defined in cache_metadata.h */
+struct BuildCache;
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define PCH_MIN_SOURCES 4                       /* Fewer users cannot repay building one */
+#define PCH_MIN_SHARE 0.5                       /* Share of a language's sources that must use it */
+#define PCH_MAX_INCLUDES 64                     /* Leading includes read from each source */
+#define PCH_DIRECTORY "pch"                     /* Under the output directory */
+
+/* ==============================================================================
+ * Types
+ * ==============================================================================
+ */
+
+/**
+ * PchLanguage - Which sources a precompiled header can serve
+ */
+typedef enum {
+    PCH_LANGUAGE_C = 0,
+    PCH_LANGUAGE_CXX,
+    PCH_LANGUAGE_COUNT
+} PchLanguage;
+
+/**
+ * PrecompiledHeader - One generated prefix header and its compiled form
+ */
+typedef struct PrecompiledHeader {
+    char **includes;                        /* Targets as written: "<stdio.h>" or "\"/abs/util.h\"" */
+    const char **graph_paths;               /* Project headers as the graph spells them, else NULL */
+    size_t include_count;                   /* 0 when no prefix was worth precompiling */
+    size_t source_count;                    /* Sources that start with the prefix */
+    size_t language_sources;                /* All sources of the language */
+    char header_path[MAX_PATH_LENGTH];      /* Generated prefix header */
+    char output_path[MAX_PATH_LENGTH];      /* Precompiled header */
+    char object_path[MAX_PATH_LENGTH];      /* MSVC /Yc object to link, else empty */
+    bool ready;                             /* Built and current; sources get the flags */
+    bool rebuilt;                           /* Compiled by this build */
+} PrecompiledHeader;
+
+/**
+ * PchSet - The precompiled headers of one build
+ */
+typedef struct PchSet {
+    PrecompiledHeader headers[PCH_LANGUAGE_COUNT];
+    PathIndex sources;                      /* Source path -> PchLanguage of its header */
+} PchSet;
+
+/* ==============================================================================
+ * Planning and Building
+ * ==============================================================================
+ */
+
+/**
+ * Choose the prefix header for each language
+ *
+ * Reads the leading includes of every translation unit in the graph and
+ * keeps, per language, the longest run at least PCH_MIN_SHARE of them
+ * (and PCH_MIN_SOURCES) start with. Nothing is written or compiled.
+ *
+ * @param graph   Scanned dependency graph (must outlive the set)
+ * @param config  Build configuration (output directory and compiler)
+ * @return        PchSet (possibly with no headers), or NULL on error
+ */
+PchSet *pch_set_plan(DependencyGraph *graph, const BuildConfig *config);
+
+/**
+ * Write and precompile the planned headers that are not current
+ *
+ * A header is compiled only if it is out of date and a source that uses
+ * it is out of date too. A header that fails to compile is left out, so
+ * its sources compile as they would without it. Without a cache every
+ * needed header is compiled.
+ *
+ * @param set     Planned PchSet
+ * @param graph   Graph the set was planned from
+ * @param config  Build configuration
+ * @param cache   Persistent cache (can be NULL)
+ * @return        Number of headers ready for use
+ */
+size_t pch_set_build(PchSet *set, DependencyGraph *graph, const BuildConfig *config,
+                     struct BuildCache *cache);
+
+/**
+ * Look up the ready precompiled header a source is compiled with
+ *
+ * @param set          PchSet (can be NULL)
+ * @param source_path  Source path as the graph spells it
+ * @return             The header, or NULL to compile without one
+ */
+const PrecompiledHeader *pch_set_find(const PchSet *set, const char *source_path);
+
+/**
+ * Free a set
+ *
+ * @param set  PchSet (can be NULL)
+ */
+void pch_set_destroy(PchSet *set);
+
+/* ==============================================================================
+ * Command Lines
+ * ==============================================================================
+ */
+
+/**
+ * Add the flags that compile a source against a precompiled header
+ *
+ * @param header  Ready precompiled header
+ * @param config  Build configuration
+ * @param args    Compile command to append to
+ * @return        true on success, false on allocation failure
+ */
+bool pch_add_compile_flags(const PrecompiledHeader *header, const BuildConfig *config,
+                           ProcessArgs *args);
+
+/**
+ * Build the argv that precompiles a prefix header
+ *
+ * @param header    Planned precompiled header
+ * @param language  Its language
+ * @param config    Build configuration
+ * @param args      Initialized ProcessArgs to append to
+ * @return          true on success, false on allocation failure
+ */
+bool pch_command_build(const PrecompiledHeader *header, PchLanguage language,
+                       const BuildConfig *config, ProcessArgs *args);
+
+/**
+ * Name of a language, for messages
+ */
+const char *pch_language_name(PchLanguage language);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRECOMPILED_HEADER_H */
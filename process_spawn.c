@@ -0,0 +1,741 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Process Spawning Implementation
+ * ==============================================================================
+ */
+
+/* wait4 and struct rusage */
+#define _DEFAULT_SOURCE
+#define _DARWIN_C_SOURCE
+
+#include "process_spawn.h"
+#include "build_trace.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <spawn.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+
+    extern char **environ;
+#endif
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define PROCESS_ARGS_MIN_CAPACITY 16
+#define PROCESS_READ_CHUNK 4096
+#define PROCESS_OUTPUT_MIN_CAPACITY 4096             /* First capture buffer */
+#define PROCESS_TAIL_MIN_LIMIT 256                   /* Smaller limits keep only the head */
+#define PROCESS_ECHO_LINE_MAX 4096                   /* Longer lines are echoed in pieces */
+#define PROCESS_NOTE_MAX 64                          /* "[... N bytes of output omitted ...]" */
+
+#ifdef _WIN32
+    #define PATH_LIST_SEPARATOR ';'
+    #define WINDOWS_COMMAND_LINE_MAX 32768
+#else
+    #define PATH_LIST_SEPARATOR ':'
+#endif
+
+/* ==============================================================================
+ * Argument Vectors
+ * ==============================================================================
+ */
+
+void process_args_init(ProcessArgs *args) {
+    if (!args) return;
+    args->argv = NULL;
+    args->count = 0;
+    args->capacity = 0;
+}
+
+void process_args_destroy(ProcessArgs *args) {
+    if (!args) return;
+    for (size_t i = 0; i < args->count; i++) {
+        free(args->argv[i]);
+    }
+    free(args->argv);
+    process_args_init(args);
+}
+
+/**
+ * Take ownership of an allocated argument
+ */
+static bool process_args_push(ProcessArgs *args, char *arg) {
+    if (!arg) return false;
+
+    if (args->count + 1 > args->capacity) {
+        size_t new_capacity = args->capacity == 0 ? PROCESS_ARGS_MIN_CAPACITY : args->capacity * 2;
+        char **new_argv = realloc(args->argv, (new_capacity + 1) * sizeof(char *));
+        if (!new_argv) {
+            free(arg);
+            return false;
+        }
+        args->argv = new_argv;
+        args->capacity = new_capacity;
+    }
+
+    args->argv[args->count++] = arg;
+    args->argv[args->count] = NULL;
+    return true;
+}
+
+bool process_args_add(ProcessArgs *args, const char *arg) {
+    if (!args || !arg) return false;
+    return process_args_push(args, strdup(arg));
+}
+
+bool process_args_addf(ProcessArgs *args, const char *format, ...) {
+    if (!args || !format) return false;
+
+    va_list ap;
+    va_start(ap, format);
+    int length = vsnprintf(NULL, 0, format, ap);
+    va_end(ap);
+    if (length < 0) return false;
+
+    char *arg = malloc((size_t)length + 1);
+    if (!arg) return false;
+
+    va_start(ap, format);
+    vsnprintf(arg, (size_t)length + 1, format, ap);
+    va_end(ap);
+
+    return process_args_push(args, arg);
+}
+
+bool process_args_format(const ProcessArgs *args, char *dest, size_t dest_size) {
+    if (!args || !dest || dest_size == 0) return false;
+
+    size_t pos = 0;
+    dest[0] = '\0';
+    for (size_t i = 0; i < args->count; i++) {
+        const char *arg = args->argv[i];
+        bool quote = arg[0] == '\0' || strpbrk(arg, " \t\"") != NULL;
+        int written = snprintf(dest + pos, dest_size - pos, quote ? "%s\"%s\"" : "%s%s",
+                               i > 0 ? " " : "", arg);
+        if (written < 0 || (size_t)written >= dest_size - pos) {
+            return false;
+        }
+        pos += (size_t)written;
+    }
+    return true;
+}
+
+/* ==============================================================================
+ * Output Capture
+ * ==============================================================================
+ */
+
+/**
+ * Keep the newest bytes in the tail ring, counting what they push out
+ */
+static void process_ring_append(Process *proc, const char *data, size_t length) {
+    size_t capacity = proc->tail_capacity;
+    if (capacity == 0) {
+        proc->output_omitted += length;
+        return;
+    }
+    if (length >= capacity) {
+        proc->output_omitted += proc->tail_length + length - capacity;
+        memcpy(proc->tail, data + length - capacity, capacity);
+        proc->tail_start = 0;
+        proc->tail_length = capacity;
+        return;
+    }
+
+    size_t overflow = proc->tail_length + length > capacity
+        ? proc->tail_length + length - capacity : 0;
+    size_t end = (proc->tail_start + proc->tail_length) % capacity;
+    size_t first = length < capacity - end ? length : capacity - end;
+    memcpy(proc->tail + end, data, first);
+    memcpy(proc->tail, data + first, length - first);
+
+    proc->tail_start = (proc->tail_start + overflow) % capacity;
+    proc->tail_length += length - overflow;
+    proc->output_omitted += overflow;
+}
+
+/**
+ * Stop growing the buffer: keep its first half as the head and send the
+ * rest to the tail ring
+ */
+static void process_start_tail(Process *proc) {
+    proc->output_truncated = true;
+
+    /* The note saying how much was dropped comes out of the tail's share */
+    size_t head = proc->output_limit >= PROCESS_TAIL_MIN_LIMIT ? proc->output_limit / 2
+                                                                : proc->output_limit;
+    size_t capacity = proc->output_limit - head;
+    capacity = capacity > PROCESS_NOTE_MAX ? capacity - PROCESS_NOTE_MAX : 0;
+    proc->tail = capacity > 0 ? malloc(capacity) : NULL;
+    proc->tail_capacity = proc->tail ? capacity : 0;
+
+    if (proc->output_length > head) {
+        process_ring_append(proc, proc->output + head, proc->output_length - head);
+        proc->output_length = head;
+        proc->output[head] = '\0';
+    }
+}
+
+/**
+ * Keep output: all of it while it fits the limit, then the head and tail
+ */
+static void process_capture_output(Process *proc, const char *data, size_t length) {
+    if (proc->output_limit == 0 || length == 0) return;
+
+    if (proc->output_truncated) {
+        process_ring_append(proc, data, length);
+        return;
+    }
+
+    /* Grow geometrically, so a quiet child costs little however high the limit */
+    size_t needed = proc->output_length + length;
+    if (needed > proc->output_capacity && proc->output_capacity < proc->output_limit) {
+        size_t capacity = proc->output_capacity == 0 ? PROCESS_OUTPUT_MIN_CAPACITY
+                                                     : proc->output_capacity * 2;
+        while (capacity < needed) capacity *= 2;
+        if (capacity > proc->output_limit) capacity = proc->output_limit;
+
+        char *output = realloc(proc->output, capacity + 1);
+        if (!output) {
+            proc->output_omitted += length;
+            proc->output_truncated = true;
+            return;
+        }
+        proc->output = output;
+        proc->output_capacity = capacity;
+        proc->output[proc->output_length] = '\0';
+    }
+
+    size_t room = proc->output_capacity - proc->output_length;
+    size_t taken = length < room ? length : room;
+    memcpy(proc->output + proc->output_length, data, taken);
+    proc->output_length += taken;
+    proc->output[proc->output_length] = '\0';
+
+    if (taken < length) {
+        process_start_tail(proc);
+        process_ring_append(proc, data + taken, length - taken);
+    }
+}
+
+/**
+ * Write complete lines to the echo stream, each with the prefix
+ *
+ * One write per line keeps lines from parallel children whole.
+ */
+static void process_echo_output(Process *proc, const char *data, size_t length) {
+    if (!proc->echo || !proc->echo_line) return;
+
+    for (size_t i = 0; i < length; i++) {
+        bool newline = data[i] == '\n';
+        if (!newline) proc->echo_line[proc->echo_line_length++] = data[i];
+
+        if (newline || proc->echo_line_length == PROCESS_ECHO_LINE_MAX) {
+            fprintf(proc->echo, "%s%.*s\n", proc->echo_prefix ? proc->echo_prefix : "",
+                    (int)proc->echo_line_length, proc->echo_line);
+            proc->echo_line_length = 0;
+        }
+    }
+}
+
+static void process_append_output(Process *proc, const char *data, size_t length) {
+    process_echo_output(proc, data, length);
+    process_capture_output(proc, data, length);
+}
+
+/**
+ * Once the child is done: echo any unfinished line, and join the head and
+ * tail with a note of how much was left out
+ */
+static void process_finish_output(Process *proc) {
+    if (proc->echo_line && proc->echo_line_length > 0) {
+        process_echo_output(proc, "\n", 1);
+    }
+    if (!proc->output_truncated || !proc->output) return;
+
+    char note[PROCESS_NOTE_MAX];
+    int written = snprintf(note, sizeof(note), "\n[... %zu bytes of output omitted ...]\n",
+                           proc->output_omitted);
+    size_t note_length = written > 0 ? (size_t)written : 0;
+
+    char *output = realloc(proc->output, proc->output_length + note_length + proc->tail_length + 1);
+    if (output) {
+        proc->output = output;
+        memcpy(output + proc->output_length, note, note_length);
+        proc->output_length += note_length;
+        for (size_t i = 0; i < proc->tail_length; i++) {
+            output[proc->output_length++] =
+                proc->tail[(proc->tail_start + i) % proc->tail_capacity];
+        }
+        output[proc->output_length] = '\0';
+        proc->output_capacity = proc->output_length;
+    }
+
+    free(proc->tail);
+    proc->tail = NULL;
+    proc->tail_capacity = 0;
+    proc->tail_length = 0;
+}
+
+void process_echo(Process *proc, FILE *stream, const char *prefix) {
+    if (!proc) return;
+
+    free(proc->echo_line);
+    free(proc->echo_prefix);
+    proc->echo_line = stream ? malloc(PROCESS_ECHO_LINE_MAX) : NULL;
+    proc->echo_prefix = stream && prefix ? strdup(prefix) : NULL;
+    proc->echo_line_length = 0;
+    proc->echo = proc->echo_line ? stream : NULL;
+}
+
+/* ==============================================================================
+ * Platform Implementation
+ * ==============================================================================
+ */
+
+#ifdef _WIN32
+
+/**
+ * Append one argument using the quoting rules of CommandLineToArgvW
+ */
+static bool append_quoted_arg(char *dest, size_t dest_size, size_t *pos, const char *arg) {
+    size_t p = *pos;
+    #define PUT(c) do { if (p + 1 >= dest_size) return false; dest[p++] = (c); } while (0)
+
+    if (p > 0) PUT(' ');
+
+    if (arg[0] != '\0' && strpbrk(arg, " \t\"") == NULL) {
+        for (const char *c = arg; *c; c++) PUT(*c);
+    } else {
+        PUT('"');
+        for (const char *c = arg; ; c++) {
+            size_t backslashes = 0;
+            while (*c == '\\') {
+                backslashes++;
+                c++;
+            }
+            if (*c == '\0') {
+                for (size_t i = 0; i < backslashes * 2; i++) PUT('\\');
+                break;
+            }
+            if (*c == '"') {
+                for (size_t i = 0; i < backslashes * 2 + 1; i++) PUT('\\');
+            } else {
+                for (size_t i = 0; i < backslashes; i++) PUT('\\');
+            }
+            PUT(*c);
+        }
+        PUT('"');
+    }
+
+    #undef PUT
+    dest[p] = '\0';
+    *pos = p;
+    return true;
+}
+
+bool process_spawn(Process *proc, char *const *argv, size_t output_limit) {
+    if (!proc || !argv || !argv[0]) return false;
+
+    memset(proc, 0, sizeof(Process));
+    proc->output_limit = output_limit;
+    proc->exit_code = -1;
+
+    char *command_line = malloc(WINDOWS_COMMAND_LINE_MAX);
+    if (!command_line) return false;
+
+    size_t pos = 0;
+    command_line[0] = '\0';
+    for (size_t i = 0; argv[i]; i++) {
+        if (!append_quoted_arg(command_line, WINDOWS_COMMAND_LINE_MAX, &pos, argv[i])) {
+            free(command_line);
+            return false;
+        }
+    }
+
+    SECURITY_ATTRIBUTES sa;
+    sa.nLength = sizeof(sa);
+    sa.lpSecurityDescriptor = NULL;
+    sa.bInheritHandle = TRUE;
+
+    HANDLE read_end, write_end;
+    if (!CreatePipe(&read_end, &write_end, &sa, 0)) {
+        free(command_line);
+        return false;
+    }
+    SetHandleInformation(read_end, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA si;
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = write_end;
+    si.hStdError = write_end;
+
+    PROCESS_INFORMATION pi;
+    BOOL started = CreateProcessA(NULL, command_line, NULL, NULL, TRUE, 0,
+                                  NULL, NULL, &si, &pi);
+    free(command_line);
+    CloseHandle(write_end);
+
+    if (!started) {
+        CloseHandle(read_end);
+        return false;
+    }
+
+    CloseHandle(pi.hThread);
+    proc->process_handle = pi.hProcess;
+    proc->output_handle = read_end;
+    proc->running = true;
+    return true;
+}
+
+/**
+ * Read whatever is in the pipe; blocking reads until EOF when block is set
+ */
+static void process_drain(Process *proc, bool block) {
+    char buffer[PROCESS_READ_CHUNK];
+
+    while (proc->output_handle) {
+        DWORD available = 0;
+        if (!block) {
+            if (!PeekNamedPipe(proc->output_handle, NULL, 0, NULL, &available, NULL)) {
+                available = 0;
+            } else if (available == 0) {
+                return;
+            }
+        }
+
+        DWORD bytes = 0;
+        DWORD wanted = block || available > sizeof(buffer) ? sizeof(buffer) : available;
+        if (!ReadFile(proc->output_handle, buffer, wanted, &bytes, NULL) || bytes == 0) {
+            CloseHandle(proc->output_handle);
+            proc->output_handle = NULL;
+            return;
+        }
+        process_append_output(proc, buffer, bytes);
+    }
+}
+
+static void process_reap(Process *proc) {
+    WaitForSingleObject(proc->process_handle, INFINITE);
+
+    DWORD status = 0;
+    proc->exit_code = GetExitCodeProcess(proc->process_handle, &status) ? (int)status : -1;
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(proc->process_handle, &counters, sizeof(counters))) {
+        proc->peak_memory = (uint64_t)counters.PeakWorkingSetSize;
+    }
+    CloseHandle(proc->process_handle);
+    proc->process_handle = NULL;
+    proc->running = false;
+    process_finish_output(proc);
+}
+
+bool process_poll(Process *proc, int timeout_ms) {
+    if (!proc) return true;
+    if (!proc->running) return true;
+
+    if (timeout_ms < 0) {
+        process_drain(proc, true);
+        process_reap(proc);
+        return true;
+    }
+
+    process_drain(proc, false);
+    if (WaitForSingleObject(proc->process_handle, (DWORD)timeout_ms) != WAIT_OBJECT_0) {
+        process_drain(proc, false);
+        return false;
+    }
+
+    /* Exited: every writer is closed unless a grandchild inherited the pipe */
+    process_drain(proc, true);
+    process_reap(proc);
+    return true;
+}
+
+bool process_find_executable(const char *name, char *dest, size_t dest_size) {
+    if (!name || !name[0]) return false;
+
+    char found[MAX_PATH];
+    if (SearchPathA(NULL, name, ".exe", sizeof(found), found, NULL) == 0) {
+        return false;
+    }
+    if (dest && dest_size > 0) {
+        snprintf(dest, dest_size, "%s", found);
+    }
+    return true;
+}
+
+#else
+
+bool process_spawn(Process *proc, char *const *argv, size_t output_limit) {
+    if (!proc || !argv || !argv[0]) return false;
+
+    memset(proc, 0, sizeof(Process));
+    proc->output_fd = -1;
+    proc->output_limit = output_limit;
+    proc->exit_code = -1;
+
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    /* Only the dup2'd copies on 1 and 2 survive exec */
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+    pid_t pid;
+    int err = posix_spawnp(&pid, argv[0], &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (err != 0) {
+        close(fds[0]);
+        errno = err;
+        return false;
+    }
+
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    proc->pid = (long)pid;
+    proc->output_fd = fds[0];
+    proc->running = true;
+    return true;
+}
+
+/**
+ * Read until the pipe would block or reaches EOF
+ */
+static void process_drain(Process *proc) {
+    char buffer[PROCESS_READ_CHUNK];
+
+    while (proc->output_fd >= 0) {
+        ssize_t bytes = read(proc->output_fd, buffer, sizeof(buffer));
+        if (bytes > 0) {
+            process_append_output(proc, buffer, (size_t)bytes);
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR) continue;
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+        close(proc->output_fd);
+        proc->output_fd = -1;
+    }
+}
+
+/**
+ * Collect the exit status; returns false if the child is still running
+ */
+static bool process_reap(Process *proc, bool block) {
+    int status = 0;
+    struct rusage usage;
+    pid_t result;
+    do {
+        result = wait4((pid_t)proc->pid, &status, block ? 0 : WNOHANG, &usage);
+    } while (result < 0 && errno == EINTR);
+
+    if (result == 0) return false;
+
+    proc->exit_code = (result > 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+    if (result > 0) {
+#ifdef __APPLE__
+        proc->peak_memory = (uint64_t)usage.ru_maxrss;          /* Bytes */
+#else
+        proc->peak_memory = (uint64_t)usage.ru_maxrss * 1024;   /* Kilobytes */
+#endif
+    }
+    proc->running = false;
+
+    /* Anything still buffered was written before exit */
+    process_drain(proc);
+    if (proc->output_fd >= 0) {
+        close(proc->output_fd);
+        proc->output_fd = -1;
+    }
+    process_finish_output(proc);
+    return true;
+}
+
+bool process_poll(Process *proc, int timeout_ms) {
+    if (!proc) return true;
+    if (!proc->running) return true;
+
+    while (proc->output_fd >= 0) {
+        struct pollfd pfd;
+        pfd.fd = proc->output_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) return false;
+
+        if (ready < 0) {
+            close(proc->output_fd);
+            proc->output_fd = -1;
+        } else {
+            process_drain(proc);
+        }
+
+        /* A bounded poll drains once; an unbounded one runs to EOF */
+        if (timeout_ms >= 0) break;
+    }
+
+    /* After EOF the child is exiting, so a blocking wait is short */
+    return process_reap(proc, proc->output_fd < 0);
+}
+
+bool process_find_executable(const char *name, char *dest, size_t dest_size) {
+    if (!name || !name[0]) return false;
+
+    if (strchr(name, '/')) {
+        if (access(name, X_OK) != 0) return false;
+        if (dest && dest_size > 0) snprintf(dest, dest_size, "%s", name);
+        return true;
+    }
+
+    const char *path = getenv("PATH");
+    if (!path) path = "/usr/bin:/bin";
+
+    while (*path) {
+        const char *end = strchr(path, PATH_LIST_SEPARATOR);
+        size_t length = end ? (size_t)(end - path) : strlen(path);
+
+        char candidate[4096];
+        int written = length == 0
+            ? snprintf(candidate, sizeof(candidate), "./%s", name)
+            : snprintf(candidate, sizeof(candidate), "%.*s/%s", (int)length, path, name);
+
+        if (written > 0 && (size_t)written < sizeof(candidate) && access(candidate, X_OK) == 0) {
+            if (dest && dest_size > 0) snprintf(dest, dest_size, "%s", candidate);
+            return true;
+        }
+
+        if (!end) break;
+        path = end + 1;
+    }
+    return false;
+}
+
+#endif
+
+/* ==============================================================================
+ * Public API Implementation
+ * ==============================================================================
+ */
+
+bool process_wait(Process *proc) {
+    if (!proc) return false;
+    process_poll(proc, -1);
+    return proc->exit_code == 0;
+}
+
+void process_destroy(Process *proc) {
+    if (!proc) return;
+    if (proc->running) {
+        process_poll(proc, -1);
+    }
+    free(proc->output);
+    free(proc->tail);
+    free(proc->echo_line);
+    free(proc->echo_prefix);
+    proc->output = NULL;
+    proc->output_length = 0;
+    proc->tail = NULL;
+    proc->echo_line = NULL;
+    proc->echo_prefix = NULL;
+    proc->echo = NULL;
+}
+
+bool process_run(char *const *argv, char *output, size_t output_size, int *exit_code) {
+    return process_run_measured(argv, output, output_size, exit_code, NULL);
+}
+
+bool process_run_measured(char *const *argv, char *output, size_t output_size,
+                          int *exit_code, uint64_t *peak_memory) {
+    if (output && output_size > 0) output[0] = '\0';
+    if (peak_memory) *peak_memory = 0;
+
+    Process proc;
+    size_t limit = output && output_size > 0 ? output_size - 1 : 0;
+    uint64_t trace_start = build_trace_begin();
+    bool spawned = process_spawn(&proc, argv, limit);
+    build_trace_end(trace_start, "process", "spawn", argv ? argv[0] : NULL);
+    if (!spawned) {
+        if (exit_code) *exit_code = -1;
+        if (output && output_size > 0 && argv && argv[0]) {
+            snprintf(output, output_size, "Failed to run %s\n", argv[0]);
+        }
+        return false;
+    }
+
+    bool success = process_wait(&proc);
+    if (exit_code) *exit_code = proc.exit_code;
+    if (peak_memory) *peak_memory = proc.peak_memory;
+    if (output && proc.output) {
+        memcpy(output, proc.output, proc.output_length + 1);
+    }
+
+    process_destroy(&proc);
+    return success;
+}
+
+bool process_run_captured(char *const *argv, ProcessCapture *capture) {
+    if (!capture) return false;
+    capture->output = NULL;
+    capture->omitted = 0;
+    capture->exit_code = -1;
+    capture->peak_memory = 0;
+
+    Process proc;
+    uint64_t trace_start = build_trace_begin();
+    bool spawned = process_spawn(&proc, argv, capture->limit);
+    build_trace_end(trace_start, "process", "spawn", argv ? argv[0] : NULL);
+    if (!spawned) {
+        if (argv && argv[0]) {
+            size_t size = strlen(argv[0]) + 32;
+            capture->output = malloc(size);
+            if (capture->output) snprintf(capture->output, size, "Failed to run %s\n", argv[0]);
+        }
+        return false;
+    }
+
+    process_echo(&proc, capture->echo, capture->echo_prefix);
+    bool success = process_wait(&proc);
+    capture->exit_code = proc.exit_code;
+    capture->peak_memory = proc.peak_memory;
+    capture->omitted = proc.output_omitted;
+
+    /* The buffer changes hands */
+    if (proc.output_length > 0) {
+        capture->output = proc.output;
+        proc.output = NULL;
+    }
+    process_destroy(&proc);
+    return success;
+}
@@ -0,0 +1,245 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Process Spawning
+ * ==============================================================================
+ *
+ * Runs tools directly from an argv vector, without a shell: posix_spawnp on
+ * POSIX, CreateProcess on Windows. The child's stdout and stderr share one
+ * pipe that the parent always drains, so the child never blocks on it.
+ * What it writes is kept in a buffer that grows as needed up to a limit;
+ * past the limit the first half is kept along with a ring of the latest
+ * output, and the middle is dropped with a note saying how much. Output
+ * can also be echoed line by line as it arrives, each line prefixed.
+ * process_poll lets a caller check on several children without blocking
+ * on any of them; process_wait and process_run block until the child is
+ * done.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef PROCESS_SPAWN_H
+#define PROCESS_SPAWN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==============================================================================
+ * Argument Vectors
+ * ==============================================================================
+ */
+
+/**
+ * ProcessArgs - Growable, NULL-terminated argv
+ */
+typedef struct ProcessArgs {
+    char **argv;                            /* argv[count] is always NULL */
+    size_t count;                           /* Number of arguments */
+    size_t capacity;                        /* Allocated slots (excluding terminator) */
+} ProcessArgs;
+
+/**
+ * Initialize an empty argument vector
+ *
+ * @param args  Pointer to ProcessArgs
+ */
+void process_args_init(ProcessArgs *args);
+
+/**
+ * Free every argument
+ *
+ * @param args  Pointer to ProcessArgs
+ */
+void process_args_destroy(ProcessArgs *args);
+
+/**
+ * Append a copy of an argument
+ *
+ * @param args  Pointer to ProcessArgs
+ * @param arg   Argument (copied)
+ * @return      true on success, false on allocation failure
+ */
+bool process_args_add(ProcessArgs *args, const char *arg);
+
+/**
+ * Append a formatted argument
+ *
+ * @param args    Pointer to ProcessArgs
+ * @param format  printf-style format
+ * @return        true on success, false on allocation failure
+ */
+bool process_args_addf(ProcessArgs *args, const char *format, ...);
+
+/**
+ * Render the arguments as one line for logs (quoting arguments with spaces)
+ *
+ * @param args       Pointer to ProcessArgs
+ * @param dest       Destination buffer
+ * @param dest_size  Size of destination buffer
+ * @return           true if everything fit, false if truncated
+ */
+bool process_args_format(const ProcessArgs *args, char *dest, size_t dest_size);
+
+/* ==============================================================================
+ * Processes
+ * ==============================================================================
+ */
+
+/**
+ * Process - A running (or finished) child
+ */
+typedef struct Process {
+#ifdef _WIN32
+    void *process_handle;                   /* HANDLE of the child */
+    void *output_handle;                    /* Read end of the output pipe */
+#else
+    long pid;                               /* Child pid */
+    int output_fd;                          /* Read end of the output pipe, -1 at EOF */
+#endif
+    char *output;                           /* Captured stdout + stderr (NUL-terminated) */
+    size_t output_length;                   /* Bytes in output */
+    size_t output_capacity;                 /* Allocated, grown up to output_limit */
+    size_t output_limit;                    /* Capture cap (see process_spawn) */
+    size_t output_omitted;                  /* Bytes dropped from the middle */
+    bool output_truncated;                  /* true if output exceeded the cap */
+    char *tail;                             /* Ring of the latest output once over the cap */
+    size_t tail_capacity;
+    size_t tail_start;                      /* Oldest byte in the ring */
+    size_t tail_length;
+    FILE *echo;                             /* Stream lines are echoed to, or NULL */
+    char *echo_prefix;                      /* Written before each echoed line */
+    char *echo_line;                        /* Line being collected for the echo */
+    size_t echo_line_length;
+    bool running;                           /* false once reaped */
+    int exit_code;                          /* Exit status, -1 if killed by a signal */
+    uint64_t peak_memory;                   /* Peak resident set in bytes once reaped, 0 if unknown */
+} Process;
+
+/**
+ * Start a child process
+ *
+ * argv[0] is looked up in PATH. Output is always drained so the child
+ * never blocks on a full pipe; at most output_limit bytes are kept. Once
+ * the limit is passed, the first half and the latest output are kept
+ * (limits under 256 bytes keep only the first bytes), and when the child
+ * is reaped they are joined by a line saying how many bytes were left
+ * out.
+ *
+ * @param proc          Process to initialize
+ * @param argv          NULL-terminated argument vector
+ * @param output_limit  Maximum captured bytes (0 discards all output)
+ * @return              true if the child started, false otherwise
+ */
+bool process_spawn(Process *proc, char *const *argv, size_t output_limit);
+
+/**
+ * Echo the child's output to a stream as it arrives
+ *
+ * Each complete line is written with the prefix in one call, so lines of
+ * children echoing to the same stream do not mix. Output is still
+ * captured as usual. Call right after process_spawn.
+ *
+ * @param proc    Process started with process_spawn
+ * @param stream  Stream to write to, or NULL to stop echoing
+ * @param prefix  Written before each line (copied; can be NULL)
+ */
+void process_echo(Process *proc, FILE *stream, const char *prefix);
+
+/**
+ * Drain available output and reap the child if it has exited
+ *
+ * @param proc        Process started with process_spawn
+ * @param timeout_ms  How long to wait for output or exit (0 = don't wait,
+ *                    negative = until the child finishes)
+ * @return            true once the child has exited and its output is drained
+ */
+bool process_poll(Process *proc, int timeout_ms);
+
+/**
+ * Block until the child exits
+ *
+ * @param proc  Process started with process_spawn
+ * @return      true if the child exited with status 0
+ */
+bool process_wait(Process *proc);
+
+/**
+ * Release an exited process (waits first if it is still running)
+ *
+ * @param proc  Process started with process_spawn
+ */
+void process_destroy(Process *proc);
+
+/**
+ * Run a command to completion and capture its output
+ *
+ * @param argv         NULL-terminated argument vector
+ * @param output       Buffer for stdout + stderr (can be NULL)
+ * @param output_size  Size of output buffer
+ * @param exit_code    Pointer to store exit code (-1 if it could not run)
+ * @return             true if the command exited with status 0
+ */
+bool process_run(char *const *argv, char *output, size_t output_size, int *exit_code);
+
+/**
+ * Run a command like process_run, also reporting its peak memory use
+ *
+ * @param argv         NULL-terminated argument vector
+ * @param output       Buffer for stdout + stderr (can be NULL)
+ * @param output_size  Size of output buffer
+ * @param exit_code    Pointer to store exit code (-1 if it could not run)
+ * @param peak_memory  Set to the child's peak resident set in bytes, 0 if
+ *                     the platform does not report it (can be NULL)
+ * @return             true if the command exited with status 0
+ */
+bool process_run_measured(char *const *argv, char *output, size_t output_size,
+                          int *exit_code, uint64_t *peak_memory);
+
+/**
+ * ProcessCapture - Options and results of process_run_captured
+ */
+typedef struct ProcessCapture {
+    size_t limit;                           /* Bytes of output kept (see process_spawn) */
+    FILE *echo;                             /* Echo lines here as they arrive, or NULL */
+    const char *echo_prefix;                /* Before each echoed line (can be NULL) */
+    char *output;                           /* Set: captured output, NULL if none; free() it */
+    size_t omitted;                         /* Set: bytes dropped from the middle */
+    int exit_code;                          /* Set: exit code, -1 if it could not run */
+    uint64_t peak_memory;                   /* Set: peak resident set in bytes, 0 if unknown */
+} ProcessCapture;
+
+/**
+ * Run a command to completion, keeping as much of its output as the
+ * capture allows
+ *
+ * Unlike process_run, the output buffer is allocated to fit, so a large
+ * limit costs memory only when the child really is that loud.
+ *
+ * @param argv     NULL-terminated argument vector
+ * @param capture  Limit and echo to use (in); output and exit status (out)
+ * @return         true if the command exited with status 0
+ */
+bool process_run_captured(char *const *argv, ProcessCapture *capture);
+
+/**
+ * Find an executable in PATH
+ *
+ * @param name       Program name (paths containing a separator are checked as-is)
+ * @param dest       Buffer for the resolved path (can be NULL)
+ * @param dest_size  Size of destination buffer
+ * @return           true if found
+ */
+bool process_find_executable(const char *name, char *dest, size_t dest_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROCESS_SPAWN_H */
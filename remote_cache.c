@@ -0,0 +1,335 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Remote Object Cache Implementation
+ * ==============================================================================
+ */
+
+#include "remote_cache.h"
+#include "net_socket.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ==============================================================================
+ * Internal Constants
+ * ==============================================================================
+ */
+
+#define HTTP_HEADER_MAX 8192                    /* Request or response header block */
+#define HTTP_BUFFER_SIZE (64u * 1024)
+
+typedef struct HttpRemote {
+    RemoteCacheUrl url;
+    ec_mutex_t lock;                        /* Guards the failure counter */
+    unsigned failures;                      /* Consecutive connection failures */
+    bool disabled;                          /* Gave up on the server */
+} HttpRemote;
+
+/* ==============================================================================
+ * URL Parsing
+ * ==============================================================================
+ */
+
+static void base64_encode(const char *input, size_t length, char *dest, size_t dest_size) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t out = 0;
+
+    for (size_t i = 0; i < length && out + 4 < dest_size; i += 3) {
+        unsigned int n = (unsigned char)input[i] << 16;
+        if (i + 1 < length) n |= (unsigned char)input[i + 1] << 8;
+        if (i + 2 < length) n |= (unsigned char)input[i + 2];
+
+        dest[out++] = alphabet[(n >> 18) & 63];
+        dest[out++] = alphabet[(n >> 12) & 63];
+        dest[out++] = i + 1 < length ? alphabet[(n >> 6) & 63] : '=';
+        dest[out++] = i + 2 < length ? alphabet[n & 63] : '=';
+    }
+    dest[out] = '\0';
+}
+
+bool remote_cache_parse_url(const char *url, RemoteCacheUrl *parsed) {
+    if (!url || !parsed) return false;
+    memset(parsed, 0, sizeof(RemoteCacheUrl));
+
+    const char *scheme = "http://";
+    if (strncmp(url, scheme, strlen(scheme)) != 0) return false;
+    const char *authority = url + strlen(scheme);
+
+    const char *path = strchr(authority, '/');
+    size_t authority_length = path ? (size_t)(path - authority) : strlen(authority);
+
+    /* Credentials */
+    const char *at = memchr(authority, '@', authority_length);
+    if (at) {
+        char credentials[256];
+        size_t length = (size_t)(at - authority);
+        if (length >= sizeof(credentials)) return false;
+        memcpy(credentials, authority, length);
+        credentials[length] = '\0';
+
+        char encoded[sizeof(parsed->authorization) - 8];
+        base64_encode(credentials, length, encoded, sizeof(encoded));
+        snprintf(parsed->authorization, sizeof(parsed->authorization), "Basic %s", encoded);
+
+        authority_length -= length + 1;
+        authority = at + 1;
+    }
+
+    /* Host, with IPv6 literals in brackets, then an optional port */
+    const char *host = authority;
+    size_t host_length;
+    const char *rest;
+    if (authority_length > 0 && authority[0] == '[') {
+        const char *close = memchr(authority, ']', authority_length);
+        if (!close) return false;
+        host = authority + 1;
+        host_length = (size_t)(close - host);
+        rest = close + 1;
+    } else {
+        const char *colon = memchr(authority, ':', authority_length);
+        host_length = colon ? (size_t)(colon - authority) : authority_length;
+        rest = authority + host_length;
+    }
+    if (host_length == 0 || host_length >= sizeof(parsed->host)) return false;
+    memcpy(parsed->host, host, host_length);
+
+    size_t rest_length = authority_length - (size_t)(rest - authority);
+    if (rest_length > 0) {
+        if (rest[0] != ':' || rest_length < 2 || rest_length - 1 >= sizeof(parsed->port)) {
+            return false;
+        }
+        for (size_t i = 1; i < rest_length; i++) {
+            if (rest[i] < '0' || rest[i] > '9') return false;
+        }
+        memcpy(parsed->port, rest + 1, rest_length - 1);
+    } else {
+        strcpy(parsed->port, "80");
+    }
+
+    /* Prefix, without the trailing slash */
+    if (path) {
+        snprintf(parsed->prefix, sizeof(parsed->prefix), "%s", path);
+        size_t length = strlen(parsed->prefix);
+        while (length > 0 && parsed->prefix[length - 1] == '/') {
+            parsed->prefix[--length] = '\0';
+        }
+    }
+    return true;
+}
+
+/* ==============================================================================
+ * HTTP Transport
+ * ==============================================================================
+ */
+
+static bool header_name_is(const char *line, const char *name) {
+    for (; *name; line++, name++) {
+        char c = *line;
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != *name) return false;
+    }
+    return *line == ':';
+}
+
+/**
+ * One request on a fresh connection
+ *
+ * HTTP/1.0 keeps the exchange simple: the server closes the connection
+ * after the response, and never sends a chunked body.
+ *
+ * @return  HTTP status, or -1 when the server could not be reached
+ */
+static int http_exchange(
+    const RemoteCacheUrl *url,
+    const char *method,
+    const char *key,
+    const char *upload_path,
+    const char *download_path,
+    bool *body_ok
+) {
+    *body_ok = false;
+
+    FILE *upload = NULL;
+    long upload_size = 0;
+    if (upload_path) {
+        upload = fopen(upload_path, "rb");
+        if (!upload) return 0;
+        fseek(upload, 0, SEEK_END);
+        upload_size = ftell(upload);
+        fseek(upload, 0, SEEK_SET);
+    }
+
+    net_socket_t sock = net_connect(url->host, url->port, REMOTE_CACHE_TIMEOUT_MS);
+    if (sock == NET_SOCKET_NONE) {
+        if (upload) fclose(upload);
+        return -1;
+    }
+
+    char header[HTTP_HEADER_MAX];
+    int length = snprintf(header, sizeof(header),
+                          "%s %s/ac/%s HTTP/1.0\r\n"
+                          "Host: %s%s%s\r\n"
+                          "User-Agent: ecbuild\r\n",
+                          method, url->prefix, key, url->host,
+                          strcmp(url->port, "80") == 0 ? "" : ":",
+                          strcmp(url->port, "80") == 0 ? "" : url->port);
+    if (url->authorization[0] && length > 0 && (size_t)length < sizeof(header)) {
+        length += snprintf(header + length, sizeof(header) - (size_t)length,
+                           "Authorization: %s\r\n", url->authorization);
+    }
+    if (upload && length > 0 && (size_t)length < sizeof(header)) {
+        length += snprintf(header + length, sizeof(header) - (size_t)length,
+                           "Content-Type: application/octet-stream\r\n"
+                           "Content-Length: %ld\r\n", upload_size);
+    }
+    if (length > 0 && (size_t)length < sizeof(header)) {
+        length += snprintf(header + length, sizeof(header) - (size_t)length, "\r\n");
+    }
+
+    char *buffer = malloc(HTTP_BUFFER_SIZE);
+    bool sent = buffer && length > 0 && (size_t)length < sizeof(header) &&
+                net_send_all(sock, header, (size_t)length);
+    while (sent && upload) {
+        size_t count = fread(buffer, 1, HTTP_BUFFER_SIZE, upload);
+        if (count == 0) break;
+        sent = net_send_all(sock, buffer, count);
+    }
+    if (upload) fclose(upload);
+
+    /* Response header block */
+    size_t received = 0;
+    char *body = NULL;
+    while (sent && received < sizeof(header) - 1) {
+        long count = net_recv(sock, header + received, sizeof(header) - 1 - received);
+        if (count <= 0) break;
+        received += (size_t)count;
+        header[received] = '\0';
+        body = strstr(header, "\r\n\r\n");
+        if (body) break;
+    }
+
+    int status = -1;
+    if (body) {
+        body += 4;
+        int major = 0, minor = 0;
+        if (sscanf(header, "HTTP/%d.%d %d", &major, &minor, &status) != 3) status = -1;
+    }
+
+    if (status == 200 && download_path) {
+        long long content_length = -1;
+        for (const char *line = strstr(header, "\r\n"); line && line + 2 < body;
+             line = strstr(line + 2, "\r\n")) {
+            if (header_name_is(line + 2, "content-length")) {
+                content_length = atoll(strchr(line + 2, ':') + 1);
+            }
+        }
+
+        FILE *out = fopen(download_path, "wb");
+        size_t leftover = received - (size_t)(body - header);
+        long long written = 0;
+        bool ok = out && fwrite(body, 1, leftover, out) == leftover;
+        written += (long long)leftover;
+
+        while (ok && (content_length < 0 || written < content_length)) {
+            long count = net_recv(sock, buffer, HTTP_BUFFER_SIZE);
+            if (count < 0) ok = false;
+            if (count <= 0) break;
+            ok = fwrite(buffer, 1, (size_t)count, out) == (size_t)count;
+            written += count;
+        }
+        if (out && fclose(out) != 0) ok = false;
+
+        /* A short body is a failed download, not a small object */
+        *body_ok = ok && (content_length < 0 || written == content_length);
+    } else if (status >= 200 && status < 300) {
+        *body_ok = true;
+    }
+
+    free(buffer);
+    net_close(sock);
+    return status;
+}
+
+/* ==============================================================================
+ * Backend
+ * ==============================================================================
+ */
+
+/**
+ * Count a transport result; give up on the server after repeated failures
+ */
+static void http_record(HttpRemote *remote, bool reached) {
+    ec_mutex_lock(&remote->lock);
+    if (reached) {
+        remote->failures = 0;
+    } else if (++remote->failures >= REMOTE_CACHE_MAX_FAILURES && !remote->disabled) {
+        remote->disabled = true;
+        fprintf(stderr, "Warning: Remote cache %s:%s unreachable, continuing without it\n",
+                remote->url.host, remote->url.port);
+    }
+    ec_mutex_unlock(&remote->lock);
+}
+
+static bool http_disabled(HttpRemote *remote) {
+    ec_mutex_lock(&remote->lock);
+    bool disabled = remote->disabled;
+    ec_mutex_unlock(&remote->lock);
+    return disabled;
+}
+
+static bool http_get(void *self, const char *key, const char *path) {
+    HttpRemote *remote = (HttpRemote *)self;
+    if (http_disabled(remote)) return false;
+
+    bool body_ok = false;
+    int status = http_exchange(&remote->url, "GET", key, NULL, path, &body_ok);
+    http_record(remote, status >= 0);
+    return status == 200 && body_ok;
+}
+
+static bool http_put(void *self, const char *key, const char *path) {
+    HttpRemote *remote = (HttpRemote *)self;
+    if (http_disabled(remote)) return false;
+
+    bool body_ok = false;
+    int status = http_exchange(&remote->url, "PUT", key, path, NULL, &body_ok);
+    http_record(remote, status >= 0);
+    return body_ok;
+}
+
+static void http_destroy(ObjectBackend *backend) {
+    if (!backend) return;
+
+    HttpRemote *remote = (HttpRemote *)backend->self;
+    ec_mutex_destroy(&remote->lock);
+    free(remote);
+    free(backend);
+
+    net_cleanup();
+}
+
+ObjectBackend *remote_cache_http_create(const char *url) {
+    HttpRemote *remote = calloc(1, sizeof(HttpRemote));
+    ObjectBackend *backend = calloc(1, sizeof(ObjectBackend));
+    if (!remote || !backend || !remote_cache_parse_url(url, &remote->url) ||
+        ec_mutex_init(&remote->lock) != 0) {
+        free(remote);
+        free(backend);
+        return NULL;
+    }
+
+    if (!net_startup()) {
+        ec_mutex_destroy(&remote->lock);
+        free(remote);
+        free(backend);
+        return NULL;
+    }
+
+    backend->name = "http";
+    backend->self = remote;
+    backend->get = http_get;
+    backend->put = http_put;
+    backend->destroy = http_destroy;
+    return backend;
+}
@@ -0,0 +1,188 @@
+/**
+ * ==============================================================================
+ * Build Tracing Test Suite
+ * ==============================================================================
+ */
+
+#include "build_trace.h"
+#include "include/eventchains_platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_TRACE "/tmp/ec_build_trace_test.json"
+
+static char *read_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *content = malloc((size_t)size + 1);
+    if (content) {
+        content[fread(content, 1, (size_t)size, fp)] = '\0';
+    }
+    fclose(fp);
+    return content;
+}
+
+static size_t count_occurrences(const char *text, const char *needle) {
+    size_t count = 0;
+    for (const char *p = strstr(text, needle); p; p = strstr(p + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay;
+    delay.tv_sec = ms / 1000;
+    delay.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&delay, NULL);
+}
+
+static void *traced_worker(void *arg) {
+    const char *detail = (const char *)arg;
+    for (int i = 0; i < 3; i++) {
+        uint64_t start = build_trace_begin();
+        sleep_ms(1);
+        build_trace_end(start, "compile", "compile", detail);
+    }
+    return NULL;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_wall_clock(void) {
+    TEST("The Clock Counts Waiting");
+
+    double start = build_clock_seconds();
+    sleep_ms(50);
+    double elapsed = build_clock_seconds() - start;
+    ASSERT(elapsed >= 0.045 && elapsed < 5.0, "Sleep measured in wall time");
+
+    TEST_END();
+}
+
+void test_disabled(void) {
+    TEST("Spans Cost Nothing While Tracing Is Off");
+
+    ASSERT(!build_trace_enabled(), "Off by default");
+    ASSERT(build_trace_begin() == 0, "No start time handed out");
+    build_trace_end(0, "compile", "compile", "ignored.c");
+
+    TEST_END();
+}
+
+void test_threads_and_export(void) {
+    TEST("Spans From Every Thread Are Exported");
+
+    ASSERT(build_trace_start() && build_trace_enabled(), "Tracing started");
+
+    uint64_t outer = build_trace_begin();
+    ASSERT(outer != 0, "Start time handed out");
+
+    ec_thread_t threads[2];
+    ec_thread_create(&threads[0], traced_worker, "src/a.c");
+    ec_thread_create(&threads[1], traced_worker, "odd \"name\"\\with\nnewline.c");
+    ec_thread_join(threads[0]);
+    ec_thread_join(threads[1]);
+    build_trace_end(outer, "build", "execute chain", NULL);
+
+    size_t written = 0;
+    ASSERT(build_trace_write(TEST_TRACE, &written) && written == 7, "Seven spans written");
+
+    char *json = read_file(TEST_TRACE);
+    ASSERT(json != NULL, "Trace readable");
+    if (json) {
+        ASSERT(strncmp(json, "{\"displayTimeUnit\"", 18) == 0 &&
+               strstr(json, "\"traceEvents\":[") != NULL &&
+               strcmp(json + strlen(json) - 3, "]}\n") == 0, "Chrome trace-event layout");
+        ASSERT(count_occurrences(json, "\"ph\":\"X\"") == 7, "Complete events");
+        ASSERT(count_occurrences(json, "\"thread_name\"") == 3 &&
+               strstr(json, "\"name\":\"main\"") && strstr(json, "\"name\":\"worker 2\""),
+               "Main and worker threads named");
+        ASSERT(strstr(json, "\"detail\":\"odd \\\"name\\\"\\\\with\\u000anewline.c\"") != NULL,
+               "Details escaped");
+        ASSERT(strstr(json, ",,") == NULL && strstr(json, ",\n]") == NULL, "No stray commas");
+        free(json);
+    }
+
+    /* Starting again discards the old spans */
+    build_trace_start();
+    ASSERT(build_trace_write(TEST_TRACE, &written) && written == 0, "Restart discards spans");
+    json = read_file(TEST_TRACE);
+    ASSERT(json && count_occurrences(json, "\"thread_name\"") == 1, "Only the main thread left");
+    free(json);
+
+    build_trace_stop();
+    ASSERT(!build_trace_enabled() && build_trace_begin() == 0, "Tracing stopped");
+    remove(TEST_TRACE);
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                 Build Tracing - Test Suite                     |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_wall_clock();
+    test_disabled();
+    test_threads_and_export();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
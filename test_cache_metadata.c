@@ -0,0 +1,710 @@
+/**
+ * ==============================================================================
+ * Persistent Cache Metadata Test Suite
+ * ==============================================================================
+ */
+
+#include "cache_metadata.h"
+#include "dependency_resolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_cache_test"
+#define TEST_HEADER TEST_DIR "/util.h"
+#define TEST_SOURCE TEST_DIR "/util.c"
+#define TEST_MAIN TEST_DIR "/main.c"
+#define TEST_CACHE_FILE TEST_DIR "/.eventchains/cache.dat"
+
+static bool create_test_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+
+    fputs(content, fp);
+    fclose(fp);
+    return true;
+}
+
+static void setup_project(void) {
+    mkdir(TEST_DIR, 0755);
+    remove(TEST_CACHE_FILE);
+    create_test_file(TEST_HEADER, "int util(void);\n");
+    create_test_file(TEST_SOURCE, "#include \"util.h\"\nint util(void) { return 1; }\n");
+    create_test_file(TEST_MAIN, "#include \"util.h\"\nint main(void) { return util(); }\n");
+}
+
+static void cleanup_project(void) {
+    remove(TEST_CACHE_FILE);
+    remove(TEST_DIR "/.eventchains/cache.dat.tmp");
+    rmdir(TEST_DIR "/.eventchains");
+    remove(TEST_HEADER);
+    remove(TEST_SOURCE);
+    remove(TEST_MAIN);
+    rmdir(TEST_DIR);
+}
+
+static DependencyGraph *scan_project(void) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    return graph;
+}
+
+/**
+ * Backdate a file so its stamp is old enough to be trusted
+ */
+static void backdate_file(const char *path) {
+    struct utimbuf times;
+    times.actime = 1000000000;
+    times.modtime = 1000000000;
+    utime(path, &times);
+}
+
+/**
+ * Compile-free stand-in for a build: record every source in the cache
+ */
+static void record_project(BuildCache *cache, DependencyGraph *graph) {
+    build_cache_update(cache, TEST_SOURCE, TEST_DIR "/util.o", graph);
+    build_cache_update(cache, TEST_MAIN, TEST_DIR "/main.o", graph);
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_save_and_reload(void) {
+    TEST("Save and Reload Mapped Cache");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    ASSERT(cache != NULL && cache->entry_count == 0, "Fresh cache is empty");
+
+    record_project(cache, graph);
+    ASSERT(cache->entry_count == 2, "Two entries recorded");
+    ASSERT(build_cache_save(cache), "Cache saved");
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache->entry_count == 2, "Two entries loaded from mapping");
+
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL), "Unchanged source is cached");
+    ASSERT(cache->overlay_count == 0, "Read-only lookup did not copy the entry");
+
+    CacheEntry *entry = build_cache_find(cache, TEST_MAIN);
+    ASSERT(entry != NULL && entry->dependency_count == 1, "Entry kept its dependency");
+    ASSERT(entry && strcmp(build_cache_string(cache, entry->object_id), TEST_DIR "/main.o") == 0,
+           "Object path resolved from string table");
+
+    /* Next build in the same process */
+    create_test_file(TEST_HEADER, "int util(void);\nint other(void);\n");
+    build_cache_reset_hash_memo(cache);
+    ASSERT(build_cache_needs_recompilation(cache, source, NULL), "Header change detected");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_overlay_changes_persist(void) {
+    TEST("Overlay Changes Persist Across Saves");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    build_cache_update(cache, TEST_SOURCE, TEST_DIR "/util.o", graph);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    /* Add a new entry on top of the mapping and invalidate a mapped one */
+    cache = build_cache_create(TEST_DIR);
+    build_cache_update(cache, TEST_MAIN, TEST_DIR "/main.o", graph);
+    ASSERT(cache->entry_count == 2, "New entry counted alongside mapped one");
+    build_cache_invalidate_dependents(cache, TEST_HEADER, graph);
+    ASSERT(cache->invalidations == 2, "Both dependents invalidated");
+    ASSERT(build_cache_save(cache), "Cache saved over its own mapping");
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache->entry_count == 2, "Both entries reloaded");
+
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    SourceFile *main_file = dependency_graph_find_file(graph, TEST_MAIN);
+    ASSERT(build_cache_needs_recompilation(cache, source, NULL) &&
+           build_cache_needs_recompilation(cache, main_file, NULL),
+           "Invalidation survived the rewrite");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_saved_cache_is_clean(void) {
+    TEST("A Saved Cache Is Not Written Again Until It Changes");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    ASSERT(build_cache_save(cache), "Cache saved");
+    ASSERT(!cache->dirty && cache->view && cache->overlay_count == 0 &&
+           cache->entry_count == 2, "Saved cache maps the new file and is clean");
+
+    struct stat before, after;
+    stat(TEST_CACHE_FILE, &before);
+    ASSERT(build_cache_save(cache), "Saved again without changes");
+    stat(TEST_CACHE_FILE, &after);
+    ASSERT(before.st_ino == after.st_ino, "Nothing rewritten");
+
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL), "Entries read from the new file");
+
+    build_cache_invalidate(cache, TEST_SOURCE);
+    ASSERT(cache->dirty && build_cache_save(cache), "A later change is saved");
+    stat(TEST_CACHE_FILE, &after);
+    ASSERT(before.st_ino != after.st_ino, "File rewritten for it");
+    build_cache_reset_hash_memo(cache);
+    ASSERT(build_cache_needs_recompilation(cache, source, NULL), "Change kept after the save");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_compile_stats_persist(void) {
+    TEST("Compile Times Persist for Scheduling");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    build_cache_record_compile(cache, TEST_SOURCE, 2.5, 300u * 1024 * 1024);
+    build_cache_record_compile(cache, "/nonexistent.c", 1.0, 1);
+
+    double seconds = 0.0;
+    uint64_t memory = 0;
+    ASSERT(build_cache_get_compile_stats(cache, TEST_SOURCE, &seconds, &memory) &&
+           seconds == 2.5 && memory == 300u * 1024 * 1024, "Recorded in the overlay");
+    ASSERT(!build_cache_get_compile_stats(cache, TEST_MAIN, &seconds, &memory) &&
+           seconds == 0.0 && memory == 0, "Untimed source has no history");
+    ASSERT(!build_cache_get_compile_stats(cache, "/nonexistent.c", NULL, NULL),
+           "No entry is created for an unknown source");
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(build_cache_get_compile_stats(cache, TEST_SOURCE, &seconds, &memory) &&
+           seconds == 2.5 && memory == 300u * 1024 * 1024, "Read back from the mapping");
+
+    /* Recompiling keeps the history until the new compile is measured */
+    build_cache_update(cache, TEST_SOURCE, TEST_DIR "/util.o", graph);
+    build_cache_record_compile(cache, TEST_SOURCE, 0.5, 0);
+    ASSERT(build_cache_get_compile_stats(cache, TEST_SOURCE, &seconds, &memory) &&
+           seconds == 0.5 && memory == 300u * 1024 * 1024, "Unmeasured memory left alone");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_corrupt_cache_rejected(void) {
+    TEST("Corrupt Cache File Is Rejected");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    /* Truncate the file so the header no longer matches its size */
+    FILE *fp = fopen(TEST_CACHE_FILE, "rb");
+    char buffer[128];
+    size_t bytes = fp ? fread(buffer, 1, sizeof(buffer), fp) : 0;
+    if (fp) fclose(fp);
+    fp = fopen(TEST_CACHE_FILE, "wb");
+    if (fp) {
+        fwrite(buffer, 1, bytes, fp);
+        fclose(fp);
+    }
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache != NULL && cache->entry_count == 0, "Truncated cache ignored");
+
+    record_project(cache, graph);
+    ASSERT(build_cache_save(cache), "Fresh cache saved");
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache->entry_count == 2, "Rebuilt cache loads");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_stat_fast_path(void) {
+    TEST("Stat Stamps Skip Hashing Unchanged Files");
+
+    setup_project();
+    backdate_file(TEST_HEADER);
+    backdate_file(TEST_SOURCE);
+    backdate_file(TEST_MAIN);
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    /* Same size and mtime, different content: only a hash can tell */
+    create_test_file(TEST_HEADER, "int utiX(void);\n");
+    backdate_file(TEST_HEADER);
+
+    cache = build_cache_create(TEST_DIR);
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL),
+           "Stat mode trusts the persisted stamp");
+
+    build_cache_set_check_mode(cache, CACHE_CHECK_CONTENT);
+    build_cache_reset_hash_memo(cache);
+    ASSERT(build_cache_needs_recompilation(cache, source, NULL),
+           "Content mode hashes and sees the change");
+
+    /* A size change is caught without hashing */
+    build_cache_set_check_mode(cache, CACHE_CHECK_STAT);
+    create_test_file(TEST_HEADER, "int util(void);\nint more(void);\n");
+    backdate_file(TEST_HEADER);
+    build_cache_reset_hash_memo(cache);
+    ASSERT(build_cache_needs_recompilation(cache, source, NULL),
+           "Stat mode detects a size change");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_hash_memo_shared(void) {
+    TEST("Shared Header Checked Once Per Build");
+
+    setup_project();
+    DependencyGraph *graph = scan_project();
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    build_cache_set_check_mode(cache, CACHE_CHECK_CONTENT);
+    record_project(cache, graph);
+
+    /* Recording already hashed util.h for util.c; main.c reuses it */
+    ASSERT(cache->memo_hits >= 1, "Second include of util.h served from memo");
+
+    size_t hits_before = cache->memo_hits;
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    SourceFile *main_file = dependency_graph_find_file(graph, TEST_MAIN);
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL) &&
+           !build_cache_needs_recompilation(cache, main_file, NULL),
+           "Both sources cached");
+    ASSERT(cache->memo_hits == hits_before + 4, "Every check answered by the memo");
+
+    build_cache_reset_hash_memo(cache);
+    ASSERT(cache->memo_hits == 0, "Memo reset for the next build");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_depfile_entries_provide_includes(void) {
+    TEST("Depfile Entries Stand In for Include Scans");
+
+    setup_project();
+    backdate_file(TEST_HEADER);
+    backdate_file(TEST_SOURCE);
+    backdate_file(TEST_MAIN);
+
+    /* util.c recorded from a depfile, main.c from the graph */
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    const char *deps[] = {TEST_HEADER};
+    build_cache_update_dependencies(cache, TEST_SOURCE, TEST_DIR "/util.o", deps, 1);
+    build_cache_update(cache, TEST_MAIN, TEST_DIR "/main.o", NULL);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    dependency_graph_set_include_provider(graph, build_cache_include_provider, cache);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    SourceFile *main_file = dependency_graph_find_file(graph, TEST_MAIN);
+    ASSERT(source && source->dependencies_provided && source->include_count == 1 &&
+           strcmp(source->includes[0], TEST_HEADER) == 0, "Depfile entry provided util.c's includes");
+    ASSERT(main_file && !main_file->dependencies_provided && main_file->include_count == 1,
+           "Graph-derived entry is parsed as usual");
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL), "Provided entry still cached");
+    dependency_graph_destroy(graph);
+
+    /* An edited source must be scanned again */
+    create_test_file(TEST_SOURCE, "#include \"util.h\"\nint util(void) { return 2; }\n");
+    graph = dependency_graph_create();
+    dependency_graph_set_include_provider(graph, build_cache_include_provider, cache);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    source = dependency_graph_find_file(graph, TEST_SOURCE);
+    ASSERT(source && !source->dependencies_provided, "Changed source rescanned");
+
+    dependency_graph_destroy(graph);
+    build_cache_destroy(cache);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_graph_snapshot_skips_parsing(void) {
+    TEST("Graph Snapshot Rebuilds Unchanged Files Without Parsing");
+
+    setup_project();
+    backdate_file(TEST_HEADER);
+    backdate_file(TEST_SOURCE);
+    backdate_file(TEST_MAIN);
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    build_cache_provide_includes(cache, graph);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    ASSERT(graph->parsed_count == 3 && graph->reused_count == 0, "First scan parses every file");
+    build_cache_record_graph(cache, graph);
+    build_cache_save(cache);
+    dependency_graph_destroy(graph);
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    build_cache_provide_includes(cache, graph);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    ASSERT(graph->parsed_count == 0 && graph->reused_count == 3, "Unchanged files come from the snapshot");
+
+    SourceFile *main_file = dependency_graph_find_file(graph, TEST_MAIN);
+    SourceFile *header = dependency_graph_find_file(graph, TEST_HEADER);
+    ASSERT(main_file && main_file->include_count == 1 &&
+           strcmp(main_file->includes[0], TEST_HEADER) == 0, "Includes restored");
+    ASSERT(main_file && main_file->main_known && main_file->has_main, "main() flag restored");
+    ASSERT(header && header->scanned && header->include_count == 0, "Header node restored");
+    ASSERT(dependency_graph_find_main(graph) == main_file, "find_main answers from the flag");
+    dependency_graph_destroy(graph);
+
+    /* Only the edited file is parsed again */
+    create_test_file(TEST_SOURCE, "#include \"util.h\"\nint util(void) { return 22; }\n");
+    backdate_file(TEST_SOURCE);
+    graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    build_cache_provide_includes(cache, graph);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    ASSERT(graph->parsed_count == 1 && graph->reused_count == 2, "Changed file re-parsed");
+    dependency_graph_destroy(graph);
+
+    /* Different include paths can resolve includes differently */
+    graph = dependency_graph_create();
+    build_cache_provide_includes(cache, graph);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    ASSERT(graph->reused_count == 0, "Snapshot ignored when include paths differ");
+    dependency_graph_destroy(graph);
+
+    build_cache_destroy(cache);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_unchanged_scan_not_saved(void) {
+    TEST("Rescanning an Unchanged Tree Does Not Rewrite the Cache");
+
+    setup_project();
+    backdate_file(TEST_HEADER);
+    backdate_file(TEST_SOURCE);
+    backdate_file(TEST_MAIN);
+
+    /* Each run loads the cache, scans through it, records and saves */
+    struct stat saved[3];
+    for (int run = 0; run < 3; run++) {
+        if (run == 2) {
+            create_test_file(TEST_SOURCE, "#include \"util.h\"\nint util(void) { return 55; }\n");
+            backdate_file(TEST_SOURCE);
+        }
+        BuildCache *cache = build_cache_create(TEST_DIR);
+        DependencyGraph *graph = dependency_graph_create();
+        dependency_graph_add_include_path(graph, TEST_DIR);
+        build_cache_provide_includes(cache, graph);
+        dependency_graph_add_file(graph, TEST_SOURCE);
+        dependency_graph_add_file(graph, TEST_MAIN);
+        dependency_graph_set_include_provider(graph, NULL, NULL);
+        build_cache_record_graph(cache, graph);
+        if (run == 1) {
+            ASSERT(graph->reused_count == 3, "Second scan reuses every file");
+            ASSERT(!cache->dirty, "Matching snapshot leaves the cache clean");
+        }
+        ASSERT(build_cache_save(cache), "Cache saved");
+        stat(TEST_CACHE_FILE, &saved[run]);
+        dependency_graph_destroy(graph);
+        build_cache_destroy(cache);
+    }
+
+    ASSERT(saved[1].st_ino == saved[0].st_ino, "Unchanged scan did not replace the file");
+    ASSERT(saved[2].st_ino != saved[1].st_ino, "Edited file recorded again");
+
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_reverse_index_finds_transitive_dependents(void) {
+    TEST("Reverse Index Finds Transitive Dependents");
+
+    setup_project();
+    create_test_file(TEST_DIR "/base.h", "typedef int base_t;\n");
+    create_test_file(TEST_HEADER, "#include \"base.h\"\nint util(void);\n");
+    backdate_file(TEST_DIR "/base.h");
+    backdate_file(TEST_HEADER);
+    backdate_file(TEST_SOURCE);
+    backdate_file(TEST_MAIN);
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    build_cache_provide_includes(cache, graph);
+    dependency_graph_add_file(graph, TEST_SOURCE);
+    dependency_graph_add_file(graph, TEST_MAIN);
+    build_cache_record_graph(cache, graph);
+    record_project(cache, graph);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+
+    /* Entries only record direct includes; the graph links base.h to util.h */
+    cache = build_cache_create(TEST_DIR);
+    const char *sources[4];
+    size_t count = 0;
+    ASSERT(build_cache_get_affected_sources(cache, TEST_DIR "/base.h", sources, 4, &count),
+           "Indirect header known to the cache");
+    ASSERT(count == 2, "Both sources affected through util.h");
+    ASSERT(cache->reverse_starts == NULL, "Answered from the mapped index");
+    ASSERT(build_cache_get_affected_sources(cache, TEST_SOURCE, sources, 4, &count) &&
+           count == 1 && strcmp(sources[0], TEST_SOURCE) == 0, "A source rebuilds itself");
+    ASSERT(!build_cache_get_affected_sources(cache, TEST_DIR "/missing.h", sources, 4, &count),
+           "Unknown file reported");
+
+    build_cache_invalidate_dependents(cache, TEST_DIR "/base.h", NULL);
+    ASSERT(cache->invalidations == 2, "Transitive dependents invalidated without a graph");
+    build_cache_destroy(cache);
+
+    remove(TEST_DIR "/base.h");
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_prune_drops_deleted_sources(void) {
+    TEST("Pruning Drops Entries of Deleted Sources");
+
+    setup_project();
+    const char *extra = TEST_DIR "/extra.c";
+    const char *extra_header = TEST_DIR "/extra.h";
+    create_test_file(extra_header, "int extra(void);\n");
+    create_test_file(extra, "#include \"extra.h\"\nint extra(void) { return 2; }\n");
+
+    DependencyGraph *graph = scan_project();
+    dependency_graph_add_file(graph, extra);
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    build_cache_update(cache, extra, TEST_DIR "/extra.o", graph);
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    /* Deleted after the build: the mapped entry and its paths go stale */
+    remove(extra);
+    remove(extra_header);
+
+    cache = build_cache_create(TEST_DIR);
+    size_t strings_before = cache->string_count;
+    ASSERT(cache->entry_count == 3, "Three entries loaded");
+    ASSERT(build_cache_prune(cache, NULL) == 1, "Entry of the deleted source pruned");
+    ASSERT(cache->entry_count == 2 && build_cache_find(cache, extra) == NULL,
+           "Pruned entry left out of lookups");
+    ASSERT(build_cache_prune(cache, NULL) == 0, "Nothing left to prune");
+
+    /* A source that comes back is recorded again */
+    create_test_file(extra, "int extra(void) { return 3; }\n");
+    build_cache_update(cache, extra, TEST_DIR "/extra.o", graph);
+    ASSERT(cache->entry_count == 3 && build_cache_find(cache, extra) != NULL,
+           "Restored source recorded again");
+    remove(extra);
+    build_cache_prune(cache, NULL);
+
+    ASSERT(build_cache_save(cache), "Cache saved");
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache->entry_count == 2 && build_cache_find(cache, extra) == NULL,
+           "Pruned entry not saved");
+    ASSERT(cache->string_count < strings_before, "Paths only it named compacted away");
+
+    CacheEntry *entry = build_cache_find(cache, TEST_MAIN);
+    ASSERT(entry != NULL && entry->dependency_count == 1 &&
+           strcmp(build_cache_string(cache, entry->object_id), TEST_DIR "/main.o") == 0,
+           "Kept entries resolve after renumbering");
+    SourceFile *source = dependency_graph_find_file(graph, TEST_SOURCE);
+    ASSERT(!build_cache_needs_recompilation(cache, source, NULL), "Kept entry still valid");
+
+    build_cache_destroy(cache);
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+void test_prune_only_when_files_change(void) {
+    TEST("Builds Prune Only When the File Set Changes");
+
+    setup_project();
+    const char *extra = TEST_DIR "/extra.c";
+    create_test_file(extra, "int extra(void) { return 2; }\n");
+
+    DependencyGraph *graph = scan_project();
+    dependency_graph_add_file(graph, extra);
+
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    record_project(cache, graph);
+    build_cache_update(cache, extra, TEST_DIR "/extra.o", graph);
+    ASSERT(build_cache_prune_changed(cache, graph) == 0, "First build checks its entries");
+    build_cache_save(cache);
+    build_cache_destroy(cache);
+
+    /* Same files as last time: the mapped entries are not visited */
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(build_cache_prune_changed(cache, graph) == 0, "Unchanged file set not pruned");
+    ASSERT(!cache->dirty && cache->entry_count == 3, "Nothing to save for the check");
+    build_cache_destroy(cache);
+
+    /* The source is deleted and the next scan no longer finds it */
+    remove(extra);
+    dependency_graph_destroy(graph);
+    graph = scan_project();
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(build_cache_prune_changed(cache, graph) == 1, "Changed file set pruned");
+    ASSERT(cache->dirty && build_cache_save(cache), "New file set saved");
+    build_cache_destroy(cache);
+
+    cache = build_cache_create(TEST_DIR);
+    ASSERT(cache->entry_count == 2, "Pruned entry not saved");
+    ASSERT(build_cache_prune_changed(cache, graph) == 0 && !cache->dirty,
+           "Saved file set matches the next build");
+    build_cache_destroy(cache);
+
+    dependency_graph_destroy(graph);
+    cleanup_project();
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|           Persistent Cache Metadata - Test Suite               |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_save_and_reload();
+    test_overlay_changes_persist();
+    test_saved_cache_is_clean();
+    test_compile_stats_persist();
+    test_corrupt_cache_rejected();
+    test_stat_fast_path();
+    test_hash_memo_shared();
+    test_depfile_entries_provide_includes();
+    test_graph_snapshot_skips_parsing();
+    test_unchanged_scan_not_saved();
+    test_reverse_index_finds_transitive_dependents();
+    test_prune_drops_deleted_sources();
+    test_prune_only_when_files_change();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
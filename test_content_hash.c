@@ -0,0 +1,232 @@
+/**
+ * ==============================================================================
+ * Content Hash Test Suite
+ * ==============================================================================
+ */
+
+#include "content_hash.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_FILE "/tmp/ec_content_hash_test.bin"
+#define BUFFER_SIZE (64 * 1024)
+
+/**
+ * Fill a buffer with deterministic pseudo-random bytes
+ */
+static void fill_pattern(unsigned char *buffer, size_t len) {
+    uint32_t state = 0x12345678u;
+    for (size_t i = 0; i < len; i++) {
+        state = state * 1103515245u + 12345u;
+        buffer[i] = (unsigned char)(state >> 16);
+    }
+}
+
+static bool write_test_file(const unsigned char *data, size_t len) {
+    FILE *fp = fopen(TEST_FILE, "wb");
+    if (!fp) return false;
+
+    size_t written = fwrite(data, 1, len, fp);
+    fclose(fp);
+    return written == len;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_vector_matches_scalar(void) {
+    TEST("Vector Path Matches Scalar Path");
+
+    unsigned char *buffer = malloc(BUFFER_SIZE + 16);
+    fill_pattern(buffer, BUFFER_SIZE + 16);
+    printf("Implementation: %s\n", content_hash_implementation());
+
+    bool all_lengths = true;
+    for (size_t len = 0; len <= 2100; len++) {
+        if (content_hash_bytes(buffer, len) != content_hash_bytes_scalar(buffer, len)) {
+            all_lengths = false;
+        }
+    }
+    ASSERT(all_lengths, "Lengths 0..2100 agree");
+
+    bool all_offsets = true;
+    for (size_t offset = 1; offset < 16; offset++) {
+        size_t len = BUFFER_SIZE - 7;
+        if (content_hash_bytes(buffer + offset, len) !=
+            content_hash_bytes_scalar(buffer + offset, len)) {
+            all_offsets = false;
+        }
+    }
+    ASSERT(all_offsets, "Unaligned inputs agree");
+
+    free(buffer);
+    TEST_END();
+}
+
+void test_distinct_inputs(void) {
+    TEST("Small Changes Change the Hash");
+
+    unsigned char *buffer = malloc(BUFFER_SIZE);
+    fill_pattern(buffer, BUFFER_SIZE);
+
+    /* Flip one bit at a few positions across the short and long paths */
+    const size_t lengths[] = {1, 15, 16, 17, 100, 240, 241, 1024, 1025, 5000, BUFFER_SIZE};
+    bool all_differ = true;
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        size_t len = lengths[i];
+        uint64_t before = content_hash_bytes(buffer, len);
+
+        buffer[0] ^= 0x01;
+        if (content_hash_bytes(buffer, len) == before) all_differ = false;
+        buffer[0] ^= 0x01;
+
+        buffer[len - 1] ^= 0x80;
+        if (content_hash_bytes(buffer, len) == before) all_differ = false;
+        buffer[len - 1] ^= 0x80;
+
+        buffer[len / 2] ^= 0x10;
+        if (content_hash_bytes(buffer, len) == before) all_differ = false;
+        buffer[len / 2] ^= 0x10;
+    }
+    ASSERT(all_differ, "Single-bit flips change the hash");
+
+    ASSERT(content_hash_bytes(buffer, 100) != content_hash_bytes(buffer, 101),
+           "Length is part of the hash");
+
+    /* Reordered chunks must not collide */
+    unsigned char swapped[64];
+    memcpy(swapped, buffer + 16, 16);
+    memcpy(swapped + 16, buffer, 16);
+    memcpy(swapped + 32, buffer + 32, 32);
+    ASSERT(content_hash_bytes(swapped, 64) != content_hash_bytes(buffer, 64),
+           "Swapped chunks hash differently");
+
+    free(buffer);
+    TEST_END();
+}
+
+static void sha256_hex(const void *data, size_t len, char *hex) {
+    uint8_t digest[32];
+    content_hash_sha256(data, len, digest);
+    for (size_t i = 0; i < 32; i++) {
+        sprintf(hex + 2 * i, "%02x", digest[i]);
+    }
+}
+
+void test_sha256_vectors(void) {
+    TEST("SHA-256 Matches the FIPS 180-4 Examples");
+
+    char hex[65];
+    sha256_hex("", 0, hex);
+    ASSERT(strcmp(hex, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855") == 0,
+           "Empty input");
+
+    sha256_hex("abc", 3, hex);
+    ASSERT(strcmp(hex, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") == 0,
+           "One block");
+
+    const char *two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    sha256_hex(two, strlen(two), hex);
+    ASSERT(strcmp(hex, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") == 0,
+           "Padding spills into a second block");
+
+    unsigned char *million = malloc(1000000);
+    memset(million, 'a', 1000000);
+    sha256_hex(million, 1000000, hex);
+    ASSERT(strcmp(hex, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0") == 0,
+           "One million 'a's");
+    free(million);
+
+    TEST_END();
+}
+
+void test_file_hash(void) {
+    TEST("File Hash Matches Buffer Hash");
+
+    unsigned char *buffer = malloc(BUFFER_SIZE);
+    fill_pattern(buffer, BUFFER_SIZE);
+
+    /* 3000 bytes takes the read path, 64 KB the mmap path */
+    ASSERT(write_test_file(buffer, 3000), "Small test file written");
+    ASSERT(content_hash_file(TEST_FILE) == content_hash_bytes(buffer, 3000),
+           "Small file hash matches");
+
+    ASSERT(write_test_file(buffer, BUFFER_SIZE), "Large test file written");
+    ASSERT(content_hash_file(TEST_FILE) == content_hash_bytes(buffer, BUFFER_SIZE),
+           "Large file hash matches");
+
+    ASSERT(write_test_file(buffer, 0), "Empty test file written");
+    ASSERT(content_hash_file(TEST_FILE) != 0, "Empty file hashes to non-zero");
+
+    remove(TEST_FILE);
+    ASSERT(content_hash_file(TEST_FILE) == 0, "Missing file returns 0");
+
+    free(buffer);
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                Content Hash - Test Suite                       |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_vector_matches_scalar();
+    test_distinct_inputs();
+    test_file_hash();
+    test_sha256_vectors();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -5,9 +5,12 @@
  */
 
 #include "dependency_resolver.h"
+#include "depfile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* Test result tracking */
 static int tests_passed = 0;
@@ -141,6 +144,7 @@ void test_simple_dependency(void) {
     }
     
     /* Cleanup */
+    build_order_destroy(&order);
     dependency_graph_destroy(graph);
     remove_test_file("/tmp/test_header.h");
     remove_test_file("/tmp/test_source.c");
@@ -194,6 +198,7 @@ void test_multiple_dependencies(void) {
     ASSERT(main_file != NULL, "Found main() function");
     
     /* Cleanup */
+    build_order_destroy(&order);
     dependency_graph_destroy(graph);
     remove_test_file("/tmp/utils.h");
     remove_test_file("/tmp/math_ops.h");
@@ -276,10 +281,10 @@ void test_transitive_dependencies(void) {
     ASSERT(main_file != NULL, "Found main file");
     
     /* Get all dependencies */
-    SourceFile *deps[MAX_SOURCE_FILES];
+    SourceFile *deps[16];
     size_t dep_count;
     DependencyErrorCode err = dependency_graph_get_all_dependencies(
-        graph, main_file, deps, MAX_SOURCE_FILES, &dep_count
+        graph, main_file, deps, 16, &dep_count
     );
     
     ASSERT(err == DEP_SUCCESS, "Retrieved transitive dependencies");
@@ -328,10 +333,10 @@ void test_library_detection(void) {
     ASSERT(strcmp(main_file->path, "/tmp/app.c") == 0, "main() in correct file");
     
     /* Find libraries */
-    SourceFile *lib_files[MAX_SOURCE_FILES];
+    SourceFile *lib_files[16];
     size_t lib_count;
     DependencyErrorCode err = dependency_graph_find_libraries(
-        graph, lib_files, MAX_SOURCE_FILES, &lib_count
+        graph, lib_files, 16, &lib_count
     );
     
     ASSERT(err == DEP_SUCCESS, "Found library files");
@@ -351,6 +356,423 @@ void test_library_detection(void) {
     TEST_END();
 }
 
+void test_find_file_index(void) {
+    TEST("File Lookup Through Path Index");
+    
+    /* Enough files to force the index to grow several times */
+    const size_t count = 200;
+    char path[64];
+    
+    DependencyGraph *graph = dependency_graph_create();
+    for (size_t i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "/tmp/test_index_%zu.c", i);
+        create_test_file(path, "int x;\n");
+        dependency_graph_add_file(graph, path);
+    }
+    
+    ASSERT(graph->file_count == count, "All files added");
+    
+    bool all_found = true;
+    for (size_t i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "/tmp/test_index_%zu.c", i);
+        SourceFile *file = dependency_graph_find_file(graph, path);
+        if (!file || strcmp(file->path, path) != 0 || file != graph->files[i]) {
+            all_found = false;
+        }
+    }
+    ASSERT(all_found, "Every file found at its own position");
+    ASSERT(dependency_graph_find_file(graph, "/tmp/test_index_missing.c") == NULL,
+           "Unknown path not found");
+    
+    /* Re-adding must not duplicate */
+    dependency_graph_add_file(graph, "/tmp/test_index_0.c");
+    ASSERT(graph->file_count == count, "Duplicate add ignored");
+    
+    /* Cleanup */
+    dependency_graph_destroy(graph);
+    for (size_t i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "/tmp/test_index_%zu.c", i);
+        remove_test_file(path);
+    }
+    
+    TEST_END();
+}
+
+void test_depfile_parse(void) {
+    TEST("Compiler Depfile Parsing");
+    
+    create_test_file("/tmp/test_depfile.d",
+        "build/main.o: main.c util.h \\\n"
+        "  sub/my\\ header.h C:\\inc\\win.h \\\r\n"
+        " cash$$.h\n"
+        "\n"
+        "util.h:\n"
+        "sub/my\\ header.h:\n"
+    );
+    
+    DepfileList deps;
+    depfile_list_init(&deps);
+    ASSERT(depfile_parse("/tmp/test_depfile.d", &deps), "Depfile parsed");
+    ASSERT(deps.count == 4, "Source skipped, four dependencies, phony rules add none");
+    ASSERT(deps.count == 4 && strcmp(deps.paths[0], "util.h") == 0, "Plain path");
+    ASSERT(deps.count == 4 && strcmp(deps.paths[1], "sub/my header.h") == 0, "Escaped space");
+    ASSERT(deps.count == 4 && strcmp(deps.paths[2], "C:\\inc\\win.h") == 0,
+           "Drive letter and backslashes kept");
+    ASSERT(deps.count == 4 && strcmp(deps.paths[3], "cash$.h") == 0, "Escaped dollar");
+    depfile_list_destroy(&deps);
+    
+    create_test_file("/tmp/test_depfile.d", "");
+    depfile_list_init(&deps);
+    ASSERT(!depfile_parse("/tmp/test_depfile.d", &deps), "Empty depfile rejected");
+    ASSERT(!depfile_parse("/tmp/test_depfile_missing.d", &deps), "Missing depfile rejected");
+    depfile_list_destroy(&deps);
+    
+    char path[256];
+    ASSERT(depfile_path_for_object("build/x.o", path, sizeof(path)) &&
+           strcmp(path, "build/x.d") == 0, "Depfile path next to object");
+    ASSERT(depfile_path_for_object("build.dir/x", path, sizeof(path)) &&
+           strcmp(path, "build.dir/x.d") == 0, "Directory dots left alone");
+    
+    remove_test_file("/tmp/test_depfile.d");
+    
+    TEST_END();
+}
+
+/**
+ * Provider that answers for test_provided.c only
+ */
+static IncludeProvision test_include_provider(void *user_data, SourceFile *file) {
+    int *calls = (int *)user_data;
+    (*calls)++;
+    if (strcmp(file->path, "/tmp/test_provided.c") != 0) return INCLUDES_NOT_PROVIDED;
+    
+    source_file_add_include(file, "/tmp/test_provided_a.h");
+    source_file_add_include(file, "/tmp/test_provided_b.h");
+    return INCLUDES_TRANSITIVE;
+}
+
+void test_include_provider_skips_scan(void) {
+    TEST("Include Provider Replaces Parsing");
+    
+    create_test_file("/tmp/test_provided_b.h", "int b;\n");
+    create_test_file("/tmp/test_provided_a.h", "#include \"/tmp/test_provided_b.h\"\n");
+    create_test_file("/tmp/test_provided.c", "int nothing_included;\n");
+    create_test_file("/tmp/test_parsed.c", "#include \"/tmp/test_provided_a.h\"\n");
+    
+    int calls = 0;
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_set_include_provider(graph, test_include_provider, &calls);
+    
+    dependency_graph_add_file(graph, "/tmp/test_provided.c");
+    SourceFile *provided = dependency_graph_find_file(graph, "/tmp/test_provided.c");
+    ASSERT(provided && provided->dependencies_provided && provided->include_count == 2,
+           "Provided list used instead of the file's own includes");
+    ASSERT(graph->provided_count == 1, "Provided file counted");
+    
+    SourceFile *header = dependency_graph_find_file(graph, "/tmp/test_provided_a.h");
+    ASSERT(header && !header->scanned && header->include_count == 0,
+           "Dependencies of a provided file are registered, not parsed");
+    
+    /* A parsed file including the same header forces it to be parsed */
+    dependency_graph_add_file(graph, "/tmp/test_parsed.c");
+    ASSERT(header && header->scanned && header->include_count == 1,
+           "Header parsed once a parsed file includes it");
+    ASSERT(calls == 4, "Provider consulted before every parse");
+    ASSERT(graph->parsed_count == 3, "Parsed files counted");
+    ASSERT(graph->file_count == 4, "No duplicate nodes");
+    
+    dependency_graph_destroy(graph);
+    remove_test_file("/tmp/test_provided_b.h");
+    remove_test_file("/tmp/test_provided_a.h");
+    remove_test_file("/tmp/test_provided.c");
+    remove_test_file("/tmp/test_parsed.c");
+    
+    TEST_END();
+}
+
+#define SCAN_DIR "/tmp/ec_scan_test"
+
+static DependencyGraph *scan_tree(size_t threads) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, SCAN_DIR);
+    dependency_graph_set_scan_threads(graph, threads);
+    dependency_graph_scan_directory(graph, SCAN_DIR, true);
+    return graph;
+}
+
+void test_parallel_scan_deterministic(void) {
+    TEST("Parallel Scan Matches Serial Scan");
+    
+    static const char *dirs[] = {SCAN_DIR, SCAN_DIR "/a", SCAN_DIR "/b",
+                                 SCAN_DIR "/b/c", SCAN_DIR "/build"};
+    static const char *files[] = {SCAN_DIR "/z.c", SCAN_DIR "/m.c", SCAN_DIR "/a/x.c",
+                                  SCAN_DIR "/a/y.h", SCAN_DIR "/b/c/deep.c",
+                                  SCAN_DIR "/b/w.c", SCAN_DIR "/build/skip.c"};
+    const size_t dir_count = sizeof(dirs) / sizeof(dirs[0]);
+    const size_t file_count = sizeof(files) / sizeof(files[0]);
+    
+    for (size_t i = 0; i < dir_count; i++) mkdir(dirs[i], 0755);
+    create_test_file(SCAN_DIR "/inc.h", "int shared;\n");
+    for (size_t i = 0; i < file_count; i++) {
+        create_test_file(files[i], "#include \"inc.h\"\n");
+    }
+    
+    DependencyGraph *serial = scan_tree(1);
+    DependencyGraph *parallel = scan_tree(4);
+    
+    ASSERT(serial->file_count == 7, "Excluded directory skipped");
+    ASSERT(parallel->file_count == serial->file_count, "Same number of files");
+    
+    bool same = parallel->file_count == serial->file_count;
+    bool sorted = true;
+    const char *previous = "";
+    for (size_t i = 0; same && i < serial->file_count; i++) {
+        const char *path = serial->files[i]->path;
+        same = strcmp(path, parallel->files[i]->path) == 0 &&
+               serial->files[i]->include_count == parallel->files[i]->include_count;
+        
+        /* inc.h joins when the first file including it is parsed */
+        if (strcmp(path, SCAN_DIR "/inc.h") == 0) continue;
+        if (strcmp(previous, path) > 0) sorted = false;
+        previous = path;
+    }
+    ASSERT(same, "Same files, includes and order");
+    ASSERT(sorted, "Scanned files added in path order");
+    ASSERT(parallel->parsed_count == serial->parsed_count, "Every file parsed once");
+    
+    SourceFile *deep = dependency_graph_find_file(parallel, SCAN_DIR "/b/c/deep.c");
+    ASSERT(deep && deep->include_count == 1 && strcmp(deep->includes[0], SCAN_DIR "/inc.h") == 0,
+           "Includes resolved by the workers");
+    
+    dependency_graph_destroy(serial);
+    dependency_graph_destroy(parallel);
+    
+    remove_test_file(SCAN_DIR "/inc.h");
+    for (size_t i = 0; i < file_count; i++) remove_test_file(files[i]);
+    for (size_t i = dir_count; i > 0; i--) rmdir(dirs[i - 1]);
+    
+    TEST_END();
+}
+
+void test_include_resolution_memo(void) {
+    TEST("Include Resolutions Are Memoized");
+    
+    mkdir("/tmp/ec_memo_test", 0755);
+    const char *source = "#include \"local.h\"\n#include <stdio.h>\n#include <ec_missing.h>\n";
+    create_test_file("/tmp/ec_memo_test/local.h", "int local;\n");
+    create_test_file("/tmp/ec_memo_test/a.c", source);
+    create_test_file("/tmp/ec_memo_test/b.c", source);
+    
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_file(graph, "/tmp/ec_memo_test/a.c");
+    
+    SourceFile *a = dependency_graph_find_file(graph, "/tmp/ec_memo_test/a.c");
+    ASSERT(a && a->include_count == 1 &&
+           strcmp(a->includes[0], "/tmp/ec_memo_test/local.h") == 0,
+           "Quoted include found next to the including file");
+    
+    size_t lookups, probes;
+    dependency_graph_include_cache_stats(graph, &lookups, &probes);
+    ASSERT(lookups == 3 && probes == 3, "First file probes each include once");
+    
+    dependency_graph_add_file(graph, "/tmp/ec_memo_test/b.c");
+    dependency_graph_include_cache_stats(graph, &lookups, &probes);
+    ASSERT(lookups == 6 && probes == 3, "Second file in the directory needs no probes");
+    
+    dependency_graph_clear_include_cache(graph);
+    dependency_graph_add_include_path(graph, "/tmp/ec_memo_test");
+    remove_test_file("/tmp/ec_memo_test/b.c");
+    create_test_file("/tmp/ec_memo_test/c.c", source);
+    dependency_graph_add_file(graph, "/tmp/ec_memo_test/c.c");
+    dependency_graph_include_cache_stats(graph, &lookups, &probes);
+    ASSERT(probes > 3, "Cleared cache probes again");
+    
+    dependency_graph_destroy(graph);
+    remove_test_file("/tmp/ec_memo_test/local.h");
+    remove_test_file("/tmp/ec_memo_test/a.c");
+    remove_test_file("/tmp/ec_memo_test/c.c");
+    rmdir("/tmp/ec_memo_test");
+    
+    TEST_END();
+}
+
+void test_large_graph(void) {
+    TEST("Graph Grows Past Former Limits");
+    
+    /* More files than the old 1024-file table, one with more than 256 includes */
+    const size_t header_count = 300;
+    const size_t source_count = 1100;
+    char path[128];
+    
+    mkdir("/tmp/ec_large_test", 0755);
+    char *big = malloc(header_count * 32);
+    size_t length = 0;
+    for (size_t i = 0; i < header_count; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_large_test/h_%zu.h", i);
+        create_test_file(path, "int shared;\n");
+        length += (size_t)sprintf(big + length, "#include \"h_%zu.h\"\n", i);
+    }
+    create_test_file("/tmp/ec_large_test/big.c", big);
+    free(big);
+    for (size_t i = 0; i < source_count; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_large_test/s_%zu.c", i);
+        create_test_file(path, "#include \"h_0.h\"\n");
+    }
+    
+    DependencyGraph *graph = dependency_graph_create();
+    DependencyErrorCode err = dependency_graph_scan_directory(graph, "/tmp/ec_large_test", false);
+    ASSERT(err == DEP_SUCCESS, "Scan succeeded");
+    ASSERT(graph->file_count == header_count + source_count + 1, "Every file added");
+    
+    SourceFile *big_file = dependency_graph_find_file(graph, "/tmp/ec_large_test/big.c");
+    SourceFile *small = dependency_graph_find_file(graph, "/tmp/ec_large_test/s_7.c");
+    SourceFile *header = dependency_graph_find_file(graph, "/tmp/ec_large_test/h_0.h");
+    ASSERT(big_file && big_file->include_count == header_count, "Every include kept");
+    ASSERT(big_file && small && header && small->include_count == 1 &&
+           big_file->includes[0] == small->includes[0] && header->path == small->includes[0],
+           "Include paths interned once per graph");
+    
+    BuildOrder order;
+    err = dependency_graph_topological_sort(graph, &order);
+    ASSERT(err == DEP_SUCCESS && order.file_count == graph->file_count, "Build order holds every file");
+    build_order_destroy(&order);
+    
+    dependency_graph_destroy(graph);
+    for (size_t i = 0; i < header_count; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_large_test/h_%zu.h", i);
+        remove_test_file(path);
+    }
+    for (size_t i = 0; i < source_count; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_large_test/s_%zu.c", i);
+        remove_test_file(path);
+    }
+    remove_test_file("/tmp/ec_large_test/big.c");
+    rmdir("/tmp/ec_large_test");
+    
+    TEST_END();
+}
+
+void test_adjacency_and_dependents(void) {
+    TEST("Integer Adjacency and Dependents");
+    
+    mkdir("/tmp/ec_adj_test", 0755);
+    create_test_file("/tmp/ec_adj_test/base.h", "#include <stdio.h>\nint base;\n");
+    create_test_file("/tmp/ec_adj_test/mid.h", "#include \"base.h\"\n");
+    create_test_file("/tmp/ec_adj_test/top.c", "#include \"mid.h\"\n");
+    create_test_file("/tmp/ec_adj_test/side.c", "#include \"base.h\"\n");
+    
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_scan_directory(graph, "/tmp/ec_adj_test", false);
+    const GraphAdjacency *adj = &graph->adjacency;
+    ASSERT(adj->current && adj->node_count == 4, "Scan builds the adjacency");
+    ASSERT(adj->edge_count == 3, "System include has no edge");
+    
+    SourceFile *base = dependency_graph_find_file(graph, "/tmp/ec_adj_test/base.h");
+    SourceFile *mid = dependency_graph_find_file(graph, "/tmp/ec_adj_test/mid.h");
+    SourceFile *top = dependency_graph_find_file(graph, "/tmp/ec_adj_test/top.c");
+    ASSERT(base && mid && top && adj->forward_start[top->id + 1] - adj->forward_start[top->id] == 1 &&
+           adj->forward[adj->forward_start[top->id]] == mid->id, "Forward edge by node id");
+    ASSERT(base && adj->reverse_start[base->id + 1] - adj->reverse_start[base->id] == 2,
+           "Reverse edges list both includers");
+    
+    SourceFile *dependents[8];
+    size_t count = 0;
+    dependency_graph_get_dependents(graph, base, dependents, 8, &count);
+    ASSERT(count == 3, "Dependents are transitive");
+    ASSERT(count == 3 && strcmp(dependents[2]->path, "/tmp/ec_adj_test/top.c") == 0,
+           "Nearest dependents listed first");
+    
+    /* A file added later makes the adjacency stale until it is needed */
+    create_test_file("/tmp/ec_adj_test/late.c", "#include \"mid.h\"\n");
+    dependency_graph_add_file(graph, "/tmp/ec_adj_test/late.c");
+    ASSERT(!graph->adjacency.current, "Adding a file marks the adjacency stale");
+    dependency_graph_get_dependents(graph, base, dependents, 8, &count);
+    ASSERT(count == 4 && graph->adjacency.current, "Rebuilt on demand");
+    dependency_graph_destroy(graph);
+    
+    /* A chain deeper than a recursive walk would handle comfortably */
+    const size_t depth = 3000;
+    char path[128];
+    char content[160];
+    for (size_t i = 0; i < depth; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_adj_test/chain_%zu.h", i);
+        snprintf(content, sizeof(content), i + 1 < depth ? "#include \"chain_%zu.h\"\n" : "int end;\n",
+                 i + 1);
+        create_test_file(path, content);
+    }
+    graph = dependency_graph_create();
+    dependency_graph_add_file(graph, "/tmp/ec_adj_test/chain_0.h");
+    ASSERT(graph->file_count == depth, "Whole chain added");
+    
+    BuildOrder order;
+    DependencyErrorCode err = dependency_graph_topological_sort(graph, &order);
+    ASSERT(err == DEP_SUCCESS && order.file_count == depth &&
+           strcmp(order.ordered_files[0]->path, path) == 0, "Deepest header ordered first");
+    build_order_destroy(&order);
+    ASSERT(!dependency_graph_has_cycle(graph, NULL, 0), "Chain has no cycle");
+    dependency_graph_destroy(graph);
+    
+    for (size_t i = 0; i < depth; i++) {
+        snprintf(path, sizeof(path), "/tmp/ec_adj_test/chain_%zu.h", i);
+        remove_test_file(path);
+    }
+    remove_test_file("/tmp/ec_adj_test/base.h");
+    remove_test_file("/tmp/ec_adj_test/mid.h");
+    remove_test_file("/tmp/ec_adj_test/top.c");
+    remove_test_file("/tmp/ec_adj_test/side.c");
+    remove_test_file("/tmp/ec_adj_test/late.c");
+    rmdir("/tmp/ec_adj_test");
+    
+    TEST_END();
+}
+
+void test_refresh_file(void) {
+    TEST("Refreshing A Changed File");
+    
+    mkdir("/tmp/ec_refresh_test", 0755);
+    create_test_file("/tmp/ec_refresh_test/a.h", "int a;\n");
+    create_test_file("/tmp/ec_refresh_test/b.h", "int b;\n");
+    create_test_file("/tmp/ec_refresh_test/main.c", "#include \"a.h\"\n");
+    
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_scan_directory(graph, "/tmp/ec_refresh_test", false);
+    SourceFile *main_file = dependency_graph_find_file(graph, "/tmp/ec_refresh_test/main.c");
+    ASSERT(main_file && main_file->include_count == 1, "Scanned with one include");
+    
+    /* The edited file is read again in place */
+    create_test_file("/tmp/ec_refresh_test/main.c",
+                     "#include \"b.h\"\n#include \"new.h\"\nint main(void) { return 0; }\n");
+    create_test_file("/tmp/ec_refresh_test/new.h", "int n;\n");
+    DependencyErrorCode err = dependency_graph_refresh_file(graph, "/tmp/ec_refresh_test/main.c");
+    ASSERT(err == DEP_SUCCESS && main_file->include_count == 2 &&
+           strcmp(main_file->includes[0], "/tmp/ec_refresh_test/b.h") == 0,
+           "Includes replaced");
+    ASSERT(source_file_has_main(main_file), "main() found again");
+    ASSERT(dependency_graph_find_file(graph, "/tmp/ec_refresh_test/new.h") != NULL,
+           "Newly included header added");
+    ASSERT(!graph->adjacency.current, "Adjacency marked stale");
+    
+    /* A file the graph has never seen is added */
+    create_test_file("/tmp/ec_refresh_test/extra.c", "#include \"a.h\"\n");
+    err = dependency_graph_refresh_file(graph, "/tmp/ec_refresh_test/extra.c");
+    ASSERT(err == DEP_SUCCESS &&
+           dependency_graph_find_file(graph, "/tmp/ec_refresh_test/extra.c") != NULL,
+           "New file added");
+    
+    remove_test_file("/tmp/ec_refresh_test/extra.c");
+    err = dependency_graph_refresh_file(graph, "/tmp/ec_refresh_test/extra.c");
+    ASSERT(err == DEP_ERROR_FILE_NOT_FOUND, "Removed file reported");
+    
+    dependency_graph_destroy(graph);
+    remove_test_file("/tmp/ec_refresh_test/a.h");
+    remove_test_file("/tmp/ec_refresh_test/b.h");
+    remove_test_file("/tmp/ec_refresh_test/new.h");
+    remove_test_file("/tmp/ec_refresh_test/main.c");
+    rmdir("/tmp/ec_refresh_test");
+    
+    TEST_END();
+}
+
 /* ==============================================================================
  * Main Test Runner
  * ==============================================================================
@@ -370,6 +792,14 @@ int main(void) {
     test_circular_dependency_detection();
     test_transitive_dependencies();
     test_library_detection();
+    test_find_file_index();
+    test_depfile_parse();
+    test_include_provider_skips_scan();
+    test_parallel_scan_deterministic();
+    test_include_resolution_memo();
+    test_large_graph();
+    test_adjacency_and_dependents();
+    test_refresh_file();
     
     /* Print summary */
     printf("\n");
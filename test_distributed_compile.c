@@ -0,0 +1,375 @@
+/**
+ * ==============================================================================
+ * Distributed Compilation Test Suite
+ * ==============================================================================
+ */
+
+#include "distributed_compile.h"
+#include "depfile.h"
+#include "process_spawn.h"
+#include "net_socket.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_dist_test"
+#define TEST_WORK TEST_DIR "/work"
+#define TEST_HEADER TEST_DIR "/answer.h"
+#define TEST_SOURCE TEST_DIR "/answer.c"
+#define TEST_BROKEN TEST_DIR "/broken.c"
+#define TEST_OBJECT TEST_DIR "/answer.o"
+#define TEST_DEPFILE TEST_DIR "/answer.d"
+#define TEST_ALIAS TEST_DIR "/mycompiler"
+#define TEST_LEAK TEST_DIR "/leak.d"
+
+/* Worker answers (DistStatus in distributed_compile.c) */
+#define STATUS_COMPILED 0
+#define STATUS_REFUSED 2
+
+static bool create_test_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+    fputs(content, fp);
+    fclose(fp);
+    return true;
+}
+
+static long file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void setup_dir(void) {
+    mkdir(TEST_DIR, 0755);
+    create_test_file(TEST_HEADER, "#define ANSWER 42\n");
+    create_test_file(TEST_SOURCE, "#include \"answer.h\"\nint answer(void) { return ANSWER; }\n");
+    create_test_file(TEST_BROKEN, "int broken(void) { return }\n");
+}
+
+static void cleanup_dir(void) {
+    remove(TEST_HEADER);
+    remove(TEST_SOURCE);
+    remove(TEST_BROKEN);
+    remove(TEST_OBJECT);
+    remove(TEST_DEPFILE);
+    remove(TEST_ALIAS);
+    remove(TEST_LEAK);
+    rmdir(TEST_WORK);
+    rmdir(TEST_DIR);
+}
+
+static DistServer *start_worker(int jobs) {
+    DistServerOptions options;
+    options.host = "127.0.0.1";
+    options.port = "0";
+    options.jobs = jobs;
+    options.work_dir = TEST_WORK;
+    options.verbose = false;
+    return dist_server_start(&options);
+}
+
+static DistPool *pool_for(const DistServer *server, int slots) {
+    char hosts[64];
+    snprintf(hosts, sizeof(hosts), "127.0.0.1:%d/%d", dist_server_port(server), slots);
+    return dist_pool_create(hosts);
+}
+
+static SourceFile make_source(const char *path) {
+    SourceFile source;
+    memset(&source, 0, sizeof(source));
+    source.path = path;
+    return source;
+}
+
+static void encode_u32(unsigned char *dest, uint32_t value) {
+    for (int i = 0; i < 4; i++) dest[i] = (unsigned char)(value >> (8 * i));
+}
+
+/**
+ * Send a worker a job by hand, the way a hostile client would, past the
+ * client's own flag checks
+ *
+ * @return  The worker's status, or -1 on a transport error
+ */
+static int send_raw_job(const DistServer *server, const char *const *argv, uint32_t argc,
+                        const char *unit) {
+    char port[16];
+    snprintf(port, sizeof(port), "%d", dist_server_port(server));
+    net_socket_t sock = net_connect("127.0.0.1", port, 10000);
+    if (sock == NET_SOCKET_NONE) return -1;
+
+    unsigned char word[8];
+    encode_u32(word, argc);
+    bool ok = net_send_all(sock, "ECD1", 4) && net_send_all(sock, word, 4);
+    for (uint32_t i = 0; ok && i < argc; i++) {
+        encode_u32(word, (uint32_t)strlen(argv[i]));
+        ok = net_send_all(sock, word, 4) && net_send_all(sock, argv[i], strlen(argv[i]));
+    }
+
+    /* C unit, then its size as a u64 and its bytes */
+    encode_u32(word, 0);
+    ok = ok && net_send_all(sock, word, 4);
+    encode_u32(word, (uint32_t)strlen(unit));
+    encode_u32(word + 4, 0);
+    ok = ok && net_send_all(sock, word, 8) && net_send_all(sock, unit, strlen(unit));
+
+    unsigned char reply[8];
+    ok = ok && net_recv_all(sock, reply, sizeof(reply)) && memcmp(reply, "ECD1", 4) == 0;
+    net_close(sock);
+    return ok ? (int)reply[4] : -1;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_host_lists(void) {
+    TEST("Worker Lists Are Parsed");
+
+    DistPool *pool = dist_pool_create("alpha, beta:4000/8,[::1]:5000");
+    ASSERT(pool && pool->worker_count == 3, "Three workers");
+    if (pool) {
+        ASSERT(strcmp(pool->workers[0].host, "alpha") == 0 &&
+               strcmp(pool->workers[0].port, DIST_DEFAULT_PORT) == 0 &&
+               pool->workers[0].slots == DIST_DEFAULT_SLOTS, "Port and slots default");
+        ASSERT(strcmp(pool->workers[1].host, "beta") == 0 &&
+               strcmp(pool->workers[1].port, "4000") == 0 &&
+               pool->workers[1].slots == 8, "Port and slots given");
+        ASSERT(strcmp(pool->workers[2].host, "::1") == 0 &&
+               strcmp(pool->workers[2].port, "5000") == 0, "IPv6 literal unbracketed");
+        ASSERT(dist_pool_slots(pool) == 8 + 2 * DIST_DEFAULT_SLOTS, "Slots summed");
+    }
+    dist_pool_destroy(pool);
+
+    ASSERT(dist_pool_create("") == NULL, "Empty list refused");
+    ASSERT(dist_pool_create("host:/2") == NULL, "Empty port refused");
+    ASSERT(dist_pool_create("host/0") == NULL, "Zero slots refused");
+    ASSERT(dist_pool_create("host:http") == NULL, "Named port refused");
+
+    TEST_END();
+}
+
+void test_remote_compile(void) {
+    TEST("A Source Is Compiled on a Worker");
+
+    setup_dir();
+    DistServer *server = start_worker(2);
+    ASSERT(server != NULL, "Worker started");
+
+    DistPool *pool = pool_for(server, 2);
+    BuildConfig *config = build_config_create();
+    ASSERT(build_config_auto_detect_compiler(config), "Compiler found");
+    build_config_add_include_path(config, TEST_DIR);
+    config->use_depfiles = true;
+
+    SourceFile source = make_source(TEST_SOURCE);
+    CompileResult result;
+    ASSERT(dist_compile_source(pool, &source, config, TEST_OBJECT, &result), "Compiled remotely");
+    ASSERT(result.success && strcmp(result.object_file, TEST_OBJECT) == 0, "Result filled in");
+    ASSERT(file_size(TEST_OBJECT) > 0, "Object placed");
+    ASSERT(pool->remote_compiles == 1 && pool->workers[0].compiled == 1, "Remote compile counted");
+    compile_result_destroy(&result);
+
+    DepfileList deps;
+    depfile_list_init(&deps);
+    ASSERT(depfile_parse(TEST_DEPFILE, &deps) && deps.count == 1 &&
+           strstr(deps.paths[0], "answer.h") != NULL,
+           "Depfile written by the local preprocessor");
+    depfile_list_destroy(&deps);
+
+    char unit[256];
+    snprintf(unit, sizeof(unit), "%s.i", TEST_OBJECT);
+    ASSERT(file_size(unit) < 0, "Preprocessed unit removed");
+
+    build_config_destroy(config);
+    dist_pool_destroy(pool);
+    dist_server_stop(server);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+void test_fallbacks(void) {
+    TEST("Failures Hand the Source Back");
+
+    setup_dir();
+    DistServer *server = start_worker(1);
+    DistPool *pool = pool_for(server, 1);
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+
+    /* A compile error is the source's fault: fall back, keep the worker */
+    SourceFile broken = make_source(TEST_BROKEN);
+    CompileResult result;
+    ASSERT(!dist_compile_source(pool, &broken, config, TEST_OBJECT, &result),
+           "Broken source handed back");
+    ASSERT(pool->workers[0].failures == 0 && !pool->workers[0].disabled, "Worker kept");
+
+    /* A compiler the worker will not run counts against the worker */
+    char real_compiler[512];
+    process_find_executable(config->compiler_path, real_compiler, sizeof(real_compiler));
+    symlink(real_compiler, TEST_ALIAS);
+    free(config->compiler_path);
+    config->compiler_path = strdup(TEST_ALIAS);
+    SourceFile source = make_source(TEST_SOURCE);
+    build_config_add_include_path(config, TEST_DIR);
+    bool any_remote = false;
+    for (int i = 0; i < DIST_MAX_FAILURES; i++) {
+        if (dist_compile_source(pool, &source, config, TEST_OBJECT, &result)) any_remote = true;
+    }
+    ASSERT(!any_remote, "Refused compiler handed back");
+    ASSERT(pool->workers[0].disabled, "Worker dropped after repeated refusals");
+    ASSERT(pool->remote_compiles == 0 && pool->local_fallbacks == DIST_MAX_FAILURES + 1,
+           "Fallbacks counted");
+
+    free(config->compiler_path);
+    config->compiler_path = NULL;
+    build_config_auto_detect_compiler(config);
+    ASSERT(!dist_compile_source(pool, &source, config, TEST_OBJECT, &result),
+           "Empty pool compiles nothing remotely");
+
+    build_config_destroy(config);
+    dist_pool_destroy(pool);
+    dist_server_stop(server);
+
+    /* Nobody listening */
+    server = start_worker(1);
+    pool = pool_for(server, 1);
+    dist_server_stop(server);
+    config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    build_config_add_include_path(config, TEST_DIR);
+    ASSERT(!dist_compile_source(pool, &source, config, TEST_OBJECT, &result),
+           "Unreachable worker handed back");
+    ASSERT(pool->workers[0].failures == 1, "Connection failure counted");
+
+    build_config_destroy(config);
+    dist_pool_destroy(pool);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+void test_worker_flag_allowlist(void) {
+    TEST("Workers Run Only Allowed Flags");
+
+    ASSERT(dist_flag_allowed("-O2") && dist_flag_allowed("-g") && dist_flag_allowed("-Wall") &&
+           dist_flag_allowed("-Wno-unused") && dist_flag_allowed("-std=c99") &&
+           dist_flag_allowed("-fPIC") && dist_flag_allowed("-march=native") &&
+           dist_flag_allowed("-DNDEBUG") && dist_flag_allowed("-c"),
+           "Flags ecbuild sends accepted");
+    ASSERT(!dist_flag_allowed("-MD") && !dist_flag_allowed("-MF/tmp/x") &&
+           !dist_flag_allowed("-Wp,-MD,/tmp/x") && !dist_flag_allowed("-Wa,-o,/tmp/x") &&
+           !dist_flag_allowed("-Wl,-o,/tmp/x"),
+           "Flags that write files refused");
+    ASSERT(!dist_flag_allowed("-include/etc/passwd") && !dist_flag_allowed("-imacros/etc/passwd") &&
+           !dist_flag_allowed("-I/etc") && !dist_flag_allowed("--sysroot=/") &&
+           !dist_flag_allowed("@/tmp/args") && !dist_flag_allowed("/etc/passwd"),
+           "Flags that read files refused");
+    ASSERT(!dist_flag_allowed("-fdump-tree-all") && !dist_flag_allowed("-fprofile-generate") &&
+           !dist_flag_allowed("-fplugin=evil.so") && !dist_flag_allowed("-fauto-profile=/tmp/x") &&
+           !dist_flag_allowed("-B/tmp") && !dist_flag_allowed("-o") && !dist_flag_allowed("-x"),
+           "Dumps, profiles, plugins and redirections refused");
+
+    setup_dir();
+    DistServer *server = start_worker(1);
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    const char *compiler = strrchr(config->compiler_path, '/');
+    compiler = compiler ? compiler + 1 : config->compiler_path;
+    const char *unit = "int answer(void) { return 42; }\n";
+
+    const char *plain[] = { compiler, "-O2", "-Wall" };
+    ASSERT(send_raw_job(server, plain, 3, unit) == STATUS_COMPILED, "Ordinary job compiled");
+
+    const char *depfile[] = { compiler, "-MD", "-MF" TEST_LEAK };
+    ASSERT(send_raw_job(server, depfile, 3, unit) == STATUS_REFUSED &&
+           file_size(TEST_LEAK) < 0, "-MF job refused, nothing written");
+
+    const char *wrapped[] = { compiler, "-Wp,-MD," TEST_LEAK };
+    ASSERT(send_raw_job(server, wrapped, 2, unit) == STATUS_REFUSED &&
+           file_size(TEST_LEAK) < 0, "-Wp,-MD job refused, nothing written");
+
+    /* The client keeps such a source local instead of sending it */
+    DistPool *pool = pool_for(server, 1);
+    build_config_add_include_path(config, TEST_DIR);
+    build_config_add_cflag(config, "-Wp,-MD," TEST_LEAK);
+    SourceFile source = make_source(TEST_SOURCE);
+    CompileResult result;
+    ASSERT(!dist_compile_source(pool, &source, config, TEST_OBJECT, &result) &&
+           pool->workers[0].failures == 0 && pool->local_fallbacks == 1,
+           "Client compiles unsendable flags locally, worker kept");
+    ASSERT(file_size(TEST_LEAK) < 0, "Nothing written by the client either");
+
+    build_config_destroy(config);
+    dist_pool_destroy(pool);
+    dist_server_stop(server);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|             Distributed Compilation - Test Suite               |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_host_lists();
+    test_remote_compile();
+    test_fallbacks();
+    test_worker_flag_allowlist();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,586 @@
+/**
+ * ==============================================================================
+ * EventChains Core Test Suite
+ * ==============================================================================
+ */
+
+#include "include/eventchains.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define MAX_TEST_EVENTS 64
+
+/**
+ * Shared record of which events ran and in what order
+ */
+typedef struct ExecutionLog {
+    ec_mutex_t mutex;
+    int order[MAX_TEST_EVENTS];
+    size_t count;
+} ExecutionLog;
+
+/**
+ * Memory cost of the events running at once, and its high-water mark
+ */
+typedef struct MemoryProbe {
+    ec_mutex_t mutex;
+    uint64_t in_flight;
+    uint64_t peak;
+} MemoryProbe;
+
+typedef struct TestEventData {
+    ExecutionLog *log;
+    int id;
+    bool fail;
+    MemoryProbe *probe;                     /* Optional */
+    uint64_t memory;                        /* Cost reported to the probe */
+} TestEventData;
+
+static void sleep_ms(long ms) {
+    struct timespec delay;
+    delay.tv_sec = ms / 1000;
+    delay.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&delay, NULL);
+}
+
+static EventResult test_event_execute(EventContext *context, void *user_data) {
+    (void)context;
+    TestEventData *data = (TestEventData *)user_data;
+    EventResult result;
+
+    ec_mutex_lock(&data->log->mutex);
+    data->log->order[data->log->count++] = data->id;
+    ec_mutex_unlock(&data->log->mutex);
+
+    if (data->probe) {
+        ec_mutex_lock(&data->probe->mutex);
+        data->probe->in_flight += data->memory;
+        if (data->probe->in_flight > data->probe->peak) {
+            data->probe->peak = data->probe->in_flight;
+        }
+        ec_mutex_unlock(&data->probe->mutex);
+
+        sleep_ms(5);
+
+        ec_mutex_lock(&data->probe->mutex);
+        data->probe->in_flight -= data->memory;
+        ec_mutex_unlock(&data->probe->mutex);
+    }
+
+    if (data->fail) {
+        event_result_failure(&result, "Intentional failure",
+                             EC_ERROR_EVENT_EXECUTION_FAILED, ERROR_DETAIL_FULL);
+    } else {
+        event_result_success(&result);
+    }
+    return result;
+}
+
+static EventChain *create_test_chain(
+    FaultToleranceMode mode,
+    ExecutionLog *log,
+    TestEventData *data,
+    size_t count
+) {
+    EventChain *chain = event_chain_create(mode);
+    if (!chain) return NULL;
+
+    for (size_t i = 0; i < count; i++) {
+        data[i].log = log;
+        data[i].id = (int)i;
+
+        char name[64];
+        snprintf(name, sizeof(name), "Event%zu", i);
+        event_chain_add_event(chain, chainable_event_create(test_event_execute, &data[i], name));
+    }
+
+    return chain;
+}
+
+/**
+ * Per-worker event counts kept by a test middleware, plus the order its
+ * batch hooks ran in (shared between middlewares)
+ */
+typedef struct BatchProbe {
+    char name;
+    char *hook_log;
+    size_t batch_workers;
+    size_t batches;
+    size_t counts[MAX_TEST_EVENTS];
+    bool index_out_of_range;
+} BatchProbe;
+
+static void probe_before_batch(const EventBatch *batch, void *user_data) {
+    BatchProbe *probe = (BatchProbe *)user_data;
+    strncat(probe->hook_log, &probe->name, 1);
+    probe->batch_workers = batch->worker_count;
+    probe->batches++;
+    memset(probe->counts, 0, sizeof(probe->counts));
+}
+
+static void probe_after_batch(const EventBatch *batch, void *user_data) {
+    BatchProbe *probe = (BatchProbe *)user_data;
+    char lower = (char)(probe->name - 'A' + 'a');
+    strncat(probe->hook_log, &lower, 1);
+    (void)batch;
+}
+
+static void probe_middleware_execute(
+    EventResult *result_ptr,
+    ChainableEvent *event,
+    EventContext *context,
+    void (*next)(EventResult *, ChainableEvent *, EventContext *, void *),
+    void *next_data,
+    void *user_data
+) {
+    BatchProbe *probe = (BatchProbe *)user_data;
+    size_t worker = event_chain_worker_index();
+    if (worker < probe->batch_workers) {
+        probe->counts[worker]++;
+    } else {
+        probe->index_out_of_range = true;
+    }
+    next(result_ptr, event, context, next_data);
+}
+
+static size_t probe_total(const BatchProbe *probe) {
+    size_t total = 0;
+    for (size_t i = 0; i < MAX_TEST_EVENTS; i++) {
+        total += probe->counts[i];
+    }
+    return total;
+}
+
+static size_t position_of(const ExecutionLog *log, int id) {
+    for (size_t i = 0; i < log->count; i++) {
+        if (log->order[i] == id) return i;
+    }
+    return SIZE_MAX;
+}
+
+#define CONTEXT_WORKERS 8
+#define KEYS_PER_WORKER 500
+
+typedef struct ContextWorker {
+    EventContext *context;
+    int id;
+    size_t misses;                          /* Lookups that came back wrong */
+} ContextWorker;
+
+static void *context_worker(void *arg) {
+    ContextWorker *worker = (ContextWorker *)arg;
+    for (int i = 0; i < KEYS_PER_WORKER; i++) {
+        void *config = NULL;
+        if (event_context_get(worker->context, "build.config", &config) != EC_SUCCESS ||
+            config != (void *)worker->context) {
+            worker->misses++;
+        }
+
+        char key[64];
+        snprintf(key, sizeof(key), "object:worker%d/file%d.o", worker->id, i);
+        if (event_context_set(worker->context, key, (void *)(intptr_t)(i + 1)) != EC_SUCCESS) {
+            worker->misses++;
+        }
+    }
+    return NULL;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_context_many_keys(void) {
+    TEST("Context Holds Thousands of Keys");
+
+    EventContext *context = event_context_create();
+    ASSERT(event_chain_get_max_context_entries() == SIZE_MAX, "No entry limit");
+
+    bool all_set = true;
+    for (int i = 0; i < 5000; i++) {
+        char key[64];
+        snprintf(key, sizeof(key), "object:src/file%d.c", i);
+        all_set = all_set && event_context_set(context, key, (void *)(intptr_t)(i + 1)) == EC_SUCCESS;
+    }
+    ASSERT(all_set && event_context_count(context) == 5000, "5000 keys stored");
+
+    /* Remove every other key; the rest must still be found past the holes */
+    for (int i = 0; i < 5000; i += 2) {
+        char key[64];
+        snprintf(key, sizeof(key), "object:src/file%d.c", i);
+        event_context_remove(context, key);
+    }
+
+    bool all_right = true;
+    for (int i = 0; i < 5000; i++) {
+        char key[64];
+        snprintf(key, sizeof(key), "object:src/file%d.c", i);
+        void *value = NULL;
+        EventChainErrorCode err = event_context_get(context, key, &value);
+        if (i % 2 == 0) {
+            all_right = all_right && err == EC_ERROR_NOT_FOUND &&
+                        !event_context_has(context, key, true);
+        } else {
+            all_right = all_right && err == EC_SUCCESS && value == (void *)(intptr_t)(i + 1) &&
+                        event_context_has(context, key, true);
+        }
+    }
+    ASSERT(all_right && event_context_count(context) == 2500, "Removed keys gone, others intact");
+
+    size_t before = event_context_memory_usage(context);
+    event_context_set(context, "object:src/file1.c", NULL);
+    ASSERT(event_context_memory_usage(context) == before, "Overwrite costs nothing extra");
+
+    event_context_clear(context);
+    ASSERT(event_context_count(context) == 0 && !event_context_has(context, "object:src/file1.c", false),
+           "Cleared");
+
+    event_context_destroy(context);
+
+    TEST_END();
+}
+
+void test_context_parallel_access(void) {
+    TEST("Context Serves Parallel Readers and Writers");
+
+    EventContext *context = event_context_create();
+    event_context_set(context, "build.config", context);
+
+    ContextWorker workers[CONTEXT_WORKERS];
+    ec_thread_t threads[CONTEXT_WORKERS];
+    for (int i = 0; i < CONTEXT_WORKERS; i++) {
+        workers[i].context = context;
+        workers[i].id = i;
+        workers[i].misses = 0;
+        ec_thread_create(&threads[i], context_worker, &workers[i]);
+    }
+
+    size_t misses = 0;
+    for (int i = 0; i < CONTEXT_WORKERS; i++) {
+        ec_thread_join(threads[i]);
+        misses += workers[i].misses;
+    }
+
+    ASSERT(misses == 0, "Every read saw the shared key, every write succeeded");
+    ASSERT(event_context_count(context) == 1 + CONTEXT_WORKERS * KEYS_PER_WORKER,
+           "No write was lost");
+
+    void *value = NULL;
+    ASSERT(event_context_get(context, "object:worker3/file499.o", &value) == EC_SUCCESS &&
+           value == (void *)(intptr_t)500, "Written values readable");
+
+    event_context_destroy(context);
+
+    TEST_END();
+}
+
+
+void test_parallel_runs_all_events(void) {
+    TEST("Parallel Execution Runs Every Event");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[32] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 32);
+    ASSERT(chain != NULL, "Chain created");
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 8, &result);
+
+    ASSERT(result.success, "Chain succeeded");
+    ASSERT(result.failure_count == 0, "No failures recorded");
+    ASSERT(log.count == 32, "All 32 events executed exactly once");
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_parallel_respects_dependencies(void) {
+    TEST("Parallel Execution Respects Dependencies");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[6] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 6);
+
+    /* 0 -> 2, 1 -> 2, 2 -> 5, 3 -> 4 */
+    ASSERT(event_chain_add_dependency(chain, 2, 0) == EC_SUCCESS, "Added 2 after 0");
+    ASSERT(event_chain_add_dependency(chain, 2, 1) == EC_SUCCESS, "Added 2 after 1");
+    ASSERT(event_chain_add_dependency(chain, 5, 2) == EC_SUCCESS, "Added 5 after 2");
+    ASSERT(event_chain_add_dependency(chain, 4, 3) == EC_SUCCESS, "Added 4 after 3");
+    ASSERT(event_chain_add_dependency(chain, 1, 4) == EC_ERROR_INVALID_PARAMETER,
+           "Forward dependency rejected");
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 4, &result);
+
+    ASSERT(result.success, "Chain succeeded");
+    ASSERT(log.count == 6, "All events executed");
+    ASSERT(position_of(&log, 2) > position_of(&log, 0) &&
+           position_of(&log, 2) > position_of(&log, 1), "Event 2 ran after 0 and 1");
+    ASSERT(position_of(&log, 5) > position_of(&log, 2), "Event 5 ran after 2");
+    ASSERT(position_of(&log, 4) > position_of(&log, 3), "Event 4 ran after 3");
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_parallel_strict_failure(void) {
+    TEST("Parallel Strict Mode Stops Dispatching");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[8] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 8);
+    data[0].fail = true;
+
+    /* Everything waits for event 0, so nothing else may start */
+    for (size_t i = 1; i < 8; i++) {
+        event_chain_add_dependency(chain, i, 0);
+    }
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 4, &result);
+
+    ASSERT(!result.success, "Chain reported failure");
+    ASSERT(result.failure_count == 1, "Exactly one failure recorded");
+    ASSERT(log.count == 1, "No dependent event was dispatched");
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_parallel_lenient_skips_dependents(void) {
+    TEST("Parallel Lenient Mode Skips Dependents Only");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[5] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_LENIENT, &log, data, 5);
+    data[1].fail = true;
+    event_chain_add_dependency(chain, 3, 1);
+    event_chain_add_dependency(chain, 4, 3);
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 3, &result);
+
+    ASSERT(log.count == 3, "Independent events 0, 1 and 2 executed");
+    ASSERT(position_of(&log, 3) == SIZE_MAX && position_of(&log, 4) == SIZE_MAX,
+           "Transitive dependents of the failure were skipped");
+    ASSERT(result.failure_count == 3, "Failure and two skips recorded");
+
+    if (result.failure_count == 3) {
+        FailureInfo *failures = (FailureInfo *)result.failures;
+        ASSERT(strcmp(failures[0].event_name, "Event1") == 0 &&
+               strcmp(failures[1].event_name, "Event3") == 0 &&
+               strcmp(failures[2].event_name, "Event4") == 0,
+               "Failures reported in event order");
+    }
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_parallel_priority_order(void) {
+    TEST("Ready Events Start Highest Priority First");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[6] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 6);
+    const double priorities[6] = { 1.0, 5.0, 3.0, 0.0, 4.0, 2.0 };
+    bool scheduled = true;
+    for (size_t i = 0; i < 6; i++) {
+        scheduled = scheduled &&
+                    event_chain_set_event_schedule(chain, i, priorities[i], 1) == EC_SUCCESS;
+    }
+    ASSERT(scheduled, "Priorities set");
+    ASSERT(event_chain_set_event_schedule(chain, 6, 1.0, 1) == EC_ERROR_INVALID_PARAMETER,
+           "Unknown event rejected");
+
+    /* Event 5 outranks two others, but has to wait for the lowest */
+    ASSERT(event_chain_add_dependency(chain, 5, 3) == EC_SUCCESS, "Added 5 after 3");
+
+    /* A budget of one event at a time makes the dispatch order observable */
+    event_chain_set_memory_budget(chain, 1);
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 4, &result);
+
+    const int expected[6] = { 1, 4, 2, 0, 3, 5 };
+    bool in_order = log.count == 6;
+    for (size_t i = 0; in_order && i < 6; i++) {
+        in_order = log.order[i] == expected[i];
+    }
+    ASSERT(result.success, "Chain succeeded");
+    ASSERT(in_order, "Dispatched by priority, dependencies still honored");
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_parallel_memory_budget(void) {
+    TEST("Memory Budget Caps Concurrent Events");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    MemoryProbe probe = {0};
+    ec_mutex_init(&probe.mutex);
+    TestEventData data[12] = {{0}};
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 12);
+    for (size_t i = 0; i < 12; i++) {
+        data[i].probe = &probe;
+        data[i].memory = i == 6 ? 100 : 30;
+        event_chain_set_event_schedule(chain, i, 0.0, data[i].memory);
+    }
+    event_chain_set_memory_budget(chain, 64);
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 8, &result);
+
+    ASSERT(result.success && log.count == 12, "Every event ran");
+    ASSERT(probe.peak <= 100, "Never more than two light events, or the heavy one alone");
+
+    chain_result_destroy(&result);
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&probe.mutex);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+void test_middleware_batches(void) {
+    TEST("Middleware Batch Hooks and Worker Slots");
+
+    ExecutionLog log = {0};
+    ec_mutex_init(&log.mutex);
+    TestEventData data[32] = {{0}};
+    char hook_log[16] = "";
+    BatchProbe outer = { .name = 'A', .hook_log = hook_log };
+    BatchProbe inner = { .name = 'B', .hook_log = hook_log };
+
+    EventChain *chain = create_test_chain(FAULT_TOLERANCE_STRICT, &log, data, 32);
+    EventMiddleware *outer_mw = event_middleware_create(probe_middleware_execute, &outer, "Outer");
+    EventMiddleware *inner_mw = event_middleware_create(probe_middleware_execute, &inner, "Inner");
+    event_middleware_set_batch_hooks(outer_mw, probe_before_batch, probe_after_batch);
+    event_middleware_set_batch_hooks(inner_mw, probe_before_batch, probe_after_batch);
+    ASSERT(event_chain_use_middleware(chain, outer_mw) == EC_SUCCESS &&
+           event_chain_use_middleware(chain, inner_mw) == EC_SUCCESS, "Middleware attached");
+
+    ChainResult result;
+    event_chain_execute_parallel(chain, 8, &result);
+    ASSERT(result.success && log.count == 32, "Every event ran");
+    ASSERT(strcmp(hook_log, "ABba") == 0, "Before hooks in order, after hooks reversed");
+    ASSERT(outer.batches == 1 && outer.batch_workers == 8, "One batch of eight workers");
+    ASSERT(!outer.index_out_of_range && !inner.index_out_of_range, "Worker indexes in range");
+    ASSERT(probe_total(&outer) == 32 && probe_total(&inner) == 32,
+           "Events counted once per layer without locks");
+    chain_result_destroy(&result);
+
+    hook_log[0] = '\0';
+    log.count = 0;
+    event_chain_execute(chain, &result);
+    ASSERT(result.success && strcmp(hook_log, "ABba") == 0, "Sequential runs are a batch too");
+    ASSERT(outer.batch_workers == 1 && outer.counts[0] == 32 && !outer.index_out_of_range,
+           "Sequential events all on worker 0");
+    chain_result_destroy(&result);
+
+    event_chain_destroy(chain);
+    ec_mutex_destroy(&log.mutex);
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|               EventChains Core - Test Suite                    |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    event_chain_initialize();
+
+    /* Run all tests */
+    test_context_many_keys();
+    test_context_parallel_access();
+    test_parallel_runs_all_events();
+    test_parallel_respects_dependencies();
+    test_parallel_strict_failure();
+    test_parallel_lenient_skips_dependents();
+    test_parallel_priority_order();
+    test_parallel_memory_budget();
+    test_middleware_batches();
+
+    event_chain_cleanup();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/**
+ * ==============================================================================
+ * Source Tree Watching Test Suite
+ * ==============================================================================
+ */
+
+#include "file_watch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_file_watch_test"
+#define WAIT_MS 3000                            /* Generous, for the polling fallback */
+
+static void write_file(const char *path, const char *content, const char *mode) {
+    FILE *fp = fopen(path, mode);
+    if (fp) {
+        fputs(content, fp);
+        fclose(fp);
+    }
+}
+
+static void cleanup_tree(void) {
+    static const char *const files[] = {
+        TEST_DIR "/main.c", TEST_DIR "/util.h", TEST_DIR "/extra.c", TEST_DIR "/notes.txt",
+        TEST_DIR "/build/main.o", TEST_DIR "/build/generated.c", TEST_DIR "/sub/nested.c"
+    };
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) remove(files[i]);
+    rmdir(TEST_DIR "/build");
+    rmdir(TEST_DIR "/sub");
+    rmdir(TEST_DIR);
+}
+
+static void setup_tree(void) {
+    cleanup_tree();
+    mkdir(TEST_DIR, 0755);
+    mkdir(TEST_DIR "/build", 0755);
+    write_file(TEST_DIR "/main.c", "int main(void) { return 0; }\n", "w");
+    write_file(TEST_DIR "/util.h", "#pragma once\n", "w");
+}
+
+static const FileChange *find_change(const FileChangeList *list, const char *path) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (strcmp(list->changes[i].path, path) == 0) return &list->changes[i];
+    }
+    return NULL;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_change_list_merging(void) {
+    TEST("Change List Merges Changes To One File");
+
+    FileChangeList list;
+    file_change_list_init(&list);
+
+    file_change_list_add(&list, "a.c", FILE_CHANGE_ADDED);
+    file_change_list_add(&list, "a.c", FILE_CHANGE_MODIFIED);
+    ASSERT(list.count == 1 && list.changes[0].kind == FILE_CHANGE_ADDED,
+           "Added then modified stays added");
+
+    file_change_list_add(&list, "a.c", FILE_CHANGE_REMOVED);
+    ASSERT(list.count == 0, "Added then removed is dropped");
+
+    file_change_list_add(&list, "b.c", FILE_CHANGE_REMOVED);
+    file_change_list_add(&list, "b.c", FILE_CHANGE_ADDED);
+    ASSERT(list.count == 1 && list.changes[0].kind == FILE_CHANGE_MODIFIED,
+           "Removed then added is a modification");
+
+    file_change_list_add(&list, "c.h", FILE_CHANGE_MODIFIED);
+    file_change_list_add(&list, "c.h", FILE_CHANGE_REMOVED);
+    ASSERT(list.count == 2 && find_change(&list, "c.h")->kind == FILE_CHANGE_REMOVED,
+           "Modified then removed is removed");
+
+    file_change_list_destroy(&list);
+    ASSERT(list.count == 0 && list.changes == NULL && !list.rescan, "Destroy empties the list");
+
+    TEST_END();
+}
+
+void test_watch_sources(void) {
+    TEST("Watcher Reports Source Changes");
+
+    setup_tree();
+    FileWatch *watch = file_watch_create(TEST_DIR, NULL, 0);
+    ASSERT(watch != NULL, "Watcher created");
+    if (!watch) {
+        TEST_END();
+        return;
+    }
+    printf("Mechanism: %s\n", file_watch_is_polling(watch) ? "polling" : "notifications");
+
+    FileChangeList changes;
+    file_change_list_init(&changes);
+    ASSERT(file_watch_wait(watch, 200, &changes) == 0, "Quiet tree times out");
+
+    write_file(TEST_DIR "/main.c", "/* edited */\n", "a");
+    ASSERT(file_watch_wait(watch, WAIT_MS, &changes) == 1, "Edit reported");
+    const FileChange *change = find_change(&changes, TEST_DIR "/main.c");
+    ASSERT(change && change->kind == FILE_CHANGE_MODIFIED && changes.count == 1,
+           "Edited source is modified");
+    file_change_list_destroy(&changes);
+
+    write_file(TEST_DIR "/extra.c", "int extra;\n", "w");
+    ASSERT(file_watch_wait(watch, WAIT_MS, &changes) == 1, "New file reported");
+    change = find_change(&changes, TEST_DIR "/extra.c");
+    ASSERT(change && change->kind == FILE_CHANGE_ADDED, "New source is added");
+    file_change_list_destroy(&changes);
+
+    remove(TEST_DIR "/util.h");
+    ASSERT(file_watch_wait(watch, WAIT_MS, &changes) == 1, "Removal reported");
+    change = find_change(&changes, TEST_DIR "/util.h");
+    ASSERT(change && change->kind == FILE_CHANGE_REMOVED, "Removed header is removed");
+    file_change_list_destroy(&changes);
+
+    /* Build output and files the scanner ignores do not wake the watcher */
+    write_file(TEST_DIR "/build/main.o", "object", "w");
+    write_file(TEST_DIR "/build/generated.c", "int generated;\n", "w");
+    write_file(TEST_DIR "/notes.txt", "not a source\n", "w");
+    ASSERT(file_watch_wait(watch, 1200, &changes) == 0 && changes.count == 0,
+           "Build directory and non-sources ignored");
+
+    /* A new directory is either walked by a poll or needs a rescan */
+    mkdir(TEST_DIR "/sub", 0755);
+    write_file(TEST_DIR "/sub/nested.c", "int nested;\n", "w");
+    ASSERT(file_watch_wait(watch, WAIT_MS, &changes) == 1 &&
+           (changes.rescan || find_change(&changes, TEST_DIR "/sub/nested.c")),
+           "New directory noticed");
+    file_change_list_destroy(&changes);
+
+    file_watch_destroy(watch);
+    cleanup_tree();
+
+    TEST_END();
+}
+
+void test_watch_missing_root(void) {
+    TEST("Watching A Missing Directory Fails");
+
+    cleanup_tree();
+    ASSERT(file_watch_create(TEST_DIR, NULL, 0) == NULL, "No watcher for a missing root");
+    ASSERT(file_watch_create(NULL, NULL, 0) == NULL, "No watcher without a root");
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|              Source Tree Watching - Test Suite                 |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_change_list_merging();
+    test_watch_sources();
+    test_watch_missing_root();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/**
+ * ==============================================================================
+ * Multi-Target Link Test Suite
+ * ==============================================================================
+ */
+
+#include "eventchains_build.h"
+#include "process_spawn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_link_test"
+#define TEST_BUILD TEST_DIR "/build"
+
+static bool create_test_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+    fputs(content, fp);
+    fclose(fp);
+    return true;
+}
+
+static bool file_exists(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+static void setup_dir(void) {
+    system("rm -rf \"" TEST_DIR "\"");
+    mkdir(TEST_DIR, 0755);
+    mkdir(TEST_DIR "/tools", 0755);
+    create_test_file(TEST_DIR "/util.h", "int add(int a, int b);\n");
+    create_test_file(TEST_DIR "/util.c",
+                     "#include \"util.h\"\nint add(int a, int b) { return a + b; }\n");
+    create_test_file(TEST_DIR "/server.c",
+                     "#include \"util.h\"\nint main(void) { return add(0, 0); }\n");
+    create_test_file(TEST_DIR "/tools/client.c",
+                     "#include \"../util.h\"\nint main(void) { return add(1, -1); }\n");
+}
+
+static int build_dir(void) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    dependency_graph_scan_directory(graph, TEST_DIR, true);
+
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    build_config_set_output_dir(config, TEST_BUILD);
+    build_config_set_output_binary(config, "suite");
+    build_config_add_include_path(config, TEST_DIR);
+    config->parallel_jobs = 2;
+
+    BuildStatistics stats;
+    int result = eventchains_build_project(graph, config, &stats);
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    return result;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_archive_command(void) {
+    TEST("Archive Commands Per Toolchain");
+
+    const char *objects[] = { "a.o", "b.o" };
+    BuildConfig *config = build_config_create();
+
+    ProcessArgs args;
+    process_args_init(&args);
+    config->compiler = COMPILER_GCC;
+    ASSERT(archive_command_build(objects, 2, "out/libx.a", config, &args), "GCC command built");
+    ASSERT(args.count == 5 && strcmp(args.argv[0], "ar") == 0 &&
+           strcmp(args.argv[1], "rcs") == 0 && strcmp(args.argv[2], "out/libx.a") == 0 &&
+           strcmp(args.argv[4], "b.o") == 0, "ar rcs archive objects");
+    process_args_destroy(&args);
+
+    process_args_init(&args);
+    config->compiler = COMPILER_MSVC;
+    ASSERT(archive_command_build(objects, 2, "out\\x.lib", config, &args) &&
+           args.count == 5 && strcmp(args.argv[0], "lib") == 0 &&
+           strcmp(args.argv[2], "/OUT:out\\x.lib") == 0, "lib /OUT:archive objects");
+    process_args_destroy(&args);
+
+    char path[256];
+    build_config_set_output_dir(config, "out");
+    ASSERT(static_library_path(config, "x", path, sizeof(path)) &&
+           strcmp(path, "out/x.lib") == 0, "MSVC library named x.lib");
+    config->compiler = COMPILER_CLANG;
+    ASSERT(static_library_path(config, "x", path, sizeof(path)) &&
+           strcmp(path, "out/libx.a") == 0, "Other libraries named libx.a");
+
+    build_config_destroy(config);
+
+    TEST_END();
+}
+
+void test_multiple_programs(void) {
+    TEST("One Pass Builds Every Program");
+
+    setup_dir();
+    ASSERT(build_dir() == 0, "Project built");
+    ASSERT(file_exists(TEST_BUILD "/libsuite.a"), "Shared code archived once");
+    ASSERT(file_exists(TEST_BUILD "/server") && file_exists(TEST_BUILD "/client"),
+           "An executable per main()");
+    ASSERT(!file_exists(TEST_BUILD "/suite"), "No combined binary");
+    ASSERT(system(TEST_BUILD "/server") == 0 && system(TEST_BUILD "/client") == 0,
+           "Executables run");
+
+    TEST_END();
+}
+
+void test_incremental_link(void) {
+    TEST("Current Outputs Are Not Relinked");
+
+    setup_dir();
+    mkdir(TEST_BUILD, 0755);
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    build_config_set_output_dir(config, TEST_BUILD);
+    build_config_add_include_path(config, TEST_DIR);
+
+    SourceFile util, server;
+    memset(&util, 0, sizeof(util));
+    memset(&server, 0, sizeof(server));
+    util.path = TEST_DIR "/util.c";
+    server.path = TEST_DIR "/server.c";
+
+    CompileResult result;
+    compile_source_file(&util, config, &result);
+    compile_result_destroy(&result);
+    compile_source_file(&server, config, &result);
+    compile_result_destroy(&result);
+    const char *objects[] = { TEST_BUILD "/server.o", TEST_BUILD "/util.o" };
+
+    ASSERT(link_executable_named(objects, 2, "server", config, &result) &&
+           !result.up_to_date, "First link runs");
+    compile_result_destroy(&result);
+    ASSERT(file_exists(TEST_BUILD "/server.link"), "Command stamp written");
+
+    ASSERT(link_executable_named(objects, 2, "server", config, &result) &&
+           result.up_to_date, "Second link skipped");
+    compile_result_destroy(&result);
+
+    ASSERT(!link_executable_named(objects, 1, "server", config, &result),
+           "Different inputs relink (and fail without util.o)");
+    compile_result_destroy(&result);
+    ASSERT(!file_exists(TEST_BUILD "/server.link"), "Failed link leaves no stamp");
+
+    ASSERT(link_executable_named(objects, 2, "server", config, &result) &&
+           !result.up_to_date, "Relinked after the failure");
+    compile_result_destroy(&result);
+
+    build_config_add_ldflag(config, "-s");
+    ASSERT(link_executable_named(objects, 2, "server", config, &result) &&
+           !result.up_to_date, "Changed flags relink");
+    compile_result_destroy(&result);
+
+    remove(TEST_BUILD "/util.o");
+    compile_source_file(&util, config, &result);
+    compile_result_destroy(&result);
+    ASSERT(link_executable_named(objects, 2, "server", config, &result) &&
+           !result.up_to_date, "Newer object relinks");
+    compile_result_destroy(&result);
+
+    build_config_destroy(config);
+
+    TEST_END();
+}
+
+void test_response_file_link(void) {
+    TEST("Long Link Commands Use a Response File");
+
+    setup_dir();
+    mkdir(TEST_BUILD, 0755);
+    create_test_file(TEST_DIR "/empty.c", "typedef int empty_unit;\n");
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    build_config_set_output_dir(config, TEST_BUILD);
+    build_config_add_include_path(config, TEST_DIR);
+
+    const char *sources[] = { TEST_DIR "/util.c", TEST_DIR "/server.c", TEST_DIR "/empty.c" };
+    for (size_t i = 0; i < 3; i++) {
+        SourceFile source;
+        memset(&source, 0, sizeof(source));
+        source.path = sources[i];
+        CompileResult result;
+        compile_source_file(&source, config, &result);
+        compile_result_destroy(&result);
+    }
+
+    /* The same symbol-free object, spelled long, well past the threshold */
+    char padded[512];
+    int length = snprintf(padded, sizeof(padded), "%s/", TEST_BUILD);
+    for (int i = 0; i < 40; i++) {
+        length += snprintf(padded + length, sizeof(padded) - length, "./");
+    }
+    snprintf(padded + length, sizeof(padded) - length, "empty.o");
+
+    enum { PADDED_COUNT = 400 };
+    const char *objects[PADDED_COUNT + 2];
+    objects[0] = TEST_BUILD "/server.o";
+    objects[1] = TEST_BUILD "/util.o";
+    for (size_t i = 0; i < PADDED_COUNT; i++) {
+        objects[i + 2] = padded;
+    }
+
+    CompileResult result;
+    ASSERT(PADDED_COUNT * strlen(padded) > RESPONSE_FILE_THRESHOLD, "Command is long");
+    ASSERT(link_executable_named(objects, PADDED_COUNT + 2, "server", config, &result) &&
+           !result.up_to_date, "Linked through a response file");
+    compile_result_destroy(&result);
+    ASSERT(system(TEST_BUILD "/server") == 0, "Executable runs");
+    ASSERT(!file_exists(TEST_BUILD "/server.rsp"), "Response file removed");
+
+    ASSERT(link_executable_named(objects, PADDED_COUNT + 2, "server", config, &result) &&
+           result.up_to_date, "Second link skipped");
+    compile_result_destroy(&result);
+
+    build_config_destroy(config);
+
+    TEST_END();
+}
+
+void test_object_clash(void) {
+    TEST("Sources Sharing a Name Are Refused");
+
+    setup_dir();
+    create_test_file(TEST_DIR "/tools/util.c", "int other(void) { return 1; }\n");
+    ASSERT(build_dir() != 0, "Build refused before two util.o overwrite each other");
+    system("rm -rf \"" TEST_DIR "\"");
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|              Multi-Target Linking - Test Suite                 |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    event_chain_initialize();
+
+    /* Run all tests */
+    test_archive_command();
+    test_multiple_programs();
+    test_incremental_link();
+    test_response_file_link();
+    test_object_clash();
+
+    event_chain_cleanup();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
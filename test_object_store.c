@@ -0,0 +1,267 @@
+/**
+ * ==============================================================================
+ * Shared Object Store Test Suite
+ * ==============================================================================
+ */
+
+#include "object_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_store_test"
+#define TEST_STORE TEST_DIR "/store"
+#define TEST_OBJECT TEST_DIR "/built.o"
+#define TEST_FETCHED TEST_DIR "/fetched.o"
+
+static bool create_test_file(const char *path, const char *content, size_t size) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    for (size_t i = 0; i < size; i++) {
+        fputc(content[i % strlen(content)], fp);
+    }
+    fclose(fp);
+    return true;
+}
+
+static bool file_equals(const char *path, const char *content, size_t size) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    bool same = true;
+    for (size_t i = 0; same && i < size; i++) {
+        same = fgetc(fp) == content[i % strlen(content)];
+    }
+    same = same && fgetc(fp) == EOF;
+    fclose(fp);
+    return same;
+}
+
+static void make_key(const ObjectStore *store, const char *source, uint64_t hash, char *dest) {
+    ObjectKey key;
+    object_key_init(&key, store);
+    object_key_add_string(&key, source);
+    object_key_add_u64(&key, hash);
+    object_key_finish(&key, dest);
+    object_key_destroy(&key);
+}
+
+static void stored_path(const char *key, char *dest, size_t dest_size) {
+    snprintf(dest, dest_size, TEST_STORE "/%.2s/%s.o", key, key);
+}
+
+static void remove_stored(const char *key) {
+    char path[512];
+    stored_path(key, path, sizeof(path));
+    remove(path);
+    snprintf(path, sizeof(path), TEST_STORE "/%.2s", key);
+    rmdir(path);
+}
+
+static void cleanup_dir(void) {
+    remove(TEST_OBJECT);
+    remove(TEST_FETCHED);
+    rmdir(TEST_STORE);
+    rmdir(TEST_DIR);
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_keys(void) {
+    TEST("Keys Cover Every Input");
+
+    char a[OBJECT_KEY_LENGTH + 1], b[OBJECT_KEY_LENGTH + 1];
+    make_key(NULL, "main.c", 42, a);
+    make_key(NULL, "main.c", 42, b);
+    ASSERT(strlen(a) == OBJECT_KEY_LENGTH, "Key is 64 hex digits");
+    ASSERT(strcmp(a, b) == 0, "Same inputs give the same key");
+
+    make_key(NULL, "main.c", 43, b);
+    ASSERT(strcmp(a, b) != 0, "Content hash changes the key");
+
+    ObjectKey key;
+    object_key_init(&key, NULL);
+    object_key_add_string(&key, "ab");
+    object_key_add_string(&key, "c");
+    object_key_finish(&key, a);
+    object_key_destroy(&key);
+
+    object_key_init(&key, NULL);
+    object_key_add_string(&key, "a");
+    object_key_add_string(&key, "bc");
+    object_key_finish(&key, b);
+    object_key_destroy(&key);
+    ASSERT(strcmp(a, b) != 0, "Strings are length-prefixed");
+
+    mkdir(TEST_DIR, 0755);
+    ObjectStore *store = object_store_open(TEST_STORE, 0);
+    BuildConfig *config = build_config_create();
+    config->compiler_path = strdup("sh");
+    ASSERT(store && object_store_set_toolchain(store, config), "Toolchain hashed");
+
+    make_key(store, "main.c", 42, a);
+    build_config_add_cflag(config, "-DNDEBUG");
+    object_store_set_toolchain(store, config);
+    make_key(store, "main.c", 42, b);
+    ASSERT(strcmp(a, b) != 0, "A compile flag changes the key");
+
+    build_config_destroy(config);
+    object_store_close(store);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+void test_insert_and_fetch(void) {
+    TEST("Insert, Then Fetch Into Another Build Directory");
+
+    mkdir(TEST_DIR, 0755);
+    ObjectStore *store = object_store_open(TEST_STORE, 0);
+    ASSERT(store != NULL, "Store opened");
+
+    char key[OBJECT_KEY_LENGTH + 1], other[OBJECT_KEY_LENGTH + 1];
+    make_key(store, "util.c", 1, key);
+    make_key(store, "util.c", 2, other);
+
+    ASSERT(!object_store_fetch(store, key, TEST_FETCHED), "Empty store misses");
+    ASSERT(!object_store_fetch(store, "not-a-key", TEST_FETCHED), "Malformed key misses");
+
+    create_test_file(TEST_OBJECT, "object bytes ", 5000);
+    ASSERT(object_store_insert(store, key, TEST_OBJECT), "Object inserted");
+    ASSERT(object_store_insert(store, key, TEST_OBJECT), "Inserting again is harmless");
+    ASSERT(store->insertions == 1 && store->bytes_inserted == 5000, "Insert counted once");
+
+    create_test_file(TEST_FETCHED, "stale", 5);
+    ASSERT(object_store_fetch(store, key, TEST_FETCHED), "Fetch hits");
+    ASSERT(file_equals(TEST_FETCHED, "object bytes ", 5000), "Fetched object replaces the stale one");
+    ASSERT(!object_store_fetch(store, other, TEST_FETCHED), "Other key still misses");
+    ASSERT(store->hits == 1 && store->misses == 3, "Hits and misses counted");
+
+    /* A second store handle sees the same object, as a second checkout would */
+    ObjectStore *shared = object_store_open(TEST_STORE "/", 0);
+    remove(TEST_FETCHED);
+    ASSERT(shared && object_store_fetch(shared, key, TEST_FETCHED), "Shared directory hits");
+    object_store_close(shared);
+
+    remove_stored(key);
+    object_store_close(store);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+void test_lru_eviction(void) {
+    TEST("Least Recently Used Objects Are Evicted");
+
+    mkdir(TEST_DIR, 0755);
+    ObjectStore *store = object_store_open(TEST_STORE, 10000);
+
+    char keys[5][OBJECT_KEY_LENGTH + 1];
+    create_test_file(TEST_OBJECT, "x", 3000);
+    for (int i = 0; i < 5; i++) {
+        make_key(store, "lru.c", (uint64_t)i, keys[i]);
+        object_store_insert(store, keys[i], TEST_OBJECT);
+
+        /* Insert order is age order: keys[0] is the oldest */
+        char path[512];
+        stored_path(keys[i], path, sizeof(path));
+        struct utimbuf times;
+        times.actime = 1000000000 + i * 100;
+        times.modtime = 1000000000 + i * 100;
+        utime(path, &times);
+    }
+
+    /* Using the oldest object makes it the newest */
+    ASSERT(object_store_fetch(store, keys[0], TEST_FETCHED), "Oldest object fetched");
+
+    size_t removed = 0;
+    uint64_t total = 0;
+    ASSERT(object_store_trim(store, &removed, &total), "Trim succeeded");
+    ASSERT(removed == 2 && total == 9000, "Trimmed to 90% of the limit");
+
+    char path[512];
+    struct stat st;
+    stored_path(keys[0], path, sizeof(path));
+    ASSERT(stat(path, &st) == 0, "Recently fetched object kept");
+    stored_path(keys[4], path, sizeof(path));
+    ASSERT(stat(path, &st) == 0, "Newest object kept");
+    stored_path(keys[1], path, sizeof(path));
+    ASSERT(stat(path, &st) != 0, "Least recently used object evicted");
+
+    ASSERT(object_store_trim(store, &removed, &total) && removed == 0,
+           "Store under its limit is left alone");
+
+    for (int i = 0; i < 5; i++) remove_stored(keys[i]);
+    object_store_close(store);
+    cleanup_dir();
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|              Shared Object Store - Test Suite                  |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_keys();
+    test_insert_and_fetch();
+    test_lru_eviction();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
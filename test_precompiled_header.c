@@ -0,0 +1,320 @@
+/**
+ * ==============================================================================
+ * Precompiled Headers Test Suite
+ * ==============================================================================
+ */
+
+#include "precompiled_header.h"
+#include "dependency_resolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_pch_test"
+
+static const char *const test_files[] = {
+    TEST_DIR "/common.h", TEST_DIR "/loose.h", TEST_DIR "/a.c", TEST_DIR "/b.c",
+    TEST_DIR "/c.c", TEST_DIR "/d.c", TEST_DIR "/macro.c", TEST_DIR "/unguarded.c",
+    TEST_DIR "/tool.cpp", TEST_DIR "/build/pch/c_prefix.h", TEST_DIR "/build/pch/c_prefix.h.gch"
+};
+
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fputs(content, fp);
+        fclose(fp);
+    }
+}
+
+static void cleanup_tree(void) {
+    for (size_t i = 0; i < sizeof(test_files) / sizeof(test_files[0]); i++) {
+        remove(test_files[i]);
+    }
+    rmdir(TEST_DIR "/build/pch");
+    rmdir(TEST_DIR "/build");
+    rmdir(TEST_DIR);
+}
+
+static void setup_tree(void) {
+    cleanup_tree();
+    mkdir(TEST_DIR, 0755);
+    mkdir(TEST_DIR "/build", 0755);
+
+    write_file(TEST_DIR "/common.h", "/* Shared */\n#ifndef COMMON_H\n#define COMMON_H\n"
+                                     "#include <string.h>\nint common(int);\n#endif\n");
+    write_file(TEST_DIR "/loose.h", "int loose;\n");
+
+    /* Four sources open the same way, comments and all */
+    const char *shared = "#include <stdio.h>\n#include \"common.h\" /* shared */\n";
+    char content[512];
+    snprintf(content, sizeof(content), "// a\n%s#include <stdlib.h>\nint a;\n", shared);
+    write_file(TEST_DIR "/a.c", content);
+    snprintf(content, sizeof(content), "/* b,\n * two lines */\n%s\n#include <stdlib.h>\nint b;\n",
+             shared);
+    write_file(TEST_DIR "/b.c", content);
+    snprintf(content, sizeof(content), "%s#include <stdlib.h>\nint c;\n", shared);
+    write_file(TEST_DIR "/c.c", content);
+    snprintf(content, sizeof(content), "%s#include <stdlib.h>\n#include <math.h>\nint d;\n",
+             shared);
+    write_file(TEST_DIR "/d.c", content);
+
+    /* A macro ahead of the includes, and a header that cannot be included twice */
+    write_file(TEST_DIR "/macro.c", "#define _GNU_SOURCE\n#include <stdio.h>\nint m;\n");
+    write_file(TEST_DIR "/unguarded.c", "#include <stdio.h>\n#include \"loose.h\"\nint u;\n");
+    write_file(TEST_DIR "/tool.cpp", "#include <stdio.h>\nint t;\n");
+}
+
+static DependencyGraph *scan_tree(void) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    dependency_graph_scan_directory(graph, TEST_DIR, true);
+    return graph;
+}
+
+static bool has_arg(const ProcessArgs *args, const char *arg) {
+    for (size_t i = 0; i < args->count; i++) {
+        if (strcmp(args->argv[i], arg) == 0) return true;
+    }
+    return false;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_plan(void) {
+    TEST("Prefix Chosen From Leading Includes");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = build_config_create();
+    build_config_set_output_dir(config, TEST_DIR "/build");
+    config->compiler = COMPILER_GCC;
+
+    PchSet *set = pch_set_plan(graph, config);
+    ASSERT(set != NULL, "Planned");
+    if (set) {
+        const PrecompiledHeader *c = &set->headers[PCH_LANGUAGE_C];
+        ASSERT(c->language_sources == 6, "Six C sources considered");
+        ASSERT(c->include_count == 3 && c->source_count == 4,
+               "Longest run shared by four or more: three includes, four users");
+        ASSERT(c->include_count == 3 && strcmp(c->includes[0], "<stdio.h>") == 0 &&
+               strstr(c->includes[1], "/ec_pch_test/common.h\"") != NULL &&
+               c->includes[1][0] == '"' && c->includes[1][1] == '/' &&
+               strcmp(c->includes[2], "<stdlib.h>") == 0,
+               "System headers as written, project headers by absolute path");
+        ASSERT(c->graph_paths && c->graph_paths[0] == NULL && c->graph_paths[1] &&
+               strstr(c->graph_paths[1], "common.h") != NULL, "Project header found in the graph");
+        ASSERT(strcmp(c->header_path, TEST_DIR "/build/pch/c_prefix.h") == 0 &&
+               strcmp(c->output_path, TEST_DIR "/build/pch/c_prefix.h.gch") == 0,
+               "GCC header and .gch under the output directory");
+
+        ASSERT(set->headers[PCH_LANGUAGE_CXX].language_sources == 1 &&
+               set->headers[PCH_LANGUAGE_CXX].include_count == 0, "Lone C++ source gets none");
+        ASSERT(pch_set_find(set, TEST_DIR "/a.c") == NULL, "Nothing used before it is built");
+        pch_set_destroy(set);
+    }
+
+    /* With one source fewer, only <stdio.h> is shared by four: macro.c
+     * defines a macro first, and unguarded.c stops at a header that
+     * cannot be included twice */
+    remove(TEST_DIR "/c.c");
+    dependency_graph_destroy(graph);
+    graph = scan_tree();
+    set = pch_set_plan(graph, config);
+    ASSERT(set && set->headers[PCH_LANGUAGE_C].include_count == 1 &&
+           set->headers[PCH_LANGUAGE_C].source_count == 4, "Shorter run with four users");
+    ASSERT(set && path_index_find(&set->sources, TEST_DIR "/macro.c") == PATH_INDEX_NONE &&
+           path_index_find(&set->sources, TEST_DIR "/unguarded.c") != PATH_INDEX_NONE,
+           "Users are the sources that start with the run");
+    pch_set_destroy(set);
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+
+    TEST_END();
+}
+
+void test_commands(void) {
+    TEST("Precompile And Use Flags Per Compiler");
+
+    PrecompiledHeader header;
+    memset(&header, 0, sizeof(header));
+    snprintf(header.header_path, sizeof(header.header_path), "build/pch/c_prefix.h");
+    snprintf(header.output_path, sizeof(header.output_path), "build/pch/c_prefix.h.gch");
+
+    BuildConfig *config = build_config_create();
+    build_config_add_cflag(config, "-O2");
+    config->compiler = COMPILER_GCC;
+
+    ProcessArgs args;
+    process_args_init(&args);
+    pch_command_build(&header, PCH_LANGUAGE_C, config, &args);
+    ASSERT(has_arg(&args, "-x") && has_arg(&args, "c-header") && has_arg(&args, "-O2") &&
+           has_arg(&args, "build/pch/c_prefix.h.gch"), "GCC precompiles as c-header with the cflags");
+    process_args_destroy(&args);
+
+    process_args_init(&args);
+    pch_command_build(&header, PCH_LANGUAGE_CXX, config, &args);
+    ASSERT(has_arg(&args, "c++-header"), "C++ precompiles as c++-header");
+    process_args_destroy(&args);
+
+    process_args_init(&args);
+    pch_add_compile_flags(&header, config, &args);
+    ASSERT(args.count == 3 && has_arg(&args, "-include") && has_arg(&args, "build/pch/c_prefix.h"),
+           "GCC forces the header in and finds the .gch beside it");
+    process_args_destroy(&args);
+
+    config->compiler = COMPILER_CLANG;
+    process_args_init(&args);
+    pch_add_compile_flags(&header, config, &args);
+    ASSERT(has_arg(&args, "-include-pch") && has_arg(&args, "build/pch/c_prefix.h.gch"),
+           "Clang names the precompiled header");
+    process_args_destroy(&args);
+
+    config->compiler = COMPILER_MSVC;
+    snprintf(header.output_path, sizeof(header.output_path), "build/pch/c_prefix.pch");
+    snprintf(header.object_path, sizeof(header.object_path), "build/pch/c_prefix.obj");
+    process_args_init(&args);
+    pch_command_build(&header, PCH_LANGUAGE_C, config, &args);
+    ASSERT(has_arg(&args, "build/pch/c_prefix.c") && has_arg(&args, "/Ycbuild/pch/c_prefix.h") &&
+           has_arg(&args, "/Fobuild/pch/c_prefix.obj"), "MSVC creates it from a stub with /Yc");
+    process_args_destroy(&args);
+
+    process_args_init(&args);
+    pch_add_compile_flags(&header, config, &args);
+    ASSERT(has_arg(&args, "/Yubuild/pch/c_prefix.h") && has_arg(&args, "/FIbuild/pch/c_prefix.h") &&
+           has_arg(&args, "/Fpbuild/pch/c_prefix.pch"), "MSVC uses it with /Yu and /FI");
+    process_args_destroy(&args);
+
+    build_config_destroy(config);
+
+    TEST_END();
+}
+
+void test_build(void) {
+    TEST("Prefix Header Written And Precompiled");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = build_config_create();
+    build_config_set_output_dir(config, TEST_DIR "/build");
+    if (!build_config_auto_detect_compiler(config) || config->compiler == COMPILER_MSVC) {
+        printf("No GCC or Clang; skipped\n");
+        build_config_destroy(config);
+        dependency_graph_destroy(graph);
+        cleanup_tree();
+        TEST_END();
+        return;
+    }
+
+    PchSet *set = pch_set_plan(graph, config);
+    size_t ready = pch_set_build(set, graph, config, NULL);
+    const PrecompiledHeader *c = set ? &set->headers[PCH_LANGUAGE_C] : NULL;
+    ASSERT(ready == 1 && c && c->ready && c->rebuilt, "Built without a cache");
+    ASSERT(c && access(c->output_path, F_OK) == 0, "Precompiled header on disk");
+    ASSERT(pch_set_find(set, TEST_DIR "/a.c") == c && pch_set_find(set, TEST_DIR "/macro.c") == NULL,
+           "Users find it, others do not");
+
+    ProcessArgs args;
+    process_args_init(&args);
+    compile_command_build(TEST_DIR "/a.c", TEST_DIR "/build/a.o", config, &args);
+    ASSERT(args.count > 0 && !has_arg(&args, "-include") && !has_arg(&args, "-include-pch"),
+           "Compile command unchanged until the set is installed");
+    process_args_destroy(&args);
+
+    config->pch = set;
+    process_args_init(&args);
+    compile_command_build(TEST_DIR "/a.c", TEST_DIR "/build/a.o", config, &args);
+    ASSERT(has_arg(&args, "-include") || has_arg(&args, "-include-pch"), "Installed set adds flags");
+    process_args_destroy(&args);
+    config->pch = NULL;
+
+    /* Rewritten only when it would say something else */
+    struct stat before, after;
+    stat(c->header_path, &before);
+    char text[1024] = {0};
+    FILE *fp = fopen(c->header_path, "r");
+    if (fp) {
+        text[fread(text, 1, sizeof(text) - 1, fp)] = '\0';
+        fclose(fp);
+    }
+    ASSERT(strstr(text, "#include <stdio.h>\n#include \"/") != NULL &&
+           strstr(text, "#include <stdlib.h>\n") != NULL, "Header lists the run in order");
+    sleep(1);
+    pch_set_build(set, graph, config, NULL);
+    stat(c->header_path, &after);
+    ASSERT(before.st_mtime == after.st_mtime, "Same header left untouched");
+
+    pch_set_destroy(set);
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|              Precompiled Headers - Test Suite                  |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_plan();
+    test_commands();
+    test_build();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/**
+ * ==============================================================================
+ * Process Spawning Test Suite
+ * ==============================================================================
+ */
+
+#include "process_spawn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_args_vector(void) {
+    TEST("Argument Vector Building");
+
+    ProcessArgs args;
+    process_args_init(&args);
+    for (int i = 0; i < 40; i++) {
+        process_args_addf(&args, "-DVALUE_%d=%d", i, i * 2);
+    }
+    ASSERT(args.count == 40, "Vector grows past its initial capacity");
+    ASSERT(args.argv[40] == NULL, "Vector stays NULL-terminated");
+    ASSERT(strcmp(args.argv[39], "-DVALUE_39=78") == 0, "Formatted argument stored");
+    process_args_destroy(&args);
+
+    process_args_init(&args);
+    process_args_add(&args, "cc");
+    process_args_add(&args, "my file.c");
+    char line[64];
+    ASSERT(process_args_format(&args, line, sizeof(line)) &&
+           strcmp(line, "cc \"my file.c\"") == 0, "Arguments with spaces are quoted in logs");
+    ASSERT(!process_args_format(&args, line, 4), "Truncation reported");
+    process_args_destroy(&args);
+
+    TEST_END();
+}
+
+void test_run_captures_output(void) {
+    TEST("Run Captures stdout, stderr and Exit Code");
+
+    char *const argv[] = {"sh", "-c", "echo out; echo err 1>&2; exit 3", NULL};
+    char output[256];
+    int exit_code = 0;
+    bool success = process_run(argv, output, sizeof(output), &exit_code);
+
+    ASSERT(!success, "Non-zero exit reported as failure");
+    ASSERT(exit_code == 3, "Exit code collected");
+    ASSERT(strstr(output, "out") && strstr(output, "err"), "Both streams captured");
+
+    char *const literal[] = {"printf", "%s|", "a b", "$HOME", "*", NULL};
+    success = process_run(literal, output, sizeof(output), &exit_code);
+    ASSERT(success && strcmp(output, "a b|$HOME|*|") == 0, "Arguments reach the child unexpanded");
+
+    uint64_t peak_memory = 0;
+    ASSERT(process_run_measured(literal, output, sizeof(output), &exit_code, &peak_memory) &&
+           peak_memory > 0, "Peak memory of the child reported");
+
+    TEST_END();
+}
+
+void test_missing_program(void) {
+    TEST("Missing Program Fails Cleanly");
+
+    char *const argv[] = {"ec-no-such-program", NULL};
+    char output[256];
+    int exit_code = 0;
+    ASSERT(!process_run(argv, output, sizeof(output), &exit_code), "Spawn failure reported");
+    ASSERT(exit_code == -1, "Exit code is -1");
+    ASSERT(strstr(output, "ec-no-such-program") != NULL, "Message names the program");
+
+    ASSERT(process_find_executable("sh", NULL, 0), "sh found in PATH");
+    ASSERT(!process_find_executable("ec-no-such-program", NULL, 0), "Unknown program not found");
+
+    TEST_END();
+}
+
+void test_poll_and_truncation(void) {
+    TEST("Non-Blocking Poll and Bounded Output");
+
+    char *const slow[] = {"sh", "-c", "sleep 0.3; echo done", NULL};
+    Process proc;
+    ASSERT(process_spawn(&proc, slow, 64), "Slow child started");
+    ASSERT(!process_poll(&proc, 0), "Poll returns while the child runs");
+    ASSERT(process_wait(&proc), "Wait collects success");
+    ASSERT(proc.output && strcmp(proc.output, "done\n") == 0, "Output collected after poll");
+    process_destroy(&proc);
+
+    /* 200 KB of output must not block the child on a full pipe */
+    char *const loud[] = {"sh", "-c", "i=0; while [ $i -lt 2000 ]; do "
+                          "echo 0123456789012345678901234567890123456789012345678901234567890123456789"
+                          "01234567890123456789012345678; i=$((i+1)); done", NULL};
+    ASSERT(process_spawn(&proc, loud, 1000), "Loud child started");
+    ASSERT(process_wait(&proc), "Loud child finished");
+    ASSERT(proc.output_length <= 1000 && proc.output_truncated, "Output capped at the limit");
+    ASSERT(proc.output && proc.output_omitted > 190000 &&
+           strstr(proc.output, "bytes of output omitted") != NULL, "What was dropped is noted");
+    ASSERT(proc.output && strncmp(proc.output, "0123456789", 10) == 0 &&
+           proc.output[proc.output_length - 1] == '\n', "First and latest output kept");
+    process_destroy(&proc);
+
+    TEST_END();
+}
+
+void test_capture_and_echo(void) {
+    TEST("Captured Output Grows To Fit and Echoes By Line");
+
+    /* Everything kept when it fits, however much that is */
+    char *const loud[] = {"sh", "-c", "i=0; while [ $i -lt 2000 ]; do "
+                          "echo line $i; i=$((i+1)); done; echo last; exit 3", NULL};
+    ProcessCapture capture;
+    memset(&capture, 0, sizeof(capture));
+    capture.limit = 1024 * 1024;
+    ASSERT(!process_run_captured(loud, &capture) && capture.exit_code == 3, "Exit code kept");
+    ASSERT(capture.output && capture.omitted == 0 && strstr(capture.output, "line 0\n") &&
+           strstr(capture.output, "line 1999\nlast\n"), "All 20 KB captured");
+    free(capture.output);
+
+    memset(&capture, 0, sizeof(capture));
+    capture.limit = 1000;
+    process_run_captured(loud, &capture);
+    const char *note = capture.output ? strstr(capture.output, "\n[... ") : NULL;
+    ASSERT(note && strncmp(capture.output, "line 0\nline 1\n", 14) == 0 &&
+           strcmp(capture.output + strlen(capture.output) - 15, "line 1999\nlast\n") == 0 &&
+           strlen(capture.output) <= 1000, "Head and tail of 20 KB within 1000 bytes");
+    free(capture.output);
+
+    /* Echoed lines carry the prefix, a last line without newline too */
+    FILE *stream = tmpfile();
+    char *const talk[] = {"sh", "-c", "echo one; echo two >&2; printf three", NULL};
+    memset(&capture, 0, sizeof(capture));
+    capture.limit = 64;
+    capture.echo = stream;
+    capture.echo_prefix = "[job] ";
+    ASSERT(process_run_captured(talk, &capture), "Echoed child succeeded");
+    ASSERT(capture.output && strcmp(capture.output, "one\ntwo\nthree") == 0,
+           "Output still captured");
+    free(capture.output);
+
+    char echoed[256] = {0};
+    if (stream) {
+        rewind(stream);
+        echoed[fread(echoed, 1, sizeof(echoed) - 1, stream)] = '\0';
+        fclose(stream);
+    }
+    ASSERT(strcmp(echoed, "[job] one\n[job] two\n[job] three\n") == 0, "Each line prefixed");
+
+    char *const missing[] = {"ec-no-such-program", NULL};
+    memset(&capture, 0, sizeof(capture));
+    ASSERT(!process_run_captured(missing, &capture) && capture.exit_code == -1 &&
+           capture.output && strstr(capture.output, "ec-no-such-program"),
+           "Spawn failure reported");
+    free(capture.output);
+
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|               Process Spawning - Test Suite                    |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_args_vector();
+    test_run_captures_output();
+    test_missing_program();
+    test_poll_and_truncation();
+    test_capture_and_echo();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
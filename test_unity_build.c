@@ -0,0 +1,452 @@
+/**
+ * ==============================================================================
+ * Unity Build Test Suite
+ * ==============================================================================
+ */
+
+#include "unity_build.h"
+#include "eventchains_build.h"
+#include "cache_metadata.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Test result tracking */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("\n--- TEST: %s ---\n", name); \
+    bool test_passed = true;
+
+#define ASSERT(condition, message) \
+    if (!(condition)) { \
+        printf("FAILED: %s\n", message); \
+        test_passed = false; \
+    } else { \
+        printf("%s\n", message); \
+    }
+
+#define TEST_END() \
+    if (test_passed) { \
+        tests_passed++; \
+        printf("PASSED\n"); \
+    } else { \
+        tests_failed++; \
+        printf("FAILED\n"); \
+    }
+
+/* ==============================================================================
+ * Test Helpers
+ * ==============================================================================
+ */
+
+#define TEST_DIR "/tmp/ec_unity_test"
+#define UNITY_DIR TEST_DIR "/build/unity"
+#define SRC_GROUP(n) UNITY_DIR "/unity_tmp_ec_unity_test_src_" #n ".c"
+#define TOOLS_GROUP UNITY_DIR "/unity_tmp_ec_unity_test_tools_0.cpp"
+
+static const char *const test_files[] = {
+    TEST_DIR "/common.h", TEST_DIR "/main.c",
+    TEST_DIR "/src/a.c", TEST_DIR "/src/b.c", TEST_DIR "/src/c.c", TEST_DIR "/src/d.c",
+    TEST_DIR "/src/e.c", TEST_DIR "/tools/one.cpp", TEST_DIR "/tools/two.cc",
+    TEST_DIR "/gen/outer.c", TEST_DIR "/gen/inner.c",
+    SRC_GROUP(0), SRC_GROUP(1), SRC_GROUP(2), TOOLS_GROUP, UNITY_DIR "/history",
+    TEST_DIR "/build/unity_tmp_ec_unity_test_src_0.o", TEST_DIR "/.eventchains/cache.dat"
+};
+
+static int edit_count = 0;
+
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fputs(content, fp);
+        fclose(fp);
+    }
+}
+
+/* Give a file new content, a little longer each time */
+static void edit_file(const char *path) {
+    char content[256];
+    edit_count++;
+    snprintf(content, sizeof(content), "#include \"../common.h\"\nint edited_%d%*s;\n",
+             edit_count, edit_count, "");
+    write_file(path, content);
+}
+
+static bool file_contains(const char *path, const char *needle) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return false;
+    char content[4096];
+    content[fread(content, 1, sizeof(content) - 1, fp)] = '\0';
+    fclose(fp);
+    return strstr(content, needle) != NULL;
+}
+
+static void cleanup_tree(void) {
+    for (size_t i = 0; i < sizeof(test_files) / sizeof(test_files[0]); i++) {
+        remove(test_files[i]);
+    }
+    rmdir(UNITY_DIR);
+    rmdir(TEST_DIR "/build");
+    rmdir(TEST_DIR "/.eventchains");
+    rmdir(TEST_DIR "/src");
+    rmdir(TEST_DIR "/tools");
+    rmdir(TEST_DIR "/gen");
+    rmdir(TEST_DIR);
+}
+
+static void setup_tree(void) {
+    cleanup_tree();
+    mkdir(TEST_DIR, 0755);
+    mkdir(TEST_DIR "/src", 0755);
+    mkdir(TEST_DIR "/tools", 0755);
+    mkdir(TEST_DIR "/gen", 0755);
+
+    write_file(TEST_DIR "/common.h", "#pragma once\nint common(int);\n");
+    write_file(TEST_DIR "/main.c", "#include \"common.h\"\nint main(void) { return 0; }\n");
+
+    const char *names[] = { "a", "b", "c", "d", "e" };
+    for (size_t i = 0; i < 5; i++) {
+        char path[256], content[256];
+        snprintf(path, sizeof(path), TEST_DIR "/src/%s.c", names[i]);
+        snprintf(content, sizeof(content), "#include \"../common.h\"\nint %s;\n", names[i]);
+        write_file(path, content);
+    }
+
+    write_file(TEST_DIR "/tools/one.cpp", "int one;\n");
+    write_file(TEST_DIR "/tools/two.cc", "int two;\n");
+
+    /* An amalgamated pair stays out of the groups */
+    write_file(TEST_DIR "/gen/outer.c", "#include \"inner.c\"\nint outer;\n");
+    write_file(TEST_DIR "/gen/inner.c", "int inner;\n");
+}
+
+static DependencyGraph *scan_tree(void) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, TEST_DIR);
+    dependency_graph_scan_directory(graph, TEST_DIR, true);
+    return graph;
+}
+
+static BuildConfig *test_config(void) {
+    BuildConfig *config = build_config_create();
+    build_config_set_output_dir(config, TEST_DIR "/build");
+    config->compiler = COMPILER_GCC;
+    return config;
+}
+
+static bool chain_compiles(const EventChain *chain, const char *path) {
+    for (size_t i = 0; i < chain->event_count; i++) {
+        const CompileEventData *data = compile_event_data(chain->events[i]);
+        if (data && strcmp(data->source->path, path) == 0) return true;
+    }
+    return false;
+}
+
+/* ==============================================================================
+ * Test Cases
+ * ==============================================================================
+ */
+
+void test_plan(void) {
+    TEST("Sources Grouped By Directory And Language");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = test_config();
+
+    UnityBuild *unity = unity_build_plan(graph, config, 2, NULL);
+    ASSERT(unity != NULL, "Planned");
+    if (unity) {
+        ASSERT(unity->candidate_count == 7, "No main() or amalgamated sources among candidates");
+        ASSERT(unity->group_count == 3 && unity->grouped_count == 6,
+               "Five sources cut 2+2+1, two tools together");
+        ASSERT(unity->hot_count == 0, "Nothing hot without a history");
+
+        const UnityGroup *a = unity_build_find(unity, TEST_DIR "/src/a.c");
+        const UnityGroup *b = unity_build_find(unity, TEST_DIR "/src/b.c");
+        const UnityGroup *d = unity_build_find(unity, TEST_DIR "/src/d.c");
+        ASSERT(a && a == b && strcmp(a->path, SRC_GROUP(0)) == 0, "a.c and b.c share a group");
+        ASSERT(d && d != a && strcmp(d->path, SRC_GROUP(1)) == 0, "c.c and d.c in the next");
+        ASSERT(unity_build_find(unity, TEST_DIR "/src/e.c") == NULL, "A run of one compiles alone");
+        ASSERT(unity_build_find(unity, TEST_DIR "/main.c") == NULL &&
+               unity_build_find(unity, TEST_DIR "/gen/outer.c") == NULL,
+               "main() and amalgamated sources compile alone");
+
+        const UnityGroup *tools = unity_build_find(unity, TEST_DIR "/tools/two.cc");
+        ASSERT(tools && strcmp(tools->path, TOOLS_GROUP) == 0, "C++ sources in a .cpp unit");
+
+        ASSERT(file_contains(SRC_GROUP(0), "ec_unity_test/src/a.c\"\n") &&
+               file_contains(SRC_GROUP(0), "#include \"/") &&
+               !file_contains(SRC_GROUP(0), "c.c"),
+               "Unity source includes its members by absolute path");
+
+        SourceFile *node = dependency_graph_find_file(graph, SRC_GROUP(0));
+        ASSERT(node && node->generated && !node->is_header && node->include_count == 2 &&
+               !source_file_has_main(node), "Unity source added to the graph");
+
+        SourceFile *member = dependency_graph_find_file(graph, TEST_DIR "/src/a.c");
+        SourceFile *alone = dependency_graph_find_file(graph, TEST_DIR "/src/e.c");
+        ASSERT(unity_build_skips(unity, member) && !unity_build_skips(unity, alone) &&
+               !unity_build_skips(unity, node), "Members are left to their unity source");
+        unity_build_destroy(unity);
+    }
+
+    ASSERT(unity_build_plan(graph, config, 1, NULL) == NULL, "Groups of one refused");
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+    TEST_END();
+}
+
+void test_chain(void) {
+    TEST("Each Group Compiles As One Event");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = test_config();
+
+    config->unity = unity_build_plan(graph, config, 2, NULL);
+    EventChain *chain = build_compilation_chain(graph, config);
+    ASSERT(chain != NULL && chain->event_count == 7,
+           "Three unity sources, e.c, main.c and the amalgamated pair");
+    if (chain) {
+        ASSERT(chain_compiles(chain, SRC_GROUP(0)) && chain_compiles(chain, TOOLS_GROUP) &&
+               !chain_compiles(chain, TEST_DIR "/src/a.c") &&
+               chain_compiles(chain, TEST_DIR "/src/e.c"), "Members compiled only inside groups");
+        event_chain_destroy(chain);
+    }
+
+    /* A new plan on the same graph leaves the old unity sources unused */
+    unity_build_destroy(config->unity);
+    config->unity = unity_build_plan(graph, config, 5, NULL);
+    chain = build_compilation_chain(graph, config);
+    ASSERT(chain != NULL && chain->event_count == 5 && !chain_compiles(chain, SRC_GROUP(1)) &&
+           chain_compiles(chain, SRC_GROUP(0)), "Unity sources an earlier plan made are skipped");
+    if (chain) event_chain_destroy(chain);
+
+    unity_build_destroy(config->unity);
+    config->unity = NULL;
+    chain = build_compilation_chain(graph, config);
+    ASSERT(chain != NULL && chain->event_count == 10 && !chain_compiles(chain, SRC_GROUP(0)),
+           "Without a plan every source compiles alone");
+    if (chain) event_chain_destroy(chain);
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+    TEST_END();
+}
+
+void test_cache_unit(void) {
+    TEST("A Group Is Invalidated As A Unit");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = test_config();
+    BuildCache *cache = build_cache_create(TEST_DIR);
+    UnityBuild *unity = unity_build_plan(graph, config, 2, cache);
+    SourceFile *node = dependency_graph_find_file(graph, SRC_GROUP(0));
+    ASSERT(cache && unity && node, "Planned with a cache");
+
+    if (cache && unity && node) {
+        const char *object = TEST_DIR "/build/unity_tmp_ec_unity_test_src_0.o";
+        write_file(object, "object");
+
+        build_cache_update_closure(cache, node->path, object, graph);
+        ASSERT(build_cache_is_current(cache, node), "Current once recorded");
+
+        edit_file(TEST_DIR "/src/b.c");
+        build_cache_reset_hash_memo(cache);
+        ASSERT(!build_cache_is_current(cache, node), "Editing a member invalidates the group");
+
+        build_cache_update_closure(cache, node->path, object, graph);
+        write_file(TEST_DIR "/common.h", "#pragma once\nint common(int, int);\n");
+        build_cache_reset_hash_memo(cache);
+        ASSERT(!build_cache_is_current(cache, node), "So does a header a member includes");
+
+        SourceFile *other = dependency_graph_find_file(graph, SRC_GROUP(1));
+        build_cache_update_closure(cache, other->path, object, graph);
+        edit_file(TEST_DIR "/src/a.c");
+        build_cache_reset_hash_memo(cache);
+        ASSERT(build_cache_is_current(cache, other), "Other groups are untouched");
+    }
+
+    unity_build_destroy(unity);
+    build_cache_destroy(cache);
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+    TEST_END();
+}
+
+void test_hot_members(void) {
+    TEST("A Source That Keeps Changing Compiles Alone");
+
+    setup_tree();
+    DependencyGraph *graph = scan_tree();
+    BuildConfig *config = test_config();
+
+    unity_build_destroy(unity_build_plan(graph, config, 2, NULL));
+    ASSERT(file_contains(UNITY_DIR "/history", "ec_unity_test/src/a.c\n"), "History recorded");
+
+    edit_file(TEST_DIR "/src/a.c");
+    UnityBuild *unity = unity_build_plan(graph, config, 2, NULL);
+    ASSERT(unity && unity->hot_count == 0 && unity_build_find(unity, TEST_DIR "/src/a.c"),
+           "One change is not enough");
+    unity_build_destroy(unity);
+
+    edit_file(TEST_DIR "/src/a.c");
+    unity = unity_build_plan(graph, config, 2, NULL);
+    ASSERT(unity && unity->hot_count == 1 &&
+           strcmp(unity->hot[0], TEST_DIR "/src/a.c") == 0, "Two changes make it hot");
+    if (unity) {
+        const UnityGroup *d = unity_build_find(unity, TEST_DIR "/src/d.c");
+        ASSERT(!unity_build_find(unity, TEST_DIR "/src/a.c") &&
+               !unity_build_find(unity, TEST_DIR "/src/b.c"),
+               "It leaves its group, and the one member left compiles alone");
+        ASSERT(d && strcmp(d->path, SRC_GROUP(1)) == 0 && unity->group_count == 2,
+               "The other groups keep their members");
+    }
+    unity_build_destroy(unity);
+
+    /* Builds that change only other sources cool it down */
+    size_t builds = 0;
+    for (; builds < UNITY_HOT_WINDOW * 2; builds++) {
+        edit_file(TEST_DIR "/src/e.c");
+        unity = unity_build_plan(graph, config, 2, NULL);
+        bool grouped = unity && unity_build_find(unity, TEST_DIR "/src/a.c") != NULL;
+        unity_build_destroy(unity);
+        if (grouped) break;
+    }
+    ASSERT(builds == UNITY_HOT_WINDOW - 2, "Back in its group once its changes age out");
+
+    /* Builds that change nothing do not */
+    edit_file(TEST_DIR "/src/a.c");
+    unity_build_destroy(unity_build_plan(graph, config, 2, NULL));
+    edit_file(TEST_DIR "/src/a.c");
+    unity_build_destroy(unity_build_plan(graph, config, 2, NULL));
+    for (int i = 0; i < UNITY_HOT_WINDOW * 2; i++) {
+        unity_build_destroy(unity_build_plan(graph, config, 2, NULL));
+    }
+    unity = unity_build_plan(graph, config, 2, NULL);
+    ASSERT(unity && !unity_build_find(unity, TEST_DIR "/src/a.c"),
+           "Still hot after builds without changes");
+    unity_build_destroy(unity);
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    cleanup_tree();
+    TEST_END();
+}
+
+#define CLASH_DIR "/tmp/ec_unity_clash"
+
+/**
+ * A tree whose lib/ sources each define the same static helper: valid
+ * alone, a redefinition once they share a translation unit
+ */
+static void setup_clash_tree(void) {
+    system("rm -rf \"" CLASH_DIR "\"");
+    mkdir(CLASH_DIR, 0755);
+    mkdir(CLASH_DIR "/lib", 0755);
+    for (int i = 0; i < 6; i++) {
+        char path[256], content[256];
+        snprintf(path, sizeof(path), CLASH_DIR "/lib/f%d.c", i);
+        snprintf(content, sizeof(content),
+                 "static int helper(void) { return %d; }\nint f%d(void) { return helper(); }\n",
+                 i, i);
+        write_file(path, content);
+    }
+    write_file(CLASH_DIR "/main.c", "int f0(void);\nint main(void) { return f0(); }\n");
+}
+
+static int build_clash_tree(void) {
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, CLASH_DIR);
+    dependency_graph_scan_directory(graph, CLASH_DIR, true);
+
+    BuildConfig *config = build_config_create();
+    build_config_auto_detect_compiler(config);
+    build_config_set_output_dir(config, CLASH_DIR "/build");
+    config->unity_size = 8;
+
+    BuildStatistics stats;
+    int result = eventchains_build_project(graph, config, &stats);
+
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+    return result;
+}
+
+void test_clashing_members(void) {
+    TEST("A Group That Fails Compiles Its Members Alone");
+
+    setup_clash_tree();
+    ASSERT(build_clash_tree() == 0, "Build succeeds despite clashing statics");
+    ASSERT(access(CLASH_DIR "/build/program", F_OK) == 0, "Program linked");
+    ASSERT(access(CLASH_DIR "/build/f5.o", F_OK) == 0, "Members compiled one by one");
+
+    DependencyGraph *graph = dependency_graph_create();
+    dependency_graph_add_include_path(graph, CLASH_DIR);
+    dependency_graph_scan_directory(graph, CLASH_DIR, true);
+    BuildConfig *config = build_config_create();
+    build_config_set_output_dir(config, CLASH_DIR "/build");
+    UnityBuild *unity = unity_build_plan(graph, config, 8, NULL);
+    ASSERT(unity && unity->group_count == 0 && unity->apart_count == 6,
+           "History keeps the members apart next time");
+    unity_build_destroy(unity);
+
+    /* Editing a member lets it try a group again */
+    write_file(CLASH_DIR "/lib/f0.c", "int f0(void) { return 0; }\n");
+    unity = unity_build_plan(graph, config, 8, NULL);
+    ASSERT(unity && unity->apart_count == 5, "An edited member rejoins");
+    unity_build_destroy(unity);
+    build_config_destroy(config);
+    dependency_graph_destroy(graph);
+
+    /* A member that fails alone too fails the build */
+    setup_clash_tree();
+    write_file(CLASH_DIR "/lib/f5.c", "int f5(void) { return }\n");
+    ASSERT(build_clash_tree() != 0, "A real error still fails the build");
+
+    system("rm -rf \"" CLASH_DIR "\"");
+    TEST_END();
+}
+
+/* ==============================================================================
+ * Main Test Runner
+ * ==============================================================================
+ */
+
+int main(void) {
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                  Unity Builds - Test Suite                     |\n");
+    printf("|----------------------------------------------------------------|\n");
+
+    /* Run all tests */
+    test_plan();
+    test_chain();
+    test_cache_unit();
+    test_hot_members();
+    test_clashing_members();
+
+    /* Print summary */
+    printf("\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|                         Test Summary                           |\n");
+    printf("|----------------------------------------------------------------|\n");
+    printf("|  Total Tests:  %3d                                             |\n",
+           tests_passed + tests_failed);
+    printf("|  Passed:       %3d                                             |\n",
+           tests_passed);
+    printf("|  Failed:       %3d                                             |\n",
+           tests_failed);
+    printf("-----------------------------------------------------------------|\n");
+
+    return tests_failed == 0 ? 0 : 1;
+}
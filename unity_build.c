@@ -0,0 +1,560 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Unity Builds Implementation
+ * ==============================================================================
+ */
+
+/* realpath() */
+#define _DEFAULT_SOURCE
+
+#include "unity_build.h"
+#include "cache_metadata.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+#endif
+
+/* ==============================================================================
+ * Candidates
+ * ==============================================================================
+ */
+
+/**
+ * UnityCandidate - A translation unit that may join a group
+ */
+typedef struct UnityCandidate {
+    const SourceFile *source;
+    size_t dir_length;                      /* Length of the directory part of the path */
+    const char *extension;                  /* Of the unity source it can join */
+    bool hot;                               /* Compiled alone for changing often */
+    bool apart;                             /* Compiled alone since its group failed */
+} UnityCandidate;
+
+static const char *unity_extension(const char *path) {
+    size_t len = strlen(path);
+    if (len >= 2 && strcmp(path + len - 2, ".c") == 0) return ".c";
+    if ((len >= 4 && strcmp(path + len - 4, ".cpp") == 0) ||
+        (len >= 3 && strcmp(path + len - 3, ".cc") == 0)) {
+        return ".cpp";
+    }
+    return NULL;
+}
+
+static size_t directory_length(const char *path) {
+    size_t length = 0;
+    for (size_t i = 0; path[i]; i++) {
+        if (path[i] == '/' || path[i] == '\\') length = i;
+    }
+    return length;
+}
+
+/**
+ * Collect the translation units that can be grouped
+ *
+ * Leaves out generated files, sources with main() and any translation
+ * unit that includes, or is included by, another one.
+ */
+static UnityCandidate *collect_candidates(DependencyGraph *graph, size_t *count) {
+    *count = 0;
+    bool *excluded = calloc(graph->file_count + 1, sizeof(bool));
+    UnityCandidate *candidates = malloc((graph->file_count + 1) * sizeof(UnityCandidate));
+    if (!excluded || !candidates) {
+        free(excluded);
+        free(candidates);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < graph->file_count; i++) {
+        const SourceFile *file = graph->files[i];
+        if (file->is_header || file->generated) continue;
+
+        for (size_t j = 0; j < file->include_count; j++) {
+            const SourceFile *dep = dependency_graph_find_file(graph, file->includes[j]);
+            if (dep && !dep->is_header) {
+                excluded[file->id] = true;
+                excluded[dep->id] = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < graph->file_count; i++) {
+        SourceFile *file = graph->files[i];
+        if (file->is_header || file->generated || excluded[file->id]) continue;
+
+        const char *extension = unity_extension(file->path);
+        if (!extension || source_file_has_main(file)) continue;
+
+        UnityCandidate *candidate = &candidates[(*count)++];
+        candidate->source = file;
+        candidate->dir_length = directory_length(file->path);
+        candidate->extension = extension;
+        candidate->hot = false;
+        candidate->apart = false;
+    }
+
+    free(excluded);
+    return candidates;
+}
+
+/**
+ * Order by directory, then language, then path, so each run of one
+ * directory and language is contiguous and stable from build to build
+ */
+static int compare_candidates(const void *a, const void *b) {
+    const UnityCandidate *left = (const UnityCandidate *)a;
+    const UnityCandidate *right = (const UnityCandidate *)b;
+
+    size_t shorter = left->dir_length < right->dir_length ? left->dir_length
+                                                          : right->dir_length;
+    int order = strncmp(left->source->path, right->source->path, shorter);
+    if (order != 0) return order;
+    if (left->dir_length != right->dir_length) {
+        return left->dir_length < right->dir_length ? -1 : 1;
+    }
+
+    order = strcmp(left->extension, right->extension);
+    return order != 0 ? order : strcmp(left->source->path, right->source->path);
+}
+
+static bool same_run(const UnityCandidate *a, const UnityCandidate *b) {
+    return a->dir_length == b->dir_length &&
+           strncmp(a->source->path, b->source->path, a->dir_length) == 0 &&
+           strcmp(a->extension, b->extension) == 0;
+}
+
+/* ==============================================================================
+ * Change History
+ * ==============================================================================
+ */
+
+#define UNITY_WINDOW_MASK ((1u << UNITY_HOT_WINDOW) - 1)
+#define UNITY_APART_FLAG 0x80000000u        /* In the changes word: kept out of groups */
+
+/**
+ * UnityHistory - What the last builds saw of one member
+ */
+typedef struct UnityHistory {
+    char *path;
+    uint64_t hash;                          /* Content when last seen */
+    unsigned changes;                       /* Bit 0: changed in the latest build with changes,
+                                             * plus UNITY_APART_FLAG */
+} UnityHistory;
+
+typedef struct UnityHistoryList {
+    UnityHistory *items;
+    size_t count;
+    size_t capacity;
+    PathIndex index;                        /* Path -> item */
+} UnityHistoryList;
+
+static bool history_add(UnityHistoryList *list, const char *path, uint64_t hash,
+                        unsigned changes) {
+    if (list->count >= list->capacity) {
+        size_t capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        UnityHistory *items = realloc(list->items, capacity * sizeof(UnityHistory));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    char *copy = strdup(path);
+    if (!copy || !path_index_insert(&list->index, copy, list->count)) {
+        free(copy);
+        return false;
+    }
+    list->items[list->count].path = copy;
+    list->items[list->count].hash = hash;
+    list->items[list->count].changes = changes & (UNITY_WINDOW_MASK | UNITY_APART_FLAG);
+    list->count++;
+    return true;
+}
+
+static void history_destroy(UnityHistoryList *list) {
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->items[i].path);
+    }
+    free(list->items);
+    path_index_destroy(&list->index);
+}
+
+/**
+ * Read the history file: one "<changes> <hash> <path>" line per member
+ *
+ * A missing or unreadable file is an empty history.
+ */
+static void history_load(UnityHistoryList *list, const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return;
+
+    char line[MAX_PATH_LENGTH + 64];
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned changes;
+        unsigned long long hash;
+        int consumed = 0;
+        if (sscanf(line, "%x %llx %n", &changes, &hash, &consumed) != 2 || consumed == 0) {
+            continue;
+        }
+
+        char *member = line + consumed;
+        member[strcspn(member, "\r\n")] = '\0';
+        if (member[0] == '\0' || path_index_find(&list->index, member) != PATH_INDEX_NONE) {
+            continue;
+        }
+        history_add(list, member, (uint64_t)hash, changes);
+    }
+    fclose(fp);
+}
+
+static bool history_save(const UnityHistoryList *list, const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+
+    bool ok = true;
+    for (size_t i = 0; i < list->count && ok; i++) {
+        ok = fprintf(fp, "%x %016llx %s\n", list->items[i].changes,
+                     (unsigned long long)list->items[i].hash, list->items[i].path) > 0;
+    }
+    return fclose(fp) == 0 && ok;
+}
+
+static unsigned count_bits(unsigned bits) {
+    unsigned count = 0;
+    for (; bits; bits &= bits - 1) count++;
+    return count;
+}
+
+/**
+ * Compare each candidate with its history and mark the hot ones
+ *
+ * The history moves on one bit only in a build where some candidate
+ * changed, so builds that change nothing do not cool a member down.
+ * Candidates seen for the first time start with no changes; members
+ * that are gone are dropped. A member set apart by a split rejoins once
+ * its text changes.
+ */
+static bool update_history(UnityCandidate *candidates, size_t count, const char *history_path,
+                           struct BuildCache *cache) {
+    UnityHistoryList old;
+    memset(&old, 0, sizeof(old));
+    path_index_init(&old.index);
+    history_load(&old, history_path);
+
+    UnityHistoryList now;
+    memset(&now, 0, sizeof(now));
+    path_index_init(&now.index);
+
+    bool *changed = calloc(count + 1, sizeof(bool));
+    bool ok = changed != NULL;
+    bool any_changed = false;
+    for (size_t i = 0; ok && i < count; i++) {
+        const char *path = candidates[i].source->path;
+        uint64_t hash = cache ? build_cache_file_hash(cache, path) : hash_file_content(path);
+
+        size_t idx = path_index_find(&old.index, path);
+        unsigned changes = idx != PATH_INDEX_NONE ? old.items[idx].changes : 0;
+        changed[i] = idx != PATH_INDEX_NONE && old.items[idx].hash != hash;
+        any_changed = any_changed || changed[i];
+        if (changed[i]) changes &= ~UNITY_APART_FLAG;
+        ok = history_add(&now, path, hash, changes);
+    }
+
+    for (size_t i = 0; ok && i < count; i++) {
+        UnityHistory *item = &now.items[i];
+        unsigned apart = item->changes & UNITY_APART_FLAG;
+        unsigned window = item->changes & UNITY_WINDOW_MASK;
+        if (any_changed) {
+            window = ((window << 1) | (changed[i] ? 1u : 0u)) & UNITY_WINDOW_MASK;
+        }
+        item->changes = window | apart;
+        candidates[i].hot = count_bits(window) >= UNITY_HOT_CHANGES;
+        candidates[i].apart = apart != 0;
+    }
+
+    if (ok && !history_save(&now, history_path)) {
+        printf("Warning: Failed to write unity build history %s\n", history_path);
+    }
+
+    free(changed);
+    history_destroy(&old);
+    history_destroy(&now);
+    return ok;
+}
+
+/* ==============================================================================
+ * Writing Unity Sources
+ * ==============================================================================
+ */
+
+static bool absolute_path(const char *path, char *dest, size_t dest_size) {
+#ifdef _WIN32
+    return _fullpath(dest, path, dest_size) != NULL;
+#else
+    char resolved[4096];
+    if (!realpath(path, resolved)) return false;
+    int written = snprintf(dest, dest_size, "%s", resolved);
+    return written > 0 && (size_t)written < dest_size;
+#endif
+}
+
+/**
+ * Name a unity source after its directory: "./src/net" with ".c" becomes
+ * <unity dir>/unity_src_net_<index>.c
+ */
+static bool group_path(const UnityCandidate *first, size_t index, const char *unity_dir,
+                       char *dest, size_t dest_size) {
+    const char *dir = first->source->path;
+    size_t length = first->dir_length;
+    while (length > 0 && (*dir == '.' || *dir == '/' || *dir == '\\')) {
+        dir++;
+        length--;
+    }
+
+    char tag[MAX_PATH_LENGTH];
+    size_t tag_length = 0;
+    for (size_t i = 0; i < length && tag_length < sizeof(tag) - 1; i++) {
+        char c = dir[i];
+        bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    (c >= '0' && c <= '9') || c == '-';
+        tag[tag_length++] = word ? c : '_';
+    }
+    tag[tag_length] = '\0';
+
+    int written = snprintf(dest, dest_size, "%s/unity_%s_%zu%s", unity_dir,
+                           tag_length > 0 ? tag : "top", index, first->extension);
+    return written > 0 && (size_t)written < dest_size;
+}
+
+/**
+ * Write a unity source, leaving the file alone if it already says the
+ * same, so its stamp and hash stay put
+ */
+static bool write_unity_source(const char *path, const char *const *members, size_t count) {
+    size_t size = 256 + count * (MAX_PATH_LENGTH + 16);
+    char *text = malloc(size);
+    if (!text) return false;
+
+    int length = snprintf(text, size,
+                          "/* Generated by ecbuild --unity; do not edit. These sources\n"
+                          " * compile as one translation unit. */\n");
+    for (size_t i = 0; length > 0 && i < count; i++) {
+        char absolute[MAX_PATH_LENGTH];
+        if (!absolute_path(members[i], absolute, sizeof(absolute))) {
+            length = -1;
+            break;
+        }
+        length += snprintf(text + length, size - (size_t)length, "#include \"%s\"\n", absolute);
+    }
+    if (length <= 0) {
+        free(text);
+        return false;
+    }
+
+    bool same = false;
+    FILE *fp = fopen(path, "rb");
+    if (fp) {
+        char *old = malloc((size_t)length + 2);
+        if (old) {
+            size_t read = fread(old, 1, (size_t)length + 1, fp);
+            same = read == (size_t)length && memcmp(old, text, (size_t)length) == 0;
+            free(old);
+        }
+        fclose(fp);
+    }
+
+    bool ok = same;
+    if (!same && (fp = fopen(path, "wb")) != NULL) {
+        ok = fwrite(text, 1, (size_t)length, fp) == (size_t)length;
+        ok = fclose(fp) == 0 && ok;
+    }
+    free(text);
+    return ok;
+}
+
+/**
+ * Write one group's unity source and add it to the graph
+ *
+ * @return  true if the group was added; false leaves its members alone
+ */
+static bool add_group(UnityBuild *unity, DependencyGraph *graph, const char *path,
+                      const char **members, size_t count) {
+    if (!write_unity_source(path, members, count)) {
+        printf("Warning: Failed to write unity source %s, compiling its sources alone\n", path);
+        return false;
+    }
+    if (dependency_graph_add_generated_file(graph, path, members, count) != DEP_SUCCESS) {
+        printf("Warning: Failed to add unity source %s to the graph\n", path);
+        return false;
+    }
+
+    /* Spelled as the graph stores it */
+    const SourceFile *node = dependency_graph_find_file(graph, path);
+    UnityGroup *group = &unity->groups[unity->group_count];
+    snprintf(group->path, sizeof(group->path), "%s", node ? node->path : path);
+    group->members = members;
+    group->member_count = count;
+
+    if (!path_index_insert(&unity->sources, group->path, unity->group_count)) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (!path_index_insert(&unity->members, members[i], unity->group_count)) return false;
+    }
+    unity->grouped_count += count;
+    unity->group_count++;
+    return true;
+}
+
+/* ==============================================================================
+ * Planning
+ * ==============================================================================
+ */
+
+/**
+ * Cut one run of a directory and language into groups
+ *
+ * The cuts are made before hot members are taken out, so a member
+ * turning hot changes only its own group.
+ */
+static bool plan_run(UnityBuild *unity, DependencyGraph *graph, const UnityCandidate *run,
+                     size_t run_length, size_t group_size, const char *unity_dir) {
+    size_t chunks = (run_length + group_size - 1) / group_size;
+    size_t start = 0;
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        /* Balanced: sizes differ by at most one */
+        size_t length = run_length / chunks + (chunk < run_length % chunks ? 1 : 0);
+
+        const char **members = malloc((length + 1) * sizeof(const char *));
+        if (!members) return false;
+        size_t count = 0;
+        for (size_t i = start; i < start + length; i++) {
+            if (!run[i].hot && !run[i].apart) members[count++] = run[i].source->path;
+        }
+
+        char path[MAX_PATH_LENGTH];
+        bool added = count >= 2 && group_path(&run[start], chunk, unity_dir, path, sizeof(path)) &&
+                     add_group(unity, graph, path, members, count);
+        if (!added) free(members);
+        start += length;
+    }
+    return true;
+}
+
+UnityBuild *unity_build_plan(DependencyGraph *graph, const BuildConfig *config,
+                             size_t group_size, struct BuildCache *cache) {
+    if (!graph || !config || !config->output_dir || group_size < 2) return NULL;
+
+    UnityBuild *unity = calloc(1, sizeof(UnityBuild));
+    if (!unity) return NULL;
+    path_index_init(&unity->members);
+    path_index_init(&unity->sources);
+
+    char unity_dir[MAX_PATH_LENGTH];
+    snprintf(unity_dir, sizeof(unity_dir), "%s/%s", config->output_dir, UNITY_DIRECTORY);
+    snprintf(unity->history_path, sizeof(unity->history_path), "%s/%s", unity_dir,
+             UNITY_HISTORY_FILE);
+    mkdir(config->output_dir, 0755);
+    mkdir(unity_dir, 0755);
+
+    size_t count = 0;
+    UnityCandidate *candidates = collect_candidates(graph, &count);
+    unity->groups = calloc(count / 2 + 1, sizeof(UnityGroup));
+    unity->hot = malloc((count + 1) * sizeof(const char *));
+    unity->apart = malloc((count + 1) * sizeof(const char *));
+    if (!candidates || !unity->groups || !unity->hot || !unity->apart ||
+        !update_history(candidates, count, unity->history_path, cache)) {
+        free(candidates);
+        unity_build_destroy(unity);
+        return NULL;
+    }
+    unity->candidate_count = count;
+
+    qsort(candidates, count, sizeof(UnityCandidate), compare_candidates);
+    for (size_t i = 0; i < count; i++) {
+        if (candidates[i].hot) {
+            unity->hot[unity->hot_count++] = candidates[i].source->path;
+        } else if (candidates[i].apart) {
+            unity->apart[unity->apart_count++] = candidates[i].source->path;
+        }
+    }
+
+    bool ok = true;
+    for (size_t start = 0; ok && start < count;) {
+        size_t end = start + 1;
+        while (end < count && same_run(&candidates[start], &candidates[end])) end++;
+
+        ok = plan_run(unity, graph, &candidates[start], end - start, group_size, unity_dir);
+        start = end;
+    }
+
+    free(candidates);
+    if (!ok) {
+        unity_build_destroy(unity);
+        return NULL;
+    }
+    return unity;
+}
+
+bool unity_build_skips(const UnityBuild *unity, const SourceFile *file) {
+    if (!file) return false;
+    if (!unity) return file->generated;
+
+    if (file->generated) {
+        return path_index_find(&unity->sources, file->path) == PATH_INDEX_NONE;
+    }
+    return path_index_find(&unity->members, file->path) != PATH_INDEX_NONE;
+}
+
+const UnityGroup *unity_build_find(const UnityBuild *unity, const char *source_path) {
+    if (!unity || !source_path) return NULL;
+
+    size_t idx = path_index_find(&unity->members, source_path);
+    return idx == PATH_INDEX_NONE ? NULL : &unity->groups[idx];
+}
+
+size_t unity_build_split(UnityBuild *unity, const char *unity_source) {
+    if (!unity || !unity_source) return 0;
+
+    size_t idx = path_index_find(&unity->sources, unity_source);
+    if (idx == PATH_INDEX_NONE) return 0;
+    const UnityGroup *group = &unity->groups[idx];
+
+    UnityHistoryList history;
+    memset(&history, 0, sizeof(history));
+    path_index_init(&history.index);
+    history_load(&history, unity->history_path);
+
+    size_t split = 0;
+    for (size_t i = 0; i < group->member_count; i++) {
+        size_t item = path_index_find(&history.index, group->members[i]);
+        if (item == PATH_INDEX_NONE) continue;
+        history.items[item].changes |= UNITY_APART_FLAG;
+        split++;
+    }
+
+    if (split > 0 && !history_save(&history, unity->history_path)) {
+        printf("Warning: Failed to write unity build history %s\n", unity->history_path);
+        split = 0;
+    }
+    history_destroy(&history);
+    return split;
+}
+
+void unity_build_destroy(UnityBuild *unity) {
+    if (!unity) return;
+
+    if (unity->groups) {
+        for (size_t i = 0; i < unity->group_count; i++) {
+            free((void *)unity->groups[i].members);
+        }
+    }
+    free(unity->groups);
+    free((void *)unity->hot);
+    free((void *)unity->apart);
+    path_index_destroy(&unity->members);
+    path_index_destroy(&unity->sources);
+    free(unity);
+}
@@ -0,0 +1,164 @@
+/**
+ * ==============================================================================
+ * EventChains Build System - Unity Builds
+ * ==============================================================================
+ *
+ * Groups the translation units of each directory into generated unity
+ * sources of about N units each, under <output_dir>/unity. A unity source
+ * is nothing but #include lines naming its members by absolute path, so
+ * the compiler parses the headers they share once per group instead of
+ * once per member.
+ *
+ * Each unity source is added to the dependency graph as a generated file
+ * that includes its members. It then compiles as one event, and its cache
+ * entry covers every member and every header they include: editing any of
+ * them rebuilds the group as a unit.
+ *
+ * A member whose own text keeps changing is taken out of its group and
+ * compiled alone, so editing it rebuilds one file rather than the group.
+ * Each member's content hash is kept in <output_dir>/unity/history with a
+ * bit per recent build that changed any member; one that changed in
+ * UNITY_HOT_CHANGES of the last UNITY_HOT_WINDOW such builds is hot, and
+ * rejoins its group once it has been left alone long enough.
+ *
+ * A group whose compile fails is split (unity_build_split): its members
+ * are compiled alone at once, and the history keeps each one out of
+ * groups until its text changes.
+ *
+ * Sources that define main() are never grouped, since each one links
+ * into an executable of its own, and neither are translation units that
+ * #include one another. Grouped sources share one translation unit, so
+ * file-scope names (static functions, macros) that clash between members
+ * of a directory fail the group's compile and split it.
+ *
+ * Copyright (c) 2024 EventChains Project
+ * Licensed under the MIT License
+ * ==============================================================================
+ */
+
+#ifndef UNITY_BUILD_H
+#define UNITY_BUILD_H
+
+#include "compile_events.h"
+#include "path_index.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Defined in cache_metadata.h */
+struct BuildCache;
+
+/* ==============================================================================
+ * Constants
+ * ==============================================================================
+ */
+
+#define UNITY_DIRECTORY "unity"                 /* Under the output directory */
+#define UNITY_HISTORY_FILE "history"            /* Member hashes and change bits */
+#define UNITY_HOT_WINDOW 8                      /* Builds with changes a member's history covers */
+#define UNITY_HOT_CHANGES 2                     /* Changes within the window that make it hot */
+
+/* ==============================================================================
+ * Types
+ * ==============================================================================
+ */
+
+/**
+ * UnityGroup - One generated unity source and the sources it includes
+ */
+typedef struct UnityGroup {
+    char path[MAX_PATH_LENGTH];             /* Generated unity source, a graph node */
+    const char **members;                   /* Member paths as the graph spells them */
+    size_t member_count;
+} UnityGroup;
+
+/**
+ * UnityBuild - The unity sources of one build
+ */
+typedef struct UnityBuild {
+    UnityGroup *groups;
+    size_t group_count;
+    PathIndex members;                      /* Member path -> index in groups */
+    PathIndex sources;                      /* Unity source path -> index in groups */
+    size_t candidate_count;                 /* Translation units that could be grouped */
+    size_t grouped_count;                   /* Members of some group */
+    const char **hot;                       /* Candidates compiled alone for changing often */
+    size_t hot_count;
+    const char **apart;                     /* Candidates compiled alone since a split */
+    size_t apart_count;
+    char history_path[MAX_PATH_LENGTH + 16];
+} UnityBuild;
+
+/* ==============================================================================
+ * Planning
+ * ==============================================================================
+ */
+
+/**
+ * Group a graph's translation units into unity sources
+ *
+ * Updates the change history, writes each unity source (leaving files
+ * that already say the same alone, so their stamps and hashes stay put)
+ * and adds it to the graph. Translation units of one directory and
+ * language are taken in path order and cut into runs of about group_size;
+ * a run of one is compiled as it is.
+ *
+ * @param graph       Scanned dependency graph (must outlive the build)
+ * @param config      Build configuration (output directory)
+ * @param group_size  Translation units per unity source (at least 2)
+ * @param cache       Persistent cache, to hash with (can be NULL)
+ * @return            UnityBuild (possibly with no groups), or NULL on error
+ */
+UnityBuild *unity_build_plan(DependencyGraph *graph, const BuildConfig *config,
+                             size_t group_size, struct BuildCache *cache);
+
+/**
+ * Whether the compilation chain leaves a file out
+ *
+ * True for members of a group, which compile inside their unity source,
+ * and for unity sources an earlier plan added to the graph that this one
+ * no longer uses.
+ *
+ * @param unity  UnityBuild (NULL when unity builds are off)
+ * @param file   Translation unit from the graph
+ * @return       true to give the file no compile event
+ */
+bool unity_build_skips(const UnityBuild *unity, const SourceFile *file);
+
+/**
+ * Look up the group a source compiles in
+ *
+ * @param unity        UnityBuild (can be NULL)
+ * @param source_path  Source path as the graph spells it
+ * @return             The group, or NULL if the source compiles alone
+ */
+const UnityGroup *unity_build_find(const UnityBuild *unity, const char *source_path);
+
+/**
+ * Split a unity source whose compile failed
+ *
+ * Its members may only fail together, for instance by defining the same
+ * static function. Each one is marked in the history to be compiled
+ * alone until its text changes; plan again to build them that way.
+ *
+ * @param unity        UnityBuild
+ * @param unity_source Unity source path as the graph spells it
+ * @return             Members set apart, 0 if unity_source is not one of the groups
+ */
+size_t unity_build_split(UnityBuild *unity, const char *unity_source);
+
+/**
+ * Free a unity build (generated files and graph nodes stay)
+ *
+ * @param unity  UnityBuild (can be NULL)
+ */
+void unity_build_destroy(UnityBuild *unity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNITY_BUILD_H */